@@ -207,3 +207,20 @@ CHECK_CXX_SOURCE_COMPILES("
     " HAVE_MMAP
 )
 GR_ADD_COND_DEF(HAVE_MMAP)
+
+########################################################################
+CHECK_CXX_SOURCE_COMPILES("
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    int main(){syscall(SYS_memfd_create, \"\", 0); return 0;}
+    " HAVE_MEMFD_CREATE
+)
+GR_ADD_COND_DEF(HAVE_MEMFD_CREATE)
+
+CHECK_CXX_SOURCE_COMPILES("
+    #include <unistd.h>
+    #include <sys/syscall.h>
+    int main(){syscall(SYS_mbind, 0, 0, 0, 0, 0, 0); return 0;}
+    " HAVE_MBIND
+)
+GR_ADD_COND_DEF(HAVE_MBIND)
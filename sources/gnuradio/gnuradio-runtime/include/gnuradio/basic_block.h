@@ -29,6 +29,7 @@
 #include <gnuradio/runtime_types.h>
 #include <gnuradio/io_signature.h>
 #include <gnuradio/thread/thread.h>
+#include <gnuradio/high_res_timer.h>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/function.hpp>
 #include <boost/foreach.hpp>
@@ -59,10 +60,13 @@ namespace gr {
                                      public boost::enable_shared_from_this<basic_block>
   {
     typedef boost::function<void(pmt::pmt_t)> msg_handler_t;
+    typedef boost::function<void(const std::vector<pmt::pmt_t> &)> msg_batch_handler_t;
 
   private:
     typedef std::map<pmt::pmt_t , msg_handler_t, pmt::comparator> d_msg_handlers_t;
     d_msg_handlers_t d_msg_handlers;
+    typedef std::map<pmt::pmt_t , msg_batch_handler_t, pmt::comparator> d_msg_batch_handlers_t;
+    d_msg_batch_handlers_t d_msg_batch_handlers;
 
     typedef std::deque<pmt::pmt_t> msg_queue_t;
     typedef std::map<pmt::pmt_t, msg_queue_t, pmt::comparator> msg_queue_map_t;
@@ -71,10 +75,93 @@ namespace gr {
 
     gr::thread::mutex mutex;          //< protects all vars
 
+    typedef std::vector<msg_edge_queue_sptr> msg_edge_queue_vector_t;
+    typedef std::map<pmt::pmt_t, msg_edge_queue_vector_t, pmt::comparator> msg_edge_queue_map_t;
+    msg_edge_queue_map_t d_msg_edges_in;   //< lock-free queues of connections to input ports
+
+    /*!
+     * Lock-free queues of connections from output ports. Publishers
+     * take a snapshot with boost::atomic_load and never lock; changes
+     * copy the map under d_msg_subscribers_mutex and swap the new one
+     * in.
+     */
+    boost::shared_ptr<const msg_edge_queue_map_t> d_msg_edges_out;
+
+    //! protects d_message_subscribers and changes of d_msg_edges_out
+    gr::thread::mutex d_msg_subscribers_mutex;
+
+    //! Removes the lock-free queues of an output port, which publishes
+    //! through the registry then; called with d_msg_subscribers_mutex held
+    void drop_msg_edges_out(pmt::pmt_t port_id);
+
+    //! Producer side of a lock-free message connection
+    void insert_tail_lockfree(msg_edge_queue &q, const pmt::pmt_t &msg);
+
+    //! Pops a message from lock-free queues of the port
+    bool pop_edge_queues(pmt::pmt_t which_port, pmt::pmt_t &msg);
+
+    //! Clears the spill marks of queues of the port; called with mutex held
+    void clear_spilled(pmt::pmt_t which_port);
+
+    //! Latency of messages, from queuing them to taking them from the queue
+    struct msg_latency_t
+    {
+      uint64_t nmsgs;
+      high_res_timer_type total;
+      high_res_timer_type max;
+      msg_latency_t() : nmsgs(0), total(0), max(0) {}
+    };
+    typedef std::deque<high_res_timer_type> msg_times_t;
+
+    bool d_msg_latency_on;            //< [PerfCounters] msg_latency
+    std::map<pmt::pmt_t, msg_times_t, pmt::comparator> d_msg_times; //< queuing times of msg_queue, protected by mutex
+    std::map<pmt::pmt_t, msg_latency_t, pmt::comparator> d_msg_latency;
+    gr::thread::mutex d_msg_pc_mutex; //< protects d_msg_latency and d_msg_pc
+
+    static const int MSG_HANDLER_HIST_BINS = 20;
+
+    //! Counters of handling the messages of an input port
+    struct msg_port_pc_t
+    {
+      uint64_t nhandled;
+      high_res_timer_type handler_total;
+      high_res_timer_type handler_min;
+      high_res_timer_type handler_max;
+      uint64_t handler_hist[MSG_HANDLER_HIST_BINS];
+      uint64_t batch_max;             //< most messages taken at once
+      uint64_t drops;
+      msg_port_pc_t();
+    };
+
+    bool d_msg_pc_on;                 //< [PerfCounters] on
+    std::map<pmt::pmt_t, msg_port_pc_t, pmt::comparator> d_msg_pc;
+
+    //! Deepest the locked queue of a port got, rings of detached
+    //! connections included; protected by mutex
+    std::map<pmt::pmt_t, size_t, pmt::comparator> d_msg_queue_high_water;
+
+    //! Notes a depth of the queue of a port; called with mutex held
+    void note_msg_queue_depth(pmt::pmt_t which_port, size_t depth)
+    {
+      size_t &high_water = d_msg_queue_high_water[which_port];
+      if(depth > high_water)
+        high_water = depth;
+    }
+
+    //! Pops the head of the locked queue of the port; called with mutex held
+    pmt::pmt_t pop_msg_queue(pmt::pmt_t which_port);
+
+    void record_msg_latency(pmt::pmt_t which_port, uint64_t nmsgs,
+                            high_res_timer_type total, high_res_timer_type max);
+
+    //! Counts a message dropped from a port without a handler
+    void record_msg_drop(pmt::pmt_t which_port);
+
   protected:
     friend class flowgraph;
     friend class flat_flowgraph; // TODO: will be redundant
     friend class tpb_thread_body;
+    friend class msg_worker_pool;
 
     enum vcolor { WHITE, GREY, BLACK };
 
@@ -91,7 +178,7 @@ namespace gr {
     msg_queue_map_t msg_queue;
     std::vector<boost::any> d_rpc_vars; // container for all RPC variables
 
-    basic_block(void) {} // allows pure virtual interface sub-classes
+    basic_block(void) : d_msg_latency_on(false), d_msg_pc_on(false) {} // allows pure virtual interface sub-classes
 
     //! Protected constructor prevents instantiation by non-derived classes
     basic_block(const std::string &name,
@@ -114,11 +201,24 @@ namespace gr {
     void set_color(vcolor color) { d_color = color; }
     vcolor color() const { return d_color; }
 
+    /*!
+     * \brief Allow the flowgraph to add a lock-free message connection
+     * from or to this block
+     */
+    void attach_msg_edge_queue(msg_edge_queue_sptr q);
+
+    /*!
+     * \brief Allow the flowgraph to remove a lock-free message
+     * connection; messages left in it are moved to the locked queue
+     */
+    void detach_msg_edge_queue(msg_edge_queue_sptr q);
+
     /*!
      * \brief Tests if there is a handler attached to port \p which_port
      */
     virtual bool has_msg_handler(pmt::pmt_t which_port) {
-      return (d_msg_handlers.find(which_port) != d_msg_handlers.end());
+      return (d_msg_handlers.find(which_port) != d_msg_handlers.end() ||
+              d_msg_batch_handlers.find(which_port) != d_msg_batch_handlers.end());
     }
 
     /*
@@ -130,11 +230,26 @@ namespace gr {
     virtual void dispatch_msg(pmt::pmt_t which_port, pmt::pmt_t msg)
     {
       // AA Update this
-      if(has_msg_handler(which_port)) {  // Is there a handler?
-        d_msg_handlers[which_port](msg); // Yes, invoke it.
+      d_msg_handlers_t::iterator handler = d_msg_handlers.find(which_port);
+      if(handler != d_msg_handlers.end()) {  // Is there a handler?
+        handler->second(msg);                // Yes, invoke it.
+        return;
+      }
+      d_msg_batch_handlers_t::iterator batch_handler = d_msg_batch_handlers.find(which_port);
+      if(batch_handler != d_msg_batch_handlers.end()) {
+        batch_handler->second(std::vector<pmt::pmt_t>(1, msg));
       }
     }
 
+    /*!
+     * \brief Dispatches messages taken from the queue of a port, timing
+     * the handler when performance counters are on.
+     *
+     * A batch handler of the port gets all of them in one call, other
+     * handlers are called by dispatch_msg for each message.
+     */
+    void dispatch_msgs(pmt::pmt_t which_port, const std::vector<pmt::pmt_t> &msgs);
+
     // Message passing interface
     pmt::pmt_t d_message_subscribers;
 
@@ -213,15 +328,11 @@ namespace gr {
     void _post(pmt::pmt_t which_port, pmt::pmt_t msg);
 
     //! is the queue empty?
-    bool empty_p(pmt::pmt_t which_port) {
-      if(msg_queue.find(which_port) == msg_queue.end())
-        throw std::runtime_error("port does not exist!");
-      return msg_queue[which_port].empty();
-    }
+    bool empty_p(pmt::pmt_t which_port);
     bool empty_p() {
       bool rv = true;
       BOOST_FOREACH(msg_queue_map_t::value_type &i, msg_queue) {
-        rv &= msg_queue[i.first].empty();
+        rv &= empty_p(i.first);
       }
       return rv;
     }
@@ -239,11 +350,7 @@ namespace gr {
     }
 
     //! How many messages in the queue?
-    size_t nmsgs(pmt::pmt_t which_port) {
-      if(msg_queue.find(which_port) == msg_queue.end())
-        throw std::runtime_error("port does not exist!");
-      return msg_queue[which_port].size();
-    }
+    size_t nmsgs(pmt::pmt_t which_port);
 
     //| Acquires and release the mutex
     void insert_tail( pmt::pmt_t which_port, pmt::pmt_t msg);
@@ -252,6 +359,16 @@ namespace gr {
      */
     pmt::pmt_t delete_head_nowait( pmt::pmt_t which_port);
 
+    /*!
+     * \brief Moves all messages queued on a port to the end of \p msgs.
+     *
+     * Messages of lock-free connections are taken without locking,
+     * the rest of them under one lock.
+     *
+     * \returns the number of messages moved
+     */
+    size_t delete_head_batch(pmt::pmt_t which_port, std::vector<pmt::pmt_t> &msgs);
+
     /*!
      * \param[in] which_port The message port from which to get the message.
      * \param[in] millisec Optional timeout value (0=no timeout).
@@ -264,6 +381,10 @@ namespace gr {
     }
 
     void erase_msg(pmt::pmt_t which_port, msg_queue_t::iterator it) {
+      if(d_msg_latency_on) {
+        msg_times_t &times = d_msg_times[which_port];
+        times.erase(times.begin() + (it - msg_queue[which_port].begin()));
+      }
       msg_queue[which_port].erase(it);
     }
 
@@ -281,6 +402,83 @@ namespace gr {
       return msg_queue;
     }
 
+    /*!
+     * \brief Average time messages of an input port spent queued, in
+     * microseconds.
+     *
+     * Measured from queuing a message to the scheduler taking it from
+     * the queue, when [PerfCounters] msg_latency is on at the time the
+     * block is made.
+     */
+    double pc_msg_latency(pmt::pmt_t which_port);
+
+    //! Maximum time messages of an input port spent queued, in microseconds.
+    double pc_msg_latency_max(pmt::pmt_t which_port);
+
+    //! Number of messages of an input port the latency was measured for.
+    uint64_t pc_msg_latency_nmsgs(pmt::pmt_t which_port);
+
+    //! Restarts the measurement of message latency on all ports.
+    void reset_msg_latency();
+
+    /*!
+     * \brief Number of messages of an input port handled.
+     *
+     * This and the other message handler counters are kept when
+     * [PerfCounters] on is set at the time the block is made and GNU
+     * Radio is built with performance counters. The times of a batch
+     * handler are those of whole calls, except the average, which is
+     * per message.
+     */
+    uint64_t pc_msg_nhandled(pmt::pmt_t which_port);
+
+    //! Average time of the message handler of an input port, in microseconds.
+    double pc_msg_handler_time(pmt::pmt_t which_port);
+
+    //! Minimum time of the message handler of an input port, in microseconds.
+    double pc_msg_handler_time_min(pmt::pmt_t which_port);
+
+    //! Maximum time of the message handler of an input port, in microseconds.
+    double pc_msg_handler_time_max(pmt::pmt_t which_port);
+
+    /*!
+     * \brief Histogram of the times of the message handler of an input port.
+     *
+     * Bin 0 counts calls shorter than 1 us, bin i calls of 2^(i-1) to
+     * 2^i us and the last bin all longer ones.
+     */
+    std::vector<uint64_t> pc_msg_handler_time_hist(pmt::pmt_t which_port);
+
+    /*!
+     * \brief Largest batch of messages the scheduler took from an
+     * input port at once.
+     *
+     * The scheduler takes all messages queued on the port when it
+     * gets to it, so this is the depth of the queue sampled when it is
+     * drained, not the deepest the queue ever was.
+     */
+    uint64_t pc_msg_batch_size_max(pmt::pmt_t which_port);
+
+    /*!
+     * \brief Most messages queued on an input port at once.
+     *
+     * Sampled whenever a message is queued. With lock-free message
+     * queues it is the deepest one connection got, its ring and its
+     * spilled messages together. Counted whether performance counters
+     * are on or not.
+     */
+    uint64_t pc_msg_queue_high_water(pmt::pmt_t which_port);
+
+    /*!
+     * \brief Number of messages dropped from an input port without a
+     * handler because more than [DEFAULT] max_messages were queued.
+     * Counted whether performance counters are on or not.
+     */
+    uint64_t pc_msg_drops(pmt::pmt_t which_port);
+
+    //! Restarts the message handler counters on all ports.
+    void reset_msg_pc();
+
 #ifdef GR_CTRLPORT
     /*!
      * \brief Add an RPC variable (get or set).
@@ -374,6 +572,33 @@ namespace gr {
         throw std::runtime_error("attempt to set_msg_handler() on bad input message port!");
       }
       d_msg_handlers[which_port] = msg_handler_t(msg_handler);
+      d_msg_batch_handlers.erase(which_port);
+    }
+
+    /*!
+     * \brief Set the callback that is fired when messages are available,
+     * with all of them at once.
+     *
+     * \p msg_handler can be any kind of function pointer or function object
+     * that has the signature:
+     * <pre>
+     *    void msg_handler(const std::vector<pmt::pmt_t> &msgs);
+     * </pre>
+     *
+     * It replaces the handler of set_msg_handler and gets every message
+     * queued on the port when the scheduler gets to it, in the order
+     * they were queued, so a block that works on groups of messages
+     * (like blocks of bursts of a decoder) pays for the dispatch once
+     * per group. \p msgs is never empty and holds only one message when
+     * the messages come one after another. The thread-safety guarantees
+     * are the same as those of set_msg_handler.
+     */
+    template <typename T> void set_msg_batch_handler(pmt::pmt_t which_port, T msg_handler) {
+      if(msg_queue.find(which_port) == msg_queue.end()) {
+        throw std::runtime_error("attempt to set_msg_batch_handler() on bad input message port!");
+      }
+      d_msg_batch_handlers[which_port] = msg_batch_handler_t(msg_handler);
+      d_msg_handlers.erase(which_port);
     }
 
     virtual void set_processor_affinity(const std::vector<int> &mask)
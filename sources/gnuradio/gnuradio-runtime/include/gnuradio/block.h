@@ -563,6 +563,62 @@ namespace gr {
      */
     float pc_throughput_avg();
 
+    using basic_block::pc_msg_nhandled;
+    using basic_block::pc_msg_handler_time_min;
+    using basic_block::pc_msg_handler_time_max;
+    using basic_block::pc_msg_handler_time_hist;
+    using basic_block::pc_msg_batch_size_max;
+    using basic_block::pc_msg_queue_high_water;
+    using basic_block::pc_msg_drops;
+
+    /*!
+     * \brief Gets number of messages handled of all input message
+     * ports, in the order of message_ports_in().
+     */
+    std::vector<float> pc_msg_nhandled();
+
+    /*!
+     * \brief Gets average time of the message handler of all input
+     * message ports, in microseconds.
+     */
+    std::vector<float> pc_msg_handler_time_avg();
+
+    /*!
+     * \brief Gets minimum time of the message handler of all input
+     * message ports, in microseconds.
+     */
+    std::vector<float> pc_msg_handler_time_min();
+
+    /*!
+     * \brief Gets maximum time of the message handler of all input
+     * message ports, in microseconds.
+     */
+    std::vector<float> pc_msg_handler_time_max();
+
+    /*!
+     * \brief Gets histograms of the times of the message handler of
+     * all input message ports, one after another.
+     */
+    std::vector<float> pc_msg_handler_time_hist();
+
+    /*!
+     * \brief Gets the largest batch of messages taken at once from
+     * all input message ports.
+     */
+    std::vector<float> pc_msg_batch_size_max();
+
+    /*!
+     * \brief Gets the most messages queued at once on all input
+     * message ports.
+     */
+    std::vector<float> pc_msg_queue_high_water();
+
+    /*!
+     * \brief Gets number of messages dropped from all input message
+     * ports.
+     */
+    std::vector<float> pc_msg_drops();
+
     /*!
      * \brief Resets the performance counters
      */
@@ -28,11 +28,13 @@
 #include <gnuradio/tags.h>
 #include <boost/weak_ptr.hpp>
 #include <gnuradio/thread/thread.h>
+#include <boost/circular_buffer.hpp>
 #include <map>
 
 namespace gr {
 
   class vmcircbuf;
+  class vmcircbuf_factory;
 
   /*!
    * \brief Allocate a buffer that holds at least \p nitems of size \p sizeof_item.
@@ -109,6 +111,13 @@ namespace gr {
      */
     void add_item_tag(const tag_t &tag);
 
+    /*!
+     * \brief  Adds new tags to the buffer, taking its lock once.
+     *
+     * \param tags       the new tags
+     */
+    void add_item_tags(const std::vector<tag_t> &tags);
+
     /*!
      * \brief  Removes an existing tag from the buffer.
      *
@@ -130,10 +139,17 @@ namespace gr {
      */
     void prune_tags(uint64_t max_time);
 
-    std::multimap<uint64_t,tag_t>::iterator get_tags_begin() { return d_item_tags.begin(); }
-    std::multimap<uint64_t,tag_t>::iterator get_tags_end() { return d_item_tags.end(); }
-    std::multimap<uint64_t,tag_t>::iterator get_tags_lower_bound(uint64_t x) { return d_item_tags.lower_bound(x); }
-    std::multimap<uint64_t,tag_t>::iterator get_tags_upper_bound(uint64_t x) { return d_item_tags.upper_bound(x); }
+    /*!
+     * Tags are kept in a ring sorted by offset, oldest first. Tags
+     * are almost always added in order and pruned from the front, so
+     * both are O(1); a tag added out of order is inserted in place.
+     */
+    typedef boost::circular_buffer<tag_t> tag_store_t;
+
+    tag_store_t::iterator get_tags_begin() { return d_item_tags.begin(); }
+    tag_store_t::iterator get_tags_end() { return d_item_tags.end(); }
+    tag_store_t::iterator get_tags_lower_bound(uint64_t x);
+    tag_store_t::iterator get_tags_upper_bound(uint64_t x);
 
     // -------------------------------------------------------------------------
 
@@ -164,9 +180,11 @@ namespace gr {
     unsigned int			d_write_index;	// in items [0,d_bufsize)
     uint64_t                            d_abs_write_offset; // num items written since the start
     bool				d_done;
-    std::multimap<uint64_t,tag_t>                   d_item_tags;
+    tag_store_t                         d_item_tags;
     uint64_t                            d_last_min_items_read;
 
+    void insert_item_tag(const tag_t &tag);
+
     unsigned index_add(unsigned a, unsigned b)
     {
       unsigned s = a + b;
@@ -190,6 +208,8 @@ namespace gr {
     }
 
     virtual bool allocate_buffer(int nitems, size_t sizeof_item);
+    bool allocate_vmcircbuf(vmcircbuf_factory *factory, int nitems, size_t sizeof_item);
+    void place_on_link_node();
 
     /*!
      * \brief constructor is private.  Use gr_make_buffer to create instances.
@@ -314,6 +334,27 @@ namespace gr {
                            uint64_t abs_end,
 			   long id);
 
+    /*!
+     * \brief Given a [start,end), returns a vector of all tags in the
+     * range with a given key.
+     *
+     * Tags are filtered while the buffer is locked, so that only the
+     * matching tags are copied into \p v. Reusing \p v between calls
+     * avoids allocations once it has grown to the number of tags of a
+     * call.
+     *
+     * \param v            a vector reference to return tags into
+     * \param abs_start    a uint64 count of the start of the range of interest
+     * \param abs_end      a uint64 count of the end of the range of interest
+     * \param key          the key of the tags of interest
+     * \param id           the unique ID of the block to make sure already deleted tags are not returned
+     */
+    void get_tags_in_range(std::vector<tag_t> &v,
+                           uint64_t abs_start,
+                           uint64_t abs_end,
+                           const pmt::pmt_t &key,
+                           long id);
+
     // -------------------------------------------------------------------------
 
   private:
@@ -327,6 +368,12 @@ namespace gr {
     boost::weak_ptr<block> d_link;   // block that reads via this buffer reader
     unsigned d_attr_delay;           // sample delay attribute for tag propagation
 
+    void copy_tags_in_range(std::vector<tag_t> &v,
+                            uint64_t abs_start,
+                            uint64_t abs_end,
+                            const pmt::pmt_t *key,
+                            long id);
+
     //! constructor is private.  Use gr::buffer::add_reader to create instances
     buffer_reader(buffer_sptr buffer, unsigned int read_index,
                   block_sptr link);
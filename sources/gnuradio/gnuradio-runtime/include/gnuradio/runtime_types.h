@@ -39,6 +39,7 @@ namespace gr {
   class hier_block2;
   class flat_flowgraph;
   class flowgraph;
+  class msg_edge_queue;
   class top_block;
 
   typedef boost::shared_ptr<basic_block>    basic_block_sptr;
@@ -49,6 +50,7 @@ namespace gr {
   typedef boost::shared_ptr<hier_block2>    hier_block2_sptr;
   typedef boost::shared_ptr<flat_flowgraph> flat_flowgraph_sptr;
   typedef boost::shared_ptr<flowgraph>      flowgraph_sptr;
+  typedef boost::shared_ptr<msg_edge_queue> msg_edge_queue_sptr;
   typedef boost::shared_ptr<top_block>      top_block_sptr;
 
 } /* namespace gr */
@@ -138,6 +138,25 @@ namespace gr {
     //! Set the maximum number of noutput_items in the flowgraph
     void set_max_noutput_items(int nmax);
 
+    //! Are lock-free msg queues used by the flowgraph?
+    bool lockfree_msg_queues();
+
+    /*!
+     * \brief Use lock-free queues for msg connections
+     *
+     * Subscribers of msg ports are resolved when the flowgraph is
+     * started instead of for each published message, and messages are
+     * passed through a lock-free ring per connection and handed to
+     * the receiving block in batches. A port may be published on from
+     * any number of threads.
+     * The depth of the rings is read from [DEFAULT]
+     * lockfree_msg_queue_depth of the preferences; messages overflowing
+     * a ring wait in the locked queue of the port.
+     *
+     * Takes effect on the next start() or unlock().
+     */
+    void set_lockfree_msg_queues(bool enable);
+
     top_block_sptr to_top_block(); // Needed for Python type coercion
 
     void setup_rpc();
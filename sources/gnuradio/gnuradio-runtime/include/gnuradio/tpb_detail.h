@@ -24,6 +24,8 @@
 
 #include <gnuradio/api.h>
 #include <gnuradio/thread/thread.h>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 #include <deque>
 #include <pmt/pmt.h>
 
@@ -56,8 +58,45 @@ namespace gr {
     //! Called by us to notify both upstream and downstream
     void notify_neighbors(block_detail *d);
 
+    //! Set by schedulers that handle the messages of the block on a
+    //! worker pool instead of the block thread; \p wakeup is called
+    //! for new messages instead of notifying the conditions.
+    void set_msg_wakeup(const boost::function<void()> &wakeup)
+    {
+      boost::atomic_store(&msg_wakeup,
+                          boost::shared_ptr<const boost::function<void()> >(
+                            new boost::function<void()>(wakeup)));
+    }
+
+    //! Back to notifying the conditions. Posters that saw the old
+    //! wakeup may still call it.
+    void clear_msg_wakeup()
+    {
+      boost::atomic_store(&msg_wakeup, boost::shared_ptr<const boost::function<void()> >());
+    }
+
     //! Called by pmt msg posters
     void notify_msg() {
+      boost::shared_ptr<const boost::function<void()> > wakeup = boost::atomic_load(&msg_wakeup);
+      if(wakeup) {
+        (*wakeup)();
+        return;
+      }
+      input_cond.notify_one();
+      output_cond.notify_one();
+    }
+
+    //! Called by lock-free msg posters, which don't hold the block
+    //! mutex; notifying under our mutex makes sure the wakeup isn't
+    //! lost between the check for messages and the wait.
+    void notify_msg_locked()
+    {
+      boost::shared_ptr<const boost::function<void()> > wakeup = boost::atomic_load(&msg_wakeup);
+      if(wakeup) {
+        (*wakeup)();
+        return;
+      }
+      gr::thread::scoped_lock guard(mutex);
       input_cond.notify_one();
       output_cond.notify_one();
     }
@@ -71,6 +110,10 @@ namespace gr {
     }
 
   private:
+    //! Set and cleared while posters call it, so it is swapped
+    //! atomically
+    boost::shared_ptr<const boost::function<void()> > msg_wakeup;
+
     //! Used by notify_downstream
     void set_input_changed()
     {
@@ -285,6 +285,14 @@ PMT_API bool is_pair(const pmt_t& obj);
 //! Return a newly allocated pair whose car is \p x and whose cdr is \p y.
 PMT_API pmt_t cons(const pmt_t& x, const pmt_t& y);
 
+/*!
+ * \brief Like cons, but the pair comes from a thread-caching pool
+ *
+ * Meant for producers of many messages per second, where the pair is
+ * released soon, often by another thread.
+ */
+PMT_API pmt_t cons_pooled(const pmt_t& x, const pmt_t& y);
+
 //! If \p pair is a pair, return the car of the \p pair, otherwise raise wrong_type.
 PMT_API pmt_t car(const pmt_t& pair);
 
@@ -387,6 +395,14 @@ PMT_API bool is_blob(pmt_t x);
  */
 PMT_API pmt_t make_blob(const void *buf, size_t len);
 
+/*!
+ * \brief Like make_blob, but small blobs come from a thread-caching pool
+ *
+ * The blob and its data are one allocation from the pool of cons_pooled.
+ * Blobs of more than about 300 bytes are made by make_blob.
+ */
+PMT_API pmt_t make_blob_pooled(const void *buf, size_t len);
+
 //! Return a pointer to the blob's data
 PMT_API const void *blob_data(pmt_t blob);
 
@@ -27,6 +27,10 @@
 #include <gnuradio/basic_block.h>
 #include <gnuradio/block_registry.h>
 #include <gnuradio/logger.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/tpb_detail.h>
+#include "msg_edge_queue.h"
+#include <algorithm>
 #include <stdexcept>
 #include <sstream>
 #include <iostream>
@@ -55,6 +59,12 @@ namespace gr {
       d_rpc_set(false),
       d_message_subscribers(pmt::make_dict())
   {
+    d_msg_latency_on = prefs::singleton()->get_bool("PerfCounters", "msg_latency", false);
+#ifdef GR_PERFORMANCE_COUNTERS
+    d_msg_pc_on = prefs::singleton()->get_bool("PerfCounters", "on", false);
+#else
+    d_msg_pc_on = false;
+#endif /* GR_PERFORMANCE_COUNTERS */
     s_ncurrently_allocated++;
   }
 
@@ -139,11 +149,28 @@ namespace gr {
   //  - publish a message on a message port
   void basic_block::message_port_pub(pmt::pmt_t port_id, pmt::pmt_t msg)
   {
-    if(!pmt::dict_has_key(d_message_subscribers, port_id)) {
-      throw std::runtime_error("port does not exist");
+    // lock-free connections, resolved by the flowgraph
+    boost::shared_ptr<const msg_edge_queue_map_t> out = boost::atomic_load(&d_msg_edges_out);
+    msg_edge_queue_map_t::const_iterator edges;
+    if(out && (edges = out->find(port_id)) != out->end()) {
+      for(size_t i = 0; i < edges->second.size(); i++) {
+        msg_edge_queue &q = *edges->second[i];
+        q.dst->insert_tail_lockfree(q, msg);
+      }
+      return;
+    }
+
+    // The subscriber lists are immutable, so a snapshot of the list
+    // is iterated without the lock
+    pmt::pmt_t currlist;
+    {
+      gr::thread::scoped_lock guard(d_msg_subscribers_mutex);
+      if(!pmt::dict_has_key(d_message_subscribers, port_id)) {
+        throw std::runtime_error("port does not exist");
+      }
+      currlist = pmt::dict_ref(d_message_subscribers, port_id, pmt::PMT_NIL);
     }
 
-    pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers, port_id, pmt::PMT_NIL);
     // iterate through subscribers on port
     while(pmt::is_pair(currlist)) {
       pmt::pmt_t target = pmt::car(currlist);
@@ -161,6 +188,7 @@ namespace gr {
   //  - subscribe to a message port
   void
   basic_block::message_port_sub(pmt::pmt_t port_id, pmt::pmt_t target){
+    gr::thread::scoped_lock guard(d_msg_subscribers_mutex);
     if(!pmt::dict_has_key(d_message_subscribers, port_id)){
       std::stringstream ss;
       ss << "Port does not exist: \"" << pmt::write_string(port_id) << "\" on block: "
@@ -170,13 +198,17 @@ namespace gr {
     pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers,port_id,pmt::PMT_NIL);
 
     // ignore re-adds of the same target
-    if(!pmt::list_has(currlist, target))
+    if(!pmt::list_has(currlist, target)) {
       d_message_subscribers = pmt::dict_add(d_message_subscribers,port_id,pmt::list_add(currlist,target));
+      // the new subscriber has no lock-free queue, so publish through the registry
+      drop_msg_edges_out(port_id);
+    }
   }
 
   void
   basic_block::message_port_unsub(pmt::pmt_t port_id, pmt::pmt_t target)
   {
+    gr::thread::scoped_lock guard(d_msg_subscribers_mutex);
     if(!pmt::dict_has_key(d_message_subscribers, port_id)) {
       std::stringstream ss;
       ss << "Port does not exist: \"" << pmt::write_string(port_id) << "\" on block: "
@@ -187,6 +219,19 @@ namespace gr {
     // ignore unsubs of unknown targets
     pmt::pmt_t currlist = pmt::dict_ref(d_message_subscribers,port_id,pmt::PMT_NIL);
     d_message_subscribers = pmt::dict_add(d_message_subscribers,port_id,pmt::list_rm(currlist,target));
+    drop_msg_edges_out(port_id);
+  }
+
+  void
+  basic_block::drop_msg_edges_out(pmt::pmt_t port_id)
+  {
+    if(!d_msg_edges_out || d_msg_edges_out->find(port_id) == d_msg_edges_out->end())
+      return;
+
+    // publishers still holding the old map finish with it
+    boost::shared_ptr<msg_edge_queue_map_t> out(new msg_edge_queue_map_t(*d_msg_edges_out));
+    out->erase(port_id);
+    boost::atomic_store(&d_msg_edges_out, boost::shared_ptr<const msg_edge_queue_map_t>(out));
   }
 
   void
@@ -206,32 +251,245 @@ namespace gr {
     }
 
     msg_queue[which_port].push_back(msg);
+    note_msg_queue_depth(which_port, msg_queue[which_port].size());
+    if(d_msg_latency_on)
+      d_msg_times[which_port].push_back(high_res_timer_now());
     msg_queue_ready[which_port]->notify_one();
 
     // wake up thread if BLKD_IN or BLKD_OUT
     global_block_registry.notify_blk(alias());
   }
 
+  namespace {
+    //! Appends messages taken from lock-free queues and sums up how
+    //! long they were queued
+    struct msg_appender
+    {
+      std::vector<pmt::pmt_t> &msgs;
+      high_res_timer_type now;
+      high_res_timer_type &total;
+      high_res_timer_type &max;
+
+      msg_appender(std::vector<pmt::pmt_t> &msgs, high_res_timer_type now,
+                   high_res_timer_type &total, high_res_timer_type &max)
+        : msgs(msgs), now(now), total(total), max(max) {}
+
+      void operator()(const msg_edge_queue::item &it) const
+      {
+        msgs.push_back(it.msg);
+        if(now) {
+          high_res_timer_type latency = now - it.t;
+          total += latency;
+          if(latency > max)
+            max = latency;
+        }
+      }
+    };
+  }
+
+  void
+  basic_block::insert_tail_lockfree(msg_edge_queue &q, const pmt::pmt_t &msg)
+  {
+    msg_edge_queue::item it(msg, d_msg_latency_on ? high_res_timer_now() : 0);
+
+    bool was_empty;
+    if(!q.spilled.load(boost::memory_order_acquire) && q.push(it, was_empty)) {
+      // Wake the receiver only if the ring was empty - otherwise it
+      // has been woken already and it will drain the ring before it
+      // waits again. Notifying under the mutexes the receiver checks
+      // the queues with makes sure the wakeup isn't lost.
+      if(was_empty) {
+        {
+          gr::thread::scoped_lock guard(mutex);
+          q.dst_ready->notify_one();
+        }
+        if(q.dst_tpb)
+          q.dst_tpb->notify_msg_locked();
+      }
+      return;
+    }
+
+    // The ring is full: spill into the locked queue
+    {
+      gr::thread::scoped_lock guard(mutex);
+      q.spilled.store(true, boost::memory_order_release);
+      msg_queue[q.dst_port].push_back(msg);
+      note_msg_queue_depth(q.dst_port, msg_queue[q.dst_port].size() + q.size());
+      if(d_msg_latency_on)
+        d_msg_times[q.dst_port].push_back(it.t);
+      q.dst_ready->notify_one();
+    }
+    if(q.dst_tpb)
+      q.dst_tpb->notify_msg_locked();
+  }
+
+  bool
+  basic_block::pop_edge_queues(pmt::pmt_t which_port, pmt::pmt_t &msg)
+  {
+    msg_edge_queue_map_t::iterator edges = d_msg_edges_in.find(which_port);
+    if(edges == d_msg_edges_in.end())
+      return false;
+
+    msg_edge_queue::item it;
+    for(size_t i = 0; i < edges->second.size(); i++) {
+      if(edges->second[i]->pop(it)) {
+        msg = it.msg;
+        if(d_msg_latency_on) {
+          high_res_timer_type latency = high_res_timer_now() - it.t;
+          record_msg_latency(which_port, 1, latency, latency);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  pmt::pmt_t
+  basic_block::pop_msg_queue(pmt::pmt_t which_port)
+  {
+    msg_queue_t &queue = msg_queue[which_port];
+    pmt::pmt_t m = queue.front();
+    queue.pop_front();
+
+    if(d_msg_latency_on) {
+      msg_times_t &times = d_msg_times[which_port];
+      high_res_timer_type latency = high_res_timer_now() - times.front();
+      times.pop_front();
+      record_msg_latency(which_port, 1, latency, latency);
+    }
+    return m;
+  }
+
+  void
+  basic_block::clear_spilled(pmt::pmt_t which_port)
+  {
+    // Producers don't start pushing into the ring of a spilled queue;
+    // one that checked the mark just before may still push, which is
+    // fine as it has nothing in the locked queue. With the ring and
+    // the locked queue empty new messages may go to the ring again.
+    msg_edge_queue_map_t::iterator edges = d_msg_edges_in.find(which_port);
+    if(edges == d_msg_edges_in.end())
+      return;
+
+    for(size_t i = 0; i < edges->second.size(); i++) {
+      msg_edge_queue &q = *edges->second[i];
+      if(q.spilled.load(boost::memory_order_acquire) && q.empty())
+        q.spilled.store(false, boost::memory_order_release);
+    }
+  }
+
+  bool
+  basic_block::empty_p(pmt::pmt_t which_port)
+  {
+    msg_queue_map_itr q = msg_queue.find(which_port);
+    if(q == msg_queue.end())
+      throw std::runtime_error("port does not exist!");
+    if(!q->second.empty())
+      return false;
+
+    msg_edge_queue_map_t::iterator edges = d_msg_edges_in.find(which_port);
+    if(edges != d_msg_edges_in.end()) {
+      for(size_t i = 0; i < edges->second.size(); i++) {
+        if(!edges->second[i]->empty())
+          return false;
+      }
+    }
+    return true;
+  }
+
+  size_t
+  basic_block::nmsgs(pmt::pmt_t which_port)
+  {
+    msg_queue_map_itr q = msg_queue.find(which_port);
+    if(q == msg_queue.end())
+      throw std::runtime_error("port does not exist!");
+    size_t n = q->second.size();
+
+    msg_edge_queue_map_t::iterator edges = d_msg_edges_in.find(which_port);
+    if(edges != d_msg_edges_in.end()) {
+      for(size_t i = 0; i < edges->second.size(); i++) {
+        n += edges->second[i]->size();
+      }
+    }
+    return n;
+  }
+
   pmt::pmt_t
   basic_block::delete_head_nowait(pmt::pmt_t which_port)
   {
+    pmt::pmt_t m;
+    if(pop_edge_queues(which_port, m))
+      return m;
+
     gr::thread::scoped_lock guard(mutex);
 
-    if(empty_p(which_port)) {
+    // a ring may have filled up and spilled since; it is frozen now
+    if(pop_edge_queues(which_port, m))
+      return m;
+
+    if(msg_queue[which_port].empty()) {
+      clear_spilled(which_port);
       return pmt::pmt_t();
     }
 
-    pmt::pmt_t m(msg_queue[which_port].front());
-    msg_queue[which_port].pop_front();
+    return pop_msg_queue(which_port);
+  }
 
-    return m;
+  size_t
+  basic_block::delete_head_batch(pmt::pmt_t which_port, std::vector<pmt::pmt_t> &msgs)
+  {
+    size_t n = msgs.size();
+    high_res_timer_type now = d_msg_latency_on ? high_res_timer_now() : 0;
+    high_res_timer_type total = 0, max = 0;
+    msg_appender append(msgs, now, total, max);
+
+    // Older messages of a spilled connection are in its ring, so the
+    // rings go first. They are drained once more under the mutex, as
+    // a ring may have filled up and spilled in the meantime.
+    msg_edge_queue_map_t::iterator edges = d_msg_edges_in.find(which_port);
+    if(edges != d_msg_edges_in.end()) {
+      for(size_t i = 0; i < edges->second.size(); i++) {
+        edges->second[i]->consume_all(append);
+      }
+    }
+
+    gr::thread::scoped_lock guard(mutex);
+
+    if(edges != d_msg_edges_in.end()) {
+      for(size_t i = 0; i < edges->second.size(); i++) {
+        edges->second[i]->consume_all(append);
+      }
+    }
+
+    msg_queue_t &queue = msg_queue[which_port];
+    msgs.insert(msgs.end(), queue.begin(), queue.end());
+    queue.clear();
+    clear_spilled(which_port);
+
+    if(d_msg_latency_on) {
+      msg_times_t &times = d_msg_times[which_port];
+      for(size_t i = 0; i < times.size(); i++) {
+        high_res_timer_type latency = now - times[i];
+        total += latency;
+        if(latency > max)
+          max = latency;
+      }
+      times.clear();
+      if(msgs.size() > n)
+        record_msg_latency(which_port, msgs.size() - n, total, max);
+    }
+
+    return msgs.size() - n;
   }
 
   pmt::pmt_t
   basic_block::delete_head_blocking(pmt::pmt_t which_port, unsigned int millisec)
   {
+    pmt::pmt_t m;
     gr::thread::scoped_lock guard(mutex);
 
+    // Lock-free producers notify under the mutex when a ring becomes
+    // non-empty, so the rings are checked under it as well.
     if (millisec) {
        boost::system_time const timeout = boost::get_system_time() + boost::posix_time::milliseconds(millisec);
        while (empty_p(which_port)) {
@@ -245,11 +503,289 @@ namespace gr {
       }
     }
 
-    pmt::pmt_t m(msg_queue[which_port].front());
-    msg_queue[which_port].pop_front();
+    if(pop_edge_queues(which_port, m))
+      return m;
+
+    m = pop_msg_queue(which_port);
+    if(msg_queue[which_port].empty())
+      clear_spilled(which_port);
     return m;
   }
 
+  void
+  basic_block::attach_msg_edge_queue(msg_edge_queue_sptr q)
+  {
+    if(q->src == this) {
+      gr::thread::scoped_lock guard(d_msg_subscribers_mutex);
+      boost::shared_ptr<msg_edge_queue_map_t> edges(d_msg_edges_out ?
+                                                    new msg_edge_queue_map_t(*d_msg_edges_out) :
+                                                    new msg_edge_queue_map_t());
+      (*edges)[q->src_port].push_back(q);
+      boost::atomic_store(&d_msg_edges_out, boost::shared_ptr<const msg_edge_queue_map_t>(edges));
+    }
+    if(q->dst == this)
+      d_msg_edges_in[q->dst_port].push_back(q);
+  }
+
+  void
+  basic_block::detach_msg_edge_queue(msg_edge_queue_sptr q)
+  {
+    if(q->src == this) {
+      gr::thread::scoped_lock guard(d_msg_subscribers_mutex);
+      if(d_msg_edges_out) {
+        boost::shared_ptr<msg_edge_queue_map_t> out(new msg_edge_queue_map_t(*d_msg_edges_out));
+        msg_edge_queue_map_t::iterator edges = out->find(q->src_port);
+        if(edges != out->end()) {
+          edges->second.erase(std::remove(edges->second.begin(), edges->second.end(), q),
+                              edges->second.end());
+          if(edges->second.empty())
+            out->erase(edges);
+        }
+        boost::atomic_store(&d_msg_edges_out, boost::shared_ptr<const msg_edge_queue_map_t>(out));
+      }
+    }
+
+    if(q->dst == this) {
+      msg_edge_queue_map_t::iterator edges = d_msg_edges_in.find(q->dst_port);
+      if(edges == d_msg_edges_in.end())
+        return;
+      edges->second.erase(std::remove(edges->second.begin(), edges->second.end(), q),
+                          edges->second.end());
+      if(edges->second.empty())
+        d_msg_edges_in.erase(edges);
+
+      // keep the messages left in the ring - they are older than the
+      // spilled ones
+      std::vector<msg_edge_queue::item> left;
+      msg_edge_queue::item it;
+      while(q->pop(it))
+        left.push_back(it);
+
+      gr::thread::scoped_lock guard(mutex);
+      note_msg_queue_depth(q->dst_port, q->high_water());
+      msg_queue_t &queue = msg_queue[q->dst_port];
+      msg_times_t &times = d_msg_times[q->dst_port];
+      bool front = q->spilled.load();
+      for(size_t i = 0; i < left.size(); i++) {
+        if(front) {
+          queue.insert(queue.begin() + i, left[i].msg);
+          if(d_msg_latency_on)
+            times.insert(times.begin() + i, left[i].t);
+        }
+        else {
+          queue.push_back(left[i].msg);
+          if(d_msg_latency_on)
+            times.push_back(left[i].t);
+        }
+      }
+    }
+  }
+
+  void
+  basic_block::record_msg_latency(pmt::pmt_t which_port, uint64_t nmsgs,
+                                  high_res_timer_type total, high_res_timer_type max)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    msg_latency_t &l = d_msg_latency[which_port];
+    l.nmsgs += nmsgs;
+    l.total += total;
+    if(max > l.max)
+      l.max = max;
+  }
+
+  void
+  basic_block::record_msg_drop(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    d_msg_pc[which_port].drops++;
+  }
+
+  basic_block::msg_port_pc_t::msg_port_pc_t()
+    : nhandled(0), handler_total(0), handler_min(0), handler_max(0),
+      batch_max(0), drops(0)
+  {
+    std::fill(handler_hist, handler_hist + MSG_HANDLER_HIST_BINS, 0);
+  }
+
+  void
+  basic_block::dispatch_msgs(pmt::pmt_t which_port, const std::vector<pmt::pmt_t> &msgs)
+  {
+    if(msgs.empty())
+      return;
+
+    d_msg_batch_handlers_t::iterator batch_handler = d_msg_batch_handlers.find(which_port);
+    bool batch = batch_handler != d_msg_batch_handlers.end();
+
+    if(!d_msg_pc_on) {
+      if(batch) {
+        batch_handler->second(msgs);
+        return;
+      }
+      for(size_t i = 0; i < msgs.size(); i++)
+        dispatch_msg(which_port, msgs[i]);
+      return;
+    }
+
+    // Time the handler of each message, or the call of a batch
+    // handler, but take the lock only once for the batch
+    high_res_timer_type total = 0, min = 0, max = 0;
+    uint64_t hist[MSG_HANDLER_HIST_BINS] = {0};
+    high_res_timer_type tps = high_res_timer_tps();
+    size_t ncalls = batch ? 1 : msgs.size();
+    for(size_t i = 0; i < ncalls; i++) {
+      high_res_timer_type start = high_res_timer_now();
+      if(batch)
+        batch_handler->second(msgs);
+      else
+        dispatch_msg(which_port, msgs[i]);
+      high_res_timer_type t = high_res_timer_now() - start;
+
+      total += t;
+      if(i == 0 || t < min)
+        min = t;
+      if(t > max)
+        max = t;
+
+      uint64_t us = static_cast<uint64_t>(t) * 1000000 / tps;
+      int bin = 0;
+      while(us && bin < MSG_HANDLER_HIST_BINS - 1) {
+        us >>= 1;
+        bin++;
+      }
+      hist[bin]++;
+    }
+
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    msg_port_pc_t &pc = d_msg_pc[which_port];
+    if(pc.nhandled == 0 || min < pc.handler_min)
+      pc.handler_min = min;
+    if(max > pc.handler_max)
+      pc.handler_max = max;
+    pc.nhandled += msgs.size();
+    pc.handler_total += total;
+    for(int i = 0; i < MSG_HANDLER_HIST_BINS; i++)
+      pc.handler_hist[i] += hist[i];
+    if(msgs.size() > pc.batch_max)
+      pc.batch_max = msgs.size();
+  }
+
+  double
+  basic_block::pc_msg_latency(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    const msg_latency_t &l = d_msg_latency[which_port];
+    if(l.nmsgs == 0)
+      return 0;
+    return 1e6 * l.total / l.nmsgs / high_res_timer_tps();
+  }
+
+  double
+  basic_block::pc_msg_latency_max(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    return 1e6 * d_msg_latency[which_port].max / high_res_timer_tps();
+  }
+
+  uint64_t
+  basic_block::pc_msg_latency_nmsgs(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    return d_msg_latency[which_port].nmsgs;
+  }
+
+  void
+  basic_block::reset_msg_latency()
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    d_msg_latency.clear();
+  }
+
+  uint64_t
+  basic_block::pc_msg_nhandled(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    return d_msg_pc[which_port].nhandled;
+  }
+
+  double
+  basic_block::pc_msg_handler_time(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    const msg_port_pc_t &pc = d_msg_pc[which_port];
+    if(pc.nhandled == 0)
+      return 0;
+    return 1e6 * pc.handler_total / pc.nhandled / high_res_timer_tps();
+  }
+
+  double
+  basic_block::pc_msg_handler_time_min(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    return 1e6 * d_msg_pc[which_port].handler_min / high_res_timer_tps();
+  }
+
+  double
+  basic_block::pc_msg_handler_time_max(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    return 1e6 * d_msg_pc[which_port].handler_max / high_res_timer_tps();
+  }
+
+  std::vector<uint64_t>
+  basic_block::pc_msg_handler_time_hist(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    const msg_port_pc_t &pc = d_msg_pc[which_port];
+    return std::vector<uint64_t>(pc.handler_hist, pc.handler_hist + MSG_HANDLER_HIST_BINS);
+  }
+
+  uint64_t
+  basic_block::pc_msg_batch_size_max(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    return d_msg_pc[which_port].batch_max;
+  }
+
+  uint64_t
+  basic_block::pc_msg_queue_high_water(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(mutex);
+    size_t high_water = d_msg_queue_high_water[which_port];
+
+    msg_edge_queue_map_t::iterator edges = d_msg_edges_in.find(which_port);
+    if(edges != d_msg_edges_in.end()) {
+      for(size_t i = 0; i < edges->second.size(); i++) {
+        high_water = std::max(high_water, edges->second[i]->high_water());
+      }
+    }
+    return high_water;
+  }
+
+  uint64_t
+  basic_block::pc_msg_drops(pmt::pmt_t which_port)
+  {
+    gr::thread::scoped_lock guard(d_msg_pc_mutex);
+    return d_msg_pc[which_port].drops;
+  }
+
+  void
+  basic_block::reset_msg_pc()
+  {
+    {
+      gr::thread::scoped_lock guard(d_msg_pc_mutex);
+      d_msg_pc.clear();
+    }
+
+    gr::thread::scoped_lock guard(mutex);
+    d_msg_queue_high_water.clear();
+    for(msg_edge_queue_map_t::iterator edges = d_msg_edges_in.begin();
+        edges != d_msg_edges_in.end(); edges++) {
+      for(size_t i = 0; i < edges->second.size(); i++) {
+        edges->second[i]->reset_high_water();
+      }
+    }
+  }
+
   pmt::pmt_t
   basic_block::message_subscribers(pmt::pmt_t port)
   {
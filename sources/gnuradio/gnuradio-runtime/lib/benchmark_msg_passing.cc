@@ -0,0 +1,165 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Messages per second through a chain of message-only blocks, with
+ * the default locked queues and with lock-free msg queues.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/top_block.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MESSAGES 2000000
+#define RELAYS 4
+
+namespace {
+
+  // Publishes MESSAGES messages when poked on "go"
+  class msg_source : public gr::block
+  {
+  public:
+    msg_source()
+      : gr::block("msg_source",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0))
+    {
+      message_port_register_in(pmt::mp("go"));
+      set_msg_handler(pmt::mp("go"), boost::bind(&msg_source::go, this, _1));
+      message_port_register_out(pmt::mp("out"));
+    }
+
+    void go(pmt::pmt_t)
+    {
+      pmt::pmt_t out = pmt::mp("out");
+      pmt::pmt_t payload = pmt::make_u8vector(148, 0);
+      for(long i = 0; i < MESSAGES; i++) {
+        message_port_pub(out, pmt::cons(pmt::PMT_NIL, payload));
+      }
+    }
+  };
+
+  class msg_relay : public gr::block
+  {
+  public:
+    msg_relay()
+      : gr::block("msg_relay",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_out(pmt::mp("out"))
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&msg_relay::relay, this, _1));
+      message_port_register_out(d_out);
+    }
+
+    void relay(pmt::pmt_t msg)
+    {
+      message_port_pub(d_out, msg);
+    }
+
+  private:
+    pmt::pmt_t d_out;
+  };
+
+  class msg_counter : public gr::block
+  {
+  public:
+    msg_counter()
+      : gr::block("msg_counter",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_count(0)
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&msg_counter::count, this, _1));
+    }
+
+    void count(pmt::pmt_t)
+    {
+      gr::thread::scoped_lock guard(d_mutex);
+      if(++d_count == MESSAGES)
+        d_done.notify_all();
+    }
+
+    void wait_all()
+    {
+      gr::thread::scoped_lock guard(d_mutex);
+      while(d_count < MESSAGES)
+        d_done.wait(guard);
+    }
+
+  private:
+    gr::thread::mutex d_mutex;
+    gr::thread::condition_variable d_done;
+    long d_count;
+  };
+
+}
+
+static void
+benchmark(bool lockfree, const char *implementation_name)
+{
+  gr::top_block_sptr tb = gr::make_top_block("benchmark_msg_passing");
+  boost::shared_ptr<msg_source> src = gnuradio::get_initial_sptr(new msg_source());
+  boost::shared_ptr<msg_counter> dst = gnuradio::get_initial_sptr(new msg_counter());
+
+  gr::basic_block_sptr prev = src;
+  for(int i = 0; i < RELAYS; i++) {
+    gr::basic_block_sptr relay = gnuradio::get_initial_sptr(new msg_relay());
+    tb->msg_connect(prev, "out", relay, "in");
+    prev = relay;
+  }
+  tb->msg_connect(prev, "out", dst, "in");
+
+  tb->set_lockfree_msg_queues(lockfree);
+  tb->start();
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  src->_post(pmt::mp("go"), pmt::PMT_T);
+  dst->wait_all();
+  boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+
+  tb->stop();
+  tb->wait();
+
+  double total = (stop - start).total_microseconds() * 1e-6;
+  printf("%18s:  time: %6.3f  msgs/sec: %10.3e  hops/sec: %10.3e\n",
+         implementation_name, total, MESSAGES / total, MESSAGES * (RELAYS + 1) / total);
+}
+
+int
+main(int argc, char **argv)
+{
+  benchmark(false, "locked queues");
+  benchmark(true, "lock-free queues");
+  return 0;
+}
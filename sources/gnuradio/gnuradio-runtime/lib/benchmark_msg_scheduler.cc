@@ -0,0 +1,254 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Message latency of a chain of message-only blocks fed at a steady
+ * pace - a source publishing a burst of messages every frame, a
+ * demultiplexer, a decoder combining four messages into one and
+ * counters - with the thread-per-block scheduler and with the worker
+ * pool of the TPB_MSG scheduler.
+ *
+ * Usage: benchmark_msg_scheduler [TPB|TPB_MSG] [frames]
+ *
+ * Eight messages, one per timeslot, are published every FRAME_USEC.
+ * Those of the first two timeslots go to the decoder, the rest to a
+ * counter. For each input port the average and maximum time messages
+ * were queued is printed, with the CPU time of the whole process,
+ * which includes idle wakeups of the blocks.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/top_block.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+#define FRAMES 2000
+#define FRAME_USEC 4615
+#define TIMESLOTS 8
+#define PAYLOAD 148
+
+namespace {
+
+  // Publishes the messages of a frame every FRAME_USEC from its own
+  // thread, then tells the flowgraph it is done
+  class paced_source : public gr::block
+  {
+  public:
+    paced_source(unsigned int frames)
+      : gr::block("paced_source",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_frames(frames)
+    {
+      message_port_register_out(pmt::mp("out"));
+    }
+
+    bool start()
+    {
+      d_thread = boost::shared_ptr<gr::thread::thread>
+        (new gr::thread::thread(boost::bind(&paced_source::run, this)));
+      return block::start();
+    }
+
+    bool stop()
+    {
+      d_thread->interrupt();
+      d_thread->join();
+      return block::stop();
+    }
+
+  private:
+    unsigned int d_frames;
+    boost::shared_ptr<gr::thread::thread> d_thread;
+
+    void run()
+    {
+      pmt::pmt_t out = pmt::mp("out");
+      for(unsigned int fn = 0; fn < d_frames; fn++) {
+        for(long tn = 0; tn < TIMESLOTS; tn++) {
+          std::vector<uint8_t> bits(PAYLOAD);
+          for(size_t i = 0; i < bits.size(); i++)
+            bits[i] = rand() & 1;
+          message_port_pub(out, pmt::cons(pmt::from_long(tn), pmt::init_u8vector(bits.size(), bits)));
+        }
+        boost::this_thread::sleep(boost::posix_time::microseconds(FRAME_USEC));
+      }
+      post(pmt::mp("system"), pmt::cons(pmt::mp("done"), pmt::from_long(1)));
+    }
+  };
+
+  // Sends messages of the first two timeslots to "ctrl", the rest to
+  // "traffic"
+  class msg_demux : public gr::block
+  {
+  public:
+    msg_demux()
+      : gr::block("msg_demux",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_ctrl(pmt::mp("ctrl")), d_traffic(pmt::mp("traffic"))
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&msg_demux::demux, this, _1));
+      message_port_register_out(d_ctrl);
+      message_port_register_out(d_traffic);
+    }
+
+    void demux(pmt::pmt_t msg)
+    {
+      message_port_pub(pmt::to_long(pmt::car(msg)) < 2 ? d_ctrl : d_traffic, msg);
+    }
+
+  private:
+    pmt::pmt_t d_ctrl;
+    pmt::pmt_t d_traffic;
+  };
+
+  // Combines every four messages into one, like a block decoder
+  // collecting the bursts of a code word
+  class msg_decoder : public gr::block
+  {
+  public:
+    msg_decoder()
+      : gr::block("msg_decoder",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_out(pmt::mp("out")), d_n(0), d_acc(0)
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&msg_decoder::decode, this, _1));
+      message_port_register_out(d_out);
+    }
+
+    void decode(pmt::pmt_t msg)
+    {
+      size_t len;
+      const uint8_t *bits = pmt::u8vector_elements(pmt::cdr(msg), len);
+      for(size_t i = 0; i < len; i++)
+        d_acc = d_acc * 31 + bits[i];
+      if(++d_n % 4 == 0)
+        message_port_pub(d_out, pmt::from_uint64(d_acc));
+    }
+
+  private:
+    pmt::pmt_t d_out;
+    long d_n;
+    uint64_t d_acc;
+  };
+
+  class msg_counter : public gr::block
+  {
+  public:
+    msg_counter()
+      : gr::block("msg_counter",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_count(0)
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&msg_counter::count, this, _1));
+    }
+
+    void count(pmt::pmt_t)
+    {
+      d_count++;
+    }
+
+    long count() const { return d_count; }
+
+  private:
+    long d_count;
+  };
+
+}
+
+// User and system time used by all threads of the process, in seconds
+static double
+cpu_time()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6
+    + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#else
+  return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+static void
+print_latency(const char *name, gr::basic_block_sptr block, const char *port)
+{
+  pmt::pmt_t p = pmt::mp(port);
+  printf("%20s:  msgs: %8lu  avg: %8.1f us  max: %8.1f us\n", name,
+         (unsigned long)block->pc_msg_latency_nmsgs(p),
+         block->pc_msg_latency(p), block->pc_msg_latency_max(p));
+}
+
+int
+main(int argc, char **argv)
+{
+  const char *scheduler = (argc > 1) ? argv[1] : "TPB_MSG";
+  unsigned int frames = (argc > 2) ? atoi(argv[2]) : FRAMES;
+
+  // both have to be set before the first flowgraph and the first block are made
+  setenv("GR_SCHEDULER", scheduler, 1);
+  gr::prefs::singleton()->set_bool("PerfCounters", "msg_latency", true);
+
+  gr::top_block_sptr tb = gr::make_top_block("benchmark_msg_scheduler");
+  gr::block_sptr src = gnuradio::get_initial_sptr(new paced_source(frames));
+  gr::block_sptr demux = gnuradio::get_initial_sptr(new msg_demux());
+  gr::block_sptr decoder = gnuradio::get_initial_sptr(new msg_decoder());
+  boost::shared_ptr<msg_counter> ctrl = gnuradio::get_initial_sptr(new msg_counter());
+  boost::shared_ptr<msg_counter> traffic = gnuradio::get_initial_sptr(new msg_counter());
+
+  tb->msg_connect(src, "out", demux, "in");
+  tb->msg_connect(demux, "ctrl", decoder, "in");
+  tb->msg_connect(decoder, "out", ctrl, "in");
+  tb->msg_connect(demux, "traffic", traffic, "in");
+
+  double start = cpu_time();
+  tb->run();
+  double total = cpu_time() - start;
+
+  printf("scheduler %s, %u frames\n", scheduler, frames);
+  print_latency("demux in", demux, "in");
+  print_latency("decoder in", decoder, "in");
+  print_latency("ctrl counter in", ctrl, "in");
+  print_latency("traffic counter in", traffic, "in");
+  printf("%20s:  %6.3f s  (%ld decoded and %ld traffic messages)\n", "cpu",
+         total, ctrl->count(), traffic->count());
+  return 0;
+}
@@ -0,0 +1,169 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tags per second through a chain of pass-through blocks, as in the
+ * flowgraphs of qa_block_tags: a source tags its items alternately
+ * with rx_time and rx_freq, the tags are propagated by the default
+ * all-to-all policy, and the sink queries the tags of one key in every
+ * call to work, like blocks looking for a frequency change.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/top_block.h>
+#include <gnuradio/sync_block.h>
+#include <gnuradio/io_signature.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+#define ITEMS 20000000
+#define RELAYS 4
+
+namespace {
+
+  // ITEMS items, every spacing-th of them tagged
+  class tag_source : public gr::sync_block
+  {
+  public:
+    tag_source(unsigned int spacing)
+      : gr::sync_block("tag_source",
+                       gr::io_signature::make(0, 0, 0),
+                       gr::io_signature::make(1, 1, sizeof(float))),
+        d_spacing(spacing),
+        d_time_key(pmt::mp("rx_time")), d_freq_key(pmt::mp("rx_freq")),
+        d_value(pmt::from_double(0))
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items)
+    {
+      uint64_t start = nitems_written(0);
+      if(start >= ITEMS)
+        return WORK_DONE;
+      noutput_items = std::min<uint64_t>(noutput_items, ITEMS - start);
+
+      memset(output_items[0], 0, noutput_items * sizeof(float));
+      uint64_t first = (start + d_spacing - 1) / d_spacing * d_spacing;
+      for(uint64_t offset = first; offset < start + noutput_items; offset += d_spacing) {
+        const pmt::pmt_t &key = (offset / d_spacing) & 1 ? d_freq_key : d_time_key;
+        add_item_tag(0, offset, key, d_value);
+      }
+      return noutput_items;
+    }
+
+  private:
+    uint64_t d_spacing;
+    pmt::pmt_t d_time_key;
+    pmt::pmt_t d_freq_key;
+    pmt::pmt_t d_value;
+  };
+
+  class tag_relay : public gr::sync_block
+  {
+  public:
+    tag_relay()
+      : gr::sync_block("tag_relay",
+                       gr::io_signature::make(1, 1, sizeof(float)),
+                       gr::io_signature::make(1, 1, sizeof(float)))
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items)
+    {
+      memcpy(output_items[0], input_items[0], noutput_items * sizeof(float));
+      return noutput_items;
+    }
+  };
+
+  class tag_sink : public gr::sync_block
+  {
+  public:
+    tag_sink()
+      : gr::sync_block("tag_sink",
+                       gr::io_signature::make(1, 1, sizeof(float)),
+                       gr::io_signature::make(0, 0, 0)),
+        d_key(pmt::mp("rx_freq")), d_count(0)
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items)
+    {
+      uint64_t start = nitems_read(0);
+      get_tags_in_range(d_tags, 0, start, start + noutput_items, d_key);
+      d_count += d_tags.size();
+      return noutput_items;
+    }
+
+    long count() const { return d_count; }
+
+  private:
+    pmt::pmt_t d_key;
+    std::vector<gr::tag_t> d_tags;
+    long d_count;
+  };
+
+}
+
+static void
+benchmark(unsigned int spacing)
+{
+  gr::top_block_sptr tb = gr::make_top_block("benchmark_tag_propagation");
+  boost::shared_ptr<tag_source> src = gnuradio::get_initial_sptr(new tag_source(spacing));
+  boost::shared_ptr<tag_sink> dst = gnuradio::get_initial_sptr(new tag_sink());
+
+  gr::basic_block_sptr prev = src;
+  for(int i = 0; i < RELAYS; i++) {
+    gr::basic_block_sptr relay = gnuradio::get_initial_sptr(new tag_relay());
+    tb->connect(prev, 0, relay, 0);
+    prev = relay;
+  }
+  tb->connect(prev, 0, dst, 0);
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  tb->run();
+  boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+
+  double total = (stop - start).total_microseconds() * 1e-6;
+  double tags = (double) ITEMS / spacing;
+  printf("tag every %4u items:  time: %6.3f  tags/sec: %10.3e  hops/sec: %10.3e  (%ld rx_freq)\n",
+         spacing, total, tags / total, tags * (RELAYS + 1) / total, dst->count());
+}
+
+int
+main(int argc, char **argv)
+{
+  static const unsigned int spacings[] = {1, 8, 64, 1024};
+  for(unsigned int i = 0; i < sizeof(spacings) / sizeof(spacings[0]); i++)
+    benchmark(spacings[i]);
+  return 0;
+}
@@ -0,0 +1,198 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Items per second of complex samples through a chain of copying
+ * blocks, with the buffers of each working vmcircbuf factory and with
+ * huge page buffers.
+ *
+ * Usage: benchmark_vmcircbuf [buffer size in bytes] [cpu,cpu,...]
+ *
+ * With a list of cpus, the blocks of the chain are bound to them in
+ * turn and their buffers are placed on the NUMA nodes of those cpus.
+ * Huge page buffers need huge pages, e.g. sysctl vm.nr_hugepages=64.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vmcircbuf.h"
+#include "vmcircbuf_memfd_hugetlb.h"
+#include <gnuradio/top_block.h>
+#include <gnuradio/sync_block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/gr_complex.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ITEMS 200000000
+#define RELAYS 6
+#define BUFFER_SIZE (4 * (1L << 20))
+
+namespace {
+
+  class sample_source : public gr::sync_block
+  {
+  public:
+    sample_source()
+      : gr::sync_block("sample_source",
+                       gr::io_signature::make(0, 0, 0),
+                       gr::io_signature::make(1, 1, sizeof(gr_complex)))
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items)
+    {
+      uint64_t start = nitems_written(0);
+      if(start >= ITEMS)
+        return WORK_DONE;
+      noutput_items = std::min<uint64_t>(noutput_items, ITEMS - start);
+      memset(output_items[0], 0, noutput_items * sizeof(gr_complex));
+      return noutput_items;
+    }
+  };
+
+  class sample_relay : public gr::sync_block
+  {
+  public:
+    sample_relay()
+      : gr::sync_block("sample_relay",
+                       gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                       gr::io_signature::make(1, 1, sizeof(gr_complex)))
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items)
+    {
+      memcpy(output_items[0], input_items[0], noutput_items * sizeof(gr_complex));
+      return noutput_items;
+    }
+  };
+
+  class sample_sink : public gr::sync_block
+  {
+  public:
+    sample_sink()
+      : gr::sync_block("sample_sink",
+                       gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                       gr::io_signature::make(0, 0, 0)),
+        d_sum(0)
+    {
+    }
+
+    int work(int noutput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items)
+    {
+      // read every cache line, as a consumer would
+      const char *in = (const char *) input_items[0];
+      for(size_t i = 0; i < noutput_items * sizeof(gr_complex); i += 64)
+        d_sum += in[i];
+      return noutput_items;
+    }
+
+  private:
+    long d_sum;
+  };
+
+}
+
+static std::vector<int>
+parse_cpus(const char *list)
+{
+  std::vector<int> cpus;
+  while(list && *list) {
+    cpus.push_back(atoi(list));
+    list = strchr(list, ',');
+    if(list)
+      list++;
+  }
+  return cpus;
+}
+
+static void
+benchmark(const std::vector<int> &cpus, const char *implementation_name)
+{
+  gr::top_block_sptr tb = gr::make_top_block("benchmark_vmcircbuf");
+  std::vector<gr::block_sptr> blocks;
+
+  blocks.push_back(gnuradio::get_initial_sptr(new sample_source()));
+  for(int i = 0; i < RELAYS; i++)
+    blocks.push_back(gnuradio::get_initial_sptr(new sample_relay()));
+  blocks.push_back(gnuradio::get_initial_sptr(new sample_sink()));
+
+  for(size_t i = 0; i < blocks.size(); i++) {
+    if(!cpus.empty())
+      blocks[i]->set_processor_affinity(std::vector<int>(1, cpus[i % cpus.size()]));
+    if(i > 0)
+      tb->connect(blocks[i - 1], 0, blocks[i], 0);
+  }
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  tb->run();
+  boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+
+  double total = (stop - start).total_microseconds() * 1e-6;
+  printf("%40s:  time: %6.3f  items/sec: %10.3e  MB/sec per edge: %8.1f\n",
+         implementation_name, total, ITEMS / total,
+         ITEMS * sizeof(gr_complex) / total / (1 << 20));
+}
+
+int
+main(int argc, char **argv)
+{
+  long buffer_size = (argc > 1) ? atol(argv[1]) : BUFFER_SIZE;
+  std::vector<int> cpus = parse_cpus((argc > 2) ? argv[2] : 0);
+  gr::prefs *prefs = gr::prefs::singleton();
+
+  prefs->set_long("DEFAULT", "buffer_size", buffer_size);
+  printf("buffer size: %ld bytes, %s\n", buffer_size,
+         cpus.empty() ? "no affinity" : "blocks bound to the given cpus");
+
+  // set_default_factory() saves the choice, so it is restored at the end
+  gr::vmcircbuf_factory *default_factory = gr::vmcircbuf_sysconfig::get_default_factory();
+  std::vector<gr::vmcircbuf_factory *> all = gr::vmcircbuf_sysconfig::all_factories();
+
+  prefs->set_bool("DEFAULT", "hugepage_buffers", false);
+  for(size_t i = 0; i < all.size(); i++) {
+    if(!gr::vmcircbuf_sysconfig::test_factory(all[i], 0))
+      continue;
+    gr::vmcircbuf_sysconfig::set_default_factory(all[i]);
+    benchmark(cpus, all[i]->name());
+  }
+  gr::vmcircbuf_sysconfig::set_default_factory(default_factory);
+
+  prefs->set_bool("DEFAULT", "hugepage_buffers", true);
+  benchmark(cpus, gr::vmcircbuf_memfd_hugetlb_factory::singleton()->name());
+
+  return 0;
+}
@@ -692,12 +692,102 @@ namespace gr {
     }
   }
 
+  std::vector<float>
+  block::pc_msg_nhandled()
+  {
+    std::vector<float> pc;
+    pmt::pmt_t ports = message_ports_in();
+    for(size_t i = 0; i < pmt::length(ports); i++) {
+      pc.push_back(pc_msg_nhandled(pmt::vector_ref(ports, i)));
+    }
+    return pc;
+  }
+
+  std::vector<float>
+  block::pc_msg_handler_time_avg()
+  {
+    std::vector<float> pc;
+    pmt::pmt_t ports = message_ports_in();
+    for(size_t i = 0; i < pmt::length(ports); i++) {
+      pc.push_back(pc_msg_handler_time(pmt::vector_ref(ports, i)));
+    }
+    return pc;
+  }
+
+  std::vector<float>
+  block::pc_msg_handler_time_min()
+  {
+    std::vector<float> pc;
+    pmt::pmt_t ports = message_ports_in();
+    for(size_t i = 0; i < pmt::length(ports); i++) {
+      pc.push_back(pc_msg_handler_time_min(pmt::vector_ref(ports, i)));
+    }
+    return pc;
+  }
+
+  std::vector<float>
+  block::pc_msg_handler_time_max()
+  {
+    std::vector<float> pc;
+    pmt::pmt_t ports = message_ports_in();
+    for(size_t i = 0; i < pmt::length(ports); i++) {
+      pc.push_back(pc_msg_handler_time_max(pmt::vector_ref(ports, i)));
+    }
+    return pc;
+  }
+
+  std::vector<float>
+  block::pc_msg_handler_time_hist()
+  {
+    std::vector<float> pc;
+    pmt::pmt_t ports = message_ports_in();
+    for(size_t i = 0; i < pmt::length(ports); i++) {
+      std::vector<uint64_t> hist = pc_msg_handler_time_hist(pmt::vector_ref(ports, i));
+      pc.insert(pc.end(), hist.begin(), hist.end());
+    }
+    return pc;
+  }
+
+  std::vector<float>
+  block::pc_msg_batch_size_max()
+  {
+    std::vector<float> pc;
+    pmt::pmt_t ports = message_ports_in();
+    for(size_t i = 0; i < pmt::length(ports); i++) {
+      pc.push_back(pc_msg_batch_size_max(pmt::vector_ref(ports, i)));
+    }
+    return pc;
+  }
+
+  std::vector<float>
+  block::pc_msg_queue_high_water()
+  {
+    std::vector<float> pc;
+    pmt::pmt_t ports = message_ports_in();
+    for(size_t i = 0; i < pmt::length(ports); i++) {
+      pc.push_back(pc_msg_queue_high_water(pmt::vector_ref(ports, i)));
+    }
+    return pc;
+  }
+
+  std::vector<float>
+  block::pc_msg_drops()
+  {
+    std::vector<float> pc;
+    pmt::pmt_t ports = message_ports_in();
+    for(size_t i = 0; i < pmt::length(ports); i++) {
+      pc.push_back(pc_msg_drops(pmt::vector_ref(ports, i)));
+    }
+    return pc;
+  }
+
   void
   block::reset_perf_counters()
   {
     if(d_detail) {
       d_detail->reset_perf_counters();
     }
+    reset_msg_pc();
   }
 
 
@@ -887,6 +977,62 @@ namespace gr {
         pmt::make_f32vector(0,0), pmt::make_f32vector(0,1), pmt::make_f32vector(0,0),
         "", "Var. of how full output buffers are", RPC_PRIVLVL_MIN,
         DISPTIME | DISPOPTSTRIP)));
+
+    d_rpc_vars.push_back(
+      rpcbasic_sptr(new rpcbasic_register_get<block, std::vector<float> >(
+        alias(), "msgs handled", &block::pc_msg_nhandled,
+        pmt::make_f32vector(0,0), pmt::make_f32vector(0,1e9), pmt::make_f32vector(0,0),
+        "", "Messages handled of each input message port", RPC_PRIVLVL_MIN,
+        DISPTIME | DISPOPTSTRIP)));
+
+    d_rpc_vars.push_back(
+      rpcbasic_sptr(new rpcbasic_register_get<block, std::vector<float> >(
+        alias(), "avg msg handler time", &block::pc_msg_handler_time_avg,
+        pmt::make_f32vector(0,0), pmt::make_f32vector(0,1e6), pmt::make_f32vector(0,0),
+        "us", "Average time of the message handler of each input message port", RPC_PRIVLVL_MIN,
+        DISPTIME | DISPOPTSTRIP)));
+
+    d_rpc_vars.push_back(
+      rpcbasic_sptr(new rpcbasic_register_get<block, std::vector<float> >(
+        alias(), "min msg handler time", &block::pc_msg_handler_time_min,
+        pmt::make_f32vector(0,0), pmt::make_f32vector(0,1e6), pmt::make_f32vector(0,0),
+        "us", "Minimum time of the message handler of each input message port", RPC_PRIVLVL_MIN,
+        DISPTIME | DISPOPTSTRIP)));
+
+    d_rpc_vars.push_back(
+      rpcbasic_sptr(new rpcbasic_register_get<block, std::vector<float> >(
+        alias(), "max msg handler time", &block::pc_msg_handler_time_max,
+        pmt::make_f32vector(0,0), pmt::make_f32vector(0,1e6), pmt::make_f32vector(0,0),
+        "us", "Maximum time of the message handler of each input message port", RPC_PRIVLVL_MIN,
+        DISPTIME | DISPOPTSTRIP)));
+
+    d_rpc_vars.push_back(
+      rpcbasic_sptr(new rpcbasic_register_get<block, std::vector<float> >(
+        alias(), "msg handler time hist", &block::pc_msg_handler_time_hist,
+        pmt::make_f32vector(0,0), pmt::make_f32vector(0,1e9), pmt::make_f32vector(0,0),
+        "", "Histogram of message handler times, in power of 2 us bins, of each input message port",
+        RPC_PRIVLVL_MIN, DISPTIME | DISPOPTSTRIP)));
+
+    d_rpc_vars.push_back(
+      rpcbasic_sptr(new rpcbasic_register_get<block, std::vector<float> >(
+        alias(), "msg batch size max", &block::pc_msg_batch_size_max,
+        pmt::make_f32vector(0,0), pmt::make_f32vector(0,1e6), pmt::make_f32vector(0,0),
+        "", "Largest batch of messages taken at once from each input message port", RPC_PRIVLVL_MIN,
+        DISPTIME | DISPOPTSTRIP)));
+
+    d_rpc_vars.push_back(
+      rpcbasic_sptr(new rpcbasic_register_get<block, std::vector<float> >(
+        alias(), "msg queue high water", &block::pc_msg_queue_high_water,
+        pmt::make_f32vector(0,0), pmt::make_f32vector(0,1e6), pmt::make_f32vector(0,0),
+        "", "Most messages queued at once on each input message port", RPC_PRIVLVL_MIN,
+        DISPTIME | DISPOPTSTRIP)));
+
+    d_rpc_vars.push_back(
+      rpcbasic_sptr(new rpcbasic_register_get<block, std::vector<float> >(
+        alias(), "msgs dropped", &block::pc_msg_drops,
+        pmt::make_f32vector(0,0), pmt::make_f32vector(0,1e9), pmt::make_f32vector(0,0),
+        "", "Messages dropped from each input message port", RPC_PRIVLVL_MIN,
+        DISPTIME | DISPOPTSTRIP)));
 #endif /* defined(GR_CTRLPORT) && defined(GR_PERFORMANCE_COUNTERS) */
   }
 
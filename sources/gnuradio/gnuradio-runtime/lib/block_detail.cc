@@ -204,22 +204,8 @@ namespace gr {
                                   const pmt::pmt_t &key,
 				  long id)
   {
-    std::vector<tag_t> found_items;
-
-    v.resize(0);
-
-    // get from gr_buffer_reader's deque of tags
-    d_input[which_input]->get_tags_in_range(found_items, abs_start, abs_end, id);
-
-    // Filter further by key name
-    pmt::pmt_t itemkey;
-    std::vector<tag_t>::iterator itr;
-    for(itr = found_items.begin(); itr != found_items.end(); itr++) {
-      itemkey = (*itr).key;
-      if(pmt::eqv(key, itemkey)) {
-        v.push_back(*itr);
-      }
-    }
+    // get from gr_buffer_reader's deque of tags, filtered by key name
+    d_input[which_input]->get_tags_in_range(v, abs_start, abs_end, key, id);
   }
 
   void
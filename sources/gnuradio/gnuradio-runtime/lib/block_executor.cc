@@ -110,22 +110,16 @@ namespace gr {
       for(int i = 0; i < d->ninputs(); i++) {
         d->get_tags_in_range(rtags, i, start_nitems_read[i],
                              d->nitems_read(i), block_id);
+        if(rtags.empty())
+          continue;
 
-        std::vector<tag_t>::iterator t;
-        if(rrate == 1.0) {
-          for(t = rtags.begin(); t != rtags.end(); t++) {
-            for(int o = 0; o < d->noutputs(); o++)
-              d->output(o)->add_item_tag(*t);
-          }
-        }
-        else {
-          for(t = rtags.begin(); t != rtags.end(); t++) {
-            tag_t new_tag = *t;
-            new_tag.offset = ((double)new_tag.offset * rrate) + 0.5;
-            for(int o = 0; o < d->noutputs(); o++)
-              d->output(o)->add_item_tag(new_tag);
-          }
+        if(rrate != 1.0) {
+          std::vector<tag_t>::iterator t;
+          for(t = rtags.begin(); t != rtags.end(); t++)
+            t->offset = ((double)t->offset * rrate) + 0.5;
         }
+        for(int o = 0; o < d->noutputs(); o++)
+          d->output(o)->add_item_tags(rtags);
       }
       break;
     case block::TPP_ONE_TO_ONE:
@@ -136,13 +130,13 @@ namespace gr {
         for(int i = 0; i < d->ninputs(); i++) {
           d->get_tags_in_range(rtags, i, start_nitems_read[i],
                                d->nitems_read(i), block_id);
+          if(rtags.empty())
+            continue;
 
           std::vector<tag_t>::iterator t;
-          for(t = rtags.begin(); t != rtags.end(); t++) {
-            tag_t new_tag = *t;
-            new_tag.offset = ((double)new_tag.offset * rrate) + 0.5;
-            d->output(i)->add_item_tag(new_tag);
-          }
+          for(t = rtags.begin(); t != rtags.end(); t++)
+            t->offset = ((double)t->offset * rrate) + 0.5;
+          d->output(i)->add_item_tags(rtags);
         }
       }
       else  {
@@ -25,13 +25,19 @@
 #endif
 #include <algorithm>
 #include <gnuradio/buffer.h>
+#include <gnuradio/block.h>
 #include <gnuradio/math.h>
+#include <gnuradio/prefs.h>
 #include "vmcircbuf.h"
+#include "vmcircbuf_memfd_hugetlb.h"
+#include "pagesize.h"
 #include <stdexcept>
 #include <iostream>
 #include <assert.h>
 #include <algorithm>
 #include <boost/math/common_factor_rt.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/format.hpp>
 
 namespace gr {
 
@@ -65,6 +71,21 @@ namespace gr {
    gr::buffer_reader goes to zero, we can successfully reclaim it.
    ---------------------------------------------------------------------------- */
 
+  // initial capacity of the tag store of a buffer, in tags
+  static const size_t TAG_STORE_CAPACITY = 64;
+
+  static bool
+  tag_offset_less(const tag_t &t, uint64_t offset)
+  {
+    return t.offset < offset;
+  }
+
+  static bool
+  offset_tag_less(uint64_t offset, const tag_t &t)
+  {
+    return offset < t.offset;
+  }
+
   /*
    * Compute the minimum number of buffer items that work (i.e.,
    * address space wrap-around works).  To work is to satisfy this
@@ -78,12 +99,50 @@ namespace gr {
     return page_size / boost::math::gcd (type_size, page_size);
   }
 
+  /*
+   * Huge page buffers are enabled by [DEFAULT] hugepage_buffers and
+   * used when rounding the buffer up to a multiple of the huge page
+   * size at most doubles it. With an item size that is not a power of
+   * two the rounding can be far more than one huge page. They are
+   * given up after the first failure, e.g. when no huge pages are
+   * reserved.
+   */
+  static bool s_hugepages_failed = false;
+
+  static bool
+  use_hugepages(int nitems, size_t sizeof_item)
+  {
+    static const long hugepage = gr::hugepagesize();
+    if(hugepage <= 0 || s_hugepages_failed ||
+       !gr::prefs::singleton()->get_bool("DEFAULT", "hugepage_buffers", false))
+      return false;
+
+    long min_nitems = minimum_buffer_items(sizeof_item, hugepage);
+    long rounded = (nitems + min_nitems - 1) / min_nitems * min_nitems;
+    return rounded <= 2 * (long)nitems;
+  }
+
+  // NUMA node of a cpu, -1 if unknown
+  static int
+  numa_node_of_cpu(int cpu)
+  {
+    namespace fs = boost::filesystem;
+    boost::system::error_code ec;
+    fs::path path(str(boost::format("/sys/devices/system/cpu/cpu%d") % cpu));
+    for(fs::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+      std::string name = it->path().filename().string();
+      if(name.compare(0, 4, "node") == 0 && name.size() > 4)
+        return atoi(name.c_str() + 4);
+    }
+    return -1;
+  }
+
 
   buffer::buffer(int nitems, size_t sizeof_item, block_sptr link)
     : d_base(0), d_bufsize(0), d_max_reader_delay(0), d_vmcircbuf(0),
       d_sizeof_item(sizeof_item), d_link(link),
       d_write_index(0), d_abs_write_offset(0), d_done(false),
-      d_last_min_items_read(0)
+      d_item_tags(TAG_STORE_CAPACITY), d_last_min_items_read(0)
   {
     if(!allocate_buffer (nitems, sizeof_item))
       throw std::bad_alloc ();
@@ -110,11 +169,33 @@ namespace gr {
    */
   bool
   buffer::allocate_buffer(int nitems, size_t sizeof_item)
+  {
+    if(use_hugepages(nitems, sizeof_item)) {
+      if(allocate_vmcircbuf(gr::vmcircbuf_memfd_hugetlb_factory::singleton(),
+                            nitems, sizeof_item)) {
+        place_on_link_node();
+        return true;
+      }
+      std::cerr << "gr::buffer::allocate_buffer: warning: huge page buffers failed,\n"
+                << "   using " << gr::vmcircbuf_sysconfig::get_default_factory()->name()
+                << " for all buffers. Are huge pages reserved (vm.nr_hugepages)?\n";
+      s_hugepages_failed = true;
+    }
+
+    if(!allocate_vmcircbuf(gr::vmcircbuf_sysconfig::get_default_factory(),
+                           nitems, sizeof_item))
+      return false;
+    place_on_link_node();
+    return true;
+  }
+
+  bool
+  buffer::allocate_vmcircbuf(vmcircbuf_factory *factory, int nitems, size_t sizeof_item)
   {
     int orig_nitems = nitems;
 
     // Any buffersize we come up with must be a multiple of min_nitems.
-    int granularity = gr::vmcircbuf_sysconfig::granularity();
+    int granularity = factory->granularity();
     int min_nitems =  minimum_buffer_items(sizeof_item, granularity);
 
     // Round-up nitems to a multiple of min_nitems.
@@ -134,7 +215,7 @@ namespace gr {
     }
 
     d_bufsize = nitems;
-    d_vmcircbuf = gr::vmcircbuf_sysconfig::make(d_bufsize * d_sizeof_item);
+    d_vmcircbuf = factory->make(d_bufsize * d_sizeof_item);
     if(d_vmcircbuf == 0){
       std::cerr << "gr::buffer::allocate_buffer: failed to allocate buffer of size "
                 << d_bufsize * d_sizeof_item / 1024 << " KB\n";
@@ -145,6 +226,36 @@ namespace gr {
     return true;
   }
 
+  /*!
+   * Prefers the memory of the NUMA node of the first processor of the
+   * writing block's affinity, if it has one, for the buffer. Nothing
+   * has touched the buffer yet, so all its pages follow the policy.
+   */
+  void
+  buffer::place_on_link_node()
+  {
+    block_sptr link = d_link.lock();
+    if(!link)
+      return;
+
+    std::vector<int> affinity = link->processor_affinity();
+    if(affinity.empty())
+      return;
+
+    int node = numa_node_of_cpu(affinity[0]);
+    if(node < 0 || d_vmcircbuf->set_numa_node(node))
+      return;
+
+    // the placement is only a preference, the buffer works without it
+    static bool warned = false;
+    if(!warned) {
+      std::cerr << "gr::buffer::place_on_link_node: warning: could not prefer NUMA node "
+                << node << " for the buffer of " << link->alias() << ",\n"
+                << "   buffers are left on the default memory policy.\n";
+      warned = true;
+    }
+  }
+
   int
   buffer::space_available()
   {
@@ -221,20 +332,44 @@ namespace gr {
     d_readers.erase(result);
   }
 
+  void
+  buffer::insert_item_tag(const tag_t &tag)
+  {
+    // the ring overwrites its front when full, so grow it first
+    if(d_item_tags.full())
+      d_item_tags.set_capacity(2 * d_item_tags.capacity());
+
+    if(d_item_tags.empty() || d_item_tags.back().offset <= tag.offset)
+      d_item_tags.push_back(tag);
+    else  // after the tags of the same offset, as the multimap did
+      d_item_tags.insert(std::upper_bound(d_item_tags.begin(), d_item_tags.end(),
+                                          tag.offset, offset_tag_less), tag);
+  }
+
   void
   buffer::add_item_tag(const tag_t &tag)
   {
     gr::thread::scoped_lock guard(*mutex());
-    d_item_tags.insert(std::pair<uint64_t,tag_t>(tag.offset,tag));
+    insert_item_tag(tag);
+  }
+
+  void
+  buffer::add_item_tags(const std::vector<tag_t> &tags)
+  {
+    gr::thread::scoped_lock guard(*mutex());
+    for(size_t i = 0; i < tags.size(); i++)
+      insert_item_tag(tags[i]);
   }
 
   void
   buffer::remove_item_tag(const tag_t &tag, long id)
   {
     gr::thread::scoped_lock guard(*mutex());
-    for(std::multimap<uint64_t,tag_t>::iterator it = d_item_tags.lower_bound(tag.offset); it != d_item_tags.upper_bound(tag.offset); ++it) {
-      if((*it).second == tag) {
-        (*it).second.marked_deleted.push_back(id);
+    tag_store_t::iterator it = get_tags_lower_bound(tag.offset);
+    tag_store_t::iterator end = get_tags_upper_bound(tag.offset);
+    for(; it != end; ++it) {
+      if(*it == tag) {
+        it->marked_deleted.push_back(id);
       }
     }
   }
@@ -252,33 +387,25 @@ namespace gr {
            gr::thread::scoped_lock guard(*mutex());
      */
 
-    /*
-      http://www.cplusplus.com/reference/map/multimap/erase/
-      "Iterators, pointers and references referring to elements removed
-      by the function are invalidated. All other iterators, pointers
-      and references keep their validity."
+    // d_item_tags is sorted by offset, so the first tag that is
+    // recent enough ends the pruning
+    while(!d_item_tags.empty() &&
+          d_item_tags.front().offset + d_max_reader_delay + bufsize() < max_time) {
+      d_item_tags.pop_front();
+    }
+  }
 
-      Store the iterator to be deleted in tmp; increment itr to the
-      next valid iterator, then erase tmp, which now becomes invalid.
-     */
+  buffer::tag_store_t::iterator
+  buffer::get_tags_lower_bound(uint64_t x)
+  {
+    return std::lower_bound(d_item_tags.begin(), d_item_tags.end(), x, tag_offset_less);
+  }
 
-    uint64_t item_time;
-   std::multimap<uint64_t,tag_t>::iterator itr(d_item_tags.begin()), tmp;
-    while(itr != d_item_tags.end()) {
-      item_time = (*itr).second.offset;
-      if(item_time+d_max_reader_delay + bufsize() < max_time) {
-        tmp = itr;
-       itr++;
-        d_item_tags.erase(tmp);
-      }
-      else {
-        // d_item_tags is a map sorted by offset, so when the if
-        // condition above fails, all future tags in the map must also
-        // fail. So just break here.
-        break;
-      }
-    }
-   }
+  buffer::tag_store_t::iterator
+  buffer::get_tags_upper_bound(uint64_t x)
+  {
+    return std::upper_bound(d_item_tags.begin(), d_item_tags.end(), x, offset_tag_less);
+  }
 
   long
   buffer_ncurrently_allocated()
@@ -345,23 +472,51 @@ namespace gr {
                                    long id)
   {
     gr::thread::scoped_lock guard(*mutex());
+    copy_tags_in_range(v, abs_start, abs_end, NULL, id);
+  }
 
+  void
+  buffer_reader::get_tags_in_range(std::vector<tag_t> &v,
+                                   uint64_t abs_start,
+                                   uint64_t abs_end,
+                                   const pmt::pmt_t &key,
+                                   long id)
+  {
+    gr::thread::scoped_lock guard(*mutex());
+    copy_tags_in_range(v, abs_start, abs_end, &key, id);
+  }
+
+  /*
+   * Copies the tags in [abs_start,abs_end) not deleted by block id,
+   * and only those with the key *key if key is not NULL. The buffer
+   * has to be locked.
+   */
+  void
+  buffer_reader::copy_tags_in_range(std::vector<tag_t> &v,
+                                    uint64_t abs_start,
+                                    uint64_t abs_end,
+                                    const pmt::pmt_t *key,
+                                    long id)
+  {
     v.resize(0);
-    std::multimap<uint64_t,tag_t>::iterator itr = d_buffer->get_tags_lower_bound(std::min(abs_start, abs_start - d_attr_delay));
-    std::multimap<uint64_t,tag_t>::iterator itr_end = d_buffer->get_tags_upper_bound(std::min(abs_end, abs_end - d_attr_delay));
+    buffer::tag_store_t::iterator itr = d_buffer->get_tags_lower_bound(std::min(abs_start, abs_start - d_attr_delay));
+    buffer::tag_store_t::iterator itr_end = d_buffer->get_tags_upper_bound(std::min(abs_end, abs_end - d_attr_delay));
 
     uint64_t item_time;
     while(itr != itr_end) {
-      item_time = (*itr).second.offset + d_attr_delay;
-      if((item_time >= abs_start) && (item_time < abs_end)) {
-        std::vector<long>::iterator id_itr;
-        id_itr = std::find(itr->second.marked_deleted.begin(), itr->second.marked_deleted.end(), id);
+      item_time = itr->offset + d_attr_delay;
+      if((item_time >= abs_start) && (item_time < abs_end) &&
+         (key == NULL || pmt::eqv(*key, itr->key))) {
         // If id is not in the vector of marked blocks
-        if(id_itr == itr->second.marked_deleted.end()) {
-          tag_t t = (*itr).second;
-          t.offset += d_attr_delay;
-          v.push_back(t);
-          v.back().marked_deleted.clear();
+        if(std::find(itr->marked_deleted.begin(), itr->marked_deleted.end(), id)
+           == itr->marked_deleted.end()) {
+          // copied without marked_deleted, which would be cleared anyway
+          v.push_back(tag_t());
+          tag_t &t = v.back();
+          t.offset = item_time;
+          t.key = itr->key;
+          t.value = itr->value;
+          t.srcid = itr->srcid;
         }
       }
       itr++;
@@ -25,6 +25,7 @@
 #endif
 
 #include "flat_flowgraph.h"
+#include "msg_edge_queue.h"
 #include <gnuradio/block_detail.h>
 #include <gnuradio/buffer.h>
 #include <gnuradio/prefs.h>
@@ -37,11 +38,9 @@ namespace gr {
 
 #define FLAT_FLOWGRAPH_DEBUG  0
 
-// 32Kbyte buffer size between blocks
+// 32Kbyte buffer size between blocks, unless [DEFAULT] buffer_size is set
 #define GR_FIXED_BUFFER_SIZE (32*(1L<<10))
 
-  static const unsigned int s_fixed_buffer_size = GR_FIXED_BUFFER_SIZE;
-
   flat_flowgraph_sptr
   make_flat_flowgraph()
   {
@@ -55,6 +54,7 @@ namespace gr {
 
   flat_flowgraph::~flat_flowgraph()
   {
+    clear_msg_edge_queues();
   }
 
   void
@@ -131,7 +131,11 @@ namespace gr {
     // *2 because we're now only filling them 1/2 way in order to
     // increase the available parallelism when using the TPB scheduler.
     // (We're double buffering, where we used to single buffer)
-    int nitems = s_fixed_buffer_size * 2 / item_size;
+    long buffer_size = prefs::singleton()->get_long("DEFAULT", "buffer_size",
+                                                    GR_FIXED_BUFFER_SIZE);
+    if(buffer_size <= 0)
+      buffer_size = GR_FIXED_BUFFER_SIZE;
+    int nitems = buffer_size * 2 / item_size;
 
     // Make sure there are at least twice the output_multiple no. of items
     if(nitems < 2*grblock->output_multiple())	// Note: this means output_multiple()
@@ -314,6 +318,57 @@ namespace gr {
     }
   }
 
+  void
+  flat_flowgraph::setup_msg_edge_queues(size_t depth)
+  {
+    clear_msg_edge_queues();
+
+    // Count edges of each output port; when a port has subscribers the
+    // edges don't know of, it has to publish through the registry
+    typedef std::map<std::pair<basic_block *, std::string>, size_t> port_count_t;
+    port_count_t nedges;
+    for(msg_edge_viter_t i = d_msg_edges.begin(); i != d_msg_edges.end(); i++) {
+      nedges[std::make_pair(i->src().block().get(), pmt::symbol_to_string(i->src().port()))]++;
+    }
+
+    for(msg_edge_viter_t i = d_msg_edges.begin(); i != d_msg_edges.end(); i++) {
+      basic_block_sptr src = i->src().block();
+      block_sptr dst = cast_to_block_sptr(i->dst().block());
+
+      pmt::pmt_t subs = pmt::dict_ref(src->d_message_subscribers, i->src().port(), pmt::PMT_NIL);
+      if(pmt::length(subs) != nedges[std::make_pair(src.get(), pmt::symbol_to_string(i->src().port()))]) {
+        if(FLAT_FLOWGRAPH_DEBUG)
+          std::cout << boost::format("flat_fg keeping locked msg queue: (%s, %s)->(%s, %s)\n") %
+            src % i->src().port() % dst % i->dst().port();
+        continue;
+      }
+      if(dst->msg_queue_ready.find(i->dst().port()) == dst->msg_queue_ready.end())
+        continue;
+
+      msg_edge_queue_sptr q(new msg_edge_queue(src.get(), i->src().port(),
+                                               dst.get(), i->dst().port(),
+                                               &dst->detail()->d_tpb,
+                                               dst->msg_queue_ready[i->dst().port()].get(),
+                                               depth));
+      src->attach_msg_edge_queue(q);
+      if(dst != src)
+        dst->attach_msg_edge_queue(q);
+      d_msg_edge_queues.push_back(q);
+    }
+  }
+
+  void
+  flat_flowgraph::clear_msg_edge_queues()
+  {
+    for(size_t i = 0; i < d_msg_edge_queues.size(); i++) {
+      msg_edge_queue_sptr q = d_msg_edge_queues[i];
+      q->src->detach_msg_edge_queue(q);
+      if(q->dst != q->src)
+        q->dst->detach_msg_edge_queue(q);
+    }
+    d_msg_edge_queues.clear();
+  }
+
   void
   flat_flowgraph::setup_buffer_alignment(block_sptr block)
   {
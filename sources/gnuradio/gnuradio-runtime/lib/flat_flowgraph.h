@@ -87,6 +87,23 @@ namespace gr {
      */
     void enable_pc_rpc();
 
+    /*!
+     * Gives each msg connection a lock-free queue of \p depth
+     * messages, used instead of the locked queue of the input port and
+     * the lookup of subscribers in the block registry. Ports with
+     * subscribers made outside of the flowgraph keep publishing the
+     * usual way. Must be called after the blocks have their details,
+     * while the flowgraph isn't running.
+     */
+    void setup_msg_edge_queues(size_t depth);
+
+    /*!
+     * Removes the lock-free queues, moving messages left in them to
+     * the locked queues. Must be called while the flowgraph isn't
+     * running.
+     */
+    void clear_msg_edge_queues();
+
   private:
     flat_flowgraph();
 
@@ -103,6 +120,8 @@ namespace gr {
      */
     void setup_buffer_alignment(block_sptr block);
 
+    std::vector<msg_edge_queue_sptr> d_msg_edge_queues;
+
     gr::logger_ptr d_logger;
     gr::logger_ptr d_debug_logger;
   };
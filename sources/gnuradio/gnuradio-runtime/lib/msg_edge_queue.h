@@ -0,0 +1,179 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GR_RUNTIME_MSG_EDGE_QUEUE_H
+#define INCLUDED_GR_RUNTIME_MSG_EDGE_QUEUE_H
+
+#include <gnuradio/api.h>
+#include <gnuradio/runtime_types.h>
+#include <gnuradio/high_res_timer.h>
+#include <pmt/pmt.h>
+#include <boost/lockfree/queue.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace gr {
+
+  struct tpb_detail;
+
+  /*!
+   * \brief Lock-free queue of one message connection
+   * \ingroup internal
+   *
+   * Made by flat_flowgraph for each message edge when lock-free message
+   * queues are enabled on the top block. The publishing block resolves
+   * the receiving block once, pushes messages into the ring without
+   * locking and wakes the receiver only when the ring was empty. The
+   * receiving block pops them in its own thread.
+   *
+   * A block may publish on a port from more than one thread (a message
+   * handler and a thread of its own, say), so the ring takes any number
+   * of producers. Messages of each producer keep their order.
+   *
+   * When the ring is full, messages spill into the locked queue of the
+   * input port until the receiver drained both the ring and the locked
+   * queue, which keeps the order of the messages of the connection.
+   */
+  class msg_edge_queue
+  {
+  public:
+    msg_edge_queue(basic_block *src_block, pmt::pmt_t src_port,
+                   basic_block *dst_block, pmt::pmt_t dst_port,
+                   tpb_detail *dst_tpb,
+                   boost::condition_variable *dst_ready,
+                   size_t depth)
+      : depth(depth), spilled(false),
+        src(src_block), src_port(src_port),
+        dst(dst_block), dst_port(dst_port),
+        dst_tpb(dst_tpb), dst_ready(dst_ready),
+        d_ring(depth), d_size(0), d_high_water(0)
+    {
+    }
+
+    ~msg_edge_queue()
+    {
+      item it;
+      while(pop(it))
+        ;
+    }
+
+    //! A message and the time it was queued at, if the receiver
+    //! measures message latency
+    struct item
+    {
+      pmt::pmt_t msg;
+      high_res_timer_type t;
+
+      item() : t(0) {}
+      item(const pmt::pmt_t &msg, high_res_timer_type t) : msg(msg), t(t) {}
+    };
+
+    /*!
+     * Pushes a message without locking; false if the ring is full.
+     * \p was_empty is set when the receiver has to be woken.
+     */
+    bool push(const item &it, bool &was_empty)
+    {
+      node n = { it.msg.get(), it.t };
+      if(n.msg)
+        intrusive_ptr_add_ref(n.msg);
+      if(!d_ring.bounded_push(n)) {
+        if(n.msg)
+          intrusive_ptr_release(n.msg);
+        return false;
+      }
+      // counted after the push: a receiver that saw the ring empty
+      // before is woken by this producer
+      long queued = d_size.fetch_add(1, boost::memory_order_acq_rel) + 1;
+      was_empty = queued == 1;
+      long high_water = d_high_water.load(boost::memory_order_relaxed);
+      while(queued > high_water &&
+            !d_high_water.compare_exchange_weak(high_water, queued, boost::memory_order_relaxed))
+        ;
+      return true;
+    }
+
+    //! Pops a message; only the receiving block does
+    bool pop(item &it)
+    {
+      node n;
+      if(!d_ring.pop(n))
+        return false;
+      d_size.fetch_sub(1, boost::memory_order_acq_rel);
+      it.msg = pmt::pmt_t(n.msg, false);   // takes over the reference
+      it.t = n.t;
+      return true;
+    }
+
+    //! Pops all messages into \p f
+    template<typename F> void consume_all(F &f)
+    {
+      item it;
+      while(pop(it))
+        f(it);
+    }
+
+    //! Messages in the ring, producers still pushing may be missed
+    size_t size() const
+    {
+      long n = d_size.load(boost::memory_order_acquire);
+      return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    //! Most messages the ring held since the last reset_high_water()
+    size_t high_water() const
+    {
+      return static_cast<size_t>(d_high_water.load(boost::memory_order_relaxed));
+    }
+
+    void reset_high_water() { d_high_water.store(0, boost::memory_order_relaxed); }
+
+    const size_t depth;
+    boost::atomic<bool> spilled;      //< messages go to the locked queue
+
+    basic_block *src;
+    pmt::pmt_t src_port;
+    basic_block *dst;
+    pmt::pmt_t dst_port;
+    tpb_detail *dst_tpb;              //< scheduler state of the receiver
+    boost::condition_variable *dst_ready; //< msg_queue_ready of the input port
+
+  private:
+    //! Ring entry holding a reference of the message
+    struct node
+    {
+      pmt::pmt_base *msg;
+      high_res_timer_type t;
+    };
+
+    boost::lockfree::queue<node> d_ring;
+    //! Messages pushed and not popped yet. A pop may be counted before
+    //! the push it took, so it can be briefly negative.
+    boost::atomic<long> d_size;
+    boost::atomic<long> d_high_water;
+  };
+
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_RUNTIME_MSG_EDGE_QUEUE_H */
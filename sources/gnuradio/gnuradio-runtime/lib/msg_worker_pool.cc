@@ -0,0 +1,199 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "msg_worker_pool.h"
+#include <gnuradio/block_detail.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/logger.h>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+namespace gr {
+
+  msg_worker_pool_sptr
+  msg_worker_pool::make(const block_vector_t &blocks, int nworkers)
+  {
+    return msg_worker_pool_sptr(new msg_worker_pool(blocks, nworkers));
+  }
+
+  msg_worker_pool::msg_worker_pool(const block_vector_t &blocks, int nworkers)
+    : d_ndone(0), d_nworkers(nworkers), d_nrunning(nworkers),
+      d_blocks_stopped(false)
+  {
+    prefs *p = prefs::singleton();
+    d_max_nmsgs = static_cast<size_t>(p->get_long("DEFAULT", "max_messages", 100));
+
+    // All blocks start queued to pick up messages posted before the
+    // flowgraph was started
+    for(size_t i = 0; i < blocks.size(); i++) {
+      d_entries.push_back(entry(blocks[i]));
+      d_ready.push_back(i);
+
+      block_detail *d = blocks[i]->detail().get();
+      d->threaded = false;
+      blocks[i]->clear_finished();
+      blocks[i]->start();			// enable any drivers, etc.
+    }
+  }
+
+  msg_worker_pool::~msg_worker_pool()
+  {
+    for(size_t i = 0; i < d_entries.size(); i++) {
+      d_entries[i].block->detail()->d_tpb.clear_msg_wakeup();
+    }
+  }
+
+  void
+  msg_worker_pool::install()
+  {
+    for(size_t i = 0; i < d_entries.size(); i++) {
+      d_entries[i].block->detail()->d_tpb.set_msg_wakeup(
+        boost::bind(&msg_worker_pool::wake, shared_from_this(), i));
+    }
+  }
+
+  void
+  msg_worker_pool::wake(size_t i)
+  {
+    gr::thread::scoped_lock guard(d_mutex);
+
+    entry &e = d_entries[i];
+    switch(e.st) {
+    case IDLE:
+      e.st = QUEUED;
+      d_ready.push_back(i);
+      d_ready_cond.notify_one();
+      break;
+
+    case RUNNING:
+      e.st = RUNNING_WOKEN;
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  void
+  msg_worker_pool::run()
+  {
+    // make sure worker_exit is called when we are interrupted
+    struct exit_guard
+    {
+      msg_worker_pool *pool;
+      exit_guard(msg_worker_pool *pool) : pool(pool) {}
+      ~exit_guard() { pool->worker_exit(); }
+    } guard_exit(this);
+
+    std::vector<pmt::pmt_t> msgs;
+    gr::thread::scoped_lock guard(d_mutex);
+
+    while(d_ndone < d_entries.size()) {
+      if(d_ready.empty()) {
+        d_ready_cond.wait(guard);	// interruption point
+        continue;
+      }
+
+      size_t i = d_ready.front();
+      d_ready.pop_front();
+      entry &e = d_entries[i];
+      e.st = RUNNING;
+
+      guard.unlock();
+      bool done = handle(e.block, msgs);
+      guard.lock();
+
+      if(done) {
+        e.st = DONE;
+        if(++d_ndone == d_entries.size())
+          d_ready_cond.notify_all();
+      }
+      else if(e.st == RUNNING_WOKEN || !e.block->empty_handled_p()) {
+        e.st = QUEUED;
+        d_ready.push_back(i);
+      }
+      else {
+        e.st = IDLE;
+      }
+    }
+  }
+
+  /*
+   * Handles one batch of messages of each port of the block, like
+   * tpb_thread_body does for blocks blocked on input. Returns true when
+   * the block is finished.
+   */
+  bool
+  msg_worker_pool::handle(block_sptr block, std::vector<pmt::pmt_t> &msgs)
+  {
+    boost::this_thread::interruption_point();
+
+    BOOST_FOREACH(basic_block::msg_queue_map_t::value_type &i, block->msg_queue) {
+      if(block->has_msg_handler(i.first)) {
+        block->delete_head_batch(i.first, msgs);
+        block->dispatch_msgs(i.first, msgs);
+        msgs.clear();
+      }
+      else {
+        // If we don't have a handler but are building up messages,
+        // prune the queue from the front to keep memory in check.
+        if(block->nmsgs(i.first) > d_max_nmsgs) {
+          GR_WARN("msg_worker_pool", "asynchronous message buffer overflowing, dropping message");
+          block->delete_head_nowait(i.first);
+          block->record_msg_drop(i.first);
+        }
+      }
+    }
+
+    if(block->finished()) {
+      block->notify_msg_neighbors();
+      block->detail()->set_done(true);
+      return true;
+    }
+    return false;
+  }
+
+  void
+  msg_worker_pool::worker_exit()
+  {
+    {
+      gr::thread::scoped_lock guard(d_mutex);
+      if(--d_nrunning > 0 || d_blocks_stopped)
+        return;
+      d_blocks_stopped = true;
+    }
+
+    // The last worker out returns the blocks to their threads and
+    // stops them. Blocks may post messages when they stop, so they
+    // are all unhooked first.
+    for(size_t i = 0; i < d_entries.size(); i++) {
+      d_entries[i].block->detail()->d_tpb.clear_msg_wakeup();
+    }
+    for(size_t i = 0; i < d_entries.size(); i++) {
+      d_entries[i].block->stop();		// stop any drivers, etc.
+    }
+  }
+
+} /* namespace gr */
@@ -0,0 +1,98 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef INCLUDED_GR_MSG_WORKER_POOL_H
+#define INCLUDED_GR_MSG_WORKER_POOL_H
+
+#include <gnuradio/api.h>
+#include <gnuradio/block.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/enable_shared_from_this.hpp>
+#include <deque>
+#include <vector>
+
+namespace gr {
+
+  class msg_worker_pool;
+  typedef boost::shared_ptr<msg_worker_pool> msg_worker_pool_sptr;
+
+  /*!
+   * \brief Runs message handlers of blocks without stream ports on a
+   * shared set of threads
+   * \ingroup internal
+   *
+   * Blocks are woken by their message queues through
+   * tpb_detail::set_msg_wakeup and wait in a ready queue for the next free
+   * worker, which handles one batch of messages of each port of the
+   * block. A block woken while it is being handled is queued again
+   * afterwards, so a block runs on one worker at a time and keeps the
+   * thread-safety guarantees of set_msg_handler.
+   *
+   * Workers return from run() when all blocks are done or when they
+   * are interrupted; the last one calls stop() of the blocks.
+   */
+  class GR_RUNTIME_API msg_worker_pool
+    : public boost::enable_shared_from_this<msg_worker_pool>
+  {
+  public:
+    //! Calls start() of the blocks; install() has to be called next.
+    static msg_worker_pool_sptr make(const block_vector_t &blocks,
+                                     int nworkers);
+    ~msg_worker_pool();
+
+    //! Hooks the pool to the message queues of the blocks
+    void install();
+
+    int nworkers() const { return d_nworkers; }
+
+    //! Body of a worker thread
+    void run();
+
+  private:
+    enum state { IDLE, QUEUED, RUNNING, RUNNING_WOKEN, DONE };
+
+    struct entry
+    {
+      block_sptr block;
+      state st;
+      entry(block_sptr block) : block(block), st(QUEUED) {}
+    };
+
+    gr::thread::mutex d_mutex;
+    gr::thread::condition_variable d_ready_cond;
+    std::vector<entry> d_entries;
+    std::deque<size_t> d_ready;
+    size_t d_ndone;
+    int d_nworkers;
+    int d_nrunning;
+    size_t d_max_nmsgs;
+    bool d_blocks_stopped;
+
+    msg_worker_pool(const block_vector_t &blocks, int nworkers);
+
+    void wake(size_t i);
+    bool handle(block_sptr block, std::vector<pmt::pmt_t> &msgs);
+    void worker_exit();
+  };
+
+} /* namespace gr */
+
+#endif /* INCLUDED_GR_MSG_WORKER_POOL_H */
@@ -56,4 +56,29 @@ namespace gr {
     return s_pagesize;
   }
 
+  int
+  hugepagesize()
+  {
+    static int s_hugepagesize = -1;
+
+    if(s_hugepagesize == -1) {
+      s_hugepagesize = 0;
+#if defined(__linux__)
+      FILE *fp = fopen("/proc/meminfo", "r");
+      if(fp) {
+        char line[256];
+        long kb;
+        while(fgets(line, sizeof(line), fp)) {
+          if(sscanf(line, "Hugepagesize: %ld kB", &kb) == 1) {
+            s_hugepagesize = kb * 1024;
+            break;
+          }
+        }
+        fclose(fp);
+      }
+#endif
+    }
+    return s_hugepagesize;
+  }
+
 } /* namespace gr */
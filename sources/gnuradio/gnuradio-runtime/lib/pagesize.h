@@ -32,6 +32,12 @@ namespace gr {
    */
   GR_RUNTIME_API int pagesize();
 
+  /*!
+   * \brief return the default huge page size in bytes, or 0 if the
+   * system has no huge pages
+   */
+  GR_RUNTIME_API int hugepagesize();
+
 } /* namespace gr */
 
 #endif /* GR_PAGESIZE_H_ */
@@ -0,0 +1,150 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Allocations per second and resident memory of burst-like messages
+ * (a pair of nil and a small blob) made by producer threads and
+ * released by consumer threads, with cons/make_blob and with
+ * cons_pooled/make_blob_pooled.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <pmt/pmt.h>
+#include <boost/thread.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#define MESSAGES 2000000   // per producer
+#define QUEUE_DEPTH 4096
+#define BLOB_SIZE 164      // burst header and 148 soft bits
+
+typedef boost::lockfree::spsc_queue<pmt::pmt_t> msg_ring;
+
+static bool
+pooled;
+
+static pmt::pmt_t
+make_msg(const uint8_t *data)
+{
+  if(pooled)
+    return pmt::cons_pooled(pmt::PMT_NIL, pmt::make_blob_pooled(data, BLOB_SIZE));
+  return pmt::cons(pmt::PMT_NIL, pmt::make_blob(data, BLOB_SIZE));
+}
+
+static void
+producer(msg_ring *ring)
+{
+  uint8_t data[BLOB_SIZE];
+  memset(data, 0, sizeof(data));
+
+  for(long i = 0; i < MESSAGES; i++) {
+    data[0] = i;
+    pmt::pmt_t msg = make_msg(data);
+    while(!ring->push(msg))
+      boost::this_thread::yield();
+  }
+}
+
+static void
+consumer(msg_ring *ring, long *checksum)
+{
+  pmt::pmt_t msg;
+  long sum = 0;
+
+  for(long i = 0; i < MESSAGES; i++) {
+    while(!ring->pop(msg))
+      boost::this_thread::yield();
+    sum += ((const uint8_t *) pmt::blob_data(pmt::cdr(msg)))[0];
+    msg = pmt::PMT_NIL;
+  }
+  *checksum = sum;
+}
+
+// Resident set size in MiB
+static double
+rss_mb()
+{
+  FILE *f = fopen("/proc/self/statm", "r");
+  if(f) {
+    long size, resident;
+    int n = fscanf(f, "%ld %ld", &size, &resident);
+    fclose(f);
+    if(n == 2)
+      return resident * (double) sysconf(_SC_PAGESIZE) / (1 << 20);
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;   // peak, in KiB on Linux
+}
+
+static void
+benchmark(int pairs, bool use_pool, const char *implementation_name)
+{
+  boost::thread_group threads;
+  std::vector<msg_ring *> rings;
+  std::vector<long> checksums(pairs);
+
+  pooled = use_pool;
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  for(int i = 0; i < pairs; i++) {
+    rings.push_back(new msg_ring(QUEUE_DEPTH));
+    threads.create_thread(boost::bind(producer, rings[i]));
+    threads.create_thread(boost::bind(consumer, rings[i], &checksums[i]));
+  }
+  threads.join_all();
+  boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+
+  for(int i = 0; i < pairs; i++)
+    delete rings[i];
+
+  double total = (stop - start).total_microseconds() * 1e-6;
+  double msgs = (double) MESSAGES * pairs;
+  printf("%2d x 2 threads %12s:  time: %6.3f  msgs/sec: %10.3e  allocs/sec: %10.3e  rss: %7.1f MiB\n",
+         pairs, implementation_name, total, msgs / total, 2 * msgs / total, rss_mb());
+}
+
+int
+main(int argc, char **argv)
+{
+  int max_pairs = std::max(1u, boost::thread::hardware_concurrency() / 2);
+
+  // the pool never returns memory to the system, so the default path
+  // runs first for its resident memory to be meaningful
+  printf("rss at start: %7.1f MiB\n", rss_mb());
+  for(int pairs = 1; pairs <= max_pairs; pairs *= 2)
+    benchmark(pairs, false, "make_blob");
+  for(int pairs = 1; pairs <= max_pairs; pairs *= 2)
+    benchmark(pairs, true, "pooled");
+
+  return 0;
+}
@@ -29,6 +29,7 @@
 #include "pmt_int.h"
 #include <gnuradio/messages/msg_accepter.h>
 #include <pmt/pmt_pool.h>
+#include "pmt_slab.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -494,6 +495,24 @@ cons(const pmt_t& x, const pmt_t& y)
   return pmt_t(new pmt_pair(x, y));
 }
 
+void *
+pmt_pair_pooled::operator new(size_t size)
+{
+  return pmt_slab::malloc(size);
+}
+
+void
+pmt_pair_pooled::operator delete(void *p)
+{
+  pmt_slab::free(p);
+}
+
+pmt_t
+cons_pooled(const pmt_t& x, const pmt_t& y)
+{
+  return pmt_t(new pmt_pair_pooled(x, y));
+}
+
 pmt_t
 car(const pmt_t& pair)
 {
@@ -1021,6 +1040,28 @@ make_blob(const void *buf, size_t len_in_bytes)
   return init_u8vector(len_in_bytes, (const uint8_t *) buf);
 }
 
+pmt_u8vector_pooled *
+pmt_u8vector_pooled::make(size_t k, const uint8_t *data)
+{
+  void *p = pmt_slab::malloc(slot_size(k));
+  return new(p) pmt_u8vector_pooled(k, data);
+}
+
+void
+pmt_u8vector_pooled::operator delete(void *p)
+{
+  pmt_slab::free(p);
+}
+
+pmt_t
+make_blob_pooled(const void *buf, size_t len_in_bytes)
+{
+  if (pmt_u8vector_pooled::slot_size(len_in_bytes) > pmt_slab::MAX_SIZE)
+    return make_blob(buf, len_in_bytes);
+
+  return pmt_t(pmt_u8vector_pooled::make(len_in_bytes, (const uint8_t *) buf));
+}
+
 const void *
 blob_data(pmt_t blob)
 {
@@ -244,6 +244,33 @@ public:
 
 #include "pmt_unv_int.h"
 
+/*
+ * Objects of cons_pooled and make_blob_pooled come from pmt_slab. The
+ * elements of the blob follow the object in the same slot.
+ */
+class pmt_pair_pooled : public pmt_pair
+{
+public:
+  pmt_pair_pooled(const pmt_t& car, const pmt_t& cdr) : pmt_pair(car, cdr) {}
+
+  static void *operator new(size_t size);
+  static void operator delete(void *p);
+};
+
+class pmt_u8vector_pooled : public pmt_u8vector
+{
+  pmt_u8vector_pooled(size_t k, const uint8_t *data)
+    : pmt_u8vector(k, data, reinterpret_cast<uint8_t *>(this + 1)) {}
+
+public:
+  //! Size of the slot of a blob of \p k bytes
+  static size_t slot_size(size_t k) { return sizeof(pmt_u8vector_pooled) + k; }
+
+  //! \p k has to fit, see slot_size
+  static pmt_u8vector_pooled *make(size_t k, const uint8_t *data);
+  static void operator delete(void *p);
+};
+
 } /* namespace pmt */
 
 #endif /* INCLUDED_PMT_INT_H */
@@ -0,0 +1,174 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "pmt_slab.h"
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <vector>
+#include <stdint.h>
+
+namespace pmt {
+
+/*
+ * Slots of class c are (c+1)*GRANULE bytes long and start with a header
+ * holding c, which keeps the objects 16-byte aligned. Free slots are
+ * linked through their first word.
+ */
+static const size_t GRANULE = 64;
+static const size_t HEADER = 16;
+static const size_t NCLASSES = (pmt_slab::MAX_SIZE + HEADER) / GRANULE;
+static const size_t BATCH = 32;			// slots moved at a time
+static const size_t CHUNK_SIZE = 64 * 1024;	// bytes taken from the system at a time
+
+struct slot {
+  slot *d_next;
+};
+
+struct central_list {
+  boost::mutex		d_mutex;
+  slot		       *d_head;
+  std::vector<char *>	d_chunks;
+
+  central_list() : d_head(0) {}
+};
+
+static central_list s_central[NCLASSES];
+
+struct thread_cache {
+  slot	       *d_head[NCLASSES];
+  size_t	d_n[NCLASSES];
+
+  thread_cache()
+  {
+    for (size_t c = 0; c < NCLASSES; c++){
+      d_head[c] = 0;
+      d_n[c] = 0;
+    }
+  }
+
+  // return everything to the shared lists when the thread exits
+  ~thread_cache()
+  {
+    for (size_t c = 0; c < NCLASSES; c++){
+      while (d_head[c])
+        release(c, d_n[c]);
+    }
+  }
+
+  // move up to n slots of class c to the shared list
+  void release(size_t c, size_t n)
+  {
+    slot *first = d_head[c];
+    slot *last = first;
+    size_t moved = 1;
+    while (moved < n && last->d_next){
+      last = last->d_next;
+      moved++;
+    }
+    d_head[c] = last->d_next;
+    d_n[c] -= moved;
+
+    boost::mutex::scoped_lock guard(s_central[c].d_mutex);
+    last->d_next = s_central[c].d_head;
+    s_central[c].d_head = first;
+  }
+
+  // take a batch of slots of class c from the shared list or a new chunk
+  void refill(size_t c)
+  {
+    central_list &central = s_central[c];
+    boost::mutex::scoped_lock guard(central.d_mutex);
+
+    if (!central.d_head){
+      size_t slot_size = (c + 1) * GRANULE;
+      char *chunk = new char[CHUNK_SIZE + GRANULE - 1];
+      central.d_chunks.push_back(chunk);
+
+      char *start = (char *)(((uintptr_t)chunk + GRANULE - 1) & -GRANULE);
+      size_t n = (chunk + CHUNK_SIZE + GRANULE - 1 - start) / slot_size;
+      for (size_t i = 0; i < n; i++){
+        slot *s = (slot *)(start + i * slot_size);
+        s->d_next = central.d_head;
+        central.d_head = s;
+      }
+    }
+
+    while (central.d_head && d_n[c] < BATCH){
+      slot *s = central.d_head;
+      central.d_head = s->d_next;
+      s->d_next = d_head[c];
+      d_head[c] = s;
+      d_n[c]++;
+    }
+  }
+};
+
+static boost::thread_specific_ptr<thread_cache> s_cache;
+
+static inline thread_cache *
+get_cache()
+{
+  thread_cache *cache = s_cache.get();
+  if (!cache){
+    cache = new thread_cache();
+    s_cache.reset(cache);
+  }
+  return cache;
+}
+
+void *
+pmt_slab::malloc(size_t size)
+{
+  size_t c = (size + HEADER - 1) / GRANULE;
+  thread_cache *cache = get_cache();
+
+  if (!cache->d_head[c])
+    cache->refill(c);
+
+  slot *s = cache->d_head[c];
+  cache->d_head[c] = s->d_next;
+  cache->d_n[c]--;
+
+  *(size_t *) s = c;
+  return (char *) s + HEADER;
+}
+
+void
+pmt_slab::free(void *p)
+{
+  if (!p)
+    return;
+
+  slot *s = (slot *)((char *) p - HEADER);
+  size_t c = *(size_t *) s;
+  thread_cache *cache = get_cache();
+
+  s->d_next = cache->d_head[c];
+  cache->d_head[c] = s;
+  if (++cache->d_n[c] > 2 * BATCH)
+    cache->release(c, BATCH);
+}
+
+} /* namespace pmt */
@@ -0,0 +1,55 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef INCLUDED_PMT_SLAB_H
+#define INCLUDED_PMT_SLAB_H
+
+#include <cstddef>
+
+/*
+ * EVERYTHING IN THIS FILE IS PRIVATE TO THE IMPLEMENTATION!
+ */
+
+namespace pmt {
+
+/*!
+ * \brief Thread-caching slab allocator of small pmt objects
+ *
+ * Objects are served from size classes of 64 bytes. Each thread keeps
+ * a free list per class and exchanges batches of objects with a shared
+ * list under a lock only when its own list runs empty or grows too
+ * long, so objects made by one thread and released by another, like
+ * messages, don't take a lock each. Memory is never returned to the
+ * system, as in pmt_pool.
+ */
+class pmt_slab {
+public:
+  //! Largest object size served
+  static const size_t MAX_SIZE = 384 - 16;
+
+  //! \p size has to be at most MAX_SIZE
+  static void *malloc(size_t size);
+  static void free(void *p);
+};
+
+} /* namespace pmt */
+
+#endif /* INCLUDED_PMT_SLAB_H */
@@ -24,6 +24,7 @@
 #include <cppunit/TestAssert.h>
 #include <gnuradio/messages/msg_passing.h>
 #include <boost/format.hpp>
+#include <boost/thread.hpp>
 #include <cstdio>
 #include <cstring>
 #include <sstream>
@@ -610,3 +611,54 @@ qa_pmt_prims::test_sugar()
   CPPUNIT_ASSERT_EQUAL(sizeof(buf), nbytes);
   CPPUNIT_ASSERT(memcmp(buf, data, nbytes) == 0);
 }
+
+static void
+release_msgs(std::vector<pmt::pmt_t> *msgs)
+{
+  msgs->clear();
+}
+
+void
+qa_pmt_prims::test_pooled()
+{
+  uint8_t buf[200];
+  for(size_t i = 0; i < sizeof(buf); i++)
+    buf[i] = i;
+
+  pmt::pmt_t blob = pmt::make_blob_pooled(buf, sizeof(buf));
+  CPPUNIT_ASSERT(pmt::is_blob(blob));
+  CPPUNIT_ASSERT_EQUAL(sizeof(buf), pmt::blob_length(blob));
+  CPPUNIT_ASSERT(memcmp(buf, pmt::blob_data(blob), sizeof(buf)) == 0);
+  CPPUNIT_ASSERT(pmt::equal(pmt::make_blob(buf, sizeof(buf)), blob));
+  pmt::u8vector_set(blob, 3, 42);
+  CPPUNIT_ASSERT_EQUAL((uint8_t) 42, pmt::u8vector_ref(blob, 3));
+  CPPUNIT_ASSERT_THROW(pmt::u8vector_ref(blob, sizeof(buf)), pmt::out_of_range);
+  CPPUNIT_ASSERT_EQUAL((size_t) 0, pmt::blob_length(pmt::make_blob_pooled(buf, 0)));
+
+  // too large for the pool
+  std::vector<uint8_t> large(4096, 7);
+  pmt::pmt_t large_blob = pmt::make_blob_pooled(&large[0], large.size());
+  CPPUNIT_ASSERT_EQUAL(large.size(), pmt::blob_length(large_blob));
+  CPPUNIT_ASSERT(memcmp(&large[0], pmt::blob_data(large_blob), large.size()) == 0);
+
+  pmt::pmt_t s1 = pmt::mp("s1");
+  pmt::pmt_t c1 = pmt::cons_pooled(s1, blob);
+  CPPUNIT_ASSERT(pmt::is_pair(c1));
+  CPPUNIT_ASSERT_EQUAL(s1, pmt::car(c1));
+  CPPUNIT_ASSERT_EQUAL(blob, pmt::cdr(c1));
+  pmt::set_car(c1, pmt::PMT_NIL);
+  CPPUNIT_ASSERT_EQUAL(pmt::PMT_NIL, pmt::car(c1));
+  CPPUNIT_ASSERT(pmt::equal(pmt::deserialize_str(pmt::serialize_str(c1)), c1));
+
+  // messages made in this thread and released in another one
+  std::vector<pmt::pmt_t> msgs;
+  for(int i = 0; i < 10000; i++)
+    msgs.push_back(pmt::cons_pooled(pmt::PMT_NIL, pmt::make_blob_pooled(buf, i % sizeof(buf))));
+  boost::thread t(release_msgs, &msgs);
+  t.join();
+  CPPUNIT_ASSERT(msgs.empty());
+  for(int i = 0; i < 10000; i++) {
+    pmt::pmt_t msg = pmt::cons_pooled(pmt::PMT_NIL, pmt::make_blob_pooled(buf, 100));
+    CPPUNIT_ASSERT(memcmp(buf, pmt::blob_data(pmt::cdr(msg)), 100) == 0);
+  }
+}
@@ -49,6 +49,7 @@ class __GR_ATTR_EXPORT qa_pmt_prims : public CppUnit::TestCase
   CPPUNIT_TEST(test_serialize);
   CPPUNIT_TEST(test_sets);
   CPPUNIT_TEST(test_sugar);
+  CPPUNIT_TEST(test_pooled);
   CPPUNIT_TEST_SUITE_END();
 
  private:
@@ -71,6 +72,7 @@ class __GR_ATTR_EXPORT qa_pmt_prims : public CppUnit::TestCase
   void test_serialize();
   void test_sets();
   void test_sugar();
+  void test_pooled();
 };
 
 #endif /* INCLUDED_QA_PMT_PRIMS_H */
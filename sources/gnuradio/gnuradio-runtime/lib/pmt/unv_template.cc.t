@@ -12,16 +12,22 @@ _@TAG@vector(pmt_t x)
 
 
 pmt_@TAG@vector::pmt_@TAG@vector(size_t k, @TYPE@ fill)
-  : d_v(k)
+  : d_v(k), d_data(k ? &d_v[0] : 0), d_len(k)
 {
   for (size_t i = 0; i < k; i++)
     d_v[i] = fill;
 }
 
 pmt_@TAG@vector::pmt_@TAG@vector(size_t k, const @TYPE@ *data)
-  : d_v(k)
+  : d_v(k), d_data(k ? &d_v[0] : 0), d_len(k)
 {
-  memcpy( &d_v[0], data, k * sizeof(@TYPE@) );
+  memcpy( d_data, data, k * sizeof(@TYPE@) );
+}
+
+pmt_@TAG@vector::pmt_@TAG@vector(size_t k, const @TYPE@ *data, @TYPE@ *storage)
+  : d_data(storage), d_len(k)
+{
+  memcpy( d_data, data, k * sizeof(@TYPE@) );
 }
 
 @TYPE@
@@ -29,7 +35,7 @@ pmt_@TAG@vector::ref(size_t k) const
 {
   if (k >= length())
     throw out_of_range("pmt_@TAG@vector_ref", from_long(k));
-  return d_v[k];
+  return d_data[k];
 }
 
 void
@@ -37,35 +43,35 @@ pmt_@TAG@vector::set(size_t k, @TYPE@ x)
 {
   if (k >= length())
     throw out_of_range("pmt_@TAG@vector_set", from_long(k));
-  d_v[k] = x;
+  d_data[k] = x;
 }
 
 const @TYPE@ *
 pmt_@TAG@vector::elements(size_t &len)
 {
   len = length();
-  return &d_v[0];
+  return d_data;
 }
 
 @TYPE@ *
 pmt_@TAG@vector::writable_elements(size_t &len)
 {
   len = length();
-  return &d_v[0];
+  return d_data;
 }
 
 const void*
 pmt_@TAG@vector::uniform_elements(size_t &len)
 {
   len = length() * sizeof(@TYPE@);
-  return &d_v[0];
+  return d_data;
 }
 
 void*
 pmt_@TAG@vector::uniform_writable_elements(size_t &len)
 {
   len = length() * sizeof(@TYPE@);
-  return &d_v[0];
+  return d_data;
 }
 
 bool
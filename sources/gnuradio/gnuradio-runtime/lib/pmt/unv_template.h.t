@@ -7,13 +7,20 @@ class pmt_@TAG@vector : public pmt_uniform_vector
 {
   std::vector< @TYPE@ >	d_v;
 
+protected:
+  @TYPE@		       *d_data;		// elements of d_v or of a subclass
+  size_t		d_len;
+
+  //! The \p k elements are kept by the subclass at \p storage
+  pmt_@TAG@vector(size_t k, const @TYPE@ *data, @TYPE@ *storage);
+
 public:
   pmt_@TAG@vector(size_t k, @TYPE@ fill);
   pmt_@TAG@vector(size_t k, const @TYPE@ *data);
   // ~pmt_@TAG@vector();
 
   bool is_@TAG@vector() const { return true; }
-  size_t length() const { return d_v.size(); }
+  size_t length() const { return d_len; }
   size_t itemsize() const { return sizeof(@TYPE@); }
   @TYPE@ ref(size_t k) const;
   void set(size_t k, @TYPE@ x);
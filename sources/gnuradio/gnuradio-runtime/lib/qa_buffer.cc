@@ -267,6 +267,63 @@ t3_body()
 }
 
 
+// ----------------------------------------------------------------------------
+// test the tag store: order of out-of-order tags, growth, key filter,
+// removal and pruning
+//
+
+static void
+t5_body()
+{
+  int nitems = 4000 / sizeof(int);
+  gr::buffer_sptr buf(gr::make_buffer(nitems, sizeof(int), gr::block_sptr()));
+  gr::buffer_reader_sptr r1(gr::buffer_add_reader(buf, 0, gr::block_sptr()));
+  pmt::pmt_t even = pmt::mp("even");
+  pmt::pmt_t odd = pmt::mp("odd");
+  std::vector<gr::tag_t> tags;
+
+  // more tags than the initial capacity, half of them out of order
+  gr::tag_t tag;
+  for(int i = 0; i < 200; i++) {
+    tag.offset = (i % 2) ? 2 * i : 400 - 2 * i;
+    tag.key = (tag.offset % 4) ? odd : even;
+    tag.value = pmt::from_long(i);
+    buf->add_item_tag(tag);
+  }
+  tag.offset = 100;
+  tag.key = even;
+  tag.value = pmt::from_long(-1);
+  buf->add_item_tag(tag);
+
+  r1->get_tags_in_range(tags, 0, 1000, 0);
+  CPPUNIT_ASSERT_EQUAL((size_t) 201, tags.size());
+  for(size_t i = 1; i < tags.size(); i++)
+    CPPUNIT_ASSERT(tags[i - 1].offset <= tags[i].offset);
+
+  // tags of the same offset keep the order they were added in
+  r1->get_tags_in_range(tags, 100, 101, 0);
+  CPPUNIT_ASSERT_EQUAL((size_t) 2, tags.size());
+  CPPUNIT_ASSERT_EQUAL(150L, pmt::to_long(tags[0].value));
+  CPPUNIT_ASSERT_EQUAL(-1L, pmt::to_long(tags[1].value));
+
+  r1->get_tags_in_range(tags, 0, 40, odd, 0);
+  CPPUNIT_ASSERT_EQUAL((size_t) 10, tags.size());
+  for(size_t i = 0; i < tags.size(); i++)
+    CPPUNIT_ASSERT(pmt::eqv(odd, tags[i].key));
+
+  buf->remove_item_tag(tag, 7);
+  r1->get_tags_in_range(tags, 100, 101, 7);
+  CPPUNIT_ASSERT_EQUAL((size_t) 1, tags.size());
+  r1->get_tags_in_range(tags, 100, 101, 8);
+  CPPUNIT_ASSERT_EQUAL((size_t) 2, tags.size());
+  CPPUNIT_ASSERT(tags[1].marked_deleted.empty());
+
+  buf->prune_tags(buf->bufsize() + 101);
+  r1->get_tags_in_range(tags, 0, 1000, 0);
+  CPPUNIT_ASSERT_EQUAL((size_t) 150, tags.size());
+  CPPUNIT_ASSERT_EQUAL((uint64_t) 102, tags[0].offset);
+}
+
 // ----------------------------------------------------------------------------
 
 void
@@ -301,4 +358,5 @@ qa_buffer::t4()
 void
 qa_buffer::t5()
 {
+  leak_check(t5_body);
 }
@@ -0,0 +1,423 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <qa_msg_edge_queue.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/prefs.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <map>
+
+/*
+ * Messages published by a source in a burst much longer than the
+ * lock-free queues have to arrive in order, whether they passed through
+ * a ring or spilled into the locked queue.
+ */
+
+namespace {
+
+  static const long NMSGS = 20000;
+
+  class seq_source : public gr::block
+  {
+  public:
+    seq_source()
+      : gr::block("seq_source",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_next(0)
+    {
+      message_port_register_in(pmt::mp("go"));
+      set_msg_handler(pmt::mp("go"), boost::bind(&seq_source::go, this, _1));
+      message_port_register_out(pmt::mp("out"));
+    }
+
+    void go(pmt::pmt_t msg)
+    {
+      long n = pmt::to_long(msg);
+      for(long i = 0; i < n; i++) {
+        message_port_pub(pmt::mp("out"), pmt::from_long(d_next++));
+      }
+    }
+
+  private:
+    long d_next;
+  };
+
+  class seq_sink : public gr::block
+  {
+  public:
+    seq_sink()
+      : gr::block("seq_sink",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_count(0), d_in_order(true)
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&seq_sink::handle, this, _1));
+    }
+
+    void handle(pmt::pmt_t msg)
+    {
+      gr::thread::scoped_lock guard(d_mutex);
+      if(pmt::to_long(msg) != d_count)
+        d_in_order = false;
+      d_count++;
+    }
+
+    long count() { gr::thread::scoped_lock guard(d_mutex); return d_count; }
+    bool in_order() { gr::thread::scoped_lock guard(d_mutex); return d_in_order; }
+
+  private:
+    gr::thread::mutex d_mutex;
+    long d_count;
+    bool d_in_order;
+  };
+
+  class seq_batch_sink : public gr::block
+  {
+  public:
+    seq_batch_sink()
+      : gr::block("seq_batch_sink",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_count(0), d_calls(0), d_in_order(true)
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_batch_handler(pmt::mp("in"), boost::bind(&seq_batch_sink::handle, this, _1));
+    }
+
+    void handle(const std::vector<pmt::pmt_t> &msgs)
+    {
+      gr::thread::scoped_lock guard(d_mutex);
+      if(msgs.empty())
+        d_in_order = false;
+      for(size_t i = 0; i < msgs.size(); i++) {
+        if(pmt::to_long(msgs[i]) != d_count)
+          d_in_order = false;
+        d_count++;
+      }
+      d_calls++;
+    }
+
+    long count() { gr::thread::scoped_lock guard(d_mutex); return d_count; }
+    long calls() { gr::thread::scoped_lock guard(d_mutex); return d_calls; }
+    bool in_order() { gr::thread::scoped_lock guard(d_mutex); return d_in_order; }
+
+  private:
+    gr::thread::mutex d_mutex;
+    long d_count;
+    long d_calls;
+    bool d_in_order;
+  };
+
+  //! Checks the order of messages of each producer, messages are
+  //! (producer . sequence number) pairs
+  class pair_sink : public gr::block
+  {
+  public:
+    pair_sink()
+      : gr::block("pair_sink",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_count(0), d_in_order(true)
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&pair_sink::handle, this, _1));
+    }
+
+    void handle(pmt::pmt_t msg)
+    {
+      gr::thread::scoped_lock guard(d_mutex);
+      long &next = d_next[pmt::to_long(pmt::car(msg))];
+      if(pmt::to_long(pmt::cdr(msg)) != next)
+        d_in_order = false;
+      next++;
+      d_count++;
+    }
+
+    long count() { gr::thread::scoped_lock guard(d_mutex); return d_count; }
+    bool in_order() { gr::thread::scoped_lock guard(d_mutex); return d_in_order; }
+
+  private:
+    gr::thread::mutex d_mutex;
+    std::map<long, long> d_next;
+    long d_count;
+    bool d_in_order;
+  };
+
+  //! Keeps the messages it gets in its queue, they are read with
+  //! delete_head_blocking()
+  class hold_sink : public gr::block
+  {
+  public:
+    hold_sink()
+      : gr::block("hold_sink",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0))
+    {
+      message_port_register_in(pmt::mp("in"));
+    }
+  };
+
+  void
+  publish_pairs(gr::basic_block_sptr src, long producer, long n)
+  {
+    for(long i = 0; i < n; i++) {
+      src->message_port_pub(pmt::mp("out"), pmt::cons(pmt::from_long(producer), pmt::from_long(i)));
+    }
+  }
+
+  template<class T> void
+  wait_for(boost::shared_ptr<T> sink, long count)
+  {
+    for(int i = 0; i < 500 && sink->count() < count; i++)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  }
+
+}
+
+void
+qa_msg_edge_queue::t0()
+{
+  gr::prefs::singleton()->set_long("DEFAULT", "lockfree_msg_queue_depth", 16);
+
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<seq_sink> sink = gnuradio::get_initial_sptr(new seq_sink());
+  tb->msg_connect(src, "out", sink, "in");
+
+  tb->set_lockfree_msg_queues(true);
+  CPPUNIT_ASSERT(tb->lockfree_msg_queues());
+  tb->start();
+  src->_post(pmt::mp("go"), pmt::from_long(NMSGS));
+  wait_for(sink, NMSGS);
+  tb->stop();
+  tb->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink->count());
+  CPPUNIT_ASSERT(sink->in_order());
+}
+
+void
+qa_msg_edge_queue::t1()
+{
+  // two subscribers of one port, each gets all messages
+  gr::prefs::singleton()->set_long("DEFAULT", "lockfree_msg_queue_depth", 16);
+
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<seq_sink> sink0 = gnuradio::get_initial_sptr(new seq_sink());
+  boost::shared_ptr<seq_sink> sink1 = gnuradio::get_initial_sptr(new seq_sink());
+  tb->msg_connect(src, "out", sink0, "in");
+  tb->msg_connect(src, "out", sink1, "in");
+
+  tb->set_lockfree_msg_queues(true);
+  tb->start();
+  src->_post(pmt::mp("go"), pmt::from_long(NMSGS));
+  wait_for(sink0, NMSGS);
+  wait_for(sink1, NMSGS);
+  tb->stop();
+  tb->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink0->count());
+  CPPUNIT_ASSERT(sink0->in_order());
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink1->count());
+  CPPUNIT_ASSERT(sink1->in_order());
+}
+
+void
+qa_msg_edge_queue::t2()
+{
+  // reconfiguration keeps the order across the lock-free queues of
+  // the old and the new flowgraph
+  gr::prefs::singleton()->set_long("DEFAULT", "lockfree_msg_queue_depth", 16);
+
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<seq_sink> sink = gnuradio::get_initial_sptr(new seq_sink());
+  tb->msg_connect(src, "out", sink, "in");
+
+  tb->set_lockfree_msg_queues(true);
+  tb->start();
+  src->_post(pmt::mp("go"), pmt::from_long(NMSGS / 2));
+  tb->lock();
+  tb->unlock();
+  src->_post(pmt::mp("go"), pmt::from_long(NMSGS / 2));
+  wait_for(sink, NMSGS);
+  tb->stop();
+  tb->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink->count());
+  CPPUNIT_ASSERT(sink->in_order());
+}
+
+void
+qa_msg_edge_queue::t3()
+{
+  // message handler counters of the receiving port
+  gr::prefs::singleton()->set_long("DEFAULT", "lockfree_msg_queue_depth", 16);
+  gr::prefs::singleton()->set_bool("PerfCounters", "on", true);
+
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<seq_sink> sink = gnuradio::get_initial_sptr(new seq_sink());
+  gr::prefs::singleton()->set_bool("PerfCounters", "on", false);
+  tb->msg_connect(src, "out", sink, "in");
+
+  tb->set_lockfree_msg_queues(true);
+  tb->start();
+  src->_post(pmt::mp("go"), pmt::from_long(NMSGS));
+  wait_for(sink, NMSGS);
+  tb->stop();
+  tb->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink->count());
+  CPPUNIT_ASSERT_EQUAL((uint64_t) 0, sink->pc_msg_drops(pmt::mp("in")));
+#ifdef GR_PERFORMANCE_COUNTERS
+  CPPUNIT_ASSERT_EQUAL((uint64_t) NMSGS, sink->pc_msg_nhandled(pmt::mp("in")));
+  CPPUNIT_ASSERT(sink->pc_msg_batch_size_max(pmt::mp("in")) >= 1);
+  CPPUNIT_ASSERT(sink->pc_msg_queue_high_water(pmt::mp("in")) >= 1);
+  CPPUNIT_ASSERT(sink->pc_msg_handler_time_min(pmt::mp("in")) <=
+                 sink->pc_msg_handler_time_max(pmt::mp("in")));
+
+  std::vector<uint64_t> hist = sink->pc_msg_handler_time_hist(pmt::mp("in"));
+  uint64_t total = 0;
+  for(size_t i = 0; i < hist.size(); i++)
+    total += hist[i];
+  CPPUNIT_ASSERT_EQUAL((uint64_t) NMSGS, total);
+
+  sink->reset_perf_counters();
+  CPPUNIT_ASSERT_EQUAL((uint64_t) 0, sink->pc_msg_nhandled(pmt::mp("in")));
+#endif /* GR_PERFORMANCE_COUNTERS */
+}
+
+void
+qa_msg_edge_queue::t4()
+{
+  // a batch handler gets all messages in order, never an empty batch
+  gr::prefs::singleton()->set_long("DEFAULT", "lockfree_msg_queue_depth", 16);
+
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<seq_batch_sink> sink = gnuradio::get_initial_sptr(new seq_batch_sink());
+  tb->msg_connect(src, "out", sink, "in");
+
+  tb->set_lockfree_msg_queues(true);
+  tb->start();
+  src->_post(pmt::mp("go"), pmt::from_long(NMSGS));
+  wait_for(sink, NMSGS);
+  tb->stop();
+  tb->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink->count());
+  CPPUNIT_ASSERT(sink->in_order());
+  CPPUNIT_ASSERT(sink->calls() >= 1 && sink->calls() <= NMSGS);
+}
+
+void
+qa_msg_edge_queue::t5()
+{
+  // threads publishing on one port at once
+  static const long NPRODUCERS = 4;
+  gr::prefs::singleton()->set_long("DEFAULT", "lockfree_msg_queue_depth", 16);
+
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<pair_sink> sink = gnuradio::get_initial_sptr(new pair_sink());
+  tb->msg_connect(src, "out", sink, "in");
+
+  tb->set_lockfree_msg_queues(true);
+  tb->start();
+  boost::thread_group producers;
+  for(long i = 0; i < NPRODUCERS; i++)
+    producers.create_thread(boost::bind(publish_pairs, src, i, NMSGS));
+  producers.join_all();
+  wait_for(sink, NPRODUCERS * NMSGS);
+  tb->stop();
+  tb->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NPRODUCERS * NMSGS, sink->count());
+  CPPUNIT_ASSERT(sink->in_order());
+}
+
+void
+qa_msg_edge_queue::t6()
+{
+  // subscribing and unsubscribing while the port is published on
+  gr::prefs::singleton()->set_long("DEFAULT", "lockfree_msg_queue_depth", 16);
+
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<pair_sink> sink = gnuradio::get_initial_sptr(new pair_sink());
+  boost::shared_ptr<pair_sink> other = gnuradio::get_initial_sptr(new pair_sink());
+  tb->msg_connect(src, "out", sink, "in");
+
+  tb->set_lockfree_msg_queues(true);
+  tb->start();
+  boost::thread producer(boost::bind(publish_pairs, src, 0, NMSGS));
+  pmt::pmt_t target = pmt::cons(other->alias_pmt(), pmt::mp("in"));
+  for(int i = 0; i < 100; i++) {
+    src->message_port_sub(pmt::mp("out"), target);
+    src->message_port_unsub(pmt::mp("out"), target);
+  }
+  producer.join();
+  wait_for(sink, NMSGS);
+  tb->stop();
+  tb->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink->count());
+  CPPUNIT_ASSERT(sink->in_order());
+  CPPUNIT_ASSERT(other->in_order());
+}
+
+void
+qa_msg_edge_queue::t7()
+{
+  // messages published after a reader emptied the ring of a spilled
+  // connection queue up behind the spilled ones
+  gr::prefs::singleton()->set_long("DEFAULT", "lockfree_msg_queue_depth", 16);
+
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<hold_sink> sink = gnuradio::get_initial_sptr(new hold_sink());
+  tb->msg_connect(src, "out", sink, "in");
+
+  tb->set_lockfree_msg_queues(true);
+  tb->start();
+  src->go(pmt::from_long(40));
+  CPPUNIT_ASSERT_EQUAL((uint64_t) 40, sink->pc_msg_queue_high_water(pmt::mp("in")));
+  long next = 0;
+  for(; next < 20; next++)
+    CPPUNIT_ASSERT_EQUAL(next, pmt::to_long(sink->delete_head_blocking(pmt::mp("in"), 1000)));
+  src->go(pmt::from_long(10));
+  for(; next < 50; next++)
+    CPPUNIT_ASSERT_EQUAL(next, pmt::to_long(sink->delete_head_blocking(pmt::mp("in"), 1000)));
+  tb->stop();
+  tb->wait();
+}
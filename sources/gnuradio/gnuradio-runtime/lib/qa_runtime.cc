@@ -38,6 +38,8 @@
 #include <qa_fxpt_vco.h>
 #include <qa_logger.h>
 #include <qa_math.h>
+#include <qa_msg_edge_queue.h>
+#include <qa_scheduler_tpb.h>
 #include <qa_vmcircbuf.h>
 #include <qa_sincos.h>
 #include <qa_fast_atan2f.h>
@@ -55,6 +57,8 @@ qa_runtime::suite()
   s->addTest(qa_fxpt_vco::suite());
   s->addTest(qa_logger::suite());
   s->addTest(qa_math::suite());
+  s->addTest(qa_msg_edge_queue::suite());
+  s->addTest(qa_scheduler_tpb::suite());
   s->addTest(qa_vmcircbuf::suite());
   s->addTest(qa_sincos::suite());
   s->addTest(qa_fast_atan2f::suite());
@@ -0,0 +1,232 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <qa_scheduler_tpb.h>
+#include "scheduler_tpb.h"
+#include "flat_flowgraph.h"
+#include <gnuradio/top_block.h>
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+/*
+ * Message-only blocks on the worker pool of the TPB_MSG scheduler. The
+ * scheduler of top blocks is chosen once per process from
+ * GR_SCHEDULER, so the flowgraph is started here the way
+ * top_block_impl::start does it.
+ */
+
+namespace {
+
+  static const long NMSGS = 20000;
+
+  class seq_source : public gr::block
+  {
+  public:
+    seq_source()
+      : gr::block("seq_source",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_next(0)
+    {
+      message_port_register_in(pmt::mp("go"));
+      set_msg_handler(pmt::mp("go"), boost::bind(&seq_source::go, this, _1));
+      message_port_register_out(pmt::mp("out"));
+    }
+
+    void go(pmt::pmt_t msg)
+    {
+      long n = pmt::to_long(msg);
+      for(long i = 0; i < n; i++) {
+        message_port_pub(pmt::mp("out"), pmt::from_long(d_next++));
+      }
+    }
+
+  private:
+    long d_next;
+  };
+
+  class seq_relay : public gr::block
+  {
+  public:
+    seq_relay()
+      : gr::block("seq_relay",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0))
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&seq_relay::relay, this, _1));
+      message_port_register_out(pmt::mp("out"));
+    }
+
+    void relay(pmt::pmt_t msg)
+    {
+      message_port_pub(pmt::mp("out"), msg);
+    }
+  };
+
+  class seq_sink : public gr::block
+  {
+  public:
+    seq_sink()
+      : gr::block("seq_sink",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0)),
+        d_count(0), d_in_order(true), d_running(false), d_concurrent(false)
+    {
+      message_port_register_in(pmt::mp("in"));
+      set_msg_handler(pmt::mp("in"), boost::bind(&seq_sink::handle, this, _1));
+    }
+
+    void handle(pmt::pmt_t msg)
+    {
+      {
+        gr::thread::scoped_lock guard(d_mutex);
+        if(d_running)
+          d_concurrent = true;
+        d_running = true;
+        if(pmt::to_long(msg) != d_count)
+          d_in_order = false;
+        d_count++;
+      }
+      boost::this_thread::yield();
+      gr::thread::scoped_lock guard(d_mutex);
+      d_running = false;
+    }
+
+    long count() { gr::thread::scoped_lock guard(d_mutex); return d_count; }
+    bool in_order() { gr::thread::scoped_lock guard(d_mutex); return d_in_order; }
+    bool concurrent() { gr::thread::scoped_lock guard(d_mutex); return d_concurrent; }
+
+  private:
+    gr::thread::mutex d_mutex;
+    long d_count;
+    bool d_in_order;
+    bool d_running;
+    bool d_concurrent;
+  };
+
+  //! Starts the flowgraph of \p tb on the TPB_MSG scheduler
+  gr::scheduler_sptr
+  start_msg_pool(gr::top_block_sptr tb, size_t lockfree_depth)
+  {
+    gr::flat_flowgraph_sptr ffg = tb->flatten();
+    ffg->validate();
+    ffg->setup_connections();
+    if(lockfree_depth)
+      ffg->setup_msg_edge_queues(lockfree_depth);
+    return gr::scheduler_tpb::make_msg_pool(ffg);
+  }
+
+  void
+  wait_for(boost::shared_ptr<seq_sink> sink, long count)
+  {
+    for(int i = 0; i < 500 && sink->count() < count; i++)
+      boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  }
+
+  void
+  post_seq(boost::shared_ptr<seq_sink> sink, long n)
+  {
+    for(long i = 0; i < n; i++)
+      sink->_post(pmt::mp("in"), pmt::from_long(i));
+  }
+
+}
+
+void
+qa_scheduler_tpb::t0()
+{
+  // a chain of message-only blocks, locked queues
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<seq_relay> relay = gnuradio::get_initial_sptr(new seq_relay());
+  boost::shared_ptr<seq_sink> sink = gnuradio::get_initial_sptr(new seq_sink());
+  tb->msg_connect(src, "out", relay, "in");
+  tb->msg_connect(relay, "out", sink, "in");
+
+  gr::scheduler_sptr sched = start_msg_pool(tb, 0);
+  src->_post(pmt::mp("go"), pmt::from_long(NMSGS));
+  wait_for(sink, NMSGS);
+  sched->stop();
+  sched->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink->count());
+  CPPUNIT_ASSERT(sink->in_order());
+  CPPUNIT_ASSERT(!sink->concurrent());
+}
+
+void
+qa_scheduler_tpb::t1()
+{
+  // the same chain with lock-free queues
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<seq_relay> relay = gnuradio::get_initial_sptr(new seq_relay());
+  boost::shared_ptr<seq_sink> sink = gnuradio::get_initial_sptr(new seq_sink());
+  tb->msg_connect(src, "out", relay, "in");
+  tb->msg_connect(relay, "out", sink, "in");
+
+  gr::scheduler_sptr sched = start_msg_pool(tb, 16);
+  src->_post(pmt::mp("go"), pmt::from_long(NMSGS));
+  wait_for(sink, NMSGS);
+  sched->stop();
+  sched->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink->count());
+  CPPUNIT_ASSERT(sink->in_order());
+  CPPUNIT_ASSERT(!sink->concurrent());
+}
+
+void
+qa_scheduler_tpb::t2()
+{
+  // messages posted while the pool is hooked to the block and unhooked
+  // again are all kept
+  gr::top_block_sptr tb = gr::make_top_block("top");
+  boost::shared_ptr<seq_source> src = gnuradio::get_initial_sptr(new seq_source());
+  boost::shared_ptr<seq_sink> sink = gnuradio::get_initial_sptr(new seq_sink());
+  tb->msg_connect(src, "out", sink, "in");
+
+  boost::thread poster(boost::bind(post_seq, sink, NMSGS));
+  for(int i = 0; i < 20; i++) {
+    gr::scheduler_sptr sched = start_msg_pool(tb, 0);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    sched->stop();
+    sched->wait();
+  }
+  poster.join();
+
+  gr::scheduler_sptr sched = start_msg_pool(tb, 0);
+  wait_for(sink, NMSGS);
+  sched->stop();
+  sched->wait();
+
+  CPPUNIT_ASSERT_EQUAL(NMSGS, sink->count());
+  CPPUNIT_ASSERT(sink->in_order());
+}
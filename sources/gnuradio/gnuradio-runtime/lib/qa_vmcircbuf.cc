@@ -27,6 +27,7 @@
 #include <qa_vmcircbuf.h>
 #include <cppunit/TestAssert.h>
 #include "vmcircbuf.h"
+#include "vmcircbuf_memfd_hugetlb.h"
 #include <stdio.h>
 
 void
@@ -38,3 +39,25 @@ qa_vmcircbuf::test_all()
 
   CPPUNIT_ASSERT_EQUAL(true, ok);
 }
+
+void
+qa_vmcircbuf::test_hugetlb()
+{
+  // without huge pages reserved the factory fails, which is fine
+  gr::vmcircbuf_factory *f = gr::vmcircbuf_memfd_hugetlb_factory::singleton();
+  int size = 2 * f->granularity();
+  gr::vmcircbuf *c = f->make(size);
+  if(c == 0)
+    return;
+
+  unsigned int *p1 = (unsigned int *)c->pointer_to_first_copy();
+  unsigned int *p2 = (unsigned int *)c->pointer_to_second_copy();
+  CPPUNIT_ASSERT_EQUAL((size_t) 0, (size_t)p1 % f->granularity());
+
+  for(unsigned int i = 0; i < size / sizeof(int); i++)
+    p1[i] = i;
+  for(unsigned int i = 0; i < size / sizeof(int); i++)
+    CPPUNIT_ASSERT_EQUAL(i, p2[i]);
+
+  delete c;
+}
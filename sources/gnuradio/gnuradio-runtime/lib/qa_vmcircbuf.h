@@ -30,10 +30,12 @@ class qa_vmcircbuf : public CppUnit::TestCase
 {
   CPPUNIT_TEST_SUITE(qa_vmcircbuf);
   CPPUNIT_TEST(test_all);
+  CPPUNIT_TEST(test_hugetlb);
   CPPUNIT_TEST_SUITE_END();
 
 private:
   void test_all();
+  void test_hugetlb();
 };
 
 #endif /* QA_GR_VMCIRCBUF_H */
@@ -26,6 +26,10 @@
 #include "scheduler_tpb.h"
 #include "tpb_thread_body.h"
 #include <gnuradio/thread/thread_body_wrapper.h>
+#include <gnuradio/block_detail.h>
+#include <gnuradio/prefs.h>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
 #include <sstream>
 
 namespace gr {
@@ -45,14 +49,35 @@ namespace gr {
     }
   };
 
+  class msg_worker_container
+  {
+    msg_worker_pool_sptr d_pool;
+
+  public:
+    msg_worker_container(msg_worker_pool_sptr pool)
+      : d_pool(pool) {}
+
+    void operator()()
+    {
+      d_pool->run();
+    }
+  };
+
   scheduler_sptr
   scheduler_tpb::make(flat_flowgraph_sptr ffg, int max_noutput_items)
   {
     return scheduler_sptr(new scheduler_tpb(ffg, max_noutput_items));
   }
 
+  scheduler_sptr
+  scheduler_tpb::make_msg_pool(flat_flowgraph_sptr ffg, int max_noutput_items)
+  {
+    return scheduler_sptr(new scheduler_tpb(ffg, max_noutput_items, true));
+  }
+
   scheduler_tpb::scheduler_tpb(flat_flowgraph_sptr ffg,
-                               int max_noutput_items)
+                               int max_noutput_items,
+                               bool msg_pool)
     : scheduler(ffg, max_noutput_items)
   {
     int block_max_noutput_items;
@@ -71,6 +96,39 @@ namespace gr {
       blocks[i]->detail()->set_done(false);
     }
 
+    // Move the blocks without stream ports to the worker pool
+
+    if(msg_pool) {
+      block_vector_t stream_blocks;
+      block_vector_t msg_blocks;
+      for(size_t i = 0; i < blocks.size(); i++) {
+        block_detail_sptr d = blocks[i]->detail();
+        if(d->ninputs() == 0 && d->noutputs() == 0)
+          msg_blocks.push_back(blocks[i]);
+        else
+          stream_blocks.push_back(blocks[i]);
+      }
+      blocks = stream_blocks;
+
+      if(!msg_blocks.empty()) {
+        prefs *p = prefs::singleton();
+        long nworkers = p->get_long("DEFAULT", "msg_worker_threads", 0);
+        if(nworkers <= 0)
+          nworkers = std::max(1U, boost::thread::hardware_concurrency());
+        nworkers = std::min(nworkers, static_cast<long>(msg_blocks.size()));
+
+        d_msg_pool = msg_worker_pool::make(msg_blocks, nworkers);
+        d_msg_pool->install();
+        for(long i = 0; i < nworkers; i++) {
+          std::stringstream name;
+          name << "msg-worker[" << i << "]";
+          d_threads.create_thread(
+            gr::thread::thread_body_wrapper<msg_worker_container>
+              (msg_worker_container(d_msg_pool), name.str()));
+        }
+      }
+    }
+
     // Fire off a thead for each block
 
     for(size_t i = 0; i < blocks.size(); i++) {
@@ -25,15 +25,21 @@
 #include <gnuradio/api.h>
 #include <gnuradio/thread/thread_group.h>
 #include "scheduler.h"
+#include "msg_worker_pool.h"
 
 namespace gr {
 
   /*!
    * \brief Concrete scheduler that uses a kernel thread-per-block
+   *
+   * Made by make_msg_pool, it runs blocks without stream ports on a
+   * shared msg_worker_pool instead, with [DEFAULT] msg_worker_threads
+   * threads (by default one per processor).
    */
   class GR_RUNTIME_API scheduler_tpb : public scheduler
   {
     gr::thread::thread_group d_threads;
+    msg_worker_pool_sptr d_msg_pool;
 
   protected:
     /*!
@@ -42,12 +48,16 @@ namespace gr {
      * The scheduler will continue running until all blocks until they
      * report that they are done or the stop method is called.
      */
-    scheduler_tpb(flat_flowgraph_sptr ffg, int max_noutput_items);
+    scheduler_tpb(flat_flowgraph_sptr ffg, int max_noutput_items,
+                  bool msg_pool=false);
 
   public:
     static scheduler_sptr make(flat_flowgraph_sptr ffg,
                                int max_noutput_items=100000);
 
+    static scheduler_sptr make_msg_pool(flat_flowgraph_sptr ffg,
+                                        int max_noutput_items=100000);
+
     ~scheduler_tpb();
 
     /*!
@@ -127,6 +127,18 @@ namespace gr {
     d_impl->set_max_noutput_items(nmax);
   }
 
+  bool
+  top_block::lockfree_msg_queues()
+  {
+    return d_impl->lockfree_msg_queues();
+  }
+
+  void
+  top_block::set_lockfree_msg_queues(bool enable)
+  {
+    d_impl->set_lockfree_msg_queues(enable);
+  }
+
   top_block_sptr
   top_block::to_top_block()
   {
@@ -49,6 +49,7 @@ namespace gr {
     scheduler_maker f;
   } scheduler_table[] = {
     { "TPB", scheduler_tpb::make },    // first entry is default
+    { "TPB_MSG", scheduler_tpb::make_msg_pool },
     { "STS", scheduler_sts::make }
   };
 
@@ -80,7 +81,7 @@ namespace gr {
 
   top_block_impl::top_block_impl(top_block *owner)
     : d_owner(owner), d_ffg(),
-      d_state(IDLE), d_lock_count(0)
+      d_state(IDLE), d_lock_count(0), d_lockfree_msgs(false)
   {
   }
 
@@ -105,12 +106,17 @@ namespace gr {
     if(d_lock_count > 0)
       throw std::runtime_error("top_block::start: can't start with flow graph locked");
 
+    // Return the messages of the previous run to the locked queues
+    if(d_ffg)
+      d_ffg->clear_msg_edge_queues();
+
     // Create new flat flow graph by flattening hierarchy
     d_ffg = d_owner->flatten();
 
     // Validate new simple flow graph and wire it up
     d_ffg->validate();
     d_ffg->setup_connections();
+    setup_msg_edge_queues();
 
     // Only export perf. counters if ControlPort config param is
     // enabled and if the PerfCounter option 'export' is turned on.
@@ -188,12 +194,14 @@ namespace gr {
   top_block_impl::restart()
   {
     wait_for_jobs();
+    d_ffg->clear_msg_edge_queues();
 
     // Create new simple flow graph
     flat_flowgraph_sptr new_ffg = d_owner->flatten();
     new_ffg->validate();		 // check consistency, sanity, etc
     new_ffg->merge_connections(d_ffg);   // reuse buffers, etc
     d_ffg = new_ffg;
+    setup_msg_edge_queues();
 
     // Create a new scheduler to execute it
     d_scheduler = make_scheduler(d_ffg, d_max_noutput_items);
@@ -237,4 +245,34 @@ namespace gr {
     d_max_noutput_items = nmax;
   }
 
+  bool
+  top_block_impl::lockfree_msg_queues()
+  {
+    return d_lockfree_msgs;
+  }
+
+  void
+  top_block_impl::set_lockfree_msg_queues(bool enable)
+  {
+    gr::thread::scoped_lock l(d_mutex);
+    d_lockfree_msgs = enable;
+  }
+
+  /*
+   * setup_msg_edge_queues is called with d_mutex held, before the
+   * scheduler is made
+   */
+  void
+  top_block_impl::setup_msg_edge_queues()
+  {
+    if(!d_lockfree_msgs)
+      return;
+
+    prefs *p = prefs::singleton();
+    long depth = p->get_long("DEFAULT", "lockfree_msg_queue_depth", 1024);
+    if(depth < 2)
+      depth = 2;
+    d_ffg->setup_msg_edge_queues(static_cast<size_t>(depth));
+  }
+
 } /* namespace gr */
@@ -72,6 +72,12 @@ namespace gr {
     // Set the maximum number of noutput_items in the flowgraph
     void set_max_noutput_items(int nmax);
 
+    // Are lock-free msg queues used by the flowgraph?
+    bool lockfree_msg_queues();
+
+    // Use lock-free msg queues from the next start or restart
+    void set_lockfree_msg_queues(bool enable);
+
   protected:
     enum tb_state { IDLE, RUNNING };
 
@@ -84,10 +90,12 @@ namespace gr {
     int d_lock_count;
     boost::condition_variable d_lock_cond;
     int d_max_noutput_items;
+    bool d_lockfree_msgs;
 
   private:
     void restart();
     void wait_for_jobs();
+    void setup_msg_edge_queues();
   };
 
 } /* namespace gr */
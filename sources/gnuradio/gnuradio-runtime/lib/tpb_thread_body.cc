@@ -47,6 +47,7 @@ namespace gr {
     block_detail *d = block->detail().get();
     block_executor::state s;
     pmt::pmt_t msg;
+    std::vector<pmt::pmt_t> msgs;
 
     d->threaded = true;
     d->thread = gr::thread::get_current_thread_id();
@@ -102,8 +103,9 @@ namespace gr {
         // any messages. This is mostly a protection for the unknown
         // startup sequence of the threads.
         if(block->has_msg_handler(i.first)) {
-          while((msg = block->delete_head_nowait(i.first))) {
-            block->dispatch_msg(i.first,msg);
+          while(block->delete_head_batch(i.first, msgs)) {
+            block->dispatch_msgs(i.first, msgs);
+            msgs.clear();
           }
         }
         else {
@@ -112,6 +114,7 @@ namespace gr {
           if(block->nmsgs(i.first) > max_nmsgs){
             GR_LOG_WARN(LOG,"asynchronous message buffer overflowing, dropping message");
             msg = block->delete_head_nowait(i.first);
+            block->record_msg_drop(i.first);
           }
         }
       }
@@ -159,9 +162,10 @@ namespace gr {
           // handle all pending messages
           BOOST_FOREACH(basic_block::msg_queue_map_t::value_type &i, block->msg_queue) {
             if(block->has_msg_handler(i.first)) {
-              while((msg = block->delete_head_nowait(i.first))) {
-                guard.unlock();			// release lock while processing msg
-                block->dispatch_msg(i.first, msg);
+              while(block->delete_head_batch(i.first, msgs)) {
+                guard.unlock();			// release lock while processing msgs
+                block->dispatch_msgs(i.first, msgs);
+                msgs.clear();
                 guard.lock();
               }
             }
@@ -171,6 +175,7 @@ namespace gr {
               if(block->nmsgs(i.first) > max_nmsgs){
                 GR_LOG_WARN(LOG,"asynchronous message buffer overflowing, dropping message");
                 msg = block->delete_head_nowait(i.first);
+                block->record_msg_drop(i.first);
               }
             }
           }
@@ -192,9 +197,10 @@ namespace gr {
 	  // handle all pending messages
           BOOST_FOREACH(basic_block::msg_queue_map_t::value_type &i, block->msg_queue) {
             if(block->has_msg_handler(i.first)) {
-                while((msg = block->delete_head_nowait(i.first))) {
-                  guard.unlock();			// release lock while processing msg
-                  block->dispatch_msg(i.first, msg);
+                while(block->delete_head_batch(i.first, msgs)) {
+                  guard.unlock();			// release lock while processing msgs
+                  block->dispatch_msgs(i.first, msgs);
+                  msgs.clear();
                   guard.lock();
                 }
             }
@@ -204,6 +210,7 @@ namespace gr {
                 if(block->nmsgs(i.first) > max_nmsgs){
                   GR_LOG_WARN(LOG,"asynchronous message buffer overflowing, dropping message");
                   msg = block->delete_head_nowait(i.first);
+                  block->record_msg_drop(i.first);
                 }
             }
           }
@@ -33,6 +33,10 @@
 #include "vmcircbuf.h"
 #include "vmcircbuf_prefs.h"
 #include "local_sighandler.h"
+#ifdef HAVE_MBIND
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
 
 // all the factories we know about
 #include "vmcircbuf_createfilemapping.h"
@@ -50,6 +54,26 @@ namespace gr {
   {
   }
 
+  bool
+  vmcircbuf::set_numa_node(int node)
+  {
+#ifdef HAVE_MBIND
+    static const int MPOL_PREFERRED_MODE = 1;   // MPOL_PREFERRED of <numaif.h>
+    unsigned long nodemask;
+
+    if(node < 0 || node >= (int)(8 * sizeof(nodemask)))
+      return false;
+    nodemask = 1UL << node;
+
+    // a page is placed by the policy of the copy it is first touched
+    // through, so both copies get it
+    return syscall(SYS_mbind, d_base, 2 * (unsigned long)d_size, MPOL_PREFERRED_MODE,
+                   &nodemask, 8 * sizeof(nodemask) + 1, 0) == 0;
+#else
+    return false;
+#endif
+  }
+
   vmcircbuf_factory::~vmcircbuf_factory()
   {
   }
@@ -50,6 +50,14 @@ namespace gr {
     // ACCESSORS
     void *pointer_to_first_copy()  const{ return d_base; }
     void *pointer_to_second_copy() const{ return d_base + d_size; }
+
+    /*!
+     * \brief prefer memory of NUMA node \p node for the buffer.
+     *
+     * Best effort, to be called before the buffer is first touched;
+     * returns false if the memory policy could not be set.
+     */
+    bool set_numa_node(int node);
   };
 
   /*!
@@ -0,0 +1,182 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "vmcircbuf_memfd_hugetlb.h"
+#include <stdexcept>
+#include <assert.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdint.h>
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_MEMFD_CREATE
+#include <sys/syscall.h>
+#endif
+#include <errno.h>
+#include <stdio.h>
+#include "pagesize.h"
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 0x0004U
+#endif
+
+namespace gr {
+
+  vmcircbuf_memfd_hugetlb::vmcircbuf_memfd_hugetlb(int size)
+    : gr::vmcircbuf(size)
+  {
+#if !defined(HAVE_MMAP) || !defined(HAVE_MEMFD_CREATE)
+    fprintf(stderr, "gr::vmcircbuf_memfd_hugetlb: mmap or memfd_create is not available\n");
+    throw std::runtime_error("gr::vmcircbuf_memfd_hugetlb");
+#else
+    gr::thread::scoped_lock guard(s_vm_mutex);
+
+    size_t hugepage = gr::hugepagesize();
+    if(hugepage == 0) {
+      fprintf(stderr, "gr::vmcircbuf_memfd_hugetlb: no huge pages on this system\n");
+      throw std::runtime_error("gr::vmcircbuf_memfd_hugetlb");
+    }
+
+    if(size <= 0 || (size % hugepage) != 0) {
+      fprintf(stderr, "gr::vmcircbuf_memfd_hugetlb: invalid size = %d\n", size);
+      throw std::runtime_error("gr::vmcircbuf_memfd_hugetlb");
+    }
+
+    int fd = syscall(SYS_memfd_create, "gnuradio", MFD_CLOEXEC | MFD_HUGETLB);
+    if(fd == -1) {
+      perror("gr::vmcircbuf_memfd_hugetlb: memfd_create");
+      throw std::runtime_error("gr::vmcircbuf_memfd_hugetlb");
+    }
+
+    if(ftruncate(fd, (off_t)size) == -1) {
+      close(fd);						// cleanup
+      perror("gr::vmcircbuf_memfd_hugetlb: ftruncate");
+      throw std::runtime_error("gr::vmcircbuf_memfd_hugetlb");
+    }
+
+    // Reserve the address space of both copies. Huge page mappings
+    // have to start on a huge page boundary, so reserve one more and
+    // give back what is before and after the aligned range.
+    size_t reserved = 2 * (size_t)size + hugepage;
+    char *area = (char*)mmap(0, reserved, PROT_NONE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, (off_t)0);
+    if(area == MAP_FAILED) {
+      close(fd);						// cleanup
+      perror("gr::vmcircbuf_memfd_hugetlb: mmap (1)");
+      throw std::runtime_error("gr::vmcircbuf_memfd_hugetlb");
+    }
+
+    char *base = (char*)(((uintptr_t)area + hugepage - 1) & ~(uintptr_t)(hugepage - 1));
+    if(base != area)
+      munmap(area, base - area);
+    if(area + reserved != base + 2 * size)
+      munmap(base + 2 * size, (area + reserved) - (base + 2 * size));
+
+    // Map the file twice over the reservation. The huge pages are
+    // reserved here, so mmap fails if the system has too few of them.
+    void *first_copy = mmap(base, size,
+                            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                            fd, (off_t)0);
+
+    if(first_copy == MAP_FAILED) {
+      munmap(base, 2 * size);
+      close(fd);						// cleanup
+      perror("gr::vmcircbuf_memfd_hugetlb: mmap (2)");
+      throw std::runtime_error("gr::vmcircbuf_memfd_hugetlb");
+    }
+
+    void *second_copy = mmap(base + size, size,
+                             PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                             fd, (off_t)0);
+
+    if(second_copy == MAP_FAILED) {
+      munmap(base, 2 * size);
+      close(fd);						// cleanup
+      perror("gr::vmcircbuf_memfd_hugetlb: mmap (3)");
+      throw std::runtime_error("gr::vmcircbuf_memfd_hugetlb");
+    }
+
+    close(fd);    // fd no longer needed.  The mapping is retained.
+
+    // Now remember the important stuff
+    d_base = base;
+    d_size = size;
+#endif
+  }
+
+  vmcircbuf_memfd_hugetlb::~vmcircbuf_memfd_hugetlb()
+  {
+#if defined(HAVE_MMAP)
+    gr::thread::scoped_lock guard(s_vm_mutex);
+
+    if(munmap(d_base, 2 * d_size) == -1) {
+      perror("gr::vmcircbuf_memfd_hugetlb: munmap");
+    }
+#endif
+  }
+
+  // ----------------------------------------------------------------
+  //			The factory interface
+  // ----------------------------------------------------------------
+
+  gr::vmcircbuf_factory *vmcircbuf_memfd_hugetlb_factory::s_the_factory = 0;
+
+  gr::vmcircbuf_factory *
+  vmcircbuf_memfd_hugetlb_factory::singleton()
+  {
+    if(s_the_factory)
+      return s_the_factory;
+
+    s_the_factory = new gr::vmcircbuf_memfd_hugetlb_factory();
+    return s_the_factory;
+  }
+
+  int
+  vmcircbuf_memfd_hugetlb_factory::granularity()
+  {
+    int hugepage = gr::hugepagesize();
+    return hugepage ? hugepage : gr::pagesize();
+  }
+
+  gr::vmcircbuf *
+  vmcircbuf_memfd_hugetlb_factory::make(int size)
+  {
+    try {
+      return new vmcircbuf_memfd_hugetlb(size);
+    }
+    catch (...) {
+      return 0;
+    }
+  }
+
+} /* namespace gr */
@@ -53,6 +53,18 @@ namespace gr {
     pmt::pmt_t message_ports_in();
     pmt::pmt_t message_ports_out();
     pmt::pmt_t message_subscribers(pmt::pmt_t which_port);
+    double pc_msg_latency(pmt::pmt_t which_port);
+    double pc_msg_latency_max(pmt::pmt_t which_port);
+    uint64_t pc_msg_latency_nmsgs(pmt::pmt_t which_port);
+    void reset_msg_latency();
+    uint64_t pc_msg_nhandled(pmt::pmt_t which_port);
+    double pc_msg_handler_time(pmt::pmt_t which_port);
+    double pc_msg_handler_time_min(pmt::pmt_t which_port);
+    double pc_msg_handler_time_max(pmt::pmt_t which_port);
+    uint64_t pc_msg_batch_size_max(pmt::pmt_t which_port);
+    uint64_t pc_msg_queue_high_water(pmt::pmt_t which_port);
+    uint64_t pc_msg_drops(pmt::pmt_t which_port);
+    void reset_msg_pc();
   };
 
   %rename(block_ncurrently_allocated) basic_block_ncurrently_allocated;
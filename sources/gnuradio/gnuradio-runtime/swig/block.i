@@ -97,6 +97,20 @@ class gr::block : public gr::basic_block
   float pc_work_time_var();
   float pc_work_time_total();
   float pc_throughput_avg();
+  uint64_t pc_msg_nhandled(pmt::pmt_t which_port);
+  double pc_msg_handler_time_min(pmt::pmt_t which_port);
+  double pc_msg_handler_time_max(pmt::pmt_t which_port);
+  uint64_t pc_msg_batch_size_max(pmt::pmt_t which_port);
+  uint64_t pc_msg_queue_high_water(pmt::pmt_t which_port);
+  uint64_t pc_msg_drops(pmt::pmt_t which_port);
+  std::vector<float> pc_msg_nhandled();
+  std::vector<float> pc_msg_handler_time_avg();
+  std::vector<float> pc_msg_handler_time_min();
+  std::vector<float> pc_msg_handler_time_max();
+  std::vector<float> pc_msg_handler_time_hist();
+  std::vector<float> pc_msg_batch_size_max();
+  std::vector<float> pc_msg_queue_high_water();
+  std::vector<float> pc_msg_drops();
 
   // Methods to manage processor affinity.
   void set_processor_affinity(const std::vector<int> &mask);
@@ -124,6 +124,7 @@ namespace pmt{
   bool is_null(const pmt_t& x);
   bool is_pair(const pmt_t& obj);
   pmt_t cons(const pmt_t& x, const pmt_t& y);
+  pmt_t cons_pooled(const pmt_t& x, const pmt_t& y);
   pmt_t car(const pmt_t& pair);
   pmt_t cdr(const pmt_t& pair);
   void set_car(pmt_t pair, pmt_t value);
@@ -160,6 +161,7 @@ namespace pmt{
 
   bool is_blob(pmt_t x);
   pmt_t make_blob(const void *buf, size_t len);
+  pmt_t make_blob_pooled(const void *buf, size_t len);
   const void *blob_data(pmt_t blob);
   size_t blob_length(pmt_t blob);
 
@@ -50,6 +50,9 @@ namespace gr {
     int max_noutput_items();
     void set_max_noutput_items(int nmax);
 
+    bool lockfree_msg_queues();
+    void set_lockfree_msg_queues(bool enable);
+
     gr::top_block_sptr to_top_block(); // Needed for Python type coercion
   };
 }
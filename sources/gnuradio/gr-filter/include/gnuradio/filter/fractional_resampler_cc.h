@@ -25,6 +25,7 @@
 
 #include <gnuradio/filter/api.h>
 #include <gnuradio/block.h>
+#include <vector>
 
 namespace gr {
   namespace filter {
@@ -52,6 +53,26 @@ namespace gr {
       virtual float resamp_ratio() const = 0;
       virtual void set_mu (float mu) = 0;
       virtual void set_resamp_ratio(float resamp_ratio) = 0;
+
+      /*!
+       * \brief Low pass filter and decimate the input in front of the
+       * interpolator, in the same call.
+       *
+       * The resampling ratio stays input rate / output rate; the
+       * interpolator steps through the decimated samples by
+       * resamp_ratio / \p decimation. Meant to keep what would alias
+       * out of a large rate change, e.g. from the rate of a receiver
+       * down to a few samples per symbol, without a filter block of
+       * its own. With a control input, the ratio is read at the input
+       * sample of each output.
+       *
+       * \param decimation Keep one of every decimation filtered
+       *                   samples, 1 turns the filter off.
+       * \param taps Low pass filter taps at the input rate.
+       */
+      virtual void set_decimation(int decimation,
+                                  const std::vector<float> &taps) = 0;
+      virtual int decimation() const = 0;
     };
 
   } /* namespace filter */
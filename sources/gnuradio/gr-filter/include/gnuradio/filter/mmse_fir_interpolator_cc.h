@@ -69,8 +69,27 @@ namespace gr {
        */
       gr_complex interpolate(const gr_complex input[], float mu) const;
 
+      /*!
+       * \brief compute \p n interpolated output values.
+       *
+       * output[k] is the value at &input[offsets[k]] for the
+       * fractional delay quantized to step \p imu[k] of nsteps(),
+       * i.e. interpolate(&input[offsets[k]], mu) with
+       * imu[k] = rint(mu * nsteps()). With SSE, two outputs are
+       * computed per iteration.
+       *
+       * \throws std::runtime_error if an imu[k] is not in [0, nsteps()].
+       */
+      void interpolateN(gr_complex output[], const gr_complex input[],
+                        const int offsets[], const int imu[], int n) const;
+
     protected:
       std::vector<kernel::fir_filter_ccf *> filters;
+
+    private:
+      // reversed taps of each step, every one twice to multiply the
+      // real and imaginary parts of the input at once
+      std::vector<float> d_taps;
     };
 
   }  /* namespace filter */
@@ -0,0 +1,174 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Output samples per second of the MMSE interpolator one output at a
+ * time against interpolateN(), for the ratios of a clock offset
+ * correction and of 2 Msps down to 4 samples per GSM symbol, and
+ * input samples per second of 10 Msps down to 4 samples per GSM
+ * symbol, with a decimating filter block in front of
+ * fractional_resampler_cc and with its fused decimation.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/filter/mmse_fir_interpolator_cc.h>
+#include <gnuradio/filter/fractional_resampler_cc.h>
+#include <gnuradio/filter/fir_filter_ccf.h>
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/gr_complex.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define OUTPUTS 50000000
+#define NOUTPUT 4096
+#define ITEMS 200000000
+
+#define GSM_RATE (1625000.0 / 6.0)
+#define CARRIER_BW 135e3
+
+static double
+elapsed(boost::posix_time::ptime start)
+{
+  boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+  return (stop - start).total_microseconds() * 1e-6;
+}
+
+static void
+benchmark_interpolator(const char *name, double ratio)
+{
+  gr::filter::mmse_fir_interpolator_cc intr;
+  int nsteps = intr.nsteps();
+  std::vector<gr_complex> in((int)(NOUTPUT * ratio) + intr.ntaps() + 1);
+  for(size_t i = 0; i < in.size(); i++)
+    in[i] = gr_complex(rand() / (float) RAND_MAX - 0.5f,
+                       rand() / (float) RAND_MAX - 0.5f);
+  std::vector<gr_complex> out(NOUTPUT);
+  std::vector<int> offsets(NOUTPUT), imu(NOUTPUT);
+  int calls = OUTPUTS / NOUTPUT;
+
+  // as fractional_resampler_cc used to, one output after the other
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  for(int c = 0; c < calls; c++) {
+    float mu = 0;
+    int ii = 0;
+    for(int oo = 0; oo < NOUTPUT; oo++) {
+      out[oo] = intr.interpolate(&in[ii], mu);
+      double s = mu + ratio;
+      double f = floor(s);
+      mu = s - f;
+      ii += (int)f;
+    }
+  }
+  double single = elapsed(start);
+
+  start = boost::posix_time::microsec_clock::universal_time();
+  for(int c = 0; c < calls; c++) {
+    float mu = 0;
+    int ii = 0;
+    for(int oo = 0; oo < NOUTPUT; oo++) {
+      offsets[oo] = ii;
+      imu[oo] = (int)rint(mu * nsteps);
+      double s = mu + ratio;
+      int incr = (int)s;
+      mu = s - incr;
+      ii += incr;
+    }
+    intr.interpolateN(&out[0], &in[0], &offsets[0], &imu[0], NOUTPUT);
+  }
+  double batch = elapsed(start);
+
+  double items = (double) calls * NOUTPUT;
+  printf("%-36s  ratio %8.5f  interpolate: %10.3e  interpolateN: %10.3e outputs/sec\n",
+         name, ratio, items / single, items / batch);
+}
+
+static double
+run(gr::top_block_sptr tb)
+{
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+  tb->run();
+  return ITEMS / elapsed(start);
+}
+
+static void
+benchmark_decimation(double samp_rate_in, int osr)
+{
+  double samp_rate_out = GSM_RATE * osr;
+  double ratio = samp_rate_in / samp_rate_out;
+  int decim = (int)ratio;
+
+  // as gsm_input designs it: keeps what would alias into the carrier
+  double stop = samp_rate_in / decim - CARRIER_BW;
+  std::vector<float> taps =
+    gr::filter::firdes::low_pass(1, samp_rate_in, (CARRIER_BW + stop) / 2,
+                                 stop - CARRIER_BW, gr::filter::firdes::WIN_HAMMING);
+
+  gr::top_block_sptr tb = gr::make_top_block("two_blocks");
+  gr::block_sptr src = gr::blocks::null_source::make(sizeof(gr_complex));
+  gr::block_sptr head = gr::blocks::head::make(sizeof(gr_complex), ITEMS);
+  gr::block_sptr fir = gr::filter::fir_filter_ccf::make(decim, taps);
+  gr::block_sptr resamp = gr::filter::fractional_resampler_cc::make(0, ratio / decim);
+  gr::block_sptr sink = gr::blocks::null_sink::make(sizeof(gr_complex));
+  tb->connect(src, 0, head, 0);
+  tb->connect(head, 0, fir, 0);
+  tb->connect(fir, 0, resamp, 0);
+  tb->connect(resamp, 0, sink, 0);
+  double two_blocks = run(tb);
+
+  tb = gr::make_top_block("fused");
+  src = gr::blocks::null_source::make(sizeof(gr_complex));
+  head = gr::blocks::head::make(sizeof(gr_complex), ITEMS);
+  gr::filter::fractional_resampler_cc::sptr fused =
+    gr::filter::fractional_resampler_cc::make(0, ratio);
+  fused->set_decimation(decim, taps);
+  sink = gr::blocks::null_sink::make(sizeof(gr_complex));
+  tb->connect(src, 0, head, 0);
+  tb->connect(head, 0, fused, 0);
+  tb->connect(fused, 0, sink, 0);
+  double fused_rate = run(tb);
+
+  printf("%5.1f Msps to osr %d, decimation %2d, %3d taps  filter block: %10.3e  fused: %10.3e input samples/sec\n",
+         samp_rate_in / 1e6, osr, decim, (int) taps.size(), two_blocks, fused_rate);
+}
+
+int
+main(int argc, char **argv)
+{
+  benchmark_interpolator("clock offset correction (+10 ppm)", 1.00001);
+  benchmark_interpolator("2 Msps to osr 4", 2e6 / (GSM_RATE * 4));
+
+  benchmark_decimation(10e6, 4);
+  benchmark_decimation(20e6, 4);
+  benchmark_decimation(20e6, 2);
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Input samples per second of freq_xlating_fir_filter_ccc for a few
+ * filter lengths and decimations: filtering and rotating one output
+ * at a time, as the block used to, against filterNdec() followed by
+ * rotateN(), and against the block itself, which also switches to
+ * overlap-save for long filters.
+ *
+ * Usage: benchmark_freq_xlating_fir [input samples per call]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/filter/freq_xlating_fir_filter_ccc.h>
+#include <gnuradio/filter/fir_filter.h>
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/blocks/rotator.h>
+#include <gnuradio/gr_complex.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define ITEMS 50000000
+#define NINPUT 8192
+
+static const int tap_counts[] = { 15, 63, 255, 1023 };
+static const int decimations[] = { 1, 4, 16, 64 };
+
+static double
+elapsed(boost::posix_time::ptime start)
+{
+  boost::posix_time::ptime stop = boost::posix_time::microsec_clock::universal_time();
+  return (stop - start).total_microseconds() * 1e-6;
+}
+
+static std::vector<gr_complex>
+composite_taps(const std::vector<float> &proto, float fwT0)
+{
+  std::vector<gr_complex> ctaps(proto.size());
+  for(unsigned int i = 0; i < proto.size(); i++)
+    ctaps[i] = proto[i] * exp(gr_complex(0, i * fwT0));
+  return ctaps;
+}
+
+int
+main(int argc, char **argv)
+{
+  int ninput = (argc > 1) ? atoi(argv[1]) : NINPUT;
+  const float fwT0 = 2 * M_PI * 0.1;
+
+  printf("%6s %6s  %12s  %12s  %12s\n", "taps", "decim",
+         "per sample", "batch", "block");
+
+  for(size_t t = 0; t < sizeof(tap_counts) / sizeof(tap_counts[0]); t++) {
+    for(size_t d = 0; d < sizeof(decimations) / sizeof(decimations[0]); d++) {
+      int ntaps = tap_counts[t];
+      int decim = decimations[d];
+      int noutput = ninput / decim;
+      int calls = ITEMS / (noutput * decim);
+
+      // a low pass of the wanted length, the shape doesn't matter
+      std::vector<float> proto = gr::filter::firdes::low_pass(1, 1, 0.5 / decim, 0.1,
+                                                               gr::filter::firdes::WIN_HAMMING);
+      proto.resize(ntaps, 0);
+      std::vector<gr_complex> ctaps = composite_taps(proto, fwT0);
+
+      std::vector<gr_complex> in(ntaps - 1 + noutput * decim);
+      for(size_t i = 0; i < in.size(); i++)
+        in[i] = gr_complex(rand() / (float) RAND_MAX - 0.5f,
+                           rand() / (float) RAND_MAX - 0.5f);
+      std::vector<gr_complex> out(noutput);
+
+      gr::filter::kernel::fir_filter_ccc fir(decim, ctaps);
+      gr::blocks::rotator r;
+      r.set_phase_incr(exp(gr_complex(0, -fwT0 * decim)));
+
+      boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      for(int c = 0; c < calls; c++) {
+        for(int i = 0, j = 0; i < noutput; i++, j += decim)
+          out[i] = r.rotate(fir.filter(&in[j]));
+      }
+      double per_sample = elapsed(start);
+
+      start = boost::posix_time::microsec_clock::universal_time();
+      for(int c = 0; c < calls; c++) {
+        fir.filterNdec(&out[0], &in[0], noutput, decim);
+        r.rotateN(&out[0], &out[0], noutput);
+      }
+      double batch = elapsed(start);
+
+      std::vector<gr_complex> btaps(proto.begin(), proto.end());
+      gr::filter::freq_xlating_fir_filter_ccc::sptr op =
+        gr::filter::freq_xlating_fir_filter_ccc::make(decim, btaps, 0.1, 1);
+      gr_vector_const_void_star input_items(1, &in[0]);
+      gr_vector_void_star output_items(1, &out[0]);
+
+      start = boost::posix_time::microsec_clock::universal_time();
+      for(int c = 0; c < calls; c++)
+        op->work(noutput, input_items, output_items);
+      double block = elapsed(start);
+
+      double items = (double) calls * noutput * decim;
+      printf("%6d %6d  %12.3e  %12.3e  %12.3e\n", ntaps, decim,
+             items / per_sample, items / batch, items / block);
+    }
+  }
+
+  return 0;
+}
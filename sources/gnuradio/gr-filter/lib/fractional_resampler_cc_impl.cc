@@ -44,7 +44,9 @@ namespace gr {
               io_signature::make2(1, 2, sizeof(gr_complex), sizeof(float)),
               io_signature::make(1, 1, sizeof(gr_complex))),
 	d_mu(phase_shift), d_mu_inc(resamp_ratio),
-	d_resamp(new mmse_fir_interpolator_cc())
+	d_resamp(new mmse_fir_interpolator_cc()),
+	d_decim(1),
+	d_decim_fir(new kernel::fir_filter_ccf(1, std::vector<float>(1, 1.0f)))
     {
       if(resamp_ratio <=  0)
 	throw std::out_of_range("resampling ratio must be > 0");
@@ -57,16 +59,21 @@ namespace gr {
     fractional_resampler_cc_impl::~fractional_resampler_cc_impl()
     {
       delete d_resamp;
+      delete d_decim_fir;
     }
 
     void
     fractional_resampler_cc_impl::forecast(int noutput_items,
                                            gr_vector_int &ninput_items_required)
     {
+      // interpolator input, then what the decimating filter needs for it
+      int nrequired = (int)ceil((noutput_items * d_mu_inc / d_decim) + d_resamp->ntaps());
+      if(d_decim > 1)
+        nrequired = nrequired * d_decim + d_decim_fir->ntaps() - 1;
+
       unsigned ninputs = ninput_items_required.size();
       for(unsigned i=0; i < ninputs; i++) {
-	ninput_items_required[i] =
-	  (int)ceil((noutput_items * d_mu_inc) + d_resamp->ntaps());
+	ninput_items_required[i] = nrequired;
       }
     }
 
@@ -76,44 +83,62 @@ namespace gr {
                                                gr_vector_const_void_star &input_items,
                                                gr_vector_void_star &output_items)
     {
+      gr::thread::scoped_lock l(d_setlock);
+
       const gr_complex *in = (const gr_complex*)input_items[0];
       gr_complex *out = (gr_complex*)output_items[0];
+      int nsteps = d_resamp->nsteps();
 
-      int ii = 0; // input index
-      int oo = 0; // output index
+      if((int)d_offsets.size() < noutput_items) {
+        d_offsets.resize(noutput_items);
+        d_imu.resize(noutput_items);
+      }
 
-      if(ninput_items.size() == 1) {
-        while(oo < noutput_items) {
-          out[oo++] = d_resamp->interpolate(&in[ii], d_mu);
+      // Where the outputs are and which filters they use, then all of
+      // them at once. s is never negative, so truncation is floor().
+      int ii = 0; // input index, in decimated samples
 
-          double s = d_mu + d_mu_inc;
-          double f = floor(s);
-          int incr = (int)f;
-          d_mu = s - f;
+      if(ninput_items.size() == 1) {
+        double mu_inc = (double)d_mu_inc / d_decim;
+        for(int oo = 0; oo < noutput_items; oo++) {
+          d_offsets[oo] = ii;
+          d_imu[oo] = (int)rint(d_mu * nsteps);
+
+          double s = d_mu + mu_inc;
+          int incr = (int)s;
+          d_mu = s - incr;
           ii += incr;
         }
-
-        consume_each(ii);
-        return noutput_items;
       }
 
       else {
         const float *rr = (const float*)input_items[1];
-        while(oo < noutput_items) {
-          out[oo++] = d_resamp->interpolate(&in[ii], d_mu);
-          d_mu_inc = rr[ii];
-
-          double s = d_mu + d_mu_inc;
-          double f = floor(s);
-          int incr = (int)f;
-          d_mu = s - f;
+        for(int oo = 0; oo < noutput_items; oo++) {
+          d_offsets[oo] = ii;
+          d_imu[oo] = (int)rint(d_mu * nsteps);
+          d_mu_inc = rr[ii * d_decim];
+
+          double s = d_mu + (double)d_mu_inc / d_decim;
+          int incr = (int)s;
+          d_mu = s - incr;
           ii += incr;
         }
 
         set_relative_rate(1.0 / d_mu_inc);
-        consume_each(ii);
-        return noutput_items;
       }
+
+      if(d_decim > 1) {
+        int ndecimated = d_offsets[noutput_items - 1] + d_resamp->ntaps();
+        if((int)d_decimated.size() < ndecimated)
+          d_decimated.resize(ndecimated);
+        d_decim_fir->filterNdec(&d_decimated[0], in, ndecimated, d_decim);
+        in = &d_decimated[0];
+      }
+
+      d_resamp->interpolateN(out, in, &d_offsets[0], &d_imu[0], noutput_items);
+
+      consume_each(ii * d_decim);
+      return noutput_items;
     }
 
     float
@@ -140,5 +165,26 @@ namespace gr {
       d_mu_inc = resamp_ratio;
     }
 
+    void
+    fractional_resampler_cc_impl::set_decimation(int decimation,
+                                                 const std::vector<float> &taps)
+    {
+      if(decimation < 1)
+	throw std::out_of_range("decimation must be > 0");
+      if(decimation > 1 && taps.empty())
+	throw std::invalid_argument("decimation needs low pass filter taps");
+
+      gr::thread::scoped_lock l(d_setlock);
+      d_decim = decimation;
+      if(decimation > 1)
+        d_decim_fir->set_taps(taps);
+    }
+
+    int
+    fractional_resampler_cc_impl::decimation() const
+    {
+      return d_decim;
+    }
+
   } /* namespace filter */
 } /* namespace gr */
@@ -25,6 +25,7 @@
 
 #include <gnuradio/filter/fractional_resampler_cc.h>
 #include <gnuradio/filter/mmse_fir_interpolator_cc.h>
+#include <gnuradio/filter/fir_filter.h>
 
 namespace gr {
   namespace filter {
@@ -37,6 +38,14 @@ namespace gr {
       float d_mu_inc;
       mmse_fir_interpolator_cc *d_resamp;
 
+      int d_decim;
+      kernel::fir_filter_ccf *d_decim_fir;
+      std::vector<gr_complex> d_decimated;
+
+      // input sample and interpolator step of every output of a call
+      std::vector<int> d_offsets;
+      std::vector<int> d_imu;
+
     public:
       fractional_resampler_cc_impl(float phase_shift,
                                    float resamp_ratio);
@@ -53,6 +62,8 @@ namespace gr {
       float resamp_ratio() const;
       void set_mu(float mu);
       void set_resamp_ratio(float resamp_ratio);
+      void set_decimation(int decimation, const std::vector<float> &taps);
+      int decimation() const;
     };
 
   } /* namespace filter */
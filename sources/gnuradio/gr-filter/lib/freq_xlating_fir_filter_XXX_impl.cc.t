@@ -32,10 +32,18 @@
 #include "@IMPL_NAME@.h"
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
+#include <algorithm>
+#include <math.h>
 
 namespace gr {
   namespace filter {
 
+    // Shortest filter applied by FFT, and by how much fewer operations
+    // the FFT has to need than the dot products (which are vectorized
+    // and stay in cache) to be used.
+    static const int MIN_FFT_TAPS = 64;
+    static const double FFT_ADVANTAGE = 1.5;
+
     @BASE_NAME@::sptr
     @BASE_NAME@::make(int decimation,
 		      const std::vector<@TAP_TYPE@> &taps,
@@ -58,7 +66,8 @@ namespace gr {
 			decimation),
       d_proto_taps(taps), d_center_freq(center_freq),
       d_sampling_freq(sampling_freq),
-      d_updated(false)
+      d_updated(false),
+      d_fwdfft(NULL), d_invfft(NULL), d_nsamples(0)
     {
       std::vector<gr_complex> dummy_taps;
       d_composite_fir = new kernel::@CFIR_TYPE@(decimation, dummy_taps);
@@ -75,6 +84,8 @@ namespace gr {
     @IMPL_NAME@::~@IMPL_NAME@()
     {
       delete d_composite_fir;
+      delete d_fwdfft;
+      delete d_invfft;
     }
 
     void
@@ -97,6 +108,75 @@ namespace gr {
 
       d_composite_fir->set_taps(ctaps);
       d_r.set_phase_incr(exp(gr_complex(0, -fwT0 * decimation())));
+      build_fft(ctaps);
+    }
+
+    void
+    @IMPL_NAME@::build_fft(const std::vector<gr_complex> &ctaps)
+    {
+      // Same transform size as fft_filter. Operations per output are
+      // 8 flops a tap for the dot product against two transforms, the
+      // product with the taps and the copy for every d_nsamples /
+      // decimation outputs of overlap-save.
+      int ntaps = ctaps.size();
+      int fftsize = (int)(2 * pow(2.0, ceil(log(double(ntaps)) / log(2.0))));
+      int nsamples = fftsize - ntaps + 1;
+      double fir_cost = 8.0 * ntaps;
+      double fft_cost = (10.0 * fftsize * log2(fftsize) + 8.0 * fftsize)
+        * decimation() / nsamples;
+
+      if(ntaps < MIN_FFT_TAPS || fir_cost < FFT_ADVANTAGE * fft_cost) {
+        d_nsamples = 0;
+        return;
+      }
+
+      if(d_fwdfft == NULL || d_fwdfft->inbuf_length() != fftsize) {
+        delete d_fwdfft;
+        delete d_invfft;
+        d_fwdfft = new fft::fft_complex(fftsize, true);
+        d_invfft = new fft::fft_complex(fftsize, false);
+      }
+
+      gr_complex *in = d_fwdfft->get_inbuf();
+      float scale = 1.0 / fftsize;
+      for(int i = 0; i < fftsize; i++)
+        in[i] = i < ntaps ? ctaps[i] * scale : gr_complex(0);
+      d_fwdfft->execute();
+      d_xformed_taps.assign(d_fwdfft->get_outbuf(),
+                            d_fwdfft->get_outbuf() + fftsize);
+      d_nsamples = nsamples;
+    }
+
+    /*
+     * Overlap-save on the input with its history. Every transform
+     * starts at the first sample of the next output, so that it gives
+     * d_nsamples full rate outputs and nothing is kept between calls.
+     */
+    void
+    @IMPL_NAME@::filter_fft(@O_TYPE@ *out, const @I_TYPE@ *in, int noutput_items)
+    {
+      int ntaps = d_proto_taps.size();
+      int fftsize = d_fwdfft->inbuf_length();
+      int decim = decimation();
+      int ninput = (noutput_items - 1) * decim + ntaps;
+
+      for(int i = 0; i < noutput_items; ) {
+        int start = i * decim;
+        int n = std::min(fftsize, ninput - start);
+        gr_complex *fin = d_fwdfft->get_inbuf();
+        for(int j = 0; j < n; j++)
+          fin[j] = in[start + j];
+        std::fill(fin + n, fin + fftsize, gr_complex(0));
+
+        d_fwdfft->execute();
+        volk_32fc_x2_multiply_32fc(d_invfft->get_inbuf(), d_fwdfft->get_outbuf(),
+                                   &d_xformed_taps[0], fftsize);
+        d_invfft->execute();
+
+        const gr_complex *y = d_invfft->get_outbuf() + ntaps - 1;
+        for(int j = 0; j < d_nsamples && i < noutput_items; j += decim)
+          out[i++] = y[j];
+      }
     }
 
     void
@@ -164,11 +244,15 @@ namespace gr {
 	return 0;		     // history requirements may have changed.
       }
 
-      unsigned j = 0;
-      for (int i = 0; i < noutput_items; i++){
-        out[i] = d_r.rotate(d_composite_fir->filter(&in[j]));
-        j += decimation();
-      }
+      // Both ways give the same outputs, a call too short to fill a
+      // transform uses the dot products
+      if(d_nsamples > 0 && noutput_items * (int)decimation() >= d_nsamples)
+        filter_fft(out, in, noutput_items);
+      else
+        d_composite_fir->filterNdec(out, in, noutput_items, decimation());
+
+      // the rotator keeps its phase between calls
+      d_r.rotateN(out, out, noutput_items);
 
       return noutput_items;
     }
@@ -32,6 +32,7 @@
 #include <gnuradio/filter/fir_filter.h>
 #include <gnuradio/filter/@BASE_NAME@.h>
 #include <gnuradio/blocks/rotator.h>
+#include <gnuradio/fft/fft.h>
 
 namespace gr {
   namespace filter {
@@ -46,7 +47,16 @@ namespace gr {
       double			d_sampling_freq;
       bool			d_updated;
 
+      // Overlap-save filtering of long filters; d_nsamples is the
+      // number of full rate outputs of a transform, 0 when not used.
+      fft::fft_complex	       *d_fwdfft;
+      fft::fft_complex	       *d_invfft;
+      std::vector<gr_complex>	d_xformed_taps;
+      int			d_nsamples;
+
       virtual void build_composite_fir();
+      void build_fft(const std::vector<gr_complex> &ctaps);
+      void filter_fft(@O_TYPE@ *out, const @I_TYPE@ *in, int noutput_items);
     public:
 
       @IMPL_NAME@(int decimation,
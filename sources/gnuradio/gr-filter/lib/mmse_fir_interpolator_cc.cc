@@ -28,6 +28,10 @@
 #include <gnuradio/filter/interpolator_taps.h>
 #include <stdexcept>
 
+#ifdef FILTER_SSE
+#include <xmmintrin.h>
+#endif
+
 namespace gr {
   namespace filter {
 
@@ -39,6 +43,14 @@ namespace gr {
 	std::vector<float> t (&taps[i][0], &taps[i][NTAPS]);
 	filters[i] = new kernel::fir_filter_ccf(1, t);
       }
+
+      d_taps.resize((NSTEPS + 1) * 2 * NTAPS);
+      for(int i = 0; i < NSTEPS + 1; i++) {
+	for(int j = 0; j < NTAPS; j++) {
+	  d_taps[(i * NTAPS + j) * 2] = taps[i][NTAPS - 1 - j];
+	  d_taps[(i * NTAPS + j) * 2 + 1] = taps[i][NTAPS - 1 - j];
+	}
+      }
     }
 
     mmse_fir_interpolator_cc::~mmse_fir_interpolator_cc()
@@ -73,5 +85,55 @@ namespace gr {
       return r;
     }
 
+#ifdef FILTER_SSE
+    // Sums of the products of the real parts with the even taps, of
+    // the imaginary parts with the even taps, and the same with the
+    // odd taps
+    static inline __m128
+    dot_prod_sse(const float *x, const float *h)
+    {
+      __m128 acc = _mm_mul_ps(_mm_loadu_ps(x), _mm_loadu_ps(h));
+      for(int j = 4; j < 2 * NTAPS; j += 4)
+	acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + j), _mm_loadu_ps(h + j)));
+      return acc;
+    }
+#endif
+
+    void
+    mmse_fir_interpolator_cc::interpolateN(gr_complex output[],
+					   const gr_complex input[],
+					   const int offsets[],
+					   const int imu[],
+					   int n) const
+    {
+      for(int k = 0; k < n; k++) {
+	if((imu[k] < 0) || (imu[k] > NSTEPS)) {
+	  throw std::runtime_error("mmse_fir_interpolator_cc: imu out of bounds.\n");
+	}
+      }
+
+      int k = 0;
+#ifdef FILTER_SSE
+      for(; k + 1 < n; k += 2) {
+	__m128 a = dot_prod_sse((const float*)&input[offsets[k]],
+				&d_taps[imu[k] * 2 * NTAPS]);
+	__m128 b = dot_prod_sse((const float*)&input[offsets[k + 1]],
+				&d_taps[imu[k + 1] * 2 * NTAPS]);
+
+	// real and imaginary parts of both outputs
+	__m128 r = _mm_add_ps(_mm_movelh_ps(a, b), _mm_movehl_ps(b, a));
+	_mm_storeu_ps((float*)&output[k], r);
+      }
+#endif
+      for(; k < n; k++) {
+	const gr_complex *x = &input[offsets[k]];
+	const float *h = &d_taps[imu[k] * 2 * NTAPS];
+	gr_complex r = 0;
+	for(int j = 0; j < NTAPS; j++)
+	  r += x[j] * h[2 * j];
+	output[k] = r;
+      }
+    }
+
   }  /* namespace filter */
 }  /* namespace gr */
@@ -124,5 +124,43 @@ namespace gr {
       CPPUNIT_ASSERT_THROW(t2_body(), std::invalid_argument);
     }
 
+    /*
+     * Batches of outputs at increasing offsets and all steps, against
+     * one output at a time
+     */
+    void
+    qa_mmse_fir_interpolator_cc::t3()
+    {
+      static const unsigned N = 100;
+      gr_complex input[N + 10];
+
+      for(unsigned i = 0; i < N+10; i++)
+	input[i] = test_fcn((double) i);
+
+      mmse_fir_interpolator_cc intr;
+      float inv_nsteps = 1.0 / intr.nsteps();
+
+      for(unsigned n = 1; n <= intr.nsteps() + 1; n++) {
+	std::vector<int> offsets(n), imu(n);
+	std::vector<gr_complex> actual(n);
+	for(unsigned k = 0; k < n; k++) {
+	  offsets[k] = k * N / n;
+	  imu[k] = (k * 7) % (intr.nsteps() + 1);
+	}
+
+	intr.interpolateN(&actual[0], input, &offsets[0], &imu[0], n);
+
+	for(unsigned k = 0; k < n; k++) {
+	  gr_complex expected = intr.interpolate(&input[offsets[k]], imu[k] * inv_nsteps);
+	  CPPUNIT_ASSERT_COMPLEXES_EQUAL(expected, actual[k], 1e-5);
+	}
+      }
+
+      std::vector<int> offsets(1, 0), imu(1, intr.nsteps() + 1);
+      gr_complex out;
+      CPPUNIT_ASSERT_THROW(intr.interpolateN(&out, input, &offsets[0], &imu[0], 1),
+			   std::runtime_error);
+    }
+
   } /* namespace filter */
 } /* namespace gr */
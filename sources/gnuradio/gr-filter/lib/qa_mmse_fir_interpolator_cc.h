@@ -34,12 +34,14 @@ namespace gr {
       CPPUNIT_TEST_SUITE(qa_mmse_fir_interpolator_cc);
       CPPUNIT_TEST(t1);
       // CPPUNIT_TEST(t2);
+      CPPUNIT_TEST(t3);
       CPPUNIT_TEST_SUITE_END();
 
     private:
       void t1();
       void t2();
       void t2_body();
+      void t3();
     };
 
   } /* namespace filter */
@@ -155,5 +155,36 @@ class test_fractional_resampler(gr_unittest.TestCase):
 
         self.assertComplexTuplesAlmostEqual(expected_data[-Ntest:], dst_data[-Ntest:], 3)
 
+    def test_005_cc(self):
+        N = 10000        # number of samples to use
+        fs = 1000        # baseband sampling rate
+        rrate = 10.125   # resampling rate, 1.125 after decimating
+        decim = 9
+
+        freq = 10
+        data = sig_source_c(fs, freq, 1, N)
+        taps = filter.firdes.low_pass(1, fs, fs/decim/2, fs/decim/4)
+
+        # the fused filter has no history, start it as fir_filter_ccf does
+        signal = blocks.vector_source_c((len(taps)-1)*[0,] + data)
+        op = filter.fractional_resampler_cc(0.0, rrate)
+        op.set_decimation(decim, taps)
+        snk = blocks.vector_sink_c()
+
+        ref_signal = blocks.vector_source_c(data)
+        ref_decim = filter.fir_filter_ccf(decim, taps)
+        ref_op = filter.fractional_resampler_cc(0.0, rrate/decim)
+        ref_snk = blocks.vector_sink_c()
+
+        self.tb.connect(signal, op, snk)
+        self.tb.connect(ref_signal, ref_decim, ref_op, ref_snk)
+        self.tb.run()
+
+        self.assertEqual(decim, op.decimation())
+
+        L = min(len(snk.data()), len(ref_snk.data()))
+        self.assertGreater(L, N/rrate/2)
+        self.assertComplexTuplesAlmostEqual(ref_snk.data()[:L], snk.data()[:L], 5)
+
 if __name__ == '__main__':
     gr_unittest.run(test_fractional_resampler, "test_fractional_resampler.xml")
@@ -72,6 +72,14 @@ class test_freq_xlating_filter(gr_unittest.TestCase):
         times = xrange(100)
         self.src_data = map(lambda t: cmath.exp(-2j*cmath.pi*fc/fs*(t/100.0)), times)
 
+    def generate_long_ccc_source(self):
+        self.fs = fs = 1
+        self.fc = fc = 0.3
+        self.bw = bw = 0.1
+        self.taps = filter.firdes.complex_band_pass(1, fs, -bw/2, bw/2, bw/10)
+        times = xrange(4000)
+        self.src_data = map(lambda t: cmath.exp(-2j*cmath.pi*fc/fs*(t/100.0)), times)
+
     def generate_fcf_source(self):
         self.fs = fs = 1
         self.fc = fc = 0.3
@@ -170,6 +178,38 @@ class test_freq_xlating_filter(gr_unittest.TestCase):
         result_data = dst.data()
         self.assertComplexTuplesAlmostEqual(expected_data, result_data, 5)
 
+    def test_fir_filter_ccc_003(self):
+        self.generate_long_ccc_source()
+
+        decim = 1
+        lo = sig_source_c(self.fs, -self.fc, 1, len(self.src_data))
+        despun = mix(lo, self.src_data)
+        expected_data = fir_filter(despun, self.taps, decim)
+
+        src = blocks.vector_source_c(self.src_data)
+        op  = filter.freq_xlating_fir_filter_ccc(decim, self.taps, self.fc, self.fs)
+        dst = blocks.vector_sink_c()
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        result_data = dst.data()
+        self.assertComplexTuplesAlmostEqual(expected_data, result_data, 4)
+
+    def test_fir_filter_ccc_004(self):
+        self.generate_long_ccc_source()
+
+        decim = 5
+        lo = sig_source_c(self.fs, -self.fc, 1, len(self.src_data))
+        despun = mix(lo, self.src_data)
+        expected_data = fir_filter(despun, self.taps, decim)
+
+        src = blocks.vector_source_c(self.src_data)
+        op  = filter.freq_xlating_fir_filter_ccc(decim, self.taps, self.fc, self.fs)
+        dst = blocks.vector_sink_c()
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        result_data = dst.data()
+        self.assertComplexTuplesAlmostEqual(expected_data, result_data, 4)
+
     def test_fir_filter_fcf_001(self):
         self.generate_fcf_source()
 
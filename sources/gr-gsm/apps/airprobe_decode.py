@@ -112,7 +112,7 @@ class airprobe_decoder(gr.top_block):
 
         self.cch_decoder = grgsm.control_channels_decoder()
 
-        self.socket_pdu = blocks.socket_pdu("UDP_CLIENT", "127.0.0.1", "4729", 10000, False)
+        self.gsmtap_sink = grgsm.gsmtap_sink("127.0.0.1", 4729)
         if self.verbose:
             self.message_printer = grgsm.message_printer(pmt.intern(""), True, True, False)
 
@@ -142,7 +142,7 @@ class airprobe_decoder(gr.top_block):
                 self.msg_connect(self.timeslot_filter, "out", self.bcch_demapper, "bursts")
 
             self.msg_connect(self.bcch_demapper, "bursts", self.cch_decoder, "bursts")
-            self.msg_connect(self.cch_decoder, "msgs", self.socket_pdu, "pdus")
+            self.msg_connect(self.cch_decoder, "msgs", self.gsmtap_sink, "in")
             if self.verbose:
                 self.msg_connect(self.cch_decoder, "msgs", self.message_printer, "msgs")
 
@@ -155,12 +155,12 @@ class airprobe_decoder(gr.top_block):
             if self.kc != [0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00]:
                 self.msg_connect(self.bcch_sdcch4_demapper, "bursts", self.decryption, "bursts")
                 self.msg_connect(self.decryption, "bursts", self.cch_decoder_decrypted, "bursts")
-                self.msg_connect(self.cch_decoder_decrypted, "msgs", self.socket_pdu, "pdus")
+                self.msg_connect(self.cch_decoder_decrypted, "msgs", self.gsmtap_sink, "in")
                 if self.verbose:
                     self.msg_connect(self.cch_decoder_decrypted, "msgs", self.message_printer, "msgs")
 
             self.msg_connect(self.bcch_sdcch4_demapper, "bursts", self.cch_decoder, "bursts")
-            self.msg_connect(self.cch_decoder, "msgs", self.socket_pdu, "pdus")
+            self.msg_connect(self.cch_decoder, "msgs", self.gsmtap_sink, "in")
             if self.verbose:
                 self.msg_connect(self.cch_decoder, "msgs", self.message_printer, "msgs")
 
@@ -173,12 +173,12 @@ class airprobe_decoder(gr.top_block):
             if self.kc != [0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00]:
                 self.msg_connect(self.sdcch8_demapper, "bursts", self.decryption, "bursts")
                 self.msg_connect(self.decryption, "bursts", self.cch_decoder_decrypted, "bursts")
-                self.msg_connect(self.cch_decoder_decrypted, "msgs", self.socket_pdu, "pdus")
+                self.msg_connect(self.cch_decoder_decrypted, "msgs", self.gsmtap_sink, "in")
                 if self.verbose:
                     self.msg_connect(self.cch_decoder_decrypted, "msgs", self.message_printer, "msgs")
 
             self.msg_connect(self.sdcch8_demapper, "bursts", self.cch_decoder, "bursts")
-            self.msg_connect(self.cch_decoder, "msgs", self.socket_pdu, "pdus")
+            self.msg_connect(self.cch_decoder, "msgs", self.gsmtap_sink, "in")
             if self.verbose:
                 self.msg_connect(self.cch_decoder, "msgs", self.message_printer, "msgs")
 
@@ -194,8 +194,8 @@ class airprobe_decoder(gr.top_block):
                 self.msg_connect(self.tch_f_demapper, "acch_bursts", self.cch_decoder, "bursts")
                 self.msg_connect(self.tch_f_demapper, "tch_bursts", self.tch_f_decoder, "bursts")
 
-            self.msg_connect(self.tch_f_decoder, "msgs", self.socket_pdu, "pdus")
-            self.msg_connect(self.cch_decoder, "msgs", self.socket_pdu, "pdus")
+            self.msg_connect(self.tch_f_decoder, "msgs", self.gsmtap_sink, "in")
+            self.msg_connect(self.cch_decoder, "msgs", self.gsmtap_sink, "in")
             if self.verbose:
                 self.msg_connect(self.tch_f_decoder, "msgs", self.message_printer, "msgs")
                 self.msg_connect(self.cch_decoder, "msgs", self.message_printer, "msgs")
@@ -0,0 +1,52 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# @file
+# @section LICENSE
+#
+# Gr-gsm is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# Gr-gsm is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with gr-gsm; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+#
+
+from optparse import OptionParser
+
+import grgsm
+import sys
+
+CONTAINER_MAGIC = "GRGSMBST"
+
+
+def is_container(filename):
+    with open(filename, "rb") as f:
+        return f.read(len(CONTAINER_MAGIC)) == CONTAINER_MAGIC
+
+
+if __name__ == '__main__':
+    parser = OptionParser(usage="%prog: [options] input_file output_file",
+                          description="Converts a file of bursts written by the burst file sink to an "
+                                      "indexed burst container or a burst container back to serialized "
+                                      "messages. The direction is chosen by the format of the input file.")
+    (options, args) = parser.parse_args()
+
+    if len(args) != 2:
+        parser.error("Input and output files are required")
+
+    input_file, output_file = args
+    if is_container(input_file):
+        bursts_num = grgsm.container_to_burst_file(input_file, output_file)
+        print "Converted %d bursts to serialized messages" % bursts_num
+    else:
+        bursts_num = grgsm.burst_file_to_container(input_file, output_file)
+        print "Converted %d bursts to a burst container" % bursts_num
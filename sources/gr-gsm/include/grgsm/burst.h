@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef INCLUDED_GSM_BURST_H
+#define INCLUDED_GSM_BURST_H
+
+#include <grgsm/api.h>
+#include <grgsm/gsmtap.h>
+#include <pmt/pmt.h>
+#include <stdint.h>
+
+namespace gr {
+  namespace gsm {
+
+    /*!
+     * \brief Read-only view of a GSM burst message
+     * \ingroup gsm
+     *
+     * Bursts are passed between blocks as PDUs: a pair of nil metadata
+     * and a blob holding the GSMTAP header followed by the bits, so that Python, message_debug, socket_pdu and burst files see
+     * them as they always did. make() takes the pair and the blob from
+     * the pools of pmt::cons_pooled and pmt::make_blob_pooled, so
+     * publishing a burst costs no heap allocation.
+     *
+     * A burst object keeps a reference to its message and gives const
+     * access to the header and the bits inside the blob, without copying
+     * them. Messages may be shared by several blocks, so a block that
+     * changes the header or the bits copies them and makes a new message.
+     *
+     * Bits are either hard (0 or 1) or soft, if the burst is marked
+     * with SOFT_BITS in the reserved byte of the GSMTAP header. Soft bits
+     * follow the sbit_t convention of libosmocore: -127 is a sure 1,
+     * 127 is a sure 0 and 0 means that nothing is known about the bit.
+     * The mark is kept in the header so that it survives burst files.
+     */
+    class GSM_API burst
+    {
+     public:
+      static const unsigned int SIZE = 148; ///< number of bits of a burst
+      static const uint8_t SOFT_BITS = 0x01; ///< mark of soft bursts in header.res
+
+      /*!
+       * \brief An empty view, to be assigned a burst later.
+       */
+      burst();
+
+      /*!
+       * \brief View of the burst carried by \p msg.
+       *
+       * A message with less than SIZE bits is copied to a new message
+       * padded with zero bits. Throws pmt::wrong_type if \p msg is not
+       * a PDU with a blob holding at least the GSMTAP header.
+       */
+      explicit burst(const pmt::pmt_t & msg);
+
+      const gsmtap_hdr & header() const
+      {
+        return *d_header;
+      }
+
+      const int8_t * bits() const
+      {
+        return d_bits;
+      }
+
+      /*!
+       * \brief The message the burst is carried by.
+       */
+      const pmt::pmt_t & message() const
+      {
+        return d_msg;
+      }
+
+      /*!
+       * \brief Returns true if the bits are soft bits.
+       */
+      bool is_soft() const
+      {
+        return d_header->res & SOFT_BITS;
+      }
+
+      /*!
+       * \brief Returns bit \p ii as 0 or 1, whatever the format of the burst.
+       */
+      uint8_t hard_bit(unsigned int ii) const
+      {
+        return is_soft() ? d_bits[ii] < 0 : d_bits[ii];
+      }
+
+      /*!
+       * \brief Returns bit \p ii as a soft bit - hard bits are sure ones.
+       */
+      int8_t soft_bit(unsigned int ii) const
+      {
+        return is_soft() ? d_bits[ii] : (d_bits[ii] ? -127 : 127);
+      }
+
+      /*!
+       * \brief Returns all bits as 0 or 1.
+       *
+       * Bits of a hard burst are returned as they are, soft bits are
+       * sliced into \p buf, which has to have room for SIZE bits.
+       */
+      const int8_t * hard_bits(int8_t * buf) const;
+
+      /*!
+       * \brief Makes a burst message of \p header and SIZE \p bits.
+       */
+      static pmt::pmt_t make(const gsmtap_hdr & header, const int8_t * bits);
+
+     private:
+      pmt::pmt_t d_msg;
+      const gsmtap_hdr * d_header;
+      const int8_t * d_bits;
+    };
+
+  } // namespace gsm
+} // namespace gr
+
+#endif /* INCLUDED_GSM_BURST_H */
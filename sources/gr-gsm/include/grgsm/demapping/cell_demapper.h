@@ -0,0 +1,82 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_GSM_CELL_DEMAPPER_H
+#define INCLUDED_GSM_CELL_DEMAPPER_H
+
+#include <grgsm/api.h>
+#include <gnuradio/block.h>
+#include <vector>
+
+namespace gr {
+  namespace gsm {
+
+    /*!
+     * Channel combinations of a timeslot (GSM 05.02, section 6.4.1)
+     */
+    enum timeslot_config
+    {
+        TS_UNUSED = 0,              ///< bursts of the timeslot are dropped
+        TS_BCCH_CCCH = 1,           ///< combination iv: FCCH + SCH + BCCH + CCCH
+        TS_BCCH_CCCH_SDCCH4 = 2,    ///< combination v: FCCH + SCH + BCCH + CCCH + SDCCH/4 + SACCH/C4
+        TS_SDCCH8 = 3,              ///< combination vii: SDCCH/8 + SACCH/C8
+        TS_TCH_F = 4                ///< combination i: TCH/F + FACCH/F + SACCH/TF
+    };
+
+    /*!
+     * \brief Demapper of all logical channels of a cell
+     * \ingroup gsm
+     *
+     * Replaces a timeslot filter/splitter followed by one demapper per
+     * timeslot. The position of every burst in the multiframe of its
+     * timeslot is looked up in a table computed from the channel
+     * combinations when the block is made, and the burst is stored in
+     * the buffer of the block of the logical channel it belongs to. When
+     * a block is complete, its bursts are published one after another -
+     * blocks of 4 bursts of all control channels (including SACCH/TF) on
+     * "bursts" and blocks of 8 diagonally interleaved bursts of TCH/F on
+     * "tch_bursts". Header fields sub_type and sub_slot of the published
+     * bursts identify the logical channel.
+     */
+    class GSM_API cell_demapper : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<cell_demapper> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of gsm::cell_demapper.
+       *
+       * To avoid accidental use of raw pointers, gsm::cell_demapper's
+       * constructor is in a private implementation
+       * class. gsm::cell_demapper::make is the public interface for
+       * creating new instances.
+       *
+       * \param timeslot_configs timeslot_config of timeslots 0 to 7,
+       *        missing ones are TS_UNUSED
+       */
+      static sptr make(const std::vector<int> &timeslot_configs);
+    };
+
+  } // namespace gsm
+} // namespace gr
+
+#endif /* INCLUDED_GSM_CELL_DEMAPPER_H */
@@ -0,0 +1,234 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef INCLUDED_GSM_BURST_CONTAINER_H
+#define INCLUDED_GSM_BURST_CONTAINER_H
+
+#include <grgsm/api.h>
+#include <grgsm/burst.h>
+#include <boost/noncopyable.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+
+namespace gr {
+  namespace gsm {
+
+    /*!
+     * \brief Indexed burst capture file
+     * \ingroup gsm
+     *
+     * A file of bursts with fixed-size records, which can be memory
+     * mapped and searched by frame number. It consists of:
+     *  - a header (burst_container::file_header),
+     *  - records of all bursts in the order they were written - each one
+     *    is the burst (GSMTAP header and bits) preceded by its frame
+     *    number,
+     *  - the index: a list of streams (bursts of one ARFCN and timeslot)
+     *    and for every stream the numbers of its records, 64 bits each.
+     *
+     * Frame numbers of the records are unwrapped by frame_unwrapper for
+     * the whole file - they keep growing after the end of a hyperframe,
+     * so that a capture of many hours can be searched too. Before the
+     * first wrap they are equal to the frame numbers from the GSMTAP
+     * headers.
+     *
+     * The index is written when the file is closed. A file without it
+     * (e.g. of an interrupted capture) or with an index which doesn't fit
+     * in the file is still readable - the reader rebuilds the index from
+     * the records. Numbers in the header and the index are in the byte
+     * order of the machine which wrote the file.
+     */
+    class GSM_API burst_container
+    {
+     public:
+      static const char MAGIC[8];
+      static const uint32_t VERSION = 2;
+      static const uint32_t HYPERFRAME = 26 * 51 * 2048;
+
+      struct file_header
+      {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t records_num;
+        uint64_t index_offset;     ///< 0 if there is no index
+        uint32_t streams_num;
+        uint32_t reserved[7];
+      };
+
+      struct record
+      {
+        uint32_t frame;            ///< unwrapped frame number
+        gsmtap_hdr header;
+        int8_t bits[burst::SIZE];
+      };
+
+      struct stream
+      {
+        uint16_t arfcn;            ///< as in the GSMTAP header (host order), with the uplink flag
+        uint8_t timeslot;
+        uint8_t reserved[5];
+        uint64_t records_num;
+        uint64_t first_entry;      ///< position of the first record number of the stream in the index
+      };
+
+      /*!
+       * \brief Returns true if \p filename is a burst container.
+       */
+      static bool is_container(const std::string & filename);
+    };
+
+    /*!
+     * \brief Unwraps GSMTAP frame numbers of a sequence of bursts.
+     * \ingroup gsm
+     *
+     * Wraps of the hyperframe are counted for the whole sequence, so the
+     * bursts of all ARFCNs and timeslots get comparable numbers. Bursts
+     * of different streams may come slightly out of order - one which
+     * comes after a wrap but belongs before it is kept before it.
+     */
+    class GSM_API frame_unwrapper
+    {
+     private:
+      bool d_started;
+      uint32_t d_last_fn;
+      uint32_t d_wraps;
+
+     public:
+      frame_unwrapper() : d_started(false), d_last_fn(0), d_wraps(0) {}
+
+      uint32_t unwrap(uint32_t fn);
+    };
+
+    /*!
+     * \brief Writes bursts to a burst container.
+     * \ingroup gsm
+     *
+     * Bursts appended after close() go to the same container: the file
+     * is opened again, its index is dropped and written anew, with the
+     * new bursts, at the next close().
+     */
+    class GSM_API burst_container_writer : boost::noncopyable
+    {
+     private:
+      std::string d_filename;
+      FILE * d_file;
+      uint64_t d_records_num;
+      frame_unwrapper d_unwrapper;
+      std::map<uint32_t, std::vector<uint64_t> > d_streams;
+
+      void open(const char * mode);
+      void write_header(uint64_t index_offset);
+
+     public:
+      /*!
+       * \brief Creates \p filename, throws std::runtime_error if it fails.
+       */
+      burst_container_writer(const std::string & filename);
+      ~burst_container_writer();
+
+      void append(const burst & b);
+
+      /*!
+       * \brief Writes the index and closes the file.
+       */
+      void close();
+    };
+
+    /*!
+     * \brief Reads a memory mapped burst container.
+     * \ingroup gsm
+     *
+     * Records are accessed directly in the mapped file. Records of a range
+     * of frame numbers are between lower_bound() and upper_bound(), mixed
+     * with the records of other frames only if the bursts were written out
+     * of order.
+     */
+    class GSM_API burst_container_reader : boost::noncopyable
+    {
+     private:
+      const uint8_t * d_data;
+      size_t d_size;
+      const burst_container::record * d_records;
+      uint64_t d_records_num;
+      const burst_container::stream * d_streams;
+      uint32_t d_streams_num;
+      const uint64_t * d_entries;
+      std::vector<burst_container::stream> d_rebuilt_streams;
+      std::vector<uint64_t> d_rebuilt_entries;
+
+      bool index_is_valid(const burst_container::file_header * header) const;
+      void rebuild_index();
+
+     public:
+      /*!
+       * \brief Maps \p filename, throws std::runtime_error if it isn't
+       * a burst container.
+       */
+      burst_container_reader(const std::string & filename);
+      ~burst_container_reader();
+
+      uint64_t records_num() const { return d_records_num; }
+      const burst_container::record & at(uint64_t ii) const { return d_records[ii]; }
+
+      uint32_t streams_num() const { return d_streams_num; }
+      const burst_container::stream & get_stream(uint32_t ii) const { return d_streams[ii]; }
+
+      /*!
+       * \brief Returns record numbers of the bursts of stream \p ii.
+       */
+      const uint64_t * stream_records(uint32_t ii) const { return d_entries + d_streams[ii].first_entry; }
+
+      /*!
+       * \brief Returns the first record of a burst with frame number
+       * greater or equal to \p frame, in any stream.
+       */
+      uint64_t lower_bound(uint32_t frame) const;
+
+      /*!
+       * \brief Returns the position after the last record of a burst
+       * with frame number less or equal to \p frame, in any stream.
+       */
+      uint64_t upper_bound(uint32_t frame) const;
+    };
+
+    /*!
+     * \brief Converts a file of serialized burst messages (written by
+     * burst_file_sink) to a burst container.
+     * \return number of bursts
+     */
+    GSM_API uint64_t burst_file_to_container(const std::string & burst_filename, const std::string & container_filename);
+
+    /*!
+     * \brief Converts a burst container to a file of serialized burst
+     * messages.
+     * \return number of bursts
+     */
+    GSM_API uint64_t container_to_burst_file(const std::string & container_filename, const std::string & burst_filename);
+
+  } // namespace gsm
+} // namespace gr
+
+#endif /* INCLUDED_GSM_BURST_CONTAINER_H */
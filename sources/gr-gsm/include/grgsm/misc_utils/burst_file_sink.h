@@ -30,9 +30,14 @@ namespace gr {
   namespace gsm {
 
     /*!
-     * \brief <+description of block+>
+     * \brief Writes bursts to a file
      * \ingroup gsm
      *
+     * Bursts are written either as serialized messages or, if \p indexed
+     * is true, to a burst container (see gr::gsm::burst_container), which
+     * can be searched by frame number. The index of the container is
+     * written when the flowgraph stops. If it is started again, bursts
+     * are appended to the same file in both formats.
      */
     class GSM_API burst_file_sink : virtual public gr::block
     {
@@ -47,7 +52,7 @@ namespace gr {
        * class. grgsm::burst_file_sink::make is the public interface for
        * creating new instances.
        */
-      static sptr make(const std::string &filename);
+      static sptr make(const std::string &filename, bool indexed=false);
     };
   } // namespace gsm
 } // namespace gr
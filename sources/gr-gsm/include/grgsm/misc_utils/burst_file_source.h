@@ -30,9 +30,18 @@ namespace gr {
   namespace gsm {
 
     /*!
-     * \brief <+description of block+>
+     * \brief Reads bursts from a file
      * \ingroup gsm
      *
+     * The file is either a file of serialized messages or a burst
+     * container - the format is recognized automatically. Only bursts
+     * with frame numbers from \p first_frame to \p last_frame are
+     * published. In both formats these are frame numbers unwrapped for
+     * the whole file (see gr::gsm::frame_unwrapper): before the first
+     * wrap of the hyperframe they are the frame numbers of the GSMTAP
+     * headers, after it they keep growing. A burst container is searched
+     * with its index, the other files are read from the beginning to the
+     * end.
      */
     class GSM_API burst_file_source : virtual public gr::block
     {
@@ -47,7 +56,7 @@ namespace gr {
        * class. grgsm::burst_file_source::make is the public interface for
        * creating new instances.
        */
-      static sptr make(const std::string &filename);
+      static sptr make(const std::string &filename, unsigned int first_frame=0, unsigned int last_frame=0xffffffff);
     };
 
   } // namespace gsm
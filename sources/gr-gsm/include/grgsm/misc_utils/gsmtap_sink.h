@@ -0,0 +1,82 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_GSMTAP_SINK_H
+#define INCLUDED_GSM_GSMTAP_SINK_H
+
+#include <grgsm/api.h>
+#include <gnuradio/block.h>
+#include <string>
+
+namespace gr {
+  namespace gsm {
+
+    /*!
+     * \brief Sends GSMTAP datagrams of messages and bursts over UDP
+     * \ingroup gsm
+     *
+     * Replaces a socket_pdu in UDP_CLIENT mode for GSMTAP. Messages
+     * and bursts (PDUs with a blob of the GSMTAP header followed by the
+     * payload or the bits) are sent as they are, one datagram straight
+     * from the blob of each message. All messages queued on "in" are
+     * sent with one sendmmsg() call where it is available.
+     *
+     * With a pcap file name, the datagrams are also written to the file
+     * as IPv4/UDP packets (LINKTYPE_RAW), which Wireshark decodes as
+     * GSMTAP. Packets are collected in a large buffer, which is written
+     * when it is full and when the flowgraph stops.
+     */
+    class GSM_API gsmtap_sink : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<gsmtap_sink> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of gsm::gsmtap_sink.
+       *
+       * To avoid accidental use of raw pointers, gsm::gsmtap_sink's
+       * constructor is in a private implementation
+       * class. gsm::gsmtap_sink::make is the public interface for
+       * creating new instances.
+       *
+       * \param host destination host name or address
+       * \param port destination UDP port
+       * \param pcap_filename file to write the datagrams to as well,
+       *        none if empty
+       */
+      static sptr make(const std::string &host = "127.0.0.1", int port = 4729,
+                       const std::string &pcap_filename = "");
+
+      /*!
+       * \brief Number of datagrams sent.
+       */
+      virtual unsigned long sent() const = 0;
+
+      /*!
+       * \brief Number of datagrams that could not be sent.
+       */
+      virtual unsigned long send_errors() const = 0;
+    };
+
+  } // namespace gsm
+} // namespace gr
+
+#endif /* INCLUDED_GSM_GSMTAP_SINK_H */
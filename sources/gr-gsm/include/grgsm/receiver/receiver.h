@@ -50,11 +50,37 @@ namespace gr {
        * constructor is in a private implementation
        * class. gsm::receiver::make is the public interface for
        * creating new instances.
+       *
+       * \param osr oversampling ratio
+       * \param cell_allocation ARFCNs of the inputs, the first one is C0
+       * \param seq_nums training sequence numbers of carriers other than C0
+       * \param burst_workers number of threads detecting bursts of carriers
+       *        other than C0 - 0 means that all bursts are detected in the
+       *        block's thread
+       * \param soft_bits publish soft bits (see gr::gsm::burst) instead of
+       *        hard ones
        */
-      static sptr make(int osr, const std::vector<int> &cell_allocation, const std::vector<int> &seq_nums);
+      static sptr make(int osr, const std::vector<int> &cell_allocation, const std::vector<int> &seq_nums, int burst_workers=0, bool soft_bits=false);
       
       virtual void set_cell_allocation(const std::vector<int> &cell_allocation) = 0;
       virtual void set_tseq_nums(const std::vector<int> & tseq_nums) = 0;
+
+      /*!
+       * \brief Follows a hopping channel
+       *
+       * Bursts of carriers other than C0 are detected only in the given
+       * timeslots and only on the carrier used by the channel in the given
+       * frame, computed from the hopping sequence (GSM 05.02, 6.2.3). This
+       * makes the cx_channel_hopper block unnecessary and saves detection
+       * of bursts which would be thrown away by it.
+       *
+       * \param ma ARFCNs of the mobile allocation, they have to be in
+       *        the cell allocation - an empty one receives all carriers
+       * \param maio mobile allocation index offset
+       * \param hsn hopping sequence number
+       * \param timeslot_mask timeslots of the channel, bit n is timeslot n
+       */
+      virtual void set_hopping(const std::vector<int> &ma, int maio, int hsn, int timeslot_mask=0xff) = 0;
       virtual void reset() = 0;
     };
    
@@ -0,0 +1,69 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_WIDEBAND_CHANNELIZER_SC16_H
+#define INCLUDED_GSM_WIDEBAND_CHANNELIZER_SC16_H
+
+#include <grgsm/api.h>
+#include <gnuradio/block.h>
+#include <vector>
+
+namespace gr {
+  namespace gsm {
+
+    /*!
+     * \brief Extracts GSM carriers from a wideband signal of interleaved int16 IQ
+     * \ingroup gsm
+     *
+     * Same as wideband_channelizer_cc, for sources giving complex int16
+     * samples (osmosdr with format=sc16), full scale being 1.0. The
+     * input is converted as it enters the filter bank, so the wideband
+     * stream takes half the memory bandwidth of complex floats.
+     */
+    class GSM_API wideband_channelizer_sc16 : virtual public gr::block
+    {
+     public:
+      typedef boost::shared_ptr<wideband_channelizer_sc16> sptr;
+
+      /*!
+       * \brief Return a shared_ptr to a new instance of gsm::wideband_channelizer_sc16.
+       *
+       * \param samp_rate_in sample rate of the input
+       * \param fc center frequency of the input
+       * \param channel_freqs downlink (or uplink) frequencies of the carriers
+       * \param osr oversampling ratio of the outputs
+       * \param ppm clock offset
+       */
+      static sptr make(double samp_rate_in, double fc, const std::vector<double> &channel_freqs, int osr=4, double ppm=0);
+
+      virtual void set_ppm(double ppm) = 0;
+      virtual double ppm() const = 0;
+
+      //! Changing these restarts the filters
+      virtual void set_fc(double fc) = 0;
+      virtual void set_samp_rate_in(double samp_rate_in) = 0;
+      virtual void set_osr(int osr) = 0;
+    };
+
+  } // namespace gsm
+} // namespace gr
+
+#endif /* INCLUDED_GSM_WIDEBAND_CHANNELIZER_SC16_H */
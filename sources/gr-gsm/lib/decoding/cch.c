@@ -272,6 +272,108 @@ int conv_decode(unsigned char *output, unsigned char *data) {
 }
 
 
+/*
+ * Soft-decision Viterbi decoding.
+ *
+ * Input bits are soft bits (-127 is a sure 1, 127 is a sure 0). The
+ * distance of a transition is the sum of the magnitudes of the received
+ * soft bits which disagree with its output bits, so it's the same trellis
+ * as above with weighted errors.
+ */
+#define MAX_SOFT_ERROR	(127 * CONV_SIZE + 1)
+
+
+static inline unsigned int soft_distance(signed char s, unsigned int bit) {
+
+	if(bit)
+		return (s > 0) ? s : 0;
+	return (s < 0) ? -s : 0;
+}
+
+
+int conv_decode_soft(unsigned char *output, const signed char *data) {
+
+	int i, t;
+	unsigned int state, nstate, b, o, distance, accumulated_error,
+	   min_state, min_error, cur_state;
+
+	unsigned int ae[1 << (K - 1)]; // accumulated error
+	unsigned int nae[1 << (K - 1)]; // next accumulated error
+	unsigned int state_history[1 << (K - 1)][CONV_INPUT_SIZE + 1];
+
+	// initialize accumulated error, assume starting state is 0
+	for(i = 0; i < (1 << (K - 1)); i++){
+		ae[i] = nae[i] = MAX_SOFT_ERROR;
+	}
+
+	ae[0] = 0;
+
+	// build trellis
+	for(t = 0; t < CONV_INPUT_SIZE; t++) {
+
+		// for each state
+		for(state = 0; state < (1 << (K - 1)); state++) {
+
+			// make sure this state is possible
+			if(ae[state] >= MAX_SOFT_ERROR)
+				continue;
+
+			// find all states we lead to
+			for(b = 0; b < 2; b++) {
+
+				// get next state given input bit b
+				nstate = next_state[state][b];
+
+				// find output for this transition
+				o = encode[state][b];
+
+				// calculate distance from received data
+				distance = soft_distance(data[2 * t], o & 2) +
+				   soft_distance(data[2 * t + 1], o & 1);
+
+				// choose surviving path
+				accumulated_error = ae[state] + distance;
+				if(accumulated_error < nae[nstate]) {
+
+					// save error for surviving state
+					nae[nstate] = accumulated_error;
+
+					// update state history
+					state_history[nstate][t + 1] = state;
+				}
+			}
+		}
+
+		// get accumulated error ready for next time slice
+		for(i = 0; i < (1 << (K - 1)); i++) {
+			ae[i] = nae[i];
+			nae[i] = MAX_SOFT_ERROR;
+		}
+	}
+
+	// the final state is the state with the smallest error
+	min_state = (unsigned int)-1;
+	min_error = MAX_SOFT_ERROR;
+	for(i = 0; i < (1 << (K - 1)); i++) {
+		if(ae[i] < min_error) {
+			min_state = i;
+			min_error = ae[i];
+		}
+	}
+
+	// trace the path
+	cur_state = min_state;
+	for(t = CONV_INPUT_SIZE; t >= 1; t--) {
+		min_state = cur_state;
+		cur_state = state_history[cur_state][t]; // get previous
+		output[t - 1] = prev_next_state[cur_state][min_state];
+	}
+
+	// return the weighted error of the decoded path
+	return min_error;
+}
+
+
 /*
  * GSM SACCH interleaving and burst mapping
  *
@@ -50,6 +50,7 @@ extern "C" {
 #define eBLOCK_SIZE		(iBLOCK_SIZE + 2)
 
 int conv_decode(unsigned char *output, unsigned char *data);
+int conv_decode_soft(unsigned char *output, const signed char *data);
 int parity_check(unsigned char *d);
 //unsigned char *decode_cch(GS_CTX *ctx, unsigned char *burst, unsigned int *len);
 //unsigned char *decode_facch(GS_CTX *ctx, unsigned char *burst, unsigned int *len, int offset);
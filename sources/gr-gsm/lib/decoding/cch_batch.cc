@@ -0,0 +1,272 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "cch_batch.h"
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define CONV_BATCH_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#define STATES_NUM (1 << 4)
+#define MAX_ERROR  (2 * CONV_INPUT_SIZE + 1)
+
+static void conv_decode_batch_generic(unsigned char * const * output, const unsigned char * const * data, int * errors, unsigned int blocks_num)
+{
+   for(unsigned int n=0; n<blocks_num; n++){
+      errors[n] = conv_decode(output[n], const_cast<unsigned char *>(data[n]));
+   }
+}
+
+#ifdef CONV_BATCH_HAVE_X86
+/*
+* Trellis of the code seen from the next state: state s is reached from
+* states 2*(s&7) and 2*(s&7)+1 with input bit s>>3. The outputs of the two
+* transitions are complementary, branch_output[s] is the output of the
+* transition from the first (even) predecessor - encode[2*(s&7)][s>>3] of
+* cch.c.
+*/
+static const unsigned int branch_output[STATES_NUM] = {
+   0, 3, 0, 3, 1, 2, 1, 2,
+   3, 0, 3, 0, 2, 1, 2, 1
+};
+
+/*
+* Lane-major copy of the received bits of a pass: rx[t][0][lane] and
+* rx[t][1][lane] are the two coded bits of step t.
+*/
+template<unsigned int LANES>
+static void gather_lanes(uint16_t (* rx)[2][LANES], const unsigned char * const * data, unsigned int blocks_num)
+{
+   for(unsigned int lane=0; lane<LANES; lane++){
+      if(lane < blocks_num){
+         const unsigned char * d = data[lane];
+         for(unsigned int t=0; t<CONV_INPUT_SIZE; t++){
+            rx[t][0][lane] = d[2 * t];
+            rx[t][1][lane] = d[2 * t + 1];
+         }
+      } else {
+         for(unsigned int t=0; t<CONV_INPUT_SIZE; t++){
+            rx[t][0][lane] = rx[t][1][lane] = 0;
+         }
+      }
+   }
+}
+
+/*
+* Choice of the final state and traceback of every lane. history[t][lane]
+* has bit s set if state s was reached from its odd predecessor at step t.
+*/
+template<unsigned int LANES>
+static void traceback_lanes(unsigned char * const * output, int * errors, unsigned int blocks_num,
+                            const uint16_t (* metrics)[LANES], const uint16_t (* history)[LANES])
+{
+   for(unsigned int lane=0; lane<LANES && lane<blocks_num; lane++){
+      unsigned int min_state = 0;
+      unsigned int min_error = metrics[0][lane];
+      for(unsigned int s=1; s<STATES_NUM; s++){
+         if(metrics[s][lane] < min_error){
+            min_state = s;
+            min_error = metrics[s][lane];
+         }
+      }
+
+      unsigned int state = min_state;
+      for(int t=CONV_INPUT_SIZE-1; t>=0; t--){
+         output[lane][t] = state >> 3;
+         state = 2 * (state & 7) + ((history[t][lane] >> state) & 1);
+      }
+      errors[lane] = min_error;
+   }
+}
+
+#define SSE2_LANES 8
+
+__attribute__((target("sse2")))
+static void conv_decode_batch_sse2(unsigned char * const * output, const unsigned char * const * data, int * errors, unsigned int blocks_num)
+{
+   uint16_t rx[CONV_INPUT_SIZE][2][SSE2_LANES] __attribute__((aligned(16)));
+   uint16_t history[CONV_INPUT_SIZE][SSE2_LANES] __attribute__((aligned(16)));
+   uint16_t metrics[STATES_NUM][SSE2_LANES] __attribute__((aligned(16)));
+   const __m128i two = _mm_set1_epi16(2);
+
+   for(unsigned int first=0; first<blocks_num; first+=SSE2_LANES){
+      unsigned int num = blocks_num - first;
+      __m128i pm[STATES_NUM];
+
+      gather_lanes<SSE2_LANES>(rx, data + first, num);
+
+      //the starting state is 0
+      pm[0] = _mm_setzero_si128();
+      for(unsigned int s=1; s<STATES_NUM; s++){
+         pm[s] = _mm_set1_epi16(MAX_ERROR);
+      }
+
+      for(unsigned int t=0; t<CONV_INPUT_SIZE; t++){
+         __m128i r0 = _mm_load_si128((const __m128i *)rx[t][0]);
+         __m128i r1 = _mm_load_si128((const __m128i *)rx[t][1]);
+         __m128i distance[4], next[STATES_NUM], decisions = _mm_setzero_si128();
+
+         //Hamming distances of the received bits from outputs 0..3
+         distance[0] = _mm_add_epi16(r0, r1);
+         distance[1] = _mm_sub_epi16(_mm_add_epi16(r0, _mm_set1_epi16(1)), r1);
+         distance[2] = _mm_sub_epi16(two, distance[1]);
+         distance[3] = _mm_sub_epi16(two, distance[0]);
+
+         for(unsigned int s=0; s<STATES_NUM; s++){
+            unsigned int o = branch_output[s];
+            __m128i pm0 = _mm_add_epi16(pm[2 * (s & 7)], distance[o]);
+            __m128i pm1 = _mm_add_epi16(pm[2 * (s & 7) + 1], distance[o ^ 3]);
+            //the odd predecessor survives only if it's strictly better
+            __m128i odd = _mm_cmplt_epi16(pm1, pm0);
+            next[s] = _mm_min_epi16(pm0, pm1);
+            decisions = _mm_or_si128(decisions, _mm_and_si128(odd, _mm_set1_epi16((short)(1 << s))));
+         }
+         _mm_store_si128((__m128i *)history[t], decisions);
+         for(unsigned int s=0; s<STATES_NUM; s++){
+            pm[s] = next[s];
+         }
+      }
+
+      for(unsigned int s=0; s<STATES_NUM; s++){
+         _mm_store_si128((__m128i *)metrics[s], pm[s]);
+      }
+      traceback_lanes<SSE2_LANES>(output + first, errors + first, num, metrics, history);
+   }
+}
+
+#define AVX2_LANES 16
+
+__attribute__((target("avx2")))
+static void conv_decode_batch_avx2(unsigned char * const * output, const unsigned char * const * data, int * errors, unsigned int blocks_num)
+{
+   uint16_t rx[CONV_INPUT_SIZE][2][AVX2_LANES] __attribute__((aligned(32)));
+   uint16_t history[CONV_INPUT_SIZE][AVX2_LANES] __attribute__((aligned(32)));
+   uint16_t metrics[STATES_NUM][AVX2_LANES] __attribute__((aligned(32)));
+   const __m256i two = _mm256_set1_epi16(2);
+
+   for(unsigned int first=0; first<blocks_num; first+=AVX2_LANES){
+      unsigned int num = blocks_num - first;
+      __m256i pm[STATES_NUM];
+
+      gather_lanes<AVX2_LANES>(rx, data + first, num);
+
+      pm[0] = _mm256_setzero_si256();
+      for(unsigned int s=1; s<STATES_NUM; s++){
+         pm[s] = _mm256_set1_epi16(MAX_ERROR);
+      }
+
+      for(unsigned int t=0; t<CONV_INPUT_SIZE; t++){
+         __m256i r0 = _mm256_load_si256((const __m256i *)rx[t][0]);
+         __m256i r1 = _mm256_load_si256((const __m256i *)rx[t][1]);
+         __m256i distance[4], next[STATES_NUM], decisions = _mm256_setzero_si256();
+
+         distance[0] = _mm256_add_epi16(r0, r1);
+         distance[1] = _mm256_sub_epi16(_mm256_add_epi16(r0, _mm256_set1_epi16(1)), r1);
+         distance[2] = _mm256_sub_epi16(two, distance[1]);
+         distance[3] = _mm256_sub_epi16(two, distance[0]);
+
+         for(unsigned int s=0; s<STATES_NUM; s++){
+            unsigned int o = branch_output[s];
+            __m256i pm0 = _mm256_add_epi16(pm[2 * (s & 7)], distance[o]);
+            __m256i pm1 = _mm256_add_epi16(pm[2 * (s & 7) + 1], distance[o ^ 3]);
+            __m256i odd = _mm256_cmpgt_epi16(pm0, pm1);
+            next[s] = _mm256_min_epi16(pm0, pm1);
+            decisions = _mm256_or_si256(decisions, _mm256_and_si256(odd, _mm256_set1_epi16((short)(1 << s))));
+         }
+         _mm256_store_si256((__m256i *)history[t], decisions);
+         for(unsigned int s=0; s<STATES_NUM; s++){
+            pm[s] = next[s];
+         }
+      }
+
+      for(unsigned int s=0; s<STATES_NUM; s++){
+         _mm256_store_si256((__m256i *)metrics[s], pm[s]);
+      }
+      traceback_lanes<AVX2_LANES>(output + first, errors + first, num, metrics, history);
+   }
+}
+#endif /* CONV_BATCH_HAVE_X86 */
+
+/*
+* Table of kernels supported by the running CPU - it's filled once,
+* on the first use.
+*/
+namespace {
+  struct conv_decode_batch_table
+  {
+    conv_decode_batch_impl impls[3];
+    unsigned int impls_num;
+
+    void add(const char * name, conv_decode_batch_kernel kernel, unsigned int lanes)
+    {
+      impls[impls_num].name = name;
+      impls[impls_num].kernel = kernel;
+      impls[impls_num].lanes = lanes;
+      impls_num++;
+    }
+
+    conv_decode_batch_table() : impls_num(0)
+    {
+      add("generic", conv_decode_batch_generic, 1);
+#ifdef CONV_BATCH_HAVE_X86
+      __builtin_cpu_init();
+      if(__builtin_cpu_supports("sse2")){
+        add("sse2", conv_decode_batch_sse2, SSE2_LANES);
+      }
+      if(__builtin_cpu_supports("avx2")){
+        add("avx2", conv_decode_batch_avx2, AVX2_LANES);
+      }
+#endif
+    }
+  };
+}
+
+const conv_decode_batch_impl * conv_decode_batch_impls(unsigned int * impls_num)
+{
+   static const conv_decode_batch_table table;
+   *impls_num = table.impls_num;
+   return table.impls;
+}
+
+conv_decode_batch_kernel conv_decode_batch_get(const char * impl_name)
+{
+   unsigned int impls_num;
+   const conv_decode_batch_impl * impls = conv_decode_batch_impls(&impls_num);
+
+   if(impl_name == NULL){
+      return impls[impls_num-1].kernel;
+   }
+   for(unsigned int i=0; i<impls_num; i++){
+      if(strcmp(impls[i].name, impl_name) == 0){
+         return impls[i].kernel;
+      }
+   }
+   return NULL;
+}
+
+void conv_decode_batch(unsigned char * const * output, const unsigned char * const * data, int * errors, unsigned int blocks_num)
+{
+   static const conv_decode_batch_kernel kernel = conv_decode_batch_get(NULL);
+   kernel(output, data, errors, blocks_num);
+}
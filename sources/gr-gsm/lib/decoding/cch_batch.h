@@ -0,0 +1,88 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * conv_decode_batch:
+ *           Viterbi decoding of many blocks of the "common" control
+ *           channel code (K=5, rate 1/2) at once. The blocks can come
+ *           from any timeslots and ARFCNs - each one occupies a lane of
+ *           a SIMD register, so "sse2" decodes 8 blocks and "avx2" 16
+ *           blocks with one pass over the trellis. "generic" calls
+ *           conv_decode() for every block.
+ *
+ *           All kernels give the same decoded bits and error counts as
+ *           conv_decode(), including the choice between paths with equal
+ *           metrics: the path metrics are exact 16-bit Hamming distances
+ *           (at most CONV_SIZE, so they never need renormalization) and
+ *           the first predecessor wins ties, as in the scalar loop.
+ *
+ *           The fastest kernel supported by the CPU is selected on the
+ *           first call of conv_decode_batch_get(NULL).
+ *
+ * SYNTAX:   void conv_decode_batch_kernel(
+ *                                  unsigned char * const * output,
+ *                                  const unsigned char * const * data,
+ *                                  int * errors,
+ *                                  unsigned int blocks_num)
+ *
+ * INPUT:    data:        Pointers to deinterleaved blocks of CONV_SIZE
+ *                        hard bits (0 or 1).
+ *           blocks_num:  Number of blocks - any number, the last SIMD
+ *                        pass is padded if needed.
+ *
+ * OUTPUT:   output:      Pointers to buffers for CONV_INPUT_SIZE decoded
+ *                        bits of every block.
+ *           errors:      Number of corrected errors of every block (the
+ *                        return value of conv_decode()).
+ */
+
+#ifndef INCLUDED_CCH_BATCH_H
+#define INCLUDED_CCH_BATCH_H
+
+#include "cch.h"
+
+typedef void (*conv_decode_batch_kernel)(unsigned char * const * output, const unsigned char * const * data, int * errors, unsigned int blocks_num);
+
+typedef struct {
+  const char * name;               ///< name of the implementation: "generic", "sse2", "avx2"
+  conv_decode_batch_kernel kernel; ///< pointer to the kernel
+  unsigned int lanes;              ///< number of blocks decoded with one pass over the trellis
+} conv_decode_batch_impl;
+
+/** Returns implementations of the batch decoder supported by the running CPU
+ *
+ * @param[out] impls_num number of entries in the returned table
+ * @return table of the implementations, ordered from the slowest ("generic") to the fastest
+ */
+const conv_decode_batch_impl * conv_decode_batch_impls(unsigned int * impls_num);
+
+/** Returns batch decoder with given name
+ *
+ * @param impl_name name of the implementation, NULL selects the fastest one
+ * @return pointer to the kernel or NULL if there is no such implementation
+ */
+conv_decode_batch_kernel conv_decode_batch_get(const char * impl_name);
+
+/** Decodes \p blocks_num blocks with the fastest kernel
+ */
+void conv_decode_batch(unsigned char * const * output, const unsigned char * const * data, int * errors, unsigned int blocks_num);
+
+#endif /* INCLUDED_CCH_BATCH_H */
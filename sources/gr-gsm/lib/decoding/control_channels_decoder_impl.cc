@@ -27,6 +27,8 @@
 #include <gnuradio/io_signature.h>
 #include <grgsm/gsmtap.h>
 #include "control_channels_decoder_impl.h"
+#include "cch_batch.h"
+#include <string.h>
 
 #define DATA_BYTES 23
 
@@ -47,7 +49,8 @@ namespace gr {
       : gr::block("control_channels_decoder",
               gr::io_signature::make(0, 0, 0),
               gr::io_signature::make(0, 0, 0)),
-              d_collected_bursts_num(0)
+              d_collected_bursts_num(0),
+              d_msgs_port(pmt::mp("msgs"))
     {
         //initialize de/interleaver
         int j, k, B;
@@ -63,29 +66,41 @@ namespace gr {
         
         //setup input/output ports
         message_port_register_in(pmt::mp("bursts"));
-        set_msg_handler(pmt::mp("bursts"), boost::bind(&control_channels_decoder_impl::decode, this, _1));
-        message_port_register_out(pmt::mp("msgs"));
+        set_msg_batch_handler(pmt::mp("bursts"), boost::bind(&control_channels_decoder_impl::decode, this, _1));
+        message_port_register_out(d_msgs_port);
     }
 
     control_channels_decoder_impl::~control_channels_decoder_impl()
     {
     }
 
-    void control_channels_decoder_impl::decode(pmt::pmt_t msg)
+    /*
+     * Deinterleaves the 4 collected bursts into the next coded block. Soft
+     * blocks are decoded right away, hard ones are left to the batch
+     * decoder.
+     */
+    void control_channels_decoder_impl::collect_block()
     {
-        unsigned char iBLOCK[BLOCKS*iBLOCK_SIZE], hl, hn, conv_data[CONV_SIZE], decoded_data[PARITY_OUTPUT_SIZE];
-        d_bursts[d_collected_bursts_num] = msg;
-        d_collected_bursts_num++;
-        //get convecutive bursts
-        
-        if(d_collected_bursts_num==4)
+        size_t n = d_blocks.size();
+        coded_block block;
+        memcpy(&block.header, &d_bursts[0].header(), sizeof(gsmtap_hdr));
+        block.soft = d_bursts[0].is_soft() || d_bursts[1].is_soft() ||
+                     d_bursts[2].is_soft() || d_bursts[3].is_soft();
+        block.errors = 0;
+        d_blocks.push_back(block);
+
+        d_conv_data.resize((n + 1) * CONV_SIZE);
+        d_decoded.resize((n + 1) * CONV_INPUT_SIZE);
+
+        if(!block.soft)
         {
-            d_collected_bursts_num=0;
+            unsigned char iBLOCK[BLOCKS*iBLOCK_SIZE];
+            unsigned char * conv_data = &d_conv_data[n * CONV_SIZE];
+
             //reorganize data
             for(int ii = 0; ii < 4; ii++)
             {
-                pmt::pmt_t header_plus_burst = pmt::cdr(d_bursts[ii]);
-                int8_t * burst_bits = (int8_t *)(pmt::blob_data(header_plus_burst))+sizeof(gsmtap_hdr);
+                const int8_t * burst_bits = d_bursts[ii].bits();
 
                 for(int jj = 0; jj < 57; jj++)
                 {
@@ -98,56 +113,130 @@ namespace gr {
             {
                 conv_data[k] = iBLOCK[interleave_trans[k]];
             }
-            //convolutional code decode
-            int errors = conv_decode(decoded_data, conv_data);
-            //std::cout << "Errors:" << errors << " " << parity_check(decoded_data) << std::endl;
-            // check parity
-            // If parity check error detected try to fix it.
-
-            if (parity_check(decoded_data))
+        }
+        else
+        {
+            //the same with soft bits - hard bursts among them count as sure
+            signed char soft_iBLOCK[BLOCKS*iBLOCK_SIZE], soft_conv_data[CONV_SIZE];
+            for(int ii = 0; ii < 4; ii++)
             {
-                FC_init(&fc_ctx, 40, 184);
-                unsigned char crc_result[PARITY_OUTPUT_SIZE];
-                if (FC_check_crc(&fc_ctx, decoded_data, crc_result) == 0)
+                for(int jj = 0; jj < 57; jj++)
                 {
-                    //("error: sacch: parity error (errors=%d fn=%d)\n", errors, ctx->fn);
-                    //std::cout << "Uncorrectable errors!" << std::endl;
-                    errors = -1;
-                    return;
-                } else {
-                    //DEBUGF("Successfully corrected parity bits! (errors=%d fn=%d)\n", errors, ctx->fn);
-                    //std::cout << "Corrected some errors" << std::endl;
-                    memcpy(decoded_data, crc_result, PARITY_OUTPUT_SIZE);
-                    errors = 0;
+                    soft_iBLOCK[ii*iBLOCK_SIZE+jj] = d_bursts[ii].soft_bit(jj + 3);
+                    soft_iBLOCK[ii*iBLOCK_SIZE+jj+57] = d_bursts[ii].soft_bit(jj + 88);
                 }
+            }
+            for (int k = 0; k < CONV_SIZE; k++)
+            {
+                soft_conv_data[k] = soft_iBLOCK[interleave_trans[k]];
+            }
+            d_blocks[n].errors = conv_decode_soft(&d_decoded[n * CONV_INPUT_SIZE], soft_conv_data);
+        }
+    }
+
+    void control_channels_decoder_impl::publish_block(const coded_block & block, unsigned char * decoded_data)
+    {
+        //std::cout << "Errors:" << block.errors << " " << parity_check(decoded_data) << std::endl;
+        // check parity
+        // If parity check error detected try to fix it.
+
+        if (parity_check(decoded_data))
+        {
+            FC_init(&fc_ctx, 40, 184);
+            unsigned char crc_result[PARITY_OUTPUT_SIZE];
+            if (FC_check_crc(&fc_ctx, decoded_data, crc_result) == 0)
+            {
+                //("error: sacch: parity error (errors=%d fn=%d)\n", errors, ctx->fn);
+                //std::cout << "Uncorrectable errors!" << std::endl;
+                return;
             } else {
-                //std::cout << "Everything correct" << std::endl;
+                //DEBUGF("Successfully corrected parity bits! (errors=%d fn=%d)\n", errors, ctx->fn);
+                //std::cout << "Corrected some errors" << std::endl;
+                memcpy(decoded_data, crc_result, PARITY_OUTPUT_SIZE);
             }
-           //compress bits
-           unsigned char outmsg[27];
-           unsigned char sbuf_len=224;
-           int i, j, c, pos=0;
-           for(i = 0; i < sbuf_len; i += 8) {
-                for(j = 0, c = 0; (j < 8) && (i + j < sbuf_len); j++){
-                    c |= (!!decoded_data[i + j]) << j;
-                }
-                outmsg[pos++] = c & 0xff;
-           }
-
-           //send message with header of the first burst
-            pmt::pmt_t first_header_plus_burst = pmt::cdr(d_bursts[0]);
-            gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(first_header_plus_burst);
-            int8_t header_plus_data[sizeof(gsmtap_hdr)+DATA_BYTES];
-            memcpy(header_plus_data, header, sizeof(gsmtap_hdr));
-            memcpy(header_plus_data+sizeof(gsmtap_hdr), outmsg, DATA_BYTES);
-            ((gsmtap_hdr*)header_plus_data)->type = GSMTAP_TYPE_UM;
-            
-            pmt::pmt_t msg_binary_blob = pmt::make_blob(header_plus_data,DATA_BYTES+sizeof(gsmtap_hdr));
-            pmt::pmt_t msg_out = pmt::cons(pmt::PMT_NIL, msg_binary_blob);
-            
-            message_port_pub(pmt::mp("msgs"), msg_out);
+        } else {
+            //std::cout << "Everything correct" << std::endl;
+        }
+        //compress bits
+        unsigned char outmsg[27];
+        unsigned char sbuf_len=224;
+        int i, j, c, pos=0;
+        for(i = 0; i < sbuf_len; i += 8) {
+            for(j = 0, c = 0; (j < 8) && (i + j < sbuf_len); j++){
+                c |= (!!decoded_data[i + j]) << j;
+            }
+            outmsg[pos++] = c & 0xff;
+        }
+
+        //send message with header of the first burst
+        int8_t header_plus_data[sizeof(gsmtap_hdr)+DATA_BYTES];
+        memcpy(header_plus_data, &block.header, sizeof(gsmtap_hdr));
+        memcpy(header_plus_data+sizeof(gsmtap_hdr), outmsg, DATA_BYTES);
+        ((gsmtap_hdr*)header_plus_data)->type = GSMTAP_TYPE_UM;
+        ((gsmtap_hdr*)header_plus_data)->res = 0;
+
+        pmt::pmt_t msg_binary_blob = pmt::make_blob_pooled(header_plus_data,DATA_BYTES+sizeof(gsmtap_hdr));
+        pmt::pmt_t msg_out = pmt::cons_pooled(pmt::PMT_NIL, msg_binary_blob);
+
+        message_port_pub(d_msgs_port, msg_out);
+    }
+
+    /*
+     * Gets all bursts queued on the input at once. Hard blocks completed
+     * by them go through the SIMD Viterbi decoder together, the decoded
+     * blocks are then published in the order of the bursts.
+     */
+    void control_channels_decoder_impl::decode(const std::vector<pmt::pmt_t> & msgs)
+    {
+        for(size_t ii = 0; ii < msgs.size(); ii++)
+        {
+            d_bursts[d_collected_bursts_num] = burst(msgs[ii]);
+            d_collected_bursts_num++;
+            //get convecutive bursts
+
+            if(d_collected_bursts_num==4)
+            {
+                d_collected_bursts_num=0;
+                collect_block();
+            }
+        }
+
+        if(d_blocks.empty())
+        {
+            return;
+        }
+
+        d_hard_data.clear();
+        d_hard_output.clear();
+        for(size_t n = 0; n < d_blocks.size(); n++)
+        {
+            if(!d_blocks[n].soft)
+            {
+                d_hard_data.push_back(&d_conv_data[n * CONV_SIZE]);
+                d_hard_output.push_back(&d_decoded[n * CONV_INPUT_SIZE]);
+            }
+        }
+        d_hard_errors.resize(d_hard_data.size());
+
+        //a single block isn't worth a pass of the SIMD decoder
+        if(d_hard_data.size() == 1)
+        {
+            d_hard_errors[0] = conv_decode(d_hard_output[0], d_hard_data[0]);
+        }
+        else if(d_hard_data.size() > 1)
+        {
+            conv_decode_batch(&d_hard_output[0], &d_hard_data[0], &d_hard_errors[0], d_hard_data.size());
+        }
+
+        for(size_t n = 0, hard = 0; n < d_blocks.size(); n++)
+        {
+            if(!d_blocks[n].soft)
+            {
+                d_blocks[n].errors = d_hard_errors[hard++];
+            }
+            publish_block(d_blocks[n], &d_decoded[n * CONV_INPUT_SIZE]);
         }
-        return;
+        d_blocks.clear();
     }
   } /* namespace gsm */
 } /* namespace gr */
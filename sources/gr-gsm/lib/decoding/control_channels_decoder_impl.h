@@ -24,8 +24,10 @@
 #define INCLUDED_GSM_CONTROL_CHANNELS_DECODER_IMPL_H
 
 #include <grgsm/decoding/control_channels_decoder.h>
+#include <grgsm/burst.h>
 #include "fire_crc.h"
 #include "cch.h"
+#include <vector>
 
 namespace gr {
   namespace gsm {
@@ -33,11 +35,30 @@ namespace gr {
     class control_channels_decoder_impl : public control_channels_decoder
     {
      private:
+      /** Block of 4 bursts waiting for the batch decoder */
+      struct coded_block
+      {
+        gsmtap_hdr header; ///< header of the first burst
+        bool soft;
+        int errors;
+      };
+
       unsigned int d_collected_bursts_num;
-      pmt::pmt_t d_bursts[4];
+      burst d_bursts[4];
       unsigned short interleave_trans[CONV_SIZE];      
       FC_CTX fc_ctx;      
-      void decode(pmt::pmt_t msg);
+      pmt::pmt_t d_msgs_port;
+
+      std::vector<coded_block> d_blocks;
+      std::vector<unsigned char> d_conv_data;   ///< deinterleaved hard bits, CONV_SIZE for each block
+      std::vector<unsigned char> d_decoded;     ///< CONV_INPUT_SIZE decoded bits for each block
+      std::vector<unsigned char *> d_hard_data;
+      std::vector<unsigned char *> d_hard_output;
+      std::vector<int> d_hard_errors;
+
+      void collect_block();
+      void publish_block(const coded_block & block, unsigned char * decoded_data);
+      void decode(const std::vector<pmt::pmt_t> & msgs);
      public:
       control_channels_decoder_impl();
       ~control_channels_decoder_impl();
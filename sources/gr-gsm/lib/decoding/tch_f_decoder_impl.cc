@@ -100,7 +100,7 @@ namespace gr {
 
     void tch_f_decoder_impl::decode(pmt::pmt_t msg)
     {
-        d_bursts[d_collected_bursts_num] = msg;
+        d_bursts[d_collected_bursts_num] = burst(msg);
         d_collected_bursts_num++;
 
         bool stolen = false;
@@ -112,16 +112,27 @@ namespace gr {
             // reorganize data
             for (int ii = 0; ii < 8; ii++)
             {
-                pmt::pmt_t header_plus_burst = pmt::cdr(d_bursts[ii]);
-                int8_t * burst_bits = (int8_t *)(pmt::blob_data(header_plus_burst))+sizeof(gsmtap_hdr);
+                const burst & b = d_bursts[ii];
 
-                for (int jj = 0; jj < 57; jj++)
+                if (!b.is_soft())
                 {
-                    iBLOCK[ii*114+jj] = burst_bits[jj + 3];
-                    iBLOCK[ii*114+jj+57] = burst_bits[jj + 88]; //88 = 3+57+1+26+1
+                    for (int jj = 0; jj < 57; jj++)
+                    {
+                        iBLOCK[ii*114+jj] = b.bits()[jj + 3];
+                        iBLOCK[ii*114+jj+57] = b.bits()[jj + 88]; //88 = 3+57+1+26+1
+                    }
+                }
+                else
+                {
+                    // probability that the bit is 1, 0.5 if nothing is known about it
+                    for (int jj = 0; jj < 57; jj++)
+                    {
+                        iBLOCK[ii*114+jj] = 0.5f - b.bits()[jj + 3] / 254.0f;
+                        iBLOCK[ii*114+jj+57] = 0.5f - b.bits()[jj + 88] / 254.0f;
+                    }
                 }
 
-                if ((ii <= 3 && static_cast<int>(burst_bits[87]) == 1) || (ii >= 4 && static_cast<int>(burst_bits[60]) == 1))
+                if ((ii <= 3 && b.hard_bit(87) == 1) || (ii >= 4 && b.hard_bit(60) == 1))
                 {
                     stolen = true;
                 }
@@ -153,12 +164,11 @@ namespace gr {
                         outmsg[pos++] = c & 0xff;
                     }
 
-                    pmt::pmt_t first_header_plus_burst = pmt::cdr(d_bursts[0]);
-                    gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(first_header_plus_burst);
                     int8_t header_plus_data[sizeof(gsmtap_hdr)+DATA_BYTES];
-                    memcpy(header_plus_data, header, sizeof(gsmtap_hdr));
+                    memcpy(header_plus_data, &d_bursts[0].header(), sizeof(gsmtap_hdr));
                     memcpy(header_plus_data+sizeof(gsmtap_hdr), outmsg, DATA_BYTES);
                     ((gsmtap_hdr*)header_plus_data)->type = GSMTAP_TYPE_UM;
+                    ((gsmtap_hdr*)header_plus_data)->res = 0;
 
                     pmt::pmt_t msg_binary_blob = pmt::make_blob(header_plus_data,DATA_BYTES+sizeof(gsmtap_hdr));
                     pmt::pmt_t msg_out = pmt::cons(pmt::PMT_NIL, msg_binary_blob);
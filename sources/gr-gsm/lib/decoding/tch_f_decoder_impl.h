@@ -30,6 +30,7 @@
 #include "GSM660Tables.h"
 #include "ViterbiR204.h"
 #include <grgsm/decoding/tch_f_decoder.h>
+#include <grgsm/burst.h>
 
 
 #define DATA_BLOCK_SIZE		184
@@ -51,7 +52,7 @@ namespace gr {
             private:
                 unsigned int d_collected_bursts_num;
                 unsigned short interleave_trans[CONV_SIZE];
-                pmt::pmt_t d_bursts[8];
+                burst d_bursts[8];
                 FILE * d_speech_file;
                 enum tch_mode d_tch_mode;
                 bool d_boundary_check;
@@ -75,7 +76,7 @@ namespace gr {
                 ViterbiR2O4 mVR204Coder;
                 ViterbiBase *mViterbi;
 
-                unsigned char iBLOCK[2*BLOCKS*iBLOCK_SIZE];
+                float iBLOCK[2*BLOCKS*iBLOCK_SIZE]; ///< received bits as probabilities of 1 (hard bits are 0 or 1)
                 unsigned char mAMRFrameHeader;
 
                 const unsigned *mAMRBitOrder;
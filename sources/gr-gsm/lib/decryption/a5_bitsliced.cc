@@ -0,0 +1,258 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "a5_bitsliced.h"
+
+extern "C" {
+    #include <osmocom/gsm/a5.h>
+}
+
+typedef uint64_t slice_t;
+
+#define R1_LEN 19
+#define R2_LEN 22
+#define R3_LEN 23
+#define R4_LEN 17
+
+#define R1_TAPS 0x072000
+#define R2_TAPS 0x300000
+#define R3_TAPS 0x700080
+#define R4_TAPS 0x010800
+
+/*
+ * Scalar registers - used for the key load, which is common to all frames.
+ */
+static inline uint32_t clock_reg(uint32_t r, unsigned int len, uint32_t taps)
+{
+    return ((r << 1) & ((1 << len) - 1)) | __builtin_parity(r & taps);
+}
+
+static void load_key(const uint8_t * key, uint32_t r[4], bool a5_2)
+{
+    r[0] = r[1] = r[2] = r[3] = 0;
+    for(int i = 0; i < 64; i++)
+    {
+        uint32_t b = (key[7 - (i >> 3)] >> (i & 7)) & 1;
+
+        r[0] = clock_reg(r[0], R1_LEN, R1_TAPS) ^ b;
+        r[1] = clock_reg(r[1], R2_LEN, R2_TAPS) ^ b;
+        r[2] = clock_reg(r[2], R3_LEN, R3_TAPS) ^ b;
+        if(a5_2){
+            r[3] = clock_reg(r[3], R4_LEN, R4_TAPS) ^ b;
+        }
+    }
+}
+
+/*
+ * Bitsliced registers: bit j of register k of frame l is bit l of r[k][j].
+ */
+struct slices
+{
+    slice_t r1[R1_LEN];
+    slice_t r2[R2_LEN];
+    slice_t r3[R3_LEN];
+    slice_t r4[R4_LEN];
+};
+
+static void broadcast(uint32_t reg, unsigned int len, slice_t * s)
+{
+    for(unsigned int j = 0; j < len; j++)
+    {
+        s[j] = ((reg >> j) & 1) ? ~(slice_t)0 : 0;
+    }
+}
+
+/*
+ * Shifts register in the frames which have their bit set in clk.
+ */
+template<unsigned int LEN>
+static inline void clock_slices(slice_t * r, slice_t feedback, slice_t clk)
+{
+    for(unsigned int j = LEN - 1; j > 0; j--)
+    {
+        r[j] ^= (r[j] ^ r[j - 1]) & clk;
+    }
+    r[0] ^= (r[0] ^ feedback) & clk;
+}
+
+static inline slice_t majority(slice_t a, slice_t b, slice_t c)
+{
+    return (a & b) | (a & c) | (b & c);
+}
+
+static inline void clock_r1(slices & s, slice_t clk)
+{
+    clock_slices<R1_LEN>(s.r1, s.r1[13] ^ s.r1[16] ^ s.r1[17] ^ s.r1[18], clk);
+}
+
+static inline void clock_r2(slices & s, slice_t clk)
+{
+    clock_slices<R2_LEN>(s.r2, s.r2[20] ^ s.r2[21], clk);
+}
+
+static inline void clock_r3(slices & s, slice_t clk)
+{
+    clock_slices<R3_LEN>(s.r3, s.r3[7] ^ s.r3[20] ^ s.r3[21] ^ s.r3[22], clk);
+}
+
+static inline void clock_r4(slices & s)
+{
+    clock_slices<R4_LEN>(s.r4, s.r4[11] ^ s.r4[16], ~(slice_t)0);
+}
+
+/*
+ * Loads the frame counts - the same forced clocking as in the key load,
+ * with a different bit in every frame.
+ */
+static void load_frames(slices & s, const uint32_t * fn, unsigned int frames_num, bool a5_2)
+{
+    uint32_t fn_count[A5_BITSLICED_FRAMES];
+
+    for(unsigned int l = 0; l < frames_num; l++)
+    {
+        fn_count[l] = osmo_a5_fn_count(fn[l]);
+    }
+    for(int i = 0; i < 22; i++)
+    {
+        slice_t b = 0;
+        for(unsigned int l = 0; l < frames_num; l++)
+        {
+            b |= (slice_t)((fn_count[l] >> i) & 1) << l;
+        }
+
+        clock_r1(s, ~(slice_t)0);
+        clock_r2(s, ~(slice_t)0);
+        clock_r3(s, ~(slice_t)0);
+        s.r1[0] ^= b;
+        s.r2[0] ^= b;
+        s.r3[0] ^= b;
+        if(a5_2){
+            clock_r4(s);
+            s.r4[0] ^= b;
+        }
+    }
+}
+
+static inline void unpack(slice_t out, unsigned int i, unsigned int frames_num, uint8_t (* ks)[A5_KEYSTREAM_BITS])
+{
+    for(unsigned int l = 0; l < frames_num; l++)
+    {
+        ks[l][i] = (out >> l) & 1;
+    }
+}
+
+static inline void a5_1_clock(slices & s)
+{
+    slice_t c1 = s.r1[8], c2 = s.r2[10], c3 = s.r3[10];
+    slice_t maj = majority(c1, c2, c3);
+
+    clock_r1(s, ~(c1 ^ maj));
+    clock_r2(s, ~(c2 ^ maj));
+    clock_r3(s, ~(c3 ^ maj));
+}
+
+void a5_1_bitsliced(const uint8_t * key, const uint32_t * fn, unsigned int frames_num,
+                    uint8_t (* dl)[A5_KEYSTREAM_BITS], uint8_t (* ul)[A5_KEYSTREAM_BITS])
+{
+    uint32_t r[4];
+    slices s;
+
+    load_key(key, r, false);
+    broadcast(r[0], R1_LEN, s.r1);
+    broadcast(r[1], R2_LEN, s.r2);
+    broadcast(r[2], R3_LEN, s.r3);
+    load_frames(s, fn, frames_num, false);
+
+    for(int i = 0; i < 100; i++)
+    {
+        a5_1_clock(s);
+    }
+
+    for(int i = 0; i < A5_KEYSTREAM_BITS; i++)
+    {
+        a5_1_clock(s);
+        if(dl){
+            unpack(s.r1[R1_LEN - 1] ^ s.r2[R2_LEN - 1] ^ s.r3[R3_LEN - 1], i, frames_num, dl);
+        }
+    }
+    if(ul){
+        for(int i = 0; i < A5_KEYSTREAM_BITS; i++)
+        {
+            a5_1_clock(s);
+            unpack(s.r1[R1_LEN - 1] ^ s.r2[R2_LEN - 1] ^ s.r3[R3_LEN - 1], i, frames_num, ul);
+        }
+    }
+}
+
+static inline void a5_2_clock(slices & s)
+{
+    slice_t c1 = s.r4[10], c2 = s.r4[3], c3 = s.r4[7];
+    slice_t maj = majority(c1, c2, c3);
+
+    clock_r1(s, ~(c1 ^ maj));
+    clock_r2(s, ~(c2 ^ maj));
+    clock_r3(s, ~(c3 ^ maj));
+    clock_r4(s);
+}
+
+static inline slice_t a5_2_output(const slices & s)
+{
+    return s.r1[R1_LEN - 1] ^ s.r2[R2_LEN - 1] ^ s.r3[R3_LEN - 1] ^
+           majority(s.r1[15], ~s.r1[14], s.r1[12]) ^
+           majority(~s.r2[16], s.r2[13], s.r2[9]) ^
+           majority(s.r3[18], s.r3[16], ~s.r3[13]);
+}
+
+void a5_2_bitsliced(const uint8_t * key, const uint32_t * fn, unsigned int frames_num,
+                    uint8_t (* dl)[A5_KEYSTREAM_BITS], uint8_t (* ul)[A5_KEYSTREAM_BITS])
+{
+    uint32_t r[4];
+    slices s;
+
+    load_key(key, r, true);
+    broadcast(r[0], R1_LEN, s.r1);
+    broadcast(r[1], R2_LEN, s.r2);
+    broadcast(r[2], R3_LEN, s.r3);
+    broadcast(r[3], R4_LEN, s.r4);
+    load_frames(s, fn, frames_num, true);
+
+    s.r1[15] = s.r2[16] = s.r3[18] = s.r4[10] = ~(slice_t)0;
+
+    for(int i = 0; i < 99; i++)
+    {
+        a5_2_clock(s);
+    }
+
+    for(int i = 0; i < A5_KEYSTREAM_BITS; i++)
+    {
+        a5_2_clock(s);
+        if(dl){
+            unpack(a5_2_output(s), i, frames_num, dl);
+        }
+    }
+    if(ul){
+        for(int i = 0; i < A5_KEYSTREAM_BITS; i++)
+        {
+            a5_2_clock(s);
+            unpack(a5_2_output(s), i, frames_num, ul);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * a5_1_bitsliced, a5_2_bitsliced:
+ *           A5/1 and A5/2 keystreams of up to A5_BITSLICED_FRAMES frames
+ *           with one key. Every bit of the LFSRs is kept in a 64-bit
+ *           word with one bit per frame, so the registers of all frames
+ *           are clocked together with a few logical operations per bit,
+ *           the irregular clocking included. The key is loaded only once,
+ *           as it doesn't depend on the frame number.
+ *
+ *           The keystreams are the same as the ones of osmo_a5_1() and
+ *           osmo_a5_2() of libosmocore.
+ *
+ * SYNTAX:   void a5_1_bitsliced(
+ *                                  const uint8_t * key,
+ *                                  const uint32_t * fn,
+ *                                  unsigned int frames_num,
+ *                                  uint8_t (* dl)[A5_KEYSTREAM_BITS],
+ *                                  uint8_t (* ul)[A5_KEYSTREAM_BITS])
+ *
+ * INPUT:    key:         8 bytes of Kc.
+ *           fn:          Frame numbers (real GSM frame numbers).
+ *           frames_num:  Number of frames, at most A5_BITSLICED_FRAMES.
+ *
+ * OUTPUT:   dl, ul:      Downlink and uplink keystreams (bits 0 or 1) of
+ *                        every frame, either of them can be NULL.
+ */
+
+#ifndef INCLUDED_A5_BITSLICED_H
+#define INCLUDED_A5_BITSLICED_H
+
+#include <stdint.h>
+
+#define A5_BITSLICED_FRAMES 64
+#define A5_KEYSTREAM_BITS   114
+
+void a5_1_bitsliced(const uint8_t * key, const uint32_t * fn, unsigned int frames_num,
+                    uint8_t (* dl)[A5_KEYSTREAM_BITS], uint8_t (* ul)[A5_KEYSTREAM_BITS]);
+
+void a5_2_bitsliced(const uint8_t * key, const uint32_t * fn, unsigned int frames_num,
+                    uint8_t (* dl)[A5_KEYSTREAM_BITS], uint8_t (* ul)[A5_KEYSTREAM_BITS]);
+
+#endif /* INCLUDED_A5_BITSLICED_H */
@@ -25,14 +25,17 @@
 #include <gnuradio/io_signature.h>
 #include <grgsm/gsmtap.h>
 #include <grgsm/endian.h>
+#include <grgsm/burst.h>
 #include <numeric>
+#include <string.h>
 #include "decryption_impl.h"
 
 extern "C" {
     #include <osmocom/gsm/a5.h>
 }
 
-const uint32_t BURST_SIZE=148;
+#define KEYSTREAM_CACHE_SIZE 512  //divides the number of frames of a hyperframe
+#define HYPERFRAME (26 * 51 * 2048)
 
 namespace gr {
   namespace gsm {
@@ -51,7 +54,8 @@ namespace gr {
       : gr::block("decryption",
               gr::io_signature::make(0, 0, 0),
               gr::io_signature::make(0, 0, 0)),
-        d_k_c_valid(false)
+        d_k_c_valid(false),
+        d_keystreams(KEYSTREAM_CACHE_SIZE)
     {
         set_k_c(k_c);
         set_a5_version(a5_version);
@@ -72,16 +76,20 @@ namespace gr {
 
     void decryption_impl::set_k_c(const std::vector<uint8_t> & k_c)
     {
+        boost::mutex::scoped_lock lock(d_mutex);
         d_k_c = k_c;
+        clear_keystreams();
     }
 
     void decryption_impl::set_a5_version(unsigned int a5_version)
     {
+        boost::mutex::scoped_lock lock(d_mutex);
         d_a5_version = 1;
         if (a5_version >= 1 && a5_version <= 4)
         {
             d_a5_version = a5_version;
         }
+        clear_keystreams();
     }
 
     void decryption_impl::validate_k_c()
@@ -117,53 +125,133 @@ namespace gr {
         }
         else
         {
-            uint8_t decrypted_data[BURST_SIZE];
             uint8_t keystream[114];
 
-            pmt::pmt_t header_plus_burst = pmt::cdr(msg);
-            gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(header_plus_burst);
-            uint8_t * burst_binary = (uint8_t *)(pmt::blob_data(header_plus_burst))+sizeof(gsmtap_hdr);
+            burst in(msg);
+            int8_t out[burst::SIZE];
+            memcpy(out, in.bits(), burst::SIZE);  //guard, stealing bits and midamble are copied as they are
 
-            uint32_t frame_number = be32toh(header->frame_number);
-            bool uplink_burst = (be16toh(header->arfcn) & 0x4000) ? true : false;
+            uint32_t frame_number = be32toh(in.header().frame_number);
+            bool uplink_burst = (be16toh(in.header().arfcn) & 0x4000) ? true : false;
 
-            if(uplink_burst){
-                //process uplink burst
-                osmo_a5(d_a5_version, &d_k_c[0], frame_number, NULL, keystream);
-            } else {
-                //process downlink burst
-                osmo_a5(d_a5_version, &d_k_c[0], frame_number, keystream, NULL);
-            }
-            /* guard bits */
-            for (int i = 0; i < 3; i++) {
-                decrypted_data[i] = burst_binary[i];
-            }
-            //encrypt first part of the burst
-            for (int i = 0; i < 57; i++) {
-                decrypted_data[i+3] = keystream[i] ^ burst_binary[i+3];
+            {
+                boost::mutex::scoped_lock lock(d_mutex);
+                if(d_a5_version == 1 || d_a5_version == 2){
+                    //traffic channels repeat every 26 frames, the others every 51
+                    uint8_t channel_type = in.header().sub_type & ~GSMTAP_CHANNEL_ACCH;
+                    unsigned int period = (channel_type == GSMTAP_CHANNEL_TCH_F || channel_type == GSMTAP_CHANNEL_TCH_H) ? 26 : 51;
+                    const frame_keystream & k = get_keystream(frame_number, period);
+                    memcpy(keystream, uplink_burst ? k.ul : k.dl, sizeof(keystream));
+                } else if(uplink_burst){
+                    //process uplink burst
+                    osmo_a5(d_a5_version, &d_k_c[0], frame_number, NULL, keystream);
+                } else {
+                    //process downlink burst
+                    osmo_a5(d_a5_version, &d_k_c[0], frame_number, keystream, NULL);
+                }
             }
-            /* stealing bits and midamble */
-            for (int i = 60; i < 88; i++) {
-                decrypted_data[i] = burst_binary[i];
+            if(!in.is_soft()){
+                //encrypt first part of the burst
+                for (int i = 0; i < 57; i++) {
+                    out[i+3] = keystream[i] ^ in.bits()[i+3];
+                }
+                //encrypt second part of the burst
+                for (int i = 0; i < 57; i++) {
+                    out[i+88] = keystream[i+57] ^ in.bits()[i+88];
+                }
+            } else {
+                //inverting a soft bit means changing its sign
+                for (int i = 0; i < 57; i++) {
+                    out[i+3] = keystream[i] ? -in.bits()[i+3] : in.bits()[i+3];
+                }
+                for (int i = 0; i < 57; i++) {
+                    out[i+88] = keystream[i+57] ? -in.bits()[i+88] : in.bits()[i+88];
+                }
             }
-            //encrypt second part of the burst
-            for (int i = 0; i < 57; i++) {
-                decrypted_data[i+88] = keystream[i+57] ^ burst_binary[i+88];
+            pmt::pmt_t msg_out = burst::make(in.header(), out);
+
+            message_port_pub(pmt::mp("bursts"), msg_out);
+        }
+        return;
+    }
+
+    void decryption_impl::clear_keystreams()
+    {
+        for (size_t i = 0; i < d_keystreams.size(); i++)
+        {
+            d_keystreams[i].valid = false;
+        }
+        d_recent_fns.clear();
+    }
+
+    /*
+     * Returns keystreams of frame fn. Frames of a channel repeat every
+     * period frames, so on a miss the keystreams of the frames decrypted
+     * during the last period are generated also for the following periods
+     * - all in one pass of the bitsliced A5.
+     */
+    const frame_keystream & decryption_impl::get_keystream(uint32_t fn, unsigned int period)
+    {
+        if (d_recent_fns.empty() || d_recent_fns.back() != fn)
+        {
+            while (!d_recent_fns.empty() &&
+                   ((fn + HYPERFRAME - d_recent_fns.front()) % HYPERFRAME >= period ||
+                    d_recent_fns.size() >= A5_BITSLICED_FRAMES))
+            {
+                d_recent_fns.pop_front();
             }
-            /* guard bits */
-            for (int i = 145; i < 148; i++) {
-                decrypted_data[i] = burst_binary[i];
+            d_recent_fns.push_back(fn);
+        }
+
+        const frame_keystream & k = d_keystreams[fn % KEYSTREAM_CACHE_SIZE];
+        if (!k.valid || k.fn != fn)
+        {
+            precompute_keystreams(fn, period);
+        }
+        return k;
+    }
+
+    void decryption_impl::precompute_keystreams(uint32_t fn, unsigned int period)
+    {
+        uint32_t fns[A5_BITSLICED_FRAMES];
+        uint8_t dl[A5_BITSLICED_FRAMES][A5_KEYSTREAM_BITS];
+        uint8_t ul[A5_BITSLICED_FRAMES][A5_KEYSTREAM_BITS];
+        unsigned int frames_num = 0;
+
+        fns[frames_num++] = fn;
+        //frames expected in the following periods, as far as the cache reaches
+        for (unsigned int ahead = period; ahead < KEYSTREAM_CACHE_SIZE && frames_num < A5_BITSLICED_FRAMES; ahead += period)
+        {
+            for (size_t i = 0; i < d_recent_fns.size() && frames_num < A5_BITSLICED_FRAMES; i++)
+            {
+                uint32_t next_fn = (d_recent_fns[i] + ahead) % HYPERFRAME;
+                uint32_t distance = (next_fn + HYPERFRAME - fn) % HYPERFRAME;
+                const frame_keystream & k = d_keystreams[next_fn % KEYSTREAM_CACHE_SIZE];
+
+                if (distance != 0 && distance < KEYSTREAM_CACHE_SIZE && !(k.valid && k.fn == next_fn))
+                {
+                    fns[frames_num++] = next_fn;
+                }
             }
-            uint8_t new_header_plus_burst[sizeof(gsmtap_hdr)+BURST_SIZE];
-            memcpy(new_header_plus_burst, header, sizeof(gsmtap_hdr));
-            memcpy(new_header_plus_burst+sizeof(gsmtap_hdr), decrypted_data, BURST_SIZE);
+        }
 
-            pmt::pmt_t msg_binary_blob = pmt::make_blob(new_header_plus_burst, sizeof(gsmtap_hdr)+BURST_SIZE);
-            pmt::pmt_t msg_out = pmt::cons(pmt::PMT_NIL, msg_binary_blob);
+        if (d_a5_version == 1)
+        {
+            a5_1_bitsliced(&d_k_c[0], fns, frames_num, dl, ul);
+        }
+        else
+        {
+            a5_2_bitsliced(&d_k_c[0], fns, frames_num, dl, ul);
+        }
 
-            message_port_pub(pmt::mp("bursts"), msg_out);
+        for (unsigned int i = 0; i < frames_num; i++)
+        {
+            frame_keystream & k = d_keystreams[fns[i] % KEYSTREAM_CACHE_SIZE];
+            k.fn = fns[i];
+            k.valid = true;
+            memcpy(k.dl, dl[i], A5_KEYSTREAM_BITS);
+            memcpy(k.ul, ul[i], A5_KEYSTREAM_BITS);
         }
-        return;
     }
   } /* namespace gsm */
 } /* namespace gr */
@@ -22,19 +22,39 @@
 #define INCLUDED_GSM_DECRYPTION_IMPL_H
 
 #include <grgsm/decryption/decryption.h>
+#include <boost/thread/mutex.hpp>
 #include <vector>
+#include <deque>
+#include "a5_bitsliced.h"
 
 namespace gr {
   namespace gsm {
 
+    /*
+     * Keystreams of one frame, in both directions.
+     */
+    struct frame_keystream
+    {
+      uint32_t fn;
+      bool valid;
+      uint8_t dl[A5_KEYSTREAM_BITS];
+      uint8_t ul[A5_KEYSTREAM_BITS];
+    };
+
     class decryption_impl : public decryption
     {
      private:
       std::vector<uint8_t> d_k_c;
       bool d_k_c_valid;
       uint8_t d_a5_version;
+      boost::mutex d_mutex;
+      std::vector<frame_keystream> d_keystreams; //cache indexed with fn % its size
+      std::deque<uint32_t> d_recent_fns;   //frames decrypted in the last multiframe
       void decrypt(pmt::pmt_t msg);
       void validate_k_c();
+      void clear_keystreams();
+      const frame_keystream & get_keystream(uint32_t fn, unsigned int period);
+      void precompute_keystreams(uint32_t fn, unsigned int period);
      public:
       decryption_impl(const std::vector<uint8_t> & k_c, unsigned int a5_version);
       ~decryption_impl();
@@ -0,0 +1,284 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "cell_demapper_impl.h"
+#include <grgsm/endian.h>
+#include <grgsm/gsmtap.h>
+#include <stdexcept>
+
+namespace gr {
+  namespace gsm {
+
+    /*
+     * Control channel blocks of the 51-multiframe (GSM 05.02, 7 Table 3) -
+     * first frames of the blocks and their channel types
+     */
+    static const unsigned int BCCH_CCCH_STARTS[] = {2, 6, 12, 16, 22, 26, 32, 36, 42, 46};
+    static const uint8_t BCCH_CCCH_TYPES[] = {
+        GSMTAP_CHANNEL_BCCH, GSMTAP_CHANNEL_CCCH, GSMTAP_CHANNEL_CCCH, GSMTAP_CHANNEL_CCCH,
+        GSMTAP_CHANNEL_CCCH, GSMTAP_CHANNEL_CCCH, GSMTAP_CHANNEL_CCCH, GSMTAP_CHANNEL_CCCH,
+        GSMTAP_CHANNEL_CCCH, GSMTAP_CHANNEL_CCCH
+    };
+    static const uint8_t BCCH_CCCH_SDCCH4_TYPES[] = {
+        GSMTAP_CHANNEL_BCCH, GSMTAP_CHANNEL_CCCH, GSMTAP_CHANNEL_CCCH, GSMTAP_CHANNEL_CCCH,
+        GSMTAP_CHANNEL_SDCCH4, GSMTAP_CHANNEL_SDCCH4, GSMTAP_CHANNEL_SDCCH4, GSMTAP_CHANNEL_SDCCH4,
+        GSMTAP_CHANNEL_ACCH|GSMTAP_CHANNEL_SDCCH4, GSMTAP_CHANNEL_ACCH|GSMTAP_CHANNEL_SDCCH4
+    };
+    static const unsigned int SDCCH8_STARTS[] = {0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44};
+    static const uint8_t SDCCH8_TYPES[] = {
+        GSMTAP_CHANNEL_SDCCH8, GSMTAP_CHANNEL_SDCCH8, GSMTAP_CHANNEL_SDCCH8, GSMTAP_CHANNEL_SDCCH8,
+        GSMTAP_CHANNEL_SDCCH8, GSMTAP_CHANNEL_SDCCH8, GSMTAP_CHANNEL_SDCCH8, GSMTAP_CHANNEL_SDCCH8,
+        GSMTAP_CHANNEL_ACCH|GSMTAP_CHANNEL_SDCCH8, GSMTAP_CHANNEL_ACCH|GSMTAP_CHANNEL_SDCCH8,
+        GSMTAP_CHANNEL_ACCH|GSMTAP_CHANNEL_SDCCH8, GSMTAP_CHANNEL_ACCH|GSMTAP_CHANNEL_SDCCH8
+    };
+
+    cell_demapper::sptr
+    cell_demapper::make(const std::vector<int> &timeslot_configs)
+    {
+      return gnuradio::get_initial_sptr
+        (new cell_demapper_impl(timeslot_configs));
+    }
+
+    /*
+     * The private constructor
+     */
+    cell_demapper_impl::cell_demapper_impl(const std::vector<int> &timeslot_configs)
+      : gr::block("cell_demapper",
+              gr::io_signature::make(0, 0, 0),
+              gr::io_signature::make(0, 0, 0)),
+        d_bursts_port(pmt::mp("bursts")),
+        d_tch_bursts_port(pmt::mp("tch_bursts"))
+    {
+        if(timeslot_configs.size() > 8)
+        {
+            throw std::invalid_argument("cell_demapper: there are only 8 timeslots");
+        }
+
+        for(unsigned int tn = 0; tn < 8; tn++)
+        {
+            int config = tn < timeslot_configs.size() ? timeslot_configs[tn] : TS_UNUSED;
+            d_periods[tn] = 1;
+
+            switch(config)
+            {
+            case TS_UNUSED:
+                break;
+            case TS_BCCH_CCCH:
+                map_ctrl_chans(tn, BCCH_CCCH_STARTS, BCCH_CCCH_TYPES, sizeof(BCCH_CCCH_TYPES));
+                break;
+            case TS_BCCH_CCCH_SDCCH4:
+                map_ctrl_chans(tn, BCCH_CCCH_STARTS, BCCH_CCCH_SDCCH4_TYPES, sizeof(BCCH_CCCH_SDCCH4_TYPES));
+                break;
+            case TS_SDCCH8:
+                map_ctrl_chans(tn, SDCCH8_STARTS, SDCCH8_TYPES, sizeof(SDCCH8_TYPES));
+                break;
+            case TS_TCH_F:
+                map_tch_f(tn);
+                break;
+            default:
+                throw std::invalid_argument("cell_demapper: unknown timeslot configuration");
+            }
+        }
+
+        message_port_register_in(pmt::mp("bursts"));
+        set_msg_handler(pmt::mp("bursts"), boost::bind(&cell_demapper_impl::demap, this, _1));
+        message_port_register_out(d_bursts_port);
+        message_port_register_out(d_tch_bursts_port);
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    cell_demapper_impl::~cell_demapper_impl()
+    {
+    }
+
+    /*
+     * Adds a block made of bursts in the given frames of the multiframe
+     * of the timeslot, which has to be set up already.
+     */
+    void cell_demapper_impl::add_block(unsigned int timeslot, const unsigned int * frames, unsigned int length,
+                                       uint8_t sub_type, uint8_t sub_slot, const pmt::pmt_t & port)
+    {
+        unsigned int period = d_periods[timeslot];
+        block_buffer block;
+
+        block.length = length;
+        block.port = port;
+        for(unsigned int ii = 0; ii < length; ii++)
+        {
+            //the block may continue in the next multiframe
+            block.offsets[ii] = (frames[ii] + period - frames[0]) % period;
+            block.frame_numbers[ii] = 0;
+
+            burst_route & route = d_routes[timeslot][frames[ii]];
+            route.sub_type = sub_type;
+            route.sub_slot = sub_slot;
+            route.blocks[route.blocks_num] = d_blocks.size();
+            route.positions[route.blocks_num] = ii;
+            route.blocks_num++;
+        }
+        d_blocks.push_back(block);
+    }
+
+    /*
+     * Control channels are mapped on a 51-multiframe, but SACCH/C4 and SACCH/C8
+     * subchannels alternate between odd and even multiframes, so the table
+     * covers two of them. Subslots are numbered in order of the blocks of each
+     * channel type.
+     */
+    void cell_demapper_impl::map_ctrl_chans(unsigned int timeslot, const unsigned int * starts_fn_mod51,
+                                            const uint8_t * channel_types, unsigned int blocks_num)
+    {
+        d_periods[timeslot] = 2 * 51;
+        d_routes[timeslot].assign(d_periods[timeslot], burst_route());
+
+        for(unsigned int multiframe = 0; multiframe < 2; multiframe++)
+        {
+            for(unsigned int ii = 0; ii < blocks_num; ii++)
+            {
+                uint8_t sub_type = channel_types[ii];
+                unsigned int subslot = 0;
+                unsigned int same_type_num = 0;
+                for(unsigned int jj = 0; jj < blocks_num; jj++)
+                {
+                    if(channel_types[jj] == sub_type)
+                    {
+                        subslot += jj < ii;
+                        same_type_num++;
+                    }
+                }
+                if((sub_type & GSMTAP_CHANNEL_ACCH) && multiframe == 1)
+                {
+                    subslot += same_type_num;   //SACCH of the second multiframe continues numbering of the first
+                }
+
+                unsigned int frames[4];
+                for(unsigned int kk = 0; kk < 4; kk++)
+                {
+                    frames[kk] = multiframe * 51 + starts_fn_mod51[ii] + kk;
+                }
+                add_block(timeslot, frames, 4, sub_type, subslot, d_bursts_port);
+            }
+        }
+    }
+
+    /*
+     * TCH/F is mapped on a 26-multiframe (GSM 05.02, 7 Table 1) - traffic in
+     * frames 0-11 and 13-24, SACCH/TF in frame 12 of even timeslots and in frame
+     * 25 of odd ones. A SACCH block spans four multiframes, starting in the one
+     * given by the timeslot, so the table covers four of them.
+     *
+     * Traffic frames are in groups of 4 and a speech block is interleaved
+     * over two consecutive groups, so each burst belongs to two blocks.
+     */
+    void cell_demapper_impl::map_tch_f(unsigned int timeslot)
+    {
+        const unsigned int groups_num = 4 * 2 * 3; //4 multiframes, 2 halves, 3 groups in each
+        unsigned int frames[8];
+
+        d_periods[timeslot] = 4 * 26;
+        d_routes[timeslot].assign(d_periods[timeslot], burst_route());
+
+        for(unsigned int group = 0; group < groups_num; group++)
+        {
+            for(unsigned int ii = 0; ii < 8; ii++)
+            {
+                unsigned int gg = (group + ii / 4) % groups_num;
+                frames[ii] = (gg / 3) * 13 + (gg % 3) * 4 + ii % 4;
+            }
+            add_block(timeslot, frames, 8, GSMTAP_CHANNEL_TCH_F, 0, d_tch_bursts_port);
+        }
+
+        unsigned int sacch_fn_mod26 = timeslot % 2 == 0 ? 12 : 25;
+        for(unsigned int ii = 0; ii < 4; ii++)
+        {
+            frames[ii] = ((timeslot / 2 + ii) % 4) * 26 + sacch_fn_mod26;
+        }
+        add_block(timeslot, frames, 4, GSMTAP_CHANNEL_ACCH|GSMTAP_CHANNEL_TCH_F, 0, d_bursts_port);
+    }
+
+    void cell_demapper_impl::demap(pmt::pmt_t msg)
+    {
+        burst b(msg);
+        unsigned int timeslot = b.header().timeslot;
+
+        if(timeslot >= 8 || d_routes[timeslot].empty())
+        {
+            return;
+        }
+
+        uint32_t frame_nr = be32toh(b.header().frame_number);
+        const burst_route & route = d_routes[timeslot][frame_nr % d_periods[timeslot]];
+        if(route.blocks_num == 0)
+        {
+            return;
+        }
+
+        gsmtap_hdr new_header = b.header();
+        new_header.sub_type = route.sub_type;
+        new_header.sub_slot = route.sub_slot;
+        pmt::pmt_t new_burst = burst::make(new_header, b.bits());
+
+        for(unsigned int ii = 0; ii < route.blocks_num; ii++)
+        {
+            block_buffer & block = d_blocks[route.blocks[ii]];
+            unsigned int last = block.length - 1;
+            unsigned int position = route.positions[ii];
+
+            block.bursts[position] = new_burst;
+            block.frame_numbers[position] = frame_nr;
+
+            if(position == last)
+            {
+                //check for a situation where some bursts were lost
+                //in this situation frame numbers won't match the mapping
+                bool block_is_complete = true;
+                for(unsigned int jj = 0; jj < last; jj++)
+                {
+                    if(!block.bursts[jj] ||
+                       block.frame_numbers[last] - block.frame_numbers[jj] != block.offsets[last] - block.offsets[jj])
+                    {
+                        block_is_complete = false;
+                    }
+                }
+                if(block_is_complete)
+                {
+                    //send bursts of the block to the output
+                    for(unsigned int jj = 0; jj <= last; jj++)
+                    {
+                        message_port_pub(block.port, block.bursts[jj]);
+                    }
+                }
+                for(unsigned int jj = 0; jj <= last; jj++)
+                {
+                    block.bursts[jj].reset();
+                }
+            }
+        }
+    }
+  } /* namespace gsm */
+} /* namespace gr */
@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_CELL_DEMAPPER_IMPL_H
+#define INCLUDED_GSM_CELL_DEMAPPER_IMPL_H
+
+#include <grgsm/demapping/cell_demapper.h>
+#include <grgsm/burst.h>
+#include <vector>
+
+namespace gr {
+  namespace gsm {
+
+    class cell_demapper_impl : public cell_demapper
+    {
+     private:
+      static const unsigned int MAX_BLOCK_BURSTS = 8;
+
+      /** Bursts of one block of a logical channel */
+      struct block_buffer
+      {
+        unsigned int length; ///< number of bursts of the block
+        uint32_t offsets[MAX_BLOCK_BURSTS]; ///< frame numbers of the bursts relative to the first one
+        uint32_t frame_numbers[MAX_BLOCK_BURSTS];
+        pmt::pmt_t bursts[MAX_BLOCK_BURSTS];
+        pmt::pmt_t port;
+      };
+
+      /** Where a burst in the given position of a multiframe goes */
+      struct burst_route
+      {
+        uint8_t sub_type; ///< GSMTAP channel type, GSMTAP_CHANNEL_UNKNOWN if the burst isn't demapped
+        uint8_t sub_slot;
+        uint8_t blocks_num; ///< TCH/F bursts are in two blocks
+        uint16_t blocks[2]; ///< indexes to d_blocks
+        uint8_t positions[2]; ///< positions in the blocks
+      };
+
+      unsigned int d_periods[8]; ///< length of the multiframe of each timeslot, in frames
+      std::vector<burst_route> d_routes[8]; ///< routes of each timeslot indexed by fn % d_periods[tn]
+      std::vector<block_buffer> d_blocks;
+      pmt::pmt_t d_bursts_port;
+      pmt::pmt_t d_tch_bursts_port;
+
+      void add_block(unsigned int timeslot, const unsigned int * frames, unsigned int length,
+                     uint8_t sub_type, uint8_t sub_slot, const pmt::pmt_t & port);
+      void map_ctrl_chans(unsigned int timeslot, const unsigned int * starts_fn_mod51,
+                          const uint8_t * channel_types, unsigned int blocks_num);
+      void map_tch_f(unsigned int timeslot);
+      void demap(pmt::pmt_t msg);
+
+     public:
+      cell_demapper_impl(const std::vector<int> &timeslot_configs);
+      ~cell_demapper_impl();
+    };
+
+  } // namespace gsm
+} // namespace gr
+
+#endif /* INCLUDED_GSM_CELL_DEMAPPER_IMPL_H */
@@ -28,8 +28,7 @@
 #include "tch_f_chans_demapper_impl.h"
 #include <grgsm/endian.h>
 #include <grgsm/gsmtap.h>
-
-#define BURST_SIZE 148
+#include <grgsm/burst.h>
 
 namespace gr {
   namespace gsm {
@@ -72,26 +71,22 @@ namespace gr {
 
     void tch_f_chans_demapper_impl::filter_tch_chans(pmt::pmt_t msg)
     {
-        pmt::pmt_t header_plus_burst = pmt::cdr(msg);
-        gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(header_plus_burst);
+        burst b(msg);
+        const gsmtap_hdr * header = &b.header();
 
         uint32_t frame_nr = be32toh(header->frame_number);
         uint32_t fn_mod26 = frame_nr % 26;
         uint32_t fn_mod13 = frame_nr % 13;
         bool frames_are_consecutive = true;
-        int8_t * burst_bits = (int8_t *)(pmt::blob_data(header_plus_burst))+sizeof(gsmtap_hdr);
 
         if(header->timeslot == d_timeslot){
-            int8_t new_msg[sizeof(gsmtap_hdr)+BURST_SIZE];
-            gsmtap_hdr * new_hdr = (gsmtap_hdr*)new_msg;
-            memcpy(new_msg, header, sizeof(gsmtap_hdr)+BURST_SIZE);
+            gsmtap_hdr new_header = *header;
 
-            new_hdr->sub_type = GSMTAP_CHANNEL_TCH_F;
+            new_header.sub_type = GSMTAP_CHANNEL_TCH_F;
             if (fn_mod13 == 12)
-                header->sub_type = GSMTAP_CHANNEL_ACCH|GSMTAP_CHANNEL_TCH_F;
+                new_header.sub_type = GSMTAP_CHANNEL_ACCH|GSMTAP_CHANNEL_TCH_F;
 
-            pmt::pmt_t msg_binary_blob = pmt::make_blob(new_msg,sizeof(gsmtap_hdr)+BURST_SIZE);
-            pmt::pmt_t msg_out = pmt::cons(pmt::PMT_NIL, msg_binary_blob);
+            pmt::pmt_t msg_out = burst::make(new_header, b.bits());
 
 
             if (fn_mod13 == 12)
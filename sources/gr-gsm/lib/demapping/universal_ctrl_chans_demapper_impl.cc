@@ -28,10 +28,9 @@
 #include "universal_ctrl_chans_demapper_impl.h"
 #include <grgsm/endian.h>
 #include <grgsm/gsmtap.h>
+#include <grgsm/burst.h>
 #include <set>
 
-#define BURST_SIZE 148
-
 namespace gr {
   namespace gsm {
 
@@ -140,8 +139,8 @@ namespace gr {
     
     void universal_ctrl_chans_demapper_impl::filter_ctrl_chans(pmt::pmt_t msg)
     {
-        pmt::pmt_t header_plus_burst = pmt::cdr(msg);
-        gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(header_plus_burst);
+        burst b(msg);
+        const gsmtap_hdr * header = &b.header();
             
         uint32_t frame_nr = be32toh(header->frame_number);
         uint32_t fn_mod51 = frame_nr % 51;
@@ -150,13 +149,10 @@ namespace gr {
         uint32_t ch_type = d_channel_types[fn_mod51];
         
         if(header->timeslot==d_timeslot){
-            int8_t new_msg[sizeof(gsmtap_hdr)+BURST_SIZE];
-            gsmtap_hdr * new_hdr = (gsmtap_hdr*)new_msg;
-            memcpy(new_msg, header, sizeof(gsmtap_hdr)+BURST_SIZE);
-            new_hdr->sub_type = ch_type;
-            new_hdr->sub_slot = d_subslots[fn_mod51 + (51 * (frame_nr % 2))];
-            pmt::pmt_t msg_binary_blob = pmt::make_blob(new_msg,sizeof(gsmtap_hdr)+BURST_SIZE);
-            pmt::pmt_t msg_out = pmt::cons(pmt::PMT_NIL, msg_binary_blob);
+            gsmtap_hdr new_header = *header;
+            new_header.sub_type = ch_type;
+            new_header.sub_slot = d_subslots[fn_mod51 + (51 * (frame_nr % 2))];
+            pmt::pmt_t msg_out = burst::make(new_header, b.bits());
 	    
             if(fn_mod51>=fn51_start && fn_mod51<=fn51_stop)
             {
@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <grgsm/endian.h>
 #include <grgsm/gsmtap.h>
+#include <grgsm/burst.h>
 
 
 namespace gr {
@@ -74,8 +75,8 @@ namespace gr {
 
     void burst_sdcch_subslot_splitter_impl::process_burst(pmt::pmt_t msg)
     {
-        pmt::pmt_t header_plus_burst = pmt::cdr(msg);
-        gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(header_plus_burst);
+        burst b(msg);
+        const gsmtap_hdr * header = &b.header();
         
         uint32_t frame_nr = be32toh(header->frame_number);
         uint32_t fn_mod102 = frame_nr % 102;
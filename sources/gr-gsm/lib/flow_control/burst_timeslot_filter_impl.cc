@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <grgsm/endian.h>
 #include <grgsm/gsmtap.h>
+#include <grgsm/burst.h>
 
 
 namespace gr {
@@ -63,8 +64,8 @@ namespace gr {
 
     void burst_timeslot_filter_impl::process_burst(pmt::pmt_t msg)
     {
-        pmt::pmt_t header_plus_burst = pmt::cdr(msg);
-        gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(header_plus_burst);
+        burst b(msg);
+        const gsmtap_hdr * header = &b.header();
         
         unsigned int timeslot = header->timeslot;
         
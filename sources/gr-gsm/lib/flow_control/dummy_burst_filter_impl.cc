@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <grgsm/endian.h>
 #include <grgsm/gsmtap.h>
+#include <grgsm/burst.h>
 
 
 namespace gr {
@@ -75,17 +76,16 @@ namespace gr {
 
     void dummy_burst_filter_impl::process_burst(pmt::pmt_t msg)
     {
-        pmt::pmt_t header_plus_burst = pmt::cdr(msg);
-        int8_t * burst = (int8_t *)(pmt::blob_data(header_plus_burst)) + sizeof(gsmtap_hdr);
-        size_t burst_len = pmt::blob_length(header_plus_burst) - sizeof(gsmtap_hdr);
-        
-        if (!is_dummy_burst(burst, burst_len))
+        burst b(msg);
+        int8_t hard_bits[burst::SIZE];
+
+        if (!is_dummy_burst(b.hard_bits(hard_bits), burst::SIZE))
         {
             message_port_pub(pmt::mp("out"), msg);
         }
     }
     
-    bool dummy_burst_filter_impl::is_dummy_burst(int8_t *burst, size_t burst_len)
+    bool dummy_burst_filter_impl::is_dummy_burst(const int8_t *burst, size_t burst_len)
     {
         if (burst_len != DUMMY_BURST_LEN)
         {
@@ -33,7 +33,7 @@ namespace gr {
     class dummy_burst_filter_impl : public dummy_burst_filter
     {
      private:
-      bool is_dummy_burst(int8_t *burst, size_t burst_len);
+      bool is_dummy_burst(const int8_t *burst, size_t burst_len);
       static const int8_t d_dummy_burst[];
      public:
       dummy_burst_filter_impl();
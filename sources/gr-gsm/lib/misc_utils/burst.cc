@@ -0,0 +1,84 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <grgsm/burst.h>
+#include <string.h>
+
+namespace gr {
+  namespace gsm {
+
+    burst::burst() : d_msg(pmt::PMT_NIL), d_header(NULL), d_bits(NULL)
+    {
+    }
+
+    burst::burst(const pmt::pmt_t & msg) : d_msg(msg)
+    {
+      if(!pmt::is_pair(msg) || !pmt::is_blob(pmt::cdr(msg))) {
+        throw pmt::wrong_type("gr::gsm::burst", msg);
+      }
+      pmt::pmt_t header_plus_burst = pmt::cdr(msg);
+      const int8_t * data = (const int8_t *)pmt::blob_data(header_plus_burst);
+      size_t len = pmt::blob_length(header_plus_burst);
+      if(len < sizeof(gsmtap_hdr)) {
+        throw pmt::wrong_type("gr::gsm::burst", msg);
+      }
+
+      if(len < sizeof(gsmtap_hdr) + SIZE) {
+        int8_t bits[SIZE];
+        size_t burst_len = len - sizeof(gsmtap_hdr);
+        memcpy(bits, data + sizeof(gsmtap_hdr), burst_len);
+        memset(bits + burst_len, 0, SIZE - burst_len);
+        d_msg = make(*(const gsmtap_hdr *)data, bits);
+        data = (const int8_t *)pmt::blob_data(pmt::cdr(d_msg));
+      }
+      d_header = (const gsmtap_hdr *)data;
+      d_bits = data + sizeof(gsmtap_hdr);
+    }
+
+    const int8_t *
+    burst::hard_bits(int8_t * buf) const
+    {
+      if(!is_soft()) {
+        return d_bits;
+      }
+      for(unsigned int ii = 0; ii < SIZE; ii++) {
+        buf[ii] = d_bits[ii] < 0;
+      }
+      return buf;
+    }
+
+    pmt::pmt_t
+    burst::make(const gsmtap_hdr & header, const int8_t * bits)
+    {
+      uint8_t header_plus_burst[sizeof(gsmtap_hdr) + SIZE];
+      memcpy(header_plus_burst, &header, sizeof(gsmtap_hdr));
+      memcpy(header_plus_burst + sizeof(gsmtap_hdr), bits, SIZE);
+
+      return pmt::cons_pooled(pmt::PMT_NIL, pmt::make_blob_pooled(header_plus_burst, sizeof(header_plus_burst)));
+    }
+
+  } /* namespace gsm */
+} /* namespace gr */
@@ -0,0 +1,367 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <grgsm/misc_utils/burst_container.h>
+#include <grgsm/endian.h>
+#include <stdexcept>
+#include <fstream>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace gr {
+  namespace gsm {
+
+    const char burst_container::MAGIC[8] = {'G', 'R', 'G', 'S', 'M', 'B', 'S', 'T'};
+
+    static uint32_t stream_key(const gsmtap_hdr & header)
+    {
+      return ((uint32_t)be16toh(header.arfcn) << 8) | header.timeslot;
+    }
+
+    bool burst_container::is_container(const std::string & filename)
+    {
+      char magic[sizeof(MAGIC)];
+      std::ifstream file(filename.c_str(), std::ifstream::binary);
+      return file.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+    uint32_t frame_unwrapper::unwrap(uint32_t fn)
+    {
+      if(!d_started) {
+        d_started = true;
+        d_last_fn = fn;
+      } else if(fn < d_last_fn && d_last_fn - fn > burst_container::HYPERFRAME / 2) {
+        d_wraps++;
+        d_last_fn = fn;
+      } else if(fn > d_last_fn && fn - d_last_fn > burst_container::HYPERFRAME / 2) {
+        //a late burst from before the last wrap
+        return d_wraps > 0 ? fn + (d_wraps - 1) * burst_container::HYPERFRAME : fn;
+      } else if(fn > d_last_fn) {
+        d_last_fn = fn;
+      }
+      return fn + d_wraps * burst_container::HYPERFRAME;
+    }
+
+    /*
+     * Writer
+     */
+    burst_container_writer::burst_container_writer(const std::string & filename)
+      : d_filename(filename), d_file(NULL), d_records_num(0)
+    {
+      open("wb");
+    }
+
+    burst_container_writer::~burst_container_writer()
+    {
+      close();
+    }
+
+    /*
+     * Opens the file and drops its index, if there is one. The header is
+     * complete only when the file is closed - until then it says that
+     * there is no index.
+     */
+    void burst_container_writer::open(const char * mode)
+    {
+      d_file = fopen(d_filename.c_str(), mode);
+      if(d_file == NULL) {
+        throw std::runtime_error("burst_container_writer: can't open " + d_filename + ": " + strerror(errno));
+      }
+
+      write_header(0);
+      off_t records_end = sizeof(burst_container::file_header) + d_records_num * sizeof(burst_container::record);
+      fseek(d_file, records_end, SEEK_SET);
+      if(ftruncate(fileno(d_file), records_end) != 0) {
+        fclose(d_file);
+        d_file = NULL;
+        throw std::runtime_error("burst_container_writer: can't truncate " + d_filename + ": " + strerror(errno));
+      }
+    }
+
+    void burst_container_writer::write_header(uint64_t index_offset)
+    {
+      burst_container::file_header header;
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, burst_container::MAGIC, sizeof(header.magic));
+      header.version = burst_container::VERSION;
+      header.record_size = sizeof(burst_container::record);
+      if(index_offset != 0) {
+        header.records_num = d_records_num;
+        header.index_offset = index_offset;
+        header.streams_num = d_streams.size();
+      }
+
+      fseek(d_file, 0, SEEK_SET);
+      fwrite(&header, sizeof(header), 1, d_file);
+    }
+
+    void burst_container_writer::append(const burst & b)
+    {
+      if(d_file == NULL) {
+        open("r+b");
+      }
+
+      burst_container::record r;
+      d_streams[stream_key(b.header())].push_back(d_records_num);
+
+      r.frame = d_unwrapper.unwrap(be32toh(b.header().frame_number));
+      memcpy(&r.header, &b.header(), sizeof(r.header));
+      memcpy(r.bits, b.bits(), sizeof(r.bits));
+      fwrite(&r, sizeof(r), 1, d_file);
+      d_records_num++;
+    }
+
+    void burst_container_writer::close()
+    {
+      if(d_file == NULL) {
+        return;
+      }
+
+      uint64_t index_offset = sizeof(burst_container::file_header) + d_records_num * sizeof(burst_container::record);
+      uint64_t first_entry = 0;
+      std::map<uint32_t, std::vector<uint64_t> >::const_iterator it;
+      for(it = d_streams.begin(); it != d_streams.end(); ++it) {
+        burst_container::stream s;
+        memset(&s, 0, sizeof(s));
+        s.arfcn = it->first >> 8;
+        s.timeslot = it->first & 0xff;
+        s.records_num = it->second.size();
+        s.first_entry = first_entry;
+        fwrite(&s, sizeof(s), 1, d_file);
+        first_entry += s.records_num;
+      }
+      for(it = d_streams.begin(); it != d_streams.end(); ++it) {
+        fwrite(&it->second[0], sizeof(uint64_t), it->second.size(), d_file);
+      }
+
+      write_header(index_offset);
+      fclose(d_file);
+      d_file = NULL;
+    }
+
+    /*
+     * Reader
+     */
+    burst_container_reader::burst_container_reader(const std::string & filename)
+      : d_data(NULL), d_size(0)
+    {
+      int fd = open(filename.c_str(), O_RDONLY);
+      if(fd < 0) {
+        throw std::runtime_error("burst_container_reader: can't open " + filename + ": " + strerror(errno));
+      }
+
+      struct stat st;
+      if(fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(burst_container::file_header)) {
+        d_size = st.st_size;
+        void * data = mmap(NULL, d_size, PROT_READ, MAP_SHARED, fd, 0);
+        if(data != MAP_FAILED) {
+          d_data = (const uint8_t *)data;
+          madvise(data, d_size, MADV_SEQUENTIAL);
+        }
+      }
+      ::close(fd);
+
+      const burst_container::file_header * header = (const burst_container::file_header *)d_data;
+      if(d_data == NULL || memcmp(header->magic, burst_container::MAGIC, sizeof(header->magic)) != 0 ||
+         header->version != burst_container::VERSION || header->record_size != sizeof(burst_container::record)) {
+        if(d_data != NULL) {
+          munmap((void *)d_data, d_size);
+        }
+        throw std::runtime_error("burst_container_reader: " + filename + " isn't a burst container");
+      }
+
+      d_records = (const burst_container::record *)(d_data + sizeof(burst_container::file_header));
+      if(index_is_valid(header)) {
+        d_records_num = header->records_num;
+        d_streams_num = header->streams_num;
+        d_streams = (const burst_container::stream *)(d_data + header->index_offset);
+        d_entries = (const uint64_t *)(d_streams + d_streams_num);
+      } else {
+        //records end where a damaged index begins, if that is plausible
+        uint64_t records_end = d_size;
+        if(header->index_offset >= sizeof(burst_container::file_header) && header->index_offset <= d_size &&
+           (header->index_offset - sizeof(burst_container::file_header)) % sizeof(burst_container::record) == 0) {
+          records_end = header->index_offset;
+        }
+        d_records_num = (records_end - sizeof(burst_container::file_header)) / sizeof(burst_container::record);
+        rebuild_index();
+      }
+    }
+
+    /*
+     * Checks that the records, the streams and the entries of the index
+     * fit in the file and that the entries point to records.
+     */
+    bool burst_container_reader::index_is_valid(const burst_container::file_header * header) const
+    {
+      const uint64_t records_start = sizeof(burst_container::file_header);
+      uint64_t index_offset = header->index_offset;
+
+      if(index_offset < records_start || index_offset > d_size || index_offset % sizeof(uint64_t) != 0 ||
+         header->records_num > (index_offset - records_start) / sizeof(burst_container::record)) {
+        return false;
+      }
+
+      uint64_t index_size = d_size - index_offset;
+      if(header->streams_num > index_size / sizeof(burst_container::stream)) {
+        return false;
+      }
+
+      const burst_container::stream * streams = (const burst_container::stream *)(d_data + index_offset);
+      const uint64_t * entries = (const uint64_t *)(streams + header->streams_num);
+      uint64_t entries_num = (index_size - header->streams_num * sizeof(burst_container::stream)) / sizeof(uint64_t);
+
+      for(uint32_t ii = 0; ii < header->streams_num; ii++) {
+        const burst_container::stream & s = streams[ii];
+        if(s.first_entry > entries_num || s.records_num > entries_num - s.first_entry) {
+          return false;
+        }
+        for(uint64_t jj = 0; jj < s.records_num; jj++) {
+          if(entries[s.first_entry + jj] >= header->records_num) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    burst_container_reader::~burst_container_reader()
+    {
+      munmap((void *)d_data, d_size);
+    }
+
+    void burst_container_reader::rebuild_index()
+    {
+      std::map<uint32_t, std::vector<uint64_t> > streams;
+      for(uint64_t ii = 0; ii < d_records_num; ii++) {
+        streams[stream_key(d_records[ii].header)].push_back(ii);
+      }
+
+      std::map<uint32_t, std::vector<uint64_t> >::const_iterator it;
+      for(it = streams.begin(); it != streams.end(); ++it) {
+        burst_container::stream s;
+        memset(&s, 0, sizeof(s));
+        s.arfcn = it->first >> 8;
+        s.timeslot = it->first & 0xff;
+        s.records_num = it->second.size();
+        s.first_entry = d_rebuilt_entries.size();
+        d_rebuilt_streams.push_back(s);
+        d_rebuilt_entries.insert(d_rebuilt_entries.end(), it->second.begin(), it->second.end());
+      }
+
+      d_streams_num = d_rebuilt_streams.size();
+      d_streams = d_rebuilt_streams.empty() ? NULL : &d_rebuilt_streams[0];
+      d_entries = d_rebuilt_entries.empty() ? NULL : &d_rebuilt_entries[0];
+    }
+
+    uint64_t burst_container_reader::lower_bound(uint32_t frame) const
+    {
+      uint64_t result = d_records_num;
+      for(uint32_t ii = 0; ii < d_streams_num; ii++) {
+        const uint64_t * records = stream_records(ii);
+        uint64_t lo = 0, hi = d_streams[ii].records_num;
+        while(lo < hi) {
+          uint64_t mid = lo + (hi - lo) / 2;
+          if(d_records[records[mid]].frame < frame) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+        if(lo < d_streams[ii].records_num && records[lo] < result) {
+          result = records[lo];
+        }
+      }
+      return result;
+    }
+
+    uint64_t burst_container_reader::upper_bound(uint32_t frame) const
+    {
+      uint64_t result = 0;
+      for(uint32_t ii = 0; ii < d_streams_num; ii++) {
+        const uint64_t * records = stream_records(ii);
+        uint64_t lo = 0, hi = d_streams[ii].records_num;
+        while(lo < hi) {
+          uint64_t mid = lo + (hi - lo) / 2;
+          if(d_records[records[mid]].frame <= frame) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+        if(lo > 0 && records[lo - 1] + 1 > result) {
+          result = records[lo - 1] + 1;
+        }
+      }
+      return result;
+    }
+
+    /*
+     * Converters
+     */
+    uint64_t burst_file_to_container(const std::string & burst_filename, const std::string & container_filename)
+    {
+      std::ifstream input(burst_filename.c_str(), std::ifstream::binary);
+      if(!input) {
+        throw std::runtime_error("burst_file_to_container: can't open " + burst_filename);
+      }
+      burst_container_writer writer(container_filename);
+      uint64_t bursts_num = 0;
+
+      while(input.peek() != EOF) {
+        pmt::pmt_t msg = pmt::deserialize(*input.rdbuf());
+        if(pmt::eq(msg, pmt::PMT_EOF)) {
+          break;
+        }
+        writer.append(burst(msg));
+        bursts_num++;
+      }
+      writer.close();
+      return bursts_num;
+    }
+
+    uint64_t container_to_burst_file(const std::string & container_filename, const std::string & burst_filename)
+    {
+      burst_container_reader reader(container_filename);
+      std::ofstream output(burst_filename.c_str(), std::ofstream::binary);
+      if(!output) {
+        throw std::runtime_error("container_to_burst_file: can't create " + burst_filename);
+      }
+
+      for(uint64_t ii = 0; ii < reader.records_num(); ii++) {
+        const burst_container::record & r = reader.at(ii);
+        std::string s = pmt::serialize_str(burst::make(r.header, r.bits));
+        output.write(s.data(), s.length());
+      }
+      return reader.records_num();
+    }
+
+  } /* namespace gsm */
+} /* namespace gr */
@@ -26,27 +26,36 @@
 
 #include <gnuradio/io_signature.h>
 #include "burst_file_sink_impl.h"
+#include <grgsm/burst.h>
 #include "stdio.h"
 
 namespace gr {
   namespace gsm {
 
     burst_file_sink::sptr
-    burst_file_sink::make(const std::string &filename)
+    burst_file_sink::make(const std::string &filename, bool indexed)
     {
       return gnuradio::get_initial_sptr
-        (new burst_file_sink_impl(filename));
+        (new burst_file_sink_impl(filename, indexed));
     }
 
     /*
      * The private constructor
      */
-    burst_file_sink_impl::burst_file_sink_impl(const std::string &filename)
+    burst_file_sink_impl::burst_file_sink_impl(const std::string &filename, bool indexed)
       : gr::block("burst_file_sink",
               gr::io_signature::make(0, 0, 0),
-              gr::io_signature::make(0, 0, 0)),
-              d_output_file(filename.c_str(), std::ofstream::binary)
+              gr::io_signature::make(0, 0, 0))
     {
+        if (indexed)
+        {
+            d_container.reset(new burst_container_writer(filename));
+        }
+        else
+        {
+            d_output_file.open(filename.c_str(), std::ofstream::binary);
+        }
+
         message_port_register_in(pmt::mp("in"));
         set_msg_handler(pmt::mp("in"), boost::bind(&burst_file_sink_impl::process_burst, this, _1));
     }
@@ -62,8 +71,23 @@ namespace gr {
         }
     }
 
+    bool burst_file_sink_impl::stop()
+    {
+        //the index is written when the container is closed
+        if (d_container)
+        {
+            d_container->close();
+        }
+        return block::stop();
+    }
+
     void burst_file_sink_impl::process_burst(pmt::pmt_t msg)
     {
+        if (d_container)
+        {
+            d_container->append(burst(msg));
+            return;
+        }
         std::string s = pmt::serialize_str(msg);
         const char *serialized = s.data();
         d_output_file.write(serialized, s.length());
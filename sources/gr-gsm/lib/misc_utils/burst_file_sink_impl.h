@@ -24,6 +24,8 @@
 #define INCLUDED_GSM_BURST_FILE_SINK_IMPL_H
 
 #include <grgsm/misc_utils/burst_file_sink.h>
+#include <grgsm/misc_utils/burst_container.h>
+#include <boost/scoped_ptr.hpp>
 #include <fstream>
 
 namespace gr {
@@ -33,9 +35,11 @@ namespace gr {
     {
      private:
         std::ofstream d_output_file;
+        boost::scoped_ptr<burst_container_writer> d_container;
      public:
-      burst_file_sink_impl(const std::string &filename);
+      burst_file_sink_impl(const std::string &filename, bool indexed);
       ~burst_file_sink_impl();
+      bool stop();
       void process_burst(pmt::pmt_t msg);
     };
 
@@ -26,6 +26,10 @@
 
 #include <gnuradio/io_signature.h>
 #include "burst_file_source_impl.h"
+#include <grgsm/misc_utils/burst_container.h>
+#include <grgsm/burst.h>
+#include <grgsm/endian.h>
+#include <string.h>
 #include "stdio.h"
 
 #define PMT_SIZE 174
@@ -34,22 +38,29 @@ namespace gr {
   namespace gsm {
 
     burst_file_source::sptr
-    burst_file_source::make(const std::string &filename)
+    burst_file_source::make(const std::string &filename, unsigned int first_frame, unsigned int last_frame)
     {
       return gnuradio::get_initial_sptr
-        (new burst_file_source_impl(filename));
+        (new burst_file_source_impl(filename, first_frame, last_frame));
     }
 
     /*
      * The private constructor
      */
-    burst_file_source_impl::burst_file_source_impl(const std::string &filename)
+    burst_file_source_impl::burst_file_source_impl(const std::string &filename, unsigned int first_frame, unsigned int last_frame)
       : gr::block("burst_file_source",
               gr::io_signature::make(0, 0, 0),
               gr::io_signature::make(0, 0, 0)),
-              d_input_file(filename.c_str(), std::ifstream::binary),
+              d_filename(filename),
+              d_indexed(burst_container::is_container(filename)),
+              d_first_frame(first_frame),
+              d_last_frame(last_frame),
               d_finished(false)
     {
+        if (!d_indexed)
+        {
+            d_input_file.open(filename.c_str(), std::ifstream::binary);
+        }
         message_port_register_out(pmt::mp("out"));
     }
 
@@ -86,6 +97,15 @@ namespace gr {
 
     void burst_file_source_impl::run()
     {
+        if (d_indexed)
+        {
+            replay_container();
+            post(pmt::mp("system"), pmt::cons(pmt::mp("done"), pmt::from_long(1)));
+            return;
+        }
+
+        bool whole_file = d_first_frame == 0 && d_last_frame == 0xffffffff;
+        frame_unwrapper unwrapper;
         char *unserialized = (char*)malloc(sizeof(char) * PMT_SIZE);
         while (d_input_file.read(unserialized, PMT_SIZE) && !d_finished)
         {
@@ -95,12 +115,38 @@ namespace gr {
             }
 
             std::string s(unserialized, PMT_SIZE);
-            pmt::pmt_t burst = pmt::deserialize_str(s);
-            message_port_pub(pmt::mp("out"), burst);
+            pmt::pmt_t msg = pmt::deserialize_str(s);
+            if (!whole_file)
+            {
+                uint32_t frame_nr = unwrapper.unwrap(be32toh(burst(msg).header().frame_number));
+                if (frame_nr < d_first_frame || frame_nr > d_last_frame)
+                {
+                    continue;
+                }
+            }
+            message_port_pub(pmt::mp("out"), msg);
         }
+        free(unserialized);
         d_input_file.close();
         post(pmt::mp("system"), pmt::cons(pmt::mp("done"), pmt::from_long(1)));
     }
+
+    void burst_file_source_impl::replay_container()
+    {
+        burst_container_reader reader(d_filename);
+        uint64_t end = reader.upper_bound(d_last_frame);
+
+        for (uint64_t ii = reader.lower_bound(d_first_frame); ii < end && !d_finished; ii++)
+        {
+            const burst_container::record & r = reader.at(ii);
+            if (r.frame < d_first_frame || r.frame > d_last_frame)
+            {
+                continue;
+            }
+
+            message_port_pub(pmt::mp("out"), burst::make(r.header, r.bits));
+        }
+    }
   } /* namespace gsm */
 } /* namespace gr */
 
@@ -33,11 +33,16 @@ namespace gr {
     {
      private:
         boost::shared_ptr<gr::thread::thread> d_thread;
+        std::string d_filename;
         std::ifstream d_input_file;
+        bool d_indexed;
+        unsigned int d_first_frame;
+        unsigned int d_last_frame;
         bool d_finished;
         void run();
+        void replay_container();
      public:
-        burst_file_source_impl(const std::string &filename);
+        burst_file_source_impl(const std::string &filename, unsigned int first_frame, unsigned int last_frame);
         ~burst_file_source_impl();
         bool start();
         bool stop();
@@ -26,6 +26,7 @@
 
 #include <gnuradio/io_signature.h>
 #include <grgsm/gsmtap.h>
+#include <grgsm/burst.h>
 #include <grgsm/endian.h>
 #include <iterator>
 #include <algorithm>
@@ -54,11 +55,12 @@ namespace gr {
 
     void bursts_printer_impl::bursts_print(pmt::pmt_t msg)
     {
-        pmt::pmt_t header_plus_burst = pmt::cdr(msg);
+        burst b(msg);
 
-        gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(header_plus_burst);
-        int8_t * burst = (int8_t *)(pmt::blob_data(header_plus_burst))+sizeof(gsmtap_hdr);
-        size_t burst_len=pmt::blob_length(header_plus_burst)-sizeof(gsmtap_hdr);
+        const gsmtap_hdr * header = &b.header();
+        size_t burst_len = burst::SIZE;
+        int8_t hard_bits[burst::SIZE];
+        const int8_t * burst = b.hard_bits(hard_bits);
         uint32_t frame_nr = be32toh(header->frame_number);
 
         if (d_ignore_dummy_bursts && is_dummy_burst(burst, burst_len))
@@ -110,7 +112,7 @@ namespace gr {
         std::cout << std::endl;
     }
 
-    bool bursts_printer_impl::is_dummy_burst(int8_t *burst, size_t burst_len)
+    bool bursts_printer_impl::is_dummy_burst(const int8_t *burst, size_t burst_len)
     {
         if (burst_len != DUMMY_BURST_LEN)
         {
@@ -40,7 +40,7 @@ namespace gr {
       bool d_prepend_frame_count;
       bool d_print_payload_only;
       bool d_ignore_dummy_bursts;
-      bool is_dummy_burst(int8_t *burst, size_t burst_len);
+      bool is_dummy_burst(const int8_t *burst, size_t burst_len);
       static const int8_t d_dummy_burst[];
      public:
       bursts_printer_impl(pmt::pmt_t prepend_string, bool prepend_fnr=false,
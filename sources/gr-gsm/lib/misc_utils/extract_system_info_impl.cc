@@ -26,6 +26,7 @@
 
 #include <gnuradio/io_signature.h>
 #include <grgsm/gsmtap.h>
+#include <grgsm/burst.h>
 #include <unistd.h>
 #include <map>
 #include <iterator>
@@ -45,8 +46,8 @@ namespace gr {
     boost::mutex extract_mutex;
     void extract_system_info_impl::process_bursts(pmt::pmt_t msg)
     {
-        pmt::pmt_t burst_plus_header_blob = pmt::cdr(msg);
-        gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(burst_plus_header_blob);
+        burst b(msg);
+        const gsmtap_hdr * header = &b.header();
 
         chan_info info;
         info.id = be16toh(header->arfcn);
@@ -0,0 +1,362 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gnuradio/io_signature.h>
+#include "gsmtap_sink_impl.h"
+#include <grgsm/endian.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/time.h>
+#include <stdexcept>
+#include <sstream>
+#include <algorithm>
+
+#define MAX_DATAGRAMS      1024       // per sendmmsg() call, the limit of the kernel
+#define PCAP_BUFFER_SIZE   (1 << 20)
+#define PCAP_LINKTYPE_RAW  101        // packets start with the IPv4 header
+#define IP_HEADER_SIZE     20
+#define UDP_HEADER_SIZE    8
+
+namespace gr {
+  namespace gsm {
+
+    gsmtap_sink::sptr
+    gsmtap_sink::make(const std::string &host, int port, const std::string &pcap_filename)
+    {
+      return gnuradio::get_initial_sptr
+        (new gsmtap_sink_impl(host, port, pcap_filename));
+    }
+
+    /*
+     * The private constructor
+     */
+    gsmtap_sink_impl::gsmtap_sink_impl(const std::string &host, int port, const std::string &pcap_filename)
+      : gr::block("gsmtap_sink",
+              gr::io_signature::make(0, 0, 0),
+              gr::io_signature::make(0, 0, 0)),
+              d_socket(-1),
+              d_src_addr(htobe32(0x7f000001)),
+              d_dst_addr(htobe32(0x7f000001)),
+              d_src_port(0),
+              d_dst_port(htobe16(port)),
+              d_ip_id(0),
+              d_pcap_file(NULL),
+              d_sent(0),
+              d_send_errors(0)
+    {
+        open_socket(host, port);
+        if(!pcap_filename.empty())
+        {
+            open_pcap(pcap_filename);
+        }
+
+        message_port_register_in(pmt::mp("in"));
+        set_msg_batch_handler(pmt::mp("in"), boost::bind(&gsmtap_sink_impl::send, this, _1));
+    }
+
+    /*
+     * Our virtual destructor.
+     */
+    gsmtap_sink_impl::~gsmtap_sink_impl()
+    {
+        if(d_pcap_file != NULL)
+        {
+            flush_pcap();
+            fclose(d_pcap_file);
+        }
+        if(d_socket != -1)
+        {
+            close(d_socket);
+        }
+    }
+
+    /*
+     * Connects a UDP socket to the destination, so that datagrams are
+     * sent without an address and ICMP errors are reported
+     */
+    void gsmtap_sink_impl::open_socket(const std::string &host, int port)
+    {
+        struct addrinfo hints;
+        struct addrinfo * result;
+        std::ostringstream service;
+
+        service << port;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+
+        int error = getaddrinfo(host.c_str(), service.str().c_str(), &hints, &result);
+        if(error != 0)
+        {
+            throw std::runtime_error("gsmtap_sink: can't resolve " + host + ": " + gai_strerror(error));
+        }
+
+        for(struct addrinfo * ai = result; ai != NULL; ai = ai->ai_next)
+        {
+            d_socket = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if(d_socket == -1)
+            {
+                continue;
+            }
+            if(connect(d_socket, ai->ai_addr, ai->ai_addrlen) == 0)
+            {
+                if(ai->ai_family == AF_INET)
+                {
+                    d_dst_addr = ((struct sockaddr_in *)ai->ai_addr)->sin_addr.s_addr;
+                }
+                break;
+            }
+            close(d_socket);
+            d_socket = -1;
+        }
+        freeaddrinfo(result);
+
+        if(d_socket == -1)
+        {
+            throw std::runtime_error("gsmtap_sink: can't connect to " + host + ": " + strerror(errno));
+        }
+
+        struct sockaddr_storage local;
+        socklen_t local_len = sizeof(local);
+        if(getsockname(d_socket, (struct sockaddr *)&local, &local_len) == 0 &&
+           local.ss_family == AF_INET)
+        {
+            d_src_addr = ((struct sockaddr_in *)&local)->sin_addr.s_addr;
+            d_src_port = ((struct sockaddr_in *)&local)->sin_port;
+        }
+    }
+
+    void gsmtap_sink_impl::open_pcap(const std::string &pcap_filename)
+    {
+        d_pcap_file = fopen(pcap_filename.c_str(), "wb");
+        if(d_pcap_file == NULL)
+        {
+            throw std::runtime_error("gsmtap_sink: can't open " + pcap_filename + ": " + strerror(errno));
+        }
+        //the buffer is written with single fwrite calls
+        setvbuf(d_pcap_file, NULL, _IONBF, 0);
+        d_pcap_buffer.reserve(PCAP_BUFFER_SIZE);
+
+        uint32_t magic = 0xa1b2c3d4;
+        uint16_t version_major = 2;
+        uint16_t version_minor = 4;
+        int32_t thiszone = 0;
+        uint32_t sigfigs = 0;
+        uint32_t snaplen = 65535;
+        uint32_t linktype = PCAP_LINKTYPE_RAW;
+
+        const uint8_t * fields[] = {(uint8_t *)&magic, (uint8_t *)&version_major, (uint8_t *)&version_minor,
+                                    (uint8_t *)&thiszone, (uint8_t *)&sigfigs, (uint8_t *)&snaplen,
+                                    (uint8_t *)&linktype};
+        const size_t sizes[] = {4, 2, 2, 4, 4, 4, 4};
+        for(unsigned int ii = 0; ii < sizeof(sizes) / sizeof(sizes[0]); ii++)
+        {
+            d_pcap_buffer.insert(d_pcap_buffer.end(), fields[ii], fields[ii] + sizes[ii]);
+        }
+    }
+
+    /*
+     * Sends all messages of a batch. The datagrams point into the
+     * blobs of the messages, which stay referenced by msgs until they
+     * are sent. Messages which aren't PDUs with a blob are skipped.
+     */
+    void gsmtap_sink_impl::send(const std::vector<pmt::pmt_t> &msgs)
+    {
+        d_iovecs.clear();
+
+        for(size_t ii = 0; ii < msgs.size(); ii++)
+        {
+            const pmt::pmt_t & msg = msgs[ii];
+            if(!pmt::is_pair(msg) || !pmt::is_blob(pmt::cdr(msg)))
+            {
+                continue;
+            }
+
+            pmt::pmt_t blob = pmt::cdr(msg);
+            struct iovec iov;
+            iov.iov_base = const_cast<void *>(pmt::blob_data(blob));
+            iov.iov_len = pmt::blob_length(blob);
+            d_iovecs.push_back(iov);
+        }
+
+        send_datagrams();
+        if(d_pcap_file != NULL)
+        {
+            write_pcap();
+        }
+    }
+
+    void gsmtap_sink_impl::send_datagrams()
+    {
+        size_t num = d_iovecs.size();
+#ifdef __linux__
+        d_mmsgs.resize(num);
+        for(size_t ii = 0; ii < num; ii++)
+        {
+            struct msghdr & hdr = d_mmsgs[ii].msg_hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            hdr.msg_iov = &d_iovecs[ii];
+            hdr.msg_iovlen = 1;
+        }
+
+        size_t next = 0;
+        int retries = 0;
+        while(next < num)
+        {
+            unsigned int vlen = std::min(num - next, (size_t)MAX_DATAGRAMS);
+            int sent = sendmmsg(d_socket, &d_mmsgs[next], vlen, 0);
+            if(sent < 0 && (errno == ECONNREFUSED || errno == EINTR) && retries < MAX_SEND_RETRIES)
+            {
+                //an ICMP error of an earlier datagram (nobody listens
+                //yet) is reported once, retry
+                retries++;
+            }
+            else if(sent < 0 && errno == ECONNREFUSED)
+            {
+                //still nobody listening, the rest of the batch is dropped
+                d_send_errors += num - next;
+                break;
+            }
+            else if(sent <= 0)
+            {
+                //e.g. ENOBUFS, the datagram is lost as a sent one could be
+                next++;
+                d_send_errors++;
+                retries = 0;
+            }
+            else
+            {
+                next += sent;
+                d_sent += sent;
+                retries = 0;
+            }
+        }
+#else
+        for(size_t ii = 0; ii < num; ii++)
+        {
+            struct msghdr hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            hdr.msg_iov = &d_iovecs[ii];
+            hdr.msg_iovlen = 1;
+
+            ssize_t sent = sendmsg(d_socket, &hdr, 0);
+            if(sent < 0 && (errno == ECONNREFUSED || errno == EINTR))
+            {
+                sent = sendmsg(d_socket, &hdr, 0);
+            }
+            if(sent < 0)
+            {
+                d_send_errors++;
+            }
+            else
+            {
+                d_sent++;
+            }
+        }
+#endif
+    }
+
+    /*
+     * Appends the datagrams of the batch to the pcap buffer as IPv4/UDP
+     * packets, all with the time of the batch
+     */
+    void gsmtap_sink_impl::write_pcap()
+    {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+
+        for(size_t ii = 0; ii < d_iovecs.size(); ii++)
+        {
+            const struct iovec & d = d_iovecs[ii];
+            uint32_t packet_len = IP_HEADER_SIZE + UDP_HEADER_SIZE + d.iov_len;
+            if(d_pcap_buffer.size() + 16 + packet_len > PCAP_BUFFER_SIZE)
+            {
+                flush_pcap();
+            }
+
+            uint32_t record[4] = {(uint32_t)tv.tv_sec, (uint32_t)tv.tv_usec, packet_len, packet_len};
+            d_pcap_buffer.insert(d_pcap_buffer.end(), (uint8_t *)record, (uint8_t *)(record + 4));
+
+            uint8_t ip[IP_HEADER_SIZE + UDP_HEADER_SIZE];
+            uint16_t total_len = htobe16(packet_len);
+            uint16_t id = htobe16(d_ip_id++);
+            uint16_t udp_len = htobe16(UDP_HEADER_SIZE + d.iov_len);
+
+            memset(ip, 0, sizeof(ip));
+            ip[0] = 0x45;                       //IPv4, 5 words of header
+            memcpy(ip + 2, &total_len, 2);
+            memcpy(ip + 4, &id, 2);
+            ip[6] = 0x40;                       //don't fragment
+            ip[8] = 64;                         //TTL
+            ip[9] = IPPROTO_UDP;
+            memcpy(ip + 12, &d_src_addr, 4);
+            memcpy(ip + 16, &d_dst_addr, 4);
+
+            uint32_t sum = 0;
+            for(int jj = 0; jj < IP_HEADER_SIZE; jj += 2)
+            {
+                sum += (ip[jj] << 8) | ip[jj + 1];
+            }
+            sum = (sum & 0xffff) + (sum >> 16);
+            sum = (sum & 0xffff) + (sum >> 16);
+            ip[10] = ~sum >> 8;
+            ip[11] = ~sum & 0xff;
+
+            //UDP checksum 0 - not computed
+            memcpy(ip + IP_HEADER_SIZE, &d_src_port, 2);
+            memcpy(ip + IP_HEADER_SIZE + 2, &d_dst_port, 2);
+            memcpy(ip + IP_HEADER_SIZE + 4, &udp_len, 2);
+            d_pcap_buffer.insert(d_pcap_buffer.end(), ip, ip + sizeof(ip));
+
+            const uint8_t * data = (const uint8_t *)d.iov_base;
+            d_pcap_buffer.insert(d_pcap_buffer.end(), data, data + d.iov_len);
+        }
+    }
+
+    void gsmtap_sink_impl::flush_pcap()
+    {
+        if(!d_pcap_buffer.empty())
+        {
+            if(fwrite(&d_pcap_buffer[0], d_pcap_buffer.size(), 1, d_pcap_file) != 1)
+            {
+                perror("gsmtap_sink: writing the pcap file");
+            }
+            d_pcap_buffer.clear();
+        }
+    }
+
+    bool gsmtap_sink_impl::stop()
+    {
+        if(d_pcap_file != NULL)
+        {
+            flush_pcap();
+        }
+        return block::stop();
+    }
+  } /* namespace gsm */
+} /* namespace gr */
@@ -0,0 +1,79 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_GSMTAP_SINK_IMPL_H
+#define INCLUDED_GSM_GSMTAP_SINK_IMPL_H
+
+#include <grgsm/misc_utils/gsmtap_sink.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+
+namespace gr {
+  namespace gsm {
+
+    class gsmtap_sink_impl : public gsmtap_sink
+    {
+     private:
+        static const int MAX_SEND_RETRIES = 1; ///< retries of a send failing with ECONNREFUSED or EINTR
+
+        int d_socket;
+        uint32_t d_src_addr;        ///< IPv4 addresses and ports of the pcap packets,
+        uint32_t d_dst_addr;        ///< in network byte order
+        uint16_t d_src_port;
+        uint16_t d_dst_port;
+        uint16_t d_ip_id;
+
+        FILE * d_pcap_file;
+        std::vector<uint8_t> d_pcap_buffer;
+
+        std::vector<struct iovec> d_iovecs; ///< one datagram each, pointing into a message blob
+#ifdef __linux__
+        std::vector<struct mmsghdr> d_mmsgs;
+#endif
+
+        unsigned long d_sent;
+        unsigned long d_send_errors;
+
+        void open_socket(const std::string &host, int port);
+        void open_pcap(const std::string &pcap_filename);
+        void send_datagrams();
+        void write_pcap();
+        void flush_pcap();
+
+     public:
+      gsmtap_sink_impl(const std::string &host, int port, const std::string &pcap_filename);
+      ~gsmtap_sink_impl();
+
+      void send(const std::vector<pmt::pmt_t> &msgs);
+      bool stop();
+
+      unsigned long sent() const { return d_sent; }
+      unsigned long send_errors() const { return d_send_errors; }
+    };
+
+  } // namespace gsm
+} // namespace gr
+
+#endif /* INCLUDED_GSM_GSMTAP_SINK_IMPL_H */
@@ -30,6 +30,7 @@
 #include <sstream>
 #include <grgsm/endian.h>
 #include <grgsm/gsmtap.h>
+#include <grgsm/burst.h>
 
 namespace gr {
   namespace gsm {
@@ -66,11 +67,12 @@ namespace gr {
 
     void burst_sink_impl::process_burst(pmt::pmt_t msg)
     {
-        pmt::pmt_t header_plus_burst = pmt::cdr(msg);
+        burst b(msg);
 
-        gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(header_plus_burst);
-        int8_t * burst = (int8_t *)(pmt::blob_data(header_plus_burst))+sizeof(gsmtap_hdr);
-        size_t burst_len=pmt::blob_length(header_plus_burst)-sizeof(gsmtap_hdr);
+        const gsmtap_hdr * header = &b.header();
+        size_t burst_len = burst::SIZE;
+        int8_t hard_bits[burst::SIZE];
+        const int8_t * burst = b.hard_bits(hard_bits);
         uint32_t frame_nr = be32toh(header->frame_number);
 
         std::stringstream burst_str;
@@ -0,0 +1,228 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <burst_detector.h>
+#include <viterbi_detector.h>
+#include <algorithm>
+#include <math.h>
+
+#define SOFT_BIT_SCALE 16.0f   //soft bit of an undistorted bit, relative to the energy of the channel impulse response
+
+burst_detector::burst_detector(int osr) :
+    d_OSR(osr),
+    d_chan_imp_length(CHAN_IMP_RESP_LENGTH),
+    d_norm_search_start_pos((int)((TRAIN_POS + GUARD_PERIOD) * osr) + 1 - 5 * osr),
+    d_norm_search_length(CHAN_IMP_RESP_LENGTH * osr + 10 * osr - 1),
+    d_norm_correlator(osr, d_norm_search_length),
+    d_allocations(0)
+{
+    d_channel_imp_resp.resize(d_chan_imp_length * d_OSR);
+    d_window_energy_buffer.resize(d_norm_search_length);
+    d_rhh_temp.resize(d_chan_imp_length * d_OSR);
+}
+
+void burst_detector::set_norm_training_seqs(const gr_complex (* norm_training_seqs)[N_TRAIN_BITS])
+{
+    d_norm_correlator.set_sequences(&norm_training_seqs[0][TRAIN_BEGINNING], TRAIN_SEQ_NUM, N_TRAIN_BITS - 10, N_TRAIN_BITS);
+}
+
+double burst_detector::signal_power(const gr_complex * input)
+{
+    double signal_pwr = 0;
+    for(int ii=GUARD_PERIOD;ii<TS_BITS;ii++)
+    {
+        signal_pwr += abs(input[ii])*abs(input[ii]);
+    }
+    return signal_pwr/(TS_BITS);
+}
+
+void burst_detector::detect_burst(const gr_complex * input, gr_complex * chan_imp_resp, int burst_start, unsigned char * output_binary, int8_t * output_soft)
+{
+    float output[BURST_SIZE];
+    gr_complex * rhh_temp = scratch(d_rhh_temp, d_chan_imp_length*d_OSR);
+    gr_complex rhh[CHAN_IMP_RESP_LENGTH];
+    gr_complex filtered_burst[BURST_SIZE];
+    int start_state = 3;
+    unsigned int stop_states[2] = {4, 12};
+
+    autocorrelation(chan_imp_resp, rhh_temp, d_chan_imp_length*d_OSR);
+    for (int ii = 0; ii < (d_chan_imp_length); ii++)
+    {
+        rhh[ii] = conj(rhh_temp[ii*d_OSR]);
+    }
+
+    mafi(&input[burst_start], BURST_SIZE, chan_imp_resp, d_chan_imp_length*d_OSR, filtered_burst);
+
+    if (output_soft)
+    {
+        //the sign of a soft output is the decision of viterbi_detector,
+        //so the hard bits come from the same pass; soft outputs are
+        //differences of path metrics, which grow with energy of the
+        //channel impulse response - it's taken out
+        viterbi_detector_soft(filtered_burst, BURST_SIZE, rhh, start_state, stop_states, 2, output);
+        const float scale = (rhh[0].real() > 0) ? -SOFT_BIT_SCALE / rhh[0].real() : 0;
+        for (int i = 0; i < BURST_SIZE ; i++)
+        {
+            output_binary[i] = (output[i] > 0);
+            float soft_bit = roundf(output[i] * scale);
+            output_soft[i] = (int8_t)std::max(-127.0f, std::min(127.0f, soft_bit));
+        }
+    }
+    else
+    {
+        viterbi_detector(filtered_burst, BURST_SIZE, rhh, start_state, stop_states, 2, output);
+
+        for (int i = 0; i < BURST_SIZE ; i++)
+        {
+            output_binary[i] = (output[i] > 0);
+        }
+    }
+}
+
+//computes autocorrelation for positive arguments
+inline void burst_detector::autocorrelation(const gr_complex * input, gr_complex * out, int nitems)
+{
+    int i, k;
+    for (k = nitems - 1; k >= 0; k--)
+    {
+        out[k] = gr_complex(0, 0);
+        for (i = k; i < nitems; i++)
+        {
+            out[k] += input[i] * conj(input[i-k]);
+        }
+    }
+}
+
+inline void burst_detector::mafi(const gr_complex * input, int nitems, gr_complex * filter, int filter_length, gr_complex * output)
+{
+    int ii = 0, n, a;
+
+    for (n = 0; n < nitems; n++)
+    {
+        a = n * d_OSR;
+        output[n] = 0;
+        ii = 0;
+
+        while (ii < filter_length)
+        {
+            if ((a + ii) >= nitems*d_OSR){
+                break;
+            }
+            output[n] += input[a+ii] * filter[ii];
+            ii++;
+        }
+    }
+}
+
+void burst_detector::correlate_norm_training_seqs(const gr_complex *input, const int * tseq_nums, int tseqs_num)
+{
+    d_norm_correlator.correlate(&input[d_norm_search_start_pos], d_norm_search_length, tseq_nums, tseqs_num);
+}
+
+int burst_detector::get_norm_chan_imp_resp(const gr_complex *input, gr_complex * chan_imp_resp, float *corr_max, int bcc)
+{
+    correlate_norm_training_seqs(input, &bcc, 1);
+    return norm_chan_imp_resp(chan_imp_resp, corr_max, bcc);
+}
+
+//especially computations of strongest_window_nr
+int burst_detector::norm_chan_imp_resp(gr_complex * chan_imp_resp, float *corr_max, int bcc)
+{
+    const int window_length = (d_chan_imp_length - 2) * d_OSR;
+    float * window_energy_buffer = scratch(d_window_energy_buffer, d_norm_search_length);
+    const gr_complex * correlation_buffer = d_norm_correlator.correlation(bcc);
+
+    int strongest_window_nr;
+    int windows_num;
+    int burst_start = 0;
+    int chan_imp_resp_center = 0;
+    float max_correlation = 0;
+
+    //compute window energies
+    windows_num = tseq_correlator::window_energies(d_norm_correlator.power(bcc), d_norm_search_length, window_length, window_energy_buffer);
+
+    strongest_window_nr = std::max_element(window_energy_buffer, window_energy_buffer + windows_num - d_chan_imp_length*d_OSR) - window_energy_buffer;
+    //strongest_window_nr = strongest_window_nr-d_OSR;
+    if(strongest_window_nr<0){
+       strongest_window_nr = 0;
+    }
+
+    max_correlation = 0;
+    for (int ii = 0; ii < (d_chan_imp_length)*d_OSR; ii++)
+    {
+        gr_complex correlation = correlation_buffer[strongest_window_nr + ii];
+        if (abs(correlation) > max_correlation)
+        {
+            chan_imp_resp_center = ii;
+            max_correlation = abs(correlation);
+        }
+        //     d_channel_imp_resp.push_back(correlation);
+        chan_imp_resp[ii] = correlation;
+    }
+
+    *corr_max = max_correlation;
+
+    //DCOUT("strongest_window_nr_new: " << strongest_window_nr);
+    burst_start = d_norm_search_start_pos + strongest_window_nr - TRAIN_POS * d_OSR; //compute first sample posiiton which corresponds to the first sample of the impulse response
+
+    //DCOUT("burst_start: " << burst_start);
+    return burst_start;
+}
+
+int burst_detector::find_tseq_num(const gr_complex * input)
+{
+    static const int all_tseq_nums[] = {TSC0, TSC1, TSC2, TSC3, TSC4, TSC5, TSC6, TSC7};
+    gr_complex * channel_imp_resp = scratch(d_channel_imp_resp, d_chan_imp_length*d_OSR);
+    float normal_corr_max;
+
+    correlate_norm_training_seqs(input, all_tseq_nums, 8); //all sequences are correlated in one pass
+    norm_chan_imp_resp(channel_imp_resp, &normal_corr_max, 0);
+    float ts_max=normal_corr_max;     //with use of a very simple algorithm based on finding
+    int ts_max_num=0;                 //maximum correlation
+    for(int ss=1; ss<=7; ss++)
+    {
+        norm_chan_imp_resp(channel_imp_resp, &normal_corr_max, ss);
+        if(ts_max<normal_corr_max)
+        {
+            ts_max = normal_corr_max;
+            ts_max_num = ss;
+        }
+    }
+    return ts_max_num;
+}
+
+bool burst_detector::detect_normal_burst(const gr_complex * input, int tseq_num, double signal_pwr, unsigned char * output_binary, int8_t * output_soft)
+{
+    gr_complex * channel_imp_resp = scratch(d_channel_imp_resp, d_chan_imp_length*d_OSR);
+    float normal_corr_max;
+    int burst_start = get_norm_chan_imp_resp(input, channel_imp_resp, &normal_corr_max, tseq_num);
+
+//  if(abs(d_c0_burst_start-burst_start)<=2){ //unused check/filter based on timing
+    if((normal_corr_max/sqrt(signal_pwr))>=0.9){
+        detect_burst(input, channel_imp_resp, burst_start, output_binary, output_soft);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,174 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_BURST_DETECTOR_H
+#define INCLUDED_GSM_BURST_DETECTOR_H
+
+#include <gnuradio/gr_complex.h>
+#include <gsm_constants.h>
+#include <tseq_correlator.h>
+#include <vector>
+#include <stdint.h>
+
+/** Channel estimation and MLSE detection of normal bursts
+ *
+ * All state needed to detect a burst - correlator and work buffers - is
+ * kept here, so one object can't be shared between threads, but copies of
+ * it can work on different carriers at the same time.
+ */
+class burst_detector
+{
+  private:
+    const int d_OSR; ///< oversampling ratio
+    const int d_chan_imp_length; ///< channel impulse length
+    const int d_norm_search_start_pos; ///< first sample of the window searched for a normal burst training sequence
+    const int d_norm_search_length; ///< number of searched offsets of a normal burst training sequence
+    tseq_correlator d_norm_correlator; ///< correlator with all normal and dummy burst training sequences
+
+    /**@name Preallocated buffers */
+    //@{
+    std::vector<gr_complex> d_channel_imp_resp; ///< channel impulse response used by detect_normal_burst
+    std::vector<float> d_window_energy_buffer; ///< energies of the channel impulse response windows
+    std::vector<gr_complex> d_rhh_temp; ///< autocorrelation of the channel impulse response
+    unsigned d_allocations; ///< number of times one of the buffers had to grow
+    //@}
+
+    template <typename T>
+    T * scratch(std::vector<T> & buffer, size_t size)
+    {
+        if (buffer.size() < size)
+        {
+            if (buffer.capacity() < size)
+            {
+                d_allocations++;
+            }
+            buffer.resize(size);
+        }
+        return &buffer[0];
+    }
+
+    /** Computes autocorrelation of input vector for positive arguments
+     *
+     * @param input vector with input samples
+     * @param out output vector
+     * @param nitems length of the input vector
+     */
+    inline void autocorrelation(const gr_complex * input, gr_complex * out, int nitems);
+
+    /** Filters input signal through channel impulse response
+     *
+     * @param input vector with input samples
+     * @param nitems number of samples to pass through filter
+     * @param filter filter taps - channel impulse response
+     * @param filter_length nember of filter taps
+     * @param output vector with filtered samples
+     */
+    inline void mafi(const gr_complex * input, int nitems, gr_complex * filter, int filter_length, gr_complex * output);
+
+  public:
+    /** Constructor
+     *
+     * @param osr oversampling ratio
+     */
+    burst_detector(int osr);
+
+    /** Sets training sequences
+     *
+     * @param norm_training_seqs MSK mapped training sequences of normal and dummy bursts
+     */
+    void set_norm_training_seqs(const gr_complex (* norm_training_seqs)[N_TRAIN_BITS]);
+
+    /** Computes mean power of the burst samples used to estimate signal level
+     *
+     * @param input vector with input samples
+     * @return mean power
+     */
+    static double signal_power(const gr_complex * input);
+
+    /** MLSE detection of a burst bits
+     *
+     * Detects bits of burst using viterbi algorithm.
+     * @param input vector with input samples
+     * @param chan_imp_resp vector with the channel impulse response
+     * @param burst_start number of the first sample of the burst
+     * @param output_binary vector with output bits
+     * @param output_soft vector with output soft bits (-127 is a sure 1, 127 a sure 0) - soft bits aren't computed if it's NULL
+     */
+    void detect_burst(const gr_complex * input, gr_complex * chan_imp_resp, int burst_start, unsigned char * output_binary, int8_t * output_soft = NULL);
+
+    /** Correlates a normal burst with several training sequences in one pass
+     *
+     * Results are used by subsequent norm_chan_imp_resp calls.
+     * @param input vector with input samples
+     * @param tseq_nums numbers of the training sequences
+     * @param tseqs_num number of the training sequences
+     */
+    void correlate_norm_training_seqs(const gr_complex *input, const int * tseq_nums, int tseqs_num);
+
+    /** Extracts channel impulse response from the last correlate_norm_training_seqs call
+     *
+     * @param chan_imp_resp complex vector where channel impulse response will be stored
+     * @param corr_max maximal correlation value in the channel impulse response
+     * @param bcc number of a training sequence - it has to be one of the correlated ones
+     * @return first sample number of normal burst
+     */
+    int norm_chan_imp_resp(gr_complex * chan_imp_resp, float *corr_max, int bcc);
+
+    /**  Extracts channel impulse response from a normal burst and computes first sample number of this burst
+     *
+     * @param input vector with input samples
+     * @param chan_imp_resp complex vector where channel impulse response will be stored
+     * @param corr_max maximal correlation value in the channel impulse response
+     * @param bcc base station color code - number of a training sequence
+     * @return first sample number of normal burst
+     */
+    int get_norm_chan_imp_resp(const gr_complex *input, gr_complex * chan_imp_resp, float *corr_max, int bcc);
+
+    /** Finds training sequence of a normal burst with the strongest correlation
+     *
+     * @param input vector with input samples
+     * @return number of the training sequence
+     */
+    int find_tseq_num(const gr_complex * input);
+
+    /** Detects a normal burst on a carrier other than C0
+     *
+     * The burst is detected only if the correlation with the training
+     * sequence is strong enough compared to the signal power.
+     * @param input vector with input samples
+     * @param tseq_num number of the training sequence
+     * @param signal_pwr mean power of the signal returned by signal_power
+     * @param output_binary vector with output bits
+     * @param output_soft vector with output soft bits or NULL
+     * @return true if a burst was detected
+     */
+    bool detect_normal_burst(const gr_complex * input, int tseq_num, double signal_pwr, unsigned char * output_binary, int8_t * output_soft = NULL);
+
+    /** Returns number of buffer allocations since the last call and resets it */
+    unsigned take_allocations()
+    {
+        unsigned allocations = d_allocations;
+        d_allocations = 0;
+        return allocations;
+    }
+};
+
+#endif /* INCLUDED_GSM_BURST_DETECTOR_H */
@@ -0,0 +1,162 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <carrier_pipeline.h>
+#include <boost/bind.hpp>
+
+#define SPINS_BEFORE_SLEEP 1000
+
+carrier_pipeline::worker::worker(const burst_detector & detector, int queue_size) :
+    jobs(queue_size),
+    detector(detector),
+    sleeping(false)
+{
+}
+
+carrier_pipeline::carrier_pipeline(int workers_num, int jobs_num, int samples_num, const burst_detector & detector) :
+    d_jobs(jobs_num),
+    d_in_flight(jobs_num),
+    d_next_worker(0),
+    d_stop(false)
+{
+    d_free_jobs.reserve(jobs_num);
+    for (int ii = 0; ii < jobs_num; ii++)
+    {
+        d_jobs[ii].samples.resize(samples_num);
+        d_jobs[ii].done = false;
+        d_free_jobs.push_back(&d_jobs[ii]);
+    }
+
+    for (int ii = 0; ii < workers_num; ii++)
+    {
+        worker * w = new worker(detector, jobs_num);
+        d_workers.push_back(w);
+        d_threads.create_thread(boost::bind(&carrier_pipeline::run, this, w));
+    }
+}
+
+carrier_pipeline::~carrier_pipeline()
+{
+    d_stop = true;
+    for (size_t ii = 0; ii < d_workers.size(); ii++)
+    {
+        gr::thread::scoped_lock lock(d_workers[ii]->mutex);
+        d_workers[ii]->wakeup.notify_one();
+    }
+    d_threads.join_all();
+
+    for (size_t ii = 0; ii < d_workers.size(); ii++)
+    {
+        delete d_workers[ii];
+    }
+}
+
+carrier_pipeline::job * carrier_pipeline::acquire()
+{
+    if (d_free_jobs.empty())
+    {
+        return NULL;
+    }
+    job * j = d_free_jobs.back();
+    d_free_jobs.pop_back();
+    j->done.store(false, boost::memory_order_relaxed);
+    return j;
+}
+
+void carrier_pipeline::dispatch(job * j)
+{
+    worker * w = d_workers[d_next_worker];
+    d_next_worker = (d_next_worker + 1) % d_workers.size();
+
+    d_in_flight.push_back(j);
+    w->jobs.push(j); //can't fail - the queue is as long as the number of jobs
+
+    //the worker sets "sleeping" before the last check of its queue, so either
+    //it sees the job or it's notified here
+    boost::atomic_thread_fence(boost::memory_order_seq_cst);
+    if (w->sleeping.load())
+    {
+        gr::thread::scoped_lock lock(w->mutex);
+        w->wakeup.notify_one();
+    }
+}
+
+void carrier_pipeline::complete(job * j)
+{
+    j->done.store(true, boost::memory_order_release);
+    d_in_flight.push_back(j);
+}
+
+carrier_pipeline::job * carrier_pipeline::finished()
+{
+    if (d_in_flight.empty() || !d_in_flight.front()->done.load(boost::memory_order_acquire))
+    {
+        return NULL;
+    }
+    return d_in_flight.front();
+}
+
+void carrier_pipeline::release()
+{
+    d_free_jobs.push_back(d_in_flight.front());
+    d_in_flight.pop_front();
+}
+
+void carrier_pipeline::run(worker * w)
+{
+    int spins = 0;
+    job * j;
+
+    while (!d_stop)
+    {
+        if (w->jobs.pop(j))
+        {
+            process(j, w->detector);
+            j->done.store(true, boost::memory_order_release);
+            spins = 0;
+        }
+        else if (++spins < SPINS_BEFORE_SLEEP)
+        {
+            boost::this_thread::yield();
+        }
+        else
+        {
+            gr::thread::scoped_lock lock(w->mutex);
+            w->sleeping.store(true);
+            while (w->jobs.read_available() == 0 && !d_stop)
+            {
+                w->wakeup.wait(lock);
+            }
+            w->sleeping.store(false);
+            spins = 0;
+        }
+    }
+}
+
+void carrier_pipeline::process(job * j, burst_detector & detector)
+{
+    j->has_burst = detector.detect_normal_burst(&j->samples[0], j->tseq_num, j->signal_pwr, j->burst_binary, j->soft_bits ? j->burst_soft : NULL);
+    j->allocations = detector.take_allocations();
+}
@@ -0,0 +1,141 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_CARRIER_PIPELINE_H
+#define INCLUDED_GSM_CARRIER_PIPELINE_H
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/thread/thread.h>
+#include <boost/atomic.hpp>
+#include <boost/circular_buffer.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <gsm_constants.h>
+#include <burst_detector.h>
+#include <vector>
+#include <stdint.h>
+
+/** Fixed pool of threads detecting bursts of carriers other than C0
+ *
+ * The receiver keeps C0 timing and frame number tracking on the scheduler
+ * thread and hands bursts of the other carriers to the workers. Every
+ * worker has its own burst_detector and a single-producer single-consumer
+ * lock-free queue of jobs, so nothing is locked on the way to a worker.
+ * A worker marks a processed job as done with an atomic flag.
+ *
+ * Jobs are taken from a free list and returned to it only by the scheduler
+ * thread. They are kept in the order of dispatching - that is in (frame
+ * number, timeslot number, carrier) order - and finished() returns them
+ * in that order, so bursts are published exactly as the serial receiver
+ * would publish them.
+ */
+class carrier_pipeline
+{
+  public:
+    struct job
+    {
+        /**@name Filled by the scheduler thread */
+        //@{
+        std::vector<gr_complex> samples; ///< copy of the input samples of the burst
+        unsigned int input_nr; ///< number of the receiver input
+        uint32_t frame_nr;
+        uint32_t timeslot_nr;
+        int tseq_num; ///< training sequence number of the carrier
+        double signal_pwr; ///< mean power of the burst
+        float signal_dbm;
+        uint8_t burst_type;
+        bool soft_bits; ///< true if soft bits are to be computed too
+        //@}
+
+        /**@name Results */
+        //@{
+        bool has_burst; ///< false if nothing is to be published
+        unsigned char burst_binary[BURST_SIZE];
+        int8_t burst_soft[BURST_SIZE]; ///< valid only if soft_bits is set
+        unsigned allocations; ///< buffer allocations made while processing the job
+        //@}
+
+        boost::atomic<bool> done;
+    };
+
+  private:
+    struct worker
+    {
+        worker(const burst_detector & detector, int queue_size);
+
+        boost::lockfree::spsc_queue<job *> jobs;
+        burst_detector detector;
+        boost::atomic<bool> sleeping;
+        gr::thread::mutex mutex;
+        gr::thread::condition_variable wakeup;
+    };
+
+    std::vector<job> d_jobs;
+    std::vector<job *> d_free_jobs; ///< used only by the scheduler thread
+    boost::circular_buffer<job *> d_in_flight; ///< jobs in the order of dispatching
+    std::vector<worker *> d_workers;
+    boost::thread_group d_threads;
+    unsigned int d_next_worker;
+    boost::atomic<bool> d_stop;
+
+    void run(worker * w);
+    static void process(job * j, burst_detector & detector);
+
+  public:
+    /** Constructor - starts the worker threads
+     *
+     * @param workers_num number of worker threads
+     * @param jobs_num maximal number of jobs in flight
+     * @param samples_num number of samples copied into every job
+     * @param detector detector copied into every worker
+     */
+    carrier_pipeline(int workers_num, int jobs_num, int samples_num, const burst_detector & detector);
+
+    /** Destructor - stops and joins the worker threads */
+    ~carrier_pipeline();
+
+    /** Returns a free job or NULL if all jobs are in flight */
+    job * acquire();
+
+    /** Hands the job to a worker */
+    void dispatch(job * j);
+
+    /** Queues a job which was already processed by the calling thread */
+    void complete(job * j);
+
+    /** Returns the oldest job if it's done, NULL otherwise */
+    job * finished();
+
+    /** Returns the job returned by finished() to the free list */
+    void release();
+
+    /** Returns true if there is no job in flight */
+    bool idle() const
+    {
+        return d_in_flight.empty();
+    }
+
+    int workers_num() const
+    {
+        return d_workers.size();
+    }
+};
+
+#endif /* INCLUDED_GSM_CARRIER_PIPELINE_H */
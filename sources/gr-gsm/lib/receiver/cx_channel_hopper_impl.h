@@ -24,6 +24,7 @@
 #define INCLUDED_GSM_CX_CHANNEL_HOPPER_IMPL_H
 
 #include <grgsm/receiver/cx_channel_hopper.h>
+#include <hopping_sequence.h>
 #include <vector>
 
 namespace gr {
@@ -36,8 +37,8 @@ namespace gr {
       int d_maio; // Mobile Allocation Index Offset
       int d_hsn; // Hopping Sequence Number
       int d_narfcn; // Length of d_ma
+      hopping_sequence d_hopping; // MAI of every frame
 
-      int calculate_ma_sfh(int maio, int hsn, int n, int fn);
       void assemble_bursts(pmt::pmt_t msg);
 
      public:
@@ -0,0 +1,199 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <fcch_detector.h>
+#include <gsm_constants.h>
+#include <gnuradio/math.h>
+#include <volk/volk.h>
+#include <math.h>
+#include <algorithm>
+
+#define PHASE_DIFFS_BLOCK 512    //number of phase differences computed at once
+
+fcch_detector::fcch_detector(int osr) :
+    d_OSR(osr),
+    d_input(NULL),
+    d_nitems(0),
+    d_computed(0)
+{
+}
+
+void fcch_detector::compute_phase_diffs(int end)
+{
+    end = std::min(std::max(end, d_computed + PHASE_DIFFS_BLOCK), d_nitems);
+    if (end <= d_computed)
+    {
+        return;
+    }
+
+    //fast_atan2f is used instead of volk_32fc_s32f_atan2_32f - it's faster than
+    //VOLK's generic kernel and gives the same phase differences as the
+    //per-sample search did
+    volk_32fc_x2_multiply_conjugate_32fc(&d_conjprod[d_computed], &d_input[d_computed], &d_input[d_computed - 1], end - d_computed);
+    for (int ii = d_computed; ii < end; ii++)
+    {
+        d_phase_diffs[ii] = gr::fast_atan2f(d_conjprod[ii]);
+    }
+    d_computed = end;
+}
+
+bool fcch_detector::find(const gr_complex * input, int nitems, int & to_consume, int & start_pos, double & freq_offset)
+{
+    if (d_phase_diffs.size() < (size_t)nitems || d_phase_diffs.empty())
+    {
+        d_conjprod.resize(std::max(nitems, 1));
+        d_phase_diffs.resize(std::max(nitems, 1));
+        d_min_queue.resize(std::max(nitems, 1));
+        d_max_queue.resize(std::max(nitems, 1));
+    }
+    d_input = input;
+    d_nitems = nitems;
+    d_computed = 1;
+
+    const float * phase_diffs = &d_phase_diffs[0];
+    const int hits_needed = FCCH_HITS_NEEDED * d_OSR; //length of the window of phase differences
+    const int max_misses = FCCH_MAX_MISSES * d_OSR;
+    int * min_queue = &d_min_queue[0];
+    int * max_queue = &d_max_queue[0];
+    int min_head = 0, min_tail = 0;
+    int max_head = 0, max_tail = 0;
+
+    int sample_number = 0;
+    int hit_count = 0;
+    int miss_count = 0;
+    int best_window_end = -1;
+    float lowest_max_min_diff = 99999;
+
+    to_consume = 0;
+    start_pos = -1;
+
+    while (true)
+    {
+        //search for a positive phase difference
+        do
+        {
+            sample_number++;
+            if (sample_number > nitems - hits_needed)   //too few samples left to find FCCH
+            {
+                to_consume = sample_number;
+                return false;
+            }
+            if (sample_number >= d_computed)
+            {
+                compute_phase_diffs(sample_number + 1);
+            }
+        } while (!(phase_diffs[sample_number] > 0));
+        to_consume = sample_number;
+
+        //search for FCCH and the best position of it
+        hit_count = 0;
+        miss_count = 0;
+        start_pos = -1;
+        lowest_max_min_diff = 99999;
+        min_head = min_tail = 0;
+        max_head = max_tail = 0;
+
+        while (true)
+        {
+            if (phase_diffs[sample_number] > 0)
+            {
+                hit_count++;
+            }
+            else
+            {
+                miss_count++;
+            }
+
+            if ((miss_count >= max_misses) && (hit_count <= hits_needed))
+            {
+                break;                          //miss_count exceeded limit before hit_count - start again
+            }
+            else if (((miss_count >= max_misses) && (hit_count > hits_needed)) || (hit_count > 2 * hits_needed))
+            {
+                goto fcch_found;
+            }
+            else if ((miss_count < max_misses) && (hit_count > hits_needed))
+            {
+                //the window is full here - it contains phase differences of
+                //the last hits_needed samples, for FCCH their spread is low
+                float max_min_diff = phase_diffs[max_queue[max_head]] - phase_diffs[min_queue[min_head]];
+                if (lowest_max_min_diff > max_min_diff)
+                {
+                    lowest_max_min_diff = max_min_diff;
+                    start_pos = sample_number - hits_needed - max_misses;
+                    best_window_end = sample_number;
+                }
+            }
+
+            sample_number++;
+            if (sample_number >= nitems)        //there's no single sample left to check
+            {
+                return false;
+            }
+            if (sample_number >= d_computed)
+            {
+                compute_phase_diffs(sample_number + 1);
+            }
+
+            //update extremes of the window ending at sample_number
+            const float value = phase_diffs[sample_number];
+            while (min_tail > min_head && phase_diffs[min_queue[min_tail - 1]] >= value)
+            {
+                min_tail--;
+            }
+            min_queue[min_tail++] = sample_number;
+            while (max_tail > max_head && phase_diffs[max_queue[max_tail - 1]] <= value)
+            {
+                max_tail--;
+            }
+            max_queue[max_tail++] = sample_number;
+            if (min_queue[min_head] <= sample_number - hits_needed)
+            {
+                min_head++;
+            }
+            if (max_queue[max_head] <= sample_number - hits_needed)
+            {
+                max_head++;
+            }
+        }
+    }
+
+fcch_found:
+    double best_sum = 0;
+    if (best_window_end >= 0)
+    {
+        for (int ii = best_window_end - hits_needed + 1; ii <= best_window_end; ii++)
+        {
+            best_sum += phase_diffs[ii] - (M_PI / 2) / d_OSR;
+        }
+    }
+
+    to_consume = start_pos + hits_needed + 1;     //consume one FCCH burst
+
+    //compute frequency offset
+    double phase_offset = best_sum / FCCH_HITS_NEEDED;
+    freq_offset = phase_offset * 1625000.0/6 / (2 * M_PI); //1625000.0/6 - GMSK symbol rate in GSM
+    return true;
+}
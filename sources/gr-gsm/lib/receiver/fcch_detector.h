@@ -0,0 +1,73 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_FCCH_DETECTOR_H
+#define INCLUDED_GSM_FCCH_DETECTOR_H
+
+#include <gnuradio/gr_complex.h>
+#include <vector>
+
+/** Searches for a FCCH burst in a whole input buffer at once
+ *
+ * Phase differences of subsequent samples are computed in blocks (VOLK
+ * multiply by conjugate, then fast_atan2f), as far as the search gets. The
+ * search itself is the hits/misses state machine of the receiver, but the
+ * spread (max - min) of the last FCCH_HITS_NEEDED * osr phase differences
+ * is kept up to date with monotonic queues instead of scanning the whole
+ * window for every sample, and the sum of the best window is computed only
+ * once, when the burst is found. The start position and the frequency
+ * offset are the same as the ones of the per-sample search.
+ */
+class fcch_detector
+{
+  private:
+    const int d_OSR;
+    const gr_complex * d_input;
+    int d_nitems;
+    int d_computed; ///< number of phase differences computed so far
+    std::vector<gr_complex> d_conjprod; ///< input[n] * conj(input[n-1])
+    std::vector<float> d_phase_diffs; ///< phase differences, d_phase_diffs[n] is the one between samples n and n-1
+    std::vector<int> d_min_queue; ///< indexes of the phase differences with increasing values
+    std::vector<int> d_max_queue; ///< indexes of the phase differences with decreasing values
+
+    /** Computes phase differences up to (at least) the given sample */
+    void compute_phase_diffs(int end);
+
+  public:
+    /** Constructor
+     *
+     * @param osr oversampling ratio
+     */
+    fcch_detector(int osr);
+
+    /** Searches for a FCCH burst
+     *
+     * @param[in] input vector with input samples
+     * @param[in] nitems number of input samples
+     * @param[out] to_consume number of samples which can be consumed
+     * @param[out] start_pos number of the first sample of the FCCH burst
+     * @param[out] freq_offset estimate of the frequency offset
+     * @return true if a FCCH burst was found
+     */
+    bool find(const gr_complex * input, int nitems, int & to_consume, int & start_pos, double & freq_offset);
+};
+
+#endif /* INCLUDED_GSM_FCCH_DETECTOR_H */
@@ -0,0 +1,74 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_HOPPING_SEQUENCE_H
+#define INCLUDED_GSM_HOPPING_SEQUENCE_H
+
+#include <stdint.h>
+#include <vector>
+
+/** Slow frequency hopping sequence of GSM 05.02, chapter 6.2.3
+ *
+ * For HSN other than 0 the mobile allocation index depends on the frame
+ * number only through FN mod 26, FN mod 51 and T1 mod 64, so it repeats
+ * every 26 * 51 * 64 frames. The indexes of the whole period are computed
+ * once, in set(), and mai() is a table lookup. Cyclic hopping (HSN 0)
+ * is computed directly.
+ */
+class hopping_sequence
+{
+  private:
+    int d_maio; ///< mobile allocation index offset
+    int d_hsn; ///< hopping sequence number
+    int d_n; ///< number of ARFCNs in the mobile allocation
+    std::vector<uint8_t> d_mai; ///< indexes of the period for HSN other than 0
+
+  public:
+    static const int PERIOD = 26 * 51 * 64;
+
+    hopping_sequence();
+
+    /** Computes the sequence
+     *
+     * @param maio mobile allocation index offset, 0 <= MAIO < n
+     * @param hsn hopping sequence number, 0 <= HSN < 64
+     * @param n number of ARFCNs in the mobile allocation, 1 <= n <= 64
+     */
+    void set(int maio, int hsn, int n);
+
+    /** Returns the mobile allocation index used in the given frame */
+    int mai(uint32_t fn) const
+    {
+        return d_hsn == 0 ? (fn + d_maio) % d_n : d_mai[fn % PERIOD];
+    }
+
+    /** Computes the mobile allocation index from scratch (GSM 05.02, 6.2.3)
+     *
+     * @param maio mobile allocation index offset
+     * @param hsn hopping sequence number
+     * @param n number of ARFCNs in the mobile allocation
+     * @param fn frame number
+     * @return index of the ARFCN in the mobile allocation
+     */
+    static int calculate_ma_sfh(int maio, int hsn, int n, int fn);
+};
+
+#endif /* INCLUDED_GSM_HOPPING_SEQUENCE_H */
@@ -109,11 +109,11 @@ class burst_counter
       return d_t3;
     }
 
-    uint32_t get_timeslot_nr() {
+    uint32_t get_timeslot_nr() const {
       return d_timeslot_nr;
     }
 
-    uint32_t get_frame_nr() {
+    uint32_t get_frame_nr() const {
       return (51 * 26 * d_t1) + (51 * (((d_t3 + 26) - d_t2) % 26)) + d_t3;
     }
     
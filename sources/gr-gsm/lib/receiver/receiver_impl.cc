@@ -27,7 +27,6 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/math.h>
 #include <math.h>
-#include <boost/circular_buffer.hpp>
 #include <algorithm>
 #include <numeric>
 #include <vector>
@@ -35,38 +34,41 @@
 #include <string.h>
 #include <iostream>
 #include <iomanip>
-#include <boost/scoped_ptr.hpp>
 
 #include <sch.h>
 #include "receiver_impl.h"
 #include <grgsm/endian.h>
+#include <grgsm/burst.h>
+#include <boost/algorithm/clamp.hpp>
 
 //files included for debuging
 //#include "plotting/plotting.hpp"
 //#include <pthread.h>
 
 #define SYNC_SEARCH_RANGE 30
+#define JOBS_PER_WORKER 32
 
 namespace gr
 {
 namespace gsm
 {
 receiver::sptr
-receiver::make(int osr, const std::vector<int> &cell_allocation, const std::vector<int> &tseq_nums)
+receiver::make(int osr, const std::vector<int> &cell_allocation, const std::vector<int> &tseq_nums, int burst_workers, bool soft_bits)
 {
     return gnuradio::get_initial_sptr
-           (new receiver_impl(osr, cell_allocation, tseq_nums));
+           (new receiver_impl(osr, cell_allocation, tseq_nums, burst_workers, soft_bits));
 }
 
 /*
  * The private constructor
  */
-receiver_impl::receiver_impl(int osr, const std::vector<int> &cell_allocation, const std::vector<int> &tseq_nums)
+receiver_impl::receiver_impl(int osr, const std::vector<int> &cell_allocation, const std::vector<int> &tseq_nums, int burst_workers, bool soft_bits)
     : gr::sync_block("receiver",
                 gr::io_signature::make(1, -1, sizeof(gr_complex)),
                 gr::io_signature::make(0, 0, 0)),
     d_OSR(osr),
     d_chan_imp_length(CHAN_IMP_RESP_LENGTH),
+    d_soft_bits(soft_bits),
     d_counter(0),
     d_fcch_start_pos(0),
     d_freq_offset_setting(0),
@@ -75,12 +77,22 @@ receiver_impl::receiver_impl(int osr, const std::vector<int> &cell_allocation, c
     d_failed_sch(0),
     d_signal_dbm(-120),
     d_tseq_nums(tseq_nums),
-    d_cell_allocation(cell_allocation),
-    d_last_time(0.0)
+    d_last_time(0.0),
+    d_allocations(0),
+    d_processed_bursts(0),
+    d_hopping_changed(false),
+    d_c0_port(pmt::mp("C0")),
+    d_cx_port(pmt::mp("CX")),
+    d_measurements_port(pmt::mp("measurements")),
+    d_freq_offset_key(pmt::mp("setting_freq_offset")),
+    d_sch_correlator(osr, SYNC_SEARCH_RANGE * osr),
+    d_detector(osr),
+    d_fcch_detector(osr)
 {
     int i;
-                                                                      //don't send samples to the receiver until there are at least samples for one
-    set_output_multiple(floor((TS_BITS + 2 * GUARD_PERIOD) * d_OSR)); // burst and two gurad periods (one gurard period is an arbitrary overlap)
+    const int burst_samples = floor((TS_BITS + 2 * GUARD_PERIOD) * d_OSR);
+                                          //don't send samples to the receiver until there are at least samples for one
+    set_output_multiple(burst_samples);   // burst and two gurad periods (one gurard period is an arbitrary overlap)
     gmsk_mapper(SYNC_BITS, N_SYNC_BITS, d_sch_training_seq, gr_complex(0.0, -1.0));
     for (i = 0; i < TRAIN_SEQ_NUM; i++)
     {
@@ -88,10 +100,26 @@ receiver_impl::receiver_impl(int osr, const std::vector<int> &cell_allocation, c
                                                                                                      //if first bit of the seqeunce ==1  first symbol ==-1
         gmsk_mapper(train_seq[i], N_TRAIN_BITS, d_norm_training_seq[i], startpoint);
     }
-    message_port_register_out(pmt::mp("C0"));
-    message_port_register_out(pmt::mp("CX"));
-    message_port_register_out(pmt::mp("measurements"));
+    d_sch_correlator.set_sequences(&d_sch_training_seq[5], 1, N_SYNC_BITS - 10, N_SYNC_BITS);
+    d_detector.set_norm_training_seqs(d_norm_training_seq);
+    message_port_register_out(d_c0_port);
+    message_port_register_out(d_cx_port);
+    message_port_register_out(d_measurements_port);
+
+    d_channel_imp_resp.resize(d_chan_imp_length * d_OSR);
+    d_window_energy_buffer.resize(SYNC_SEARCH_RANGE * d_OSR);
+    d_freq_offset_tags.reserve(16);
     configure_receiver();  //configure the receiver - tell it where to find which burst type
+
+    boost::shared_ptr<hopping_state> state(new hopping_state());
+    state->cell_allocation = cell_allocation;
+    state->timeslots = 0xff;
+    d_hopping = d_new_hopping = state;
+
+    if(burst_workers > 0)
+    {
+        d_pipeline.reset(new carrier_pipeline(burst_workers, burst_workers * JOBS_PER_WORKER, burst_samples, d_detector));
+    }
 }
 
 /*
@@ -101,6 +129,19 @@ receiver_impl::~receiver_impl()
 {
 }
 
+bool receiver_impl::stop()
+{
+    if(d_pipeline)
+    {
+        while(!d_pipeline->idle())   //publish bursts which are still processed by the workers
+        {
+            publish_finished_bursts();
+            boost::this_thread::yield();
+        }
+    }
+    return true;
+}
+
 int
 receiver_impl::work(int noutput_items,
 	               gr_vector_const_void_star &input_items,
@@ -108,25 +149,48 @@ receiver_impl::work(int noutput_items,
 {
 //    std::vector<const gr_complex *> iii = (std::vector<const gr_complex *>) input_items; // jak zrobić to rzutowanie poprawnie
     gr_complex * input = (gr_complex *) input_items[0];
-    std::vector<tag_t> freq_offset_tags;
     uint64_t start = nitems_read(0);
     uint64_t stop = start + noutput_items;
 
+    if(d_hopping_changed.exchange(false))
+    {
+        boost::mutex::scoped_lock lock(d_hopping_mutex);
+        d_hopping = d_new_hopping;
+    }
+
+    if(d_pipeline)
+    {
+        publish_finished_bursts();
+    }
+
     float current_time = static_cast<float>(start)/(GSM_SYMBOL_RATE*d_OSR);
     if((current_time - d_last_time) > 0.1)
     {
         pmt::pmt_t msg = pmt::make_tuple(pmt::mp("current_time"),pmt::from_double(current_time));
-        message_port_pub(pmt::mp("measurements"), msg);
+        message_port_pub(d_measurements_port, msg);
         d_last_time = current_time;
+
+        d_allocations += d_detector.take_allocations();
+        if(d_processed_bursts > 0)
+        {
+            double allocations_per_burst = static_cast<double>(d_allocations) / d_processed_bursts;
+            pmt::pmt_t msg = pmt::make_tuple(pmt::mp("allocations_per_burst"),pmt::from_double(allocations_per_burst));
+            message_port_pub(d_measurements_port, msg);
+            d_allocations = 0;
+            d_processed_bursts = 0;
+        }
     }
 
-    pmt::pmt_t key = pmt::string_to_symbol("setting_freq_offset");
-    get_tags_in_range(freq_offset_tags, 0, start, stop, key);
+    size_t tags_capacity = d_freq_offset_tags.capacity();
+    get_tags_in_range(d_freq_offset_tags, 0, start, stop, d_freq_offset_key);
+    if(d_freq_offset_tags.capacity() != tags_capacity){
+        d_allocations++;
+    }
     bool freq_offset_tag_in_fcch = false;
     uint64_t tag_offset=-1; //-1 - just some clearly invalid value
     
-    if(!freq_offset_tags.empty()){
-        tag_t freq_offset_tag = freq_offset_tags[0];
+    if(!d_freq_offset_tags.empty()){
+        const tag_t & freq_offset_tag = d_freq_offset_tags[0];
         tag_offset = freq_offset_tag.offset - start;
         
         burst_type b_type = d_channel_conf.get_burst_type(d_burst_nr);
@@ -150,7 +214,7 @@ receiver_impl::work(int noutput_items,
         if (find_fcch_burst(input, noutput_items,freq_offset_tmp))
         {
             pmt::pmt_t msg = pmt::make_tuple(pmt::mp("freq_offset"),pmt::from_double(freq_offset_tmp-d_freq_offset_setting),pmt::mp("fcch_search"));
-            message_port_pub(pmt::mp("measurements"), msg);
+            message_port_pub(d_measurements_port, msg);
 
             d_state = sch_search;
         }
@@ -163,15 +227,15 @@ receiver_impl::work(int noutput_items,
 
     case sch_search:
     {
-        std::vector<gr_complex> channel_imp_resp(CHAN_IMP_RESP_LENGTH*d_OSR);
+        gr_complex * channel_imp_resp = scratch(d_channel_imp_resp, d_chan_imp_length*d_OSR);
         int t1, t2, t3;
         int burst_start = 0;
         unsigned char output_binary[BURST_SIZE];
 
         if (reach_sch_burst(noutput_items))                                //wait for a SCH burst
         {
-            burst_start = get_sch_chan_imp_resp(input, &channel_imp_resp[0]); //get channel impulse response from it
-            detect_burst(input, &channel_imp_resp[0], burst_start, output_binary); //detect bits using MLSE detection
+            burst_start = get_sch_chan_imp_resp(input, channel_imp_resp); //get channel impulse response from it
+            d_detector.detect_burst(input, channel_imp_resp, burst_start, output_binary); //detect bits using MLSE detection
             if (decode_sch(&output_binary[3], &t1, &t2, &t3, &d_ncc, &d_bcc) == 0)   //decode SCH burst
             {
                 d_burst_nr.set(t1, t2, t3, 0);                                  //set counter of bursts value
@@ -194,36 +258,44 @@ receiver_impl::work(int noutput_items,
     //in this state receiver is synchronized and it processes bursts according to burst type for given burst number
     case synchronized:
     {
-        std::vector<gr_complex> channel_imp_resp(CHAN_IMP_RESP_LENGTH*d_OSR);
+        gr_complex * channel_imp_resp = scratch(d_channel_imp_resp, d_chan_imp_length*d_OSR);
         int offset = 0;
         int to_consume = 0;
         unsigned char output_binary[BURST_SIZE];
+        int8_t soft_bits[BURST_SIZE];
+        int8_t * output_soft = d_soft_bits ? soft_bits : NULL;
 
         burst_type b_type;
         
-        for(int input_nr=0; input_nr<d_cell_allocation.size(); input_nr++)
+        int followed_input = d_hopping->followed_input(d_burst_nr);
+
+        for(int input_nr=0; input_nr<d_hopping->cell_allocation.size(); input_nr++)
         {
             double signal_pwr = 0;
             input = (gr_complex *)input_items[input_nr];
             
-            for(int ii=GUARD_PERIOD;ii<TS_BITS;ii++)
-            {
-                signal_pwr += abs(input[ii])*abs(input[ii]);
-            }
-            signal_pwr = signal_pwr/(TS_BITS);
-            d_signal_dbm = round(10*log10(signal_pwr/50));
-            if(input_nr==0){
-                d_c0_signal_dbm = d_signal_dbm;
-            }
-            
             if(input_nr==0) //for c0 channel burst type is controlled by channel configuration
             {
                 b_type = d_channel_conf.get_burst_type(d_burst_nr); //get burst type for given burst number
             }
+            else if(followed_input >= 0 && input_nr != followed_input)
+            {
+                b_type = empty; //the followed channel isn't on this carrier in this timeslot
+            }
             else 
             {
                 b_type = normal_or_noise; //for the rest it can be only normal burst or noise (at least at this moment of development)
             }
+
+            if(input_nr==0 || b_type != empty)
+            {
+                d_processed_bursts++;
+                signal_pwr = burst_detector::signal_power(input);
+                d_signal_dbm = round(10*log10(signal_pwr/50));
+                if(input_nr==0){
+                    d_c0_signal_dbm = d_signal_dbm;
+                }
+            }
             
             switch (b_type)
             {
@@ -233,19 +305,19 @@ receiver_impl::work(int noutput_items,
                 const unsigned last_sample = first_sample + USEFUL_BITS * d_OSR - TAIL_BITS * d_OSR;
                 double freq_offset_tmp = compute_freq_offset(input, first_sample, last_sample);       //extract frequency offset from it
 
-                send_burst(d_burst_nr, fc_fb, GSMTAP_BURST_FCCH, input_nr);
+                send_burst(d_burst_nr, fc_fb, NULL, GSMTAP_BURST_FCCH, input_nr);
 
                 pmt::pmt_t msg = pmt::make_tuple(pmt::mp("freq_offset"),pmt::from_double(freq_offset_tmp-d_freq_offset_setting),pmt::mp("synchronized"));
-                message_port_pub(pmt::mp("measurements"), msg);
+                message_port_pub(d_measurements_port, msg);
                 break;
             }
             case sch_burst:                                                                      //if it's SCH burst
             {
                 int t1, t2, t3, d_ncc, d_bcc;
-                d_c0_burst_start = get_sch_chan_imp_resp(input, &channel_imp_resp[0]);                //get channel impulse response
+                d_c0_burst_start = get_sch_chan_imp_resp(input, channel_imp_resp);                //get channel impulse response
                 
-                detect_burst(input, &channel_imp_resp[0], d_c0_burst_start, output_binary);           //MLSE detection of bits
-                send_burst(d_burst_nr, output_binary, GSMTAP_BURST_SCH, input_nr);
+                d_detector.detect_burst(input, channel_imp_resp, d_c0_burst_start, output_binary, output_soft);           //MLSE detection of bits
+                send_burst(d_burst_nr, output_binary, output_soft, GSMTAP_BURST_SCH, input_nr);
                 if (decode_sch(&output_binary[3], &t1, &t2, &t3, &d_ncc, &d_bcc) == 0)           //and decode SCH data
                 {
                     // d_burst_nr.set(t1, t2, t3, 0);                                              //but only to check if burst_start value is correct
@@ -260,7 +332,7 @@ receiver_impl::work(int noutput_items,
                     {
                         d_state = fcch_search; 
                         pmt::pmt_t msg = pmt::make_tuple(pmt::mp("freq_offset"),pmt::from_double(0.0),pmt::mp("sync_loss"));
-                        message_port_pub(pmt::mp("measurements"), msg);
+                        message_port_pub(d_measurements_port, msg);
                         //DCOUT("Re-Synchronization!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
                     }
                 }
@@ -269,9 +341,9 @@ receiver_impl::work(int noutput_items,
             case normal_burst:
             {
                 float normal_corr_max;                                                    //if it's normal burst
-                d_c0_burst_start = get_norm_chan_imp_resp(input, &channel_imp_resp[0], &normal_corr_max, d_bcc); //get channel impulse response for given training sequence number - d_bcc
-                detect_burst(input, &channel_imp_resp[0], d_c0_burst_start, output_binary);            //MLSE detection of bits
-                send_burst(d_burst_nr, output_binary, GSMTAP_BURST_NORMAL, input_nr);
+                d_c0_burst_start = d_detector.get_norm_chan_imp_resp(input, channel_imp_resp, &normal_corr_max, d_bcc); //get channel impulse response for given training sequence number - d_bcc
+                d_detector.detect_burst(input, channel_imp_resp, d_c0_burst_start, output_binary, output_soft);            //MLSE detection of bits
+                send_burst(d_burst_nr, output_binary, output_soft, GSMTAP_BURST_NORMAL, input_nr);
                 break;
             }
             case dummy_or_normal:
@@ -279,51 +351,36 @@ receiver_impl::work(int noutput_items,
                 unsigned int normal_burst_start, dummy_burst_start;
                 float dummy_corr_max, normal_corr_max;
 
-                dummy_burst_start = get_norm_chan_imp_resp(input, &channel_imp_resp[0], &dummy_corr_max, TS_DUMMY);
-                normal_burst_start = get_norm_chan_imp_resp(input, &channel_imp_resp[0], &normal_corr_max, d_bcc);
+                const int tseq_nums[2] = {TS_DUMMY, d_bcc};
+                d_detector.correlate_norm_training_seqs(input, tseq_nums, 2);       //correlate with both sequences at once
+                dummy_burst_start = d_detector.norm_chan_imp_resp(channel_imp_resp, &dummy_corr_max, TS_DUMMY);
+                normal_burst_start = d_detector.norm_chan_imp_resp(channel_imp_resp, &normal_corr_max, d_bcc);
                             
                 if (normal_corr_max > dummy_corr_max)
                 {
                     d_c0_burst_start = normal_burst_start;
-                    detect_burst(input, &channel_imp_resp[0], normal_burst_start, output_binary);
-                    send_burst(d_burst_nr, output_binary, GSMTAP_BURST_NORMAL, input_nr); 
+                    d_detector.detect_burst(input, channel_imp_resp, normal_burst_start, output_binary, output_soft);
+                    send_burst(d_burst_nr, output_binary, output_soft, GSMTAP_BURST_NORMAL, input_nr); 
                 }
                 else
                 {
                     d_c0_burst_start = dummy_burst_start;
-                    send_burst(d_burst_nr, dummy_burst, GSMTAP_BURST_DUMMY, input_nr);
+                    send_burst(d_burst_nr, dummy_burst, NULL, GSMTAP_BURST_DUMMY, input_nr);
                 }
                 break;
             }
             case rach_burst:
                 break;
             case dummy:
-                send_burst(d_burst_nr, dummy_burst, GSMTAP_BURST_DUMMY, input_nr);
+                send_burst(d_burst_nr, dummy_burst, NULL, GSMTAP_BURST_DUMMY, input_nr);
                 break;
             case normal_or_noise:
             {
-                unsigned int burst_start;
-                float normal_corr_max_tmp;
-                float normal_corr_max=-1e6;
-                int max_tn;
-                std::vector<gr_complex> v(input, input + noutput_items);
                 if(d_signal_dbm>=d_c0_signal_dbm-13)
                 {
                     if(d_tseq_nums.size()==0)              //there is no information about training sequence
                     {                                      //however the receiver can detect it
-                        get_norm_chan_imp_resp(input, &channel_imp_resp[0], &normal_corr_max, 0);
-                        float ts_max=normal_corr_max;     //with use of a very simple algorithm based on finding
-                        int ts_max_num=0;                 //maximum correlation
-                        for(int ss=1; ss<=7; ss++)
-                        {
-                            get_norm_chan_imp_resp(input, &channel_imp_resp[0], &normal_corr_max, ss);
-                            if(ts_max<normal_corr_max)
-                            {
-                                ts_max = normal_corr_max;
-                                ts_max_num = ss;
-                            }
-                        }
-                        d_tseq_nums.push_back(ts_max_num);
+                        d_tseq_nums.push_back(d_detector.find_tseq_num(input));
                     }
                     int tseq_num;
                     if(input_nr<=d_tseq_nums.size()){
@@ -331,11 +388,13 @@ receiver_impl::work(int noutput_items,
                     } else {
                         tseq_num = d_tseq_nums.back();
                     }
-                    burst_start = get_norm_chan_imp_resp(input, &channel_imp_resp[0], &normal_corr_max, tseq_num);
-//                  if(abs(d_c0_burst_start-burst_start)<=2){ //unused check/filter based on timing
-                    if((normal_corr_max/sqrt(signal_pwr))>=0.9){
-                        detect_burst(input, &channel_imp_resp[0], burst_start, output_binary);
-                        send_burst(d_burst_nr, output_binary, GSMTAP_BURST_NORMAL, input_nr);
+                    if(d_pipeline)
+                    {
+                        dispatch_burst(input, tseq_num, signal_pwr, input_nr);  //the burst is detected by one of the workers
+                    }
+                    else if(d_detector.detect_normal_burst(input, tseq_num, signal_pwr, output_binary, output_soft))
+                    {
+                        send_burst(d_burst_nr, output_binary, output_soft, GSMTAP_BURST_NORMAL, input_nr);
                     }
                 }
                 break;
@@ -361,161 +420,13 @@ receiver_impl::work(int noutput_items,
 
 bool receiver_impl::find_fcch_burst(const gr_complex *input, const int nitems, double & computed_freq_offset)
 {
-    boost::circular_buffer<float> phase_diff_buffer(FCCH_HITS_NEEDED * d_OSR); //circular buffer used to scan throug signal to find
-    //best match for FCCH burst
-    float phase_diff = 0;
-    gr_complex conjprod;
-    int start_pos = -1;
-    int hit_count = 0;
-    int miss_count = 0;
-    float min_phase_diff;
-    float max_phase_diff;
-    double best_sum = 0;
-    float lowest_max_min_diff = 99999;
-
     int to_consume = 0;
-    int sample_number = 0;
-    bool end = false;
-    bool result = false;
-    boost::circular_buffer<float>::iterator buffer_iter;
-    
-    /**@name Possible states of FCCH search algorithm*/
-    //@{
-    enum states
-    {
-        init,               ///< initialize variables
-        search,             ///< search for positive samples
-        found_something,    ///< search for FCCH and the best position of it
-        fcch_found,         ///< when FCCH was found
-        search_fail         ///< when there is no FCCH in the input vector
-    } fcch_search_state;
-    //@}
-
-    fcch_search_state = init;
+    int start_pos = -1;
+    bool result = d_fcch_detector.find(input, nitems, to_consume, start_pos, computed_freq_offset);
 
-    while (!end)
+    if (result)
     {
-        switch (fcch_search_state)
-        {
-
-        case init: //initialize variables
-            hit_count = 0;
-            miss_count = 0;
-            start_pos = -1;
-            lowest_max_min_diff = 99999;
-            phase_diff_buffer.clear();
-            fcch_search_state = search;
-
-            break;
-
-        case search:                                                // search for positive samples
-            sample_number++;
-
-            if (sample_number > nitems - FCCH_HITS_NEEDED * d_OSR)   //if it isn't possible to find FCCH because
-            {
-                                                                       //there's too few samples left to look into,
-                to_consume = sample_number;                            //don't do anything with those samples which are left
-                                                                       //and consume only those which were checked
-                fcch_search_state = search_fail;
-            }
-            else
-            {
-                phase_diff = compute_phase_diff(input[sample_number], input[sample_number-1]);
-
-                if (phase_diff > 0)                                   //if a positive phase difference was found
-                {
-                    to_consume = sample_number;
-                    fcch_search_state = found_something;                //switch to state in which searches for FCCH
-                }
-                else
-                {
-                    fcch_search_state = search;
-                }
-            }
-
-            break;
-
-        case found_something:  // search for FCCH and the best position of it
-        {
-            if (phase_diff > 0)
-            {
-                hit_count++;       //positive phase differencies increases hits_count
-            }
-            else
-            {
-                miss_count++;      //negative increases miss_count
-            }
-
-            if ((miss_count >= FCCH_MAX_MISSES * d_OSR) && (hit_count <= FCCH_HITS_NEEDED * d_OSR))
-            {
-                //if miss_count exceeds limit before hit_count
-                fcch_search_state = init;       //go to init
-                continue;
-            }
-            else if (((miss_count >= FCCH_MAX_MISSES * d_OSR) && (hit_count > FCCH_HITS_NEEDED * d_OSR)) || (hit_count > 2 * FCCH_HITS_NEEDED * d_OSR))
-            {
-                //if hit_count and miss_count exceeds limit then FCCH was found
-                fcch_search_state = fcch_found;
-                continue;
-            }
-            else if ((miss_count < FCCH_MAX_MISSES * d_OSR) && (hit_count > FCCH_HITS_NEEDED * d_OSR))
-            {
-                //find difference between minimal and maximal element in the buffer
-                //for FCCH this value should be low
-                //this part is searching for a region where this value is lowest
-                min_phase_diff = * (min_element(phase_diff_buffer.begin(), phase_diff_buffer.end()));
-                max_phase_diff = * (max_element(phase_diff_buffer.begin(), phase_diff_buffer.end()));
-
-                if (lowest_max_min_diff > max_phase_diff - min_phase_diff)
-                {
-                    lowest_max_min_diff = max_phase_diff - min_phase_diff;
-                    start_pos = sample_number - FCCH_HITS_NEEDED * d_OSR - FCCH_MAX_MISSES * d_OSR; //store start pos
-                    best_sum = 0;
-
-                    for (buffer_iter = phase_diff_buffer.begin();
-                            buffer_iter != (phase_diff_buffer.end());
-                            buffer_iter++)
-                    {
-                        best_sum += *buffer_iter - (M_PI / 2) / d_OSR;   //store best value of phase offset sum
-                    }
-                }
-            }
-
-            sample_number++;
-
-            if (sample_number >= nitems)      //if there's no single sample left to check
-            {
-                fcch_search_state = search_fail;//FCCH search failed
-                continue;
-            }
-
-            phase_diff = compute_phase_diff(input[sample_number], input[sample_number-1]);
-            phase_diff_buffer.push_back(phase_diff);
-            fcch_search_state = found_something;
-        }
-        break;
-
-        case fcch_found:
-        {
-            to_consume = start_pos + FCCH_HITS_NEEDED * d_OSR + 1; //consume one FCCH burst
-
-            d_fcch_start_pos = d_counter + start_pos;
-
-            //compute frequency offset
-            double phase_offset = best_sum / FCCH_HITS_NEEDED;
-            double freq_offset = phase_offset * 1625000.0/6 / (2 * M_PI); //1625000.0/6 - GMSK symbol rate in GSM
-            computed_freq_offset = freq_offset;
-
-            end = true;
-            result = true;
-            break;
-        }
-
-        case search_fail:
-            end = true;
-            result = false;
-            break;
-        }
+        d_fcch_start_pos = d_counter + start_pos;
     }
 
     d_counter += to_consume;
@@ -579,48 +490,24 @@ bool receiver_impl::reach_sch_burst(const int nitems)
 
 int receiver_impl::get_sch_chan_imp_resp(const gr_complex *input, gr_complex * chan_imp_resp)
 {
-    std::vector<gr_complex> correlation_buffer;
-    std::vector<float> power_buffer;
-    std::vector<float> window_energy_buffer;
+    const int search_length = SYNC_SEARCH_RANGE * d_OSR;
+    const int window_length = d_chan_imp_length * d_OSR;
+    const int sch_seq_nr = 0;
+    float * window_energy_buffer = scratch(d_window_energy_buffer, search_length);
 
     int strongest_window_nr;
+    int windows_num;
     int burst_start = 0;
     int chan_imp_resp_center = 0;
     float max_correlation = 0;
-    float energy = 0;
 
-    for (int ii = SYNC_POS * d_OSR; ii < (SYNC_POS + SYNC_SEARCH_RANGE) *d_OSR; ii++)
-    {
-        gr_complex correlation = correlate_sequence(&d_sch_training_seq[5], N_SYNC_BITS - 10, &input[ii]);
-        correlation_buffer.push_back(correlation);
-        power_buffer.push_back(std::pow(abs(correlation), 2));
-    }
-    //compute window energies
-    std::vector<float>::iterator iter = power_buffer.begin();
-    bool loop_end = false;
-    while (iter != power_buffer.end())
-    {
-        std::vector<float>::iterator iter_ii = iter;
-        energy = 0;
+    d_sch_correlator.correlate(&input[SYNC_POS * d_OSR], search_length, &sch_seq_nr, 1);
+    const gr_complex * correlation_buffer = d_sch_correlator.correlation(sch_seq_nr);
 
-        for (int ii = 0; ii < (d_chan_imp_length) *d_OSR; ii++, iter_ii++)
-        {
-            if (iter_ii == power_buffer.end())
-            {
-                loop_end = true;
-                break;
-            }
-            energy += (*iter_ii);
-        }
-        if (loop_end)
-        {
-            break;
-        }
-        iter++;
-        window_energy_buffer.push_back(energy);
-    }
+    //compute window energies
+    windows_num = tseq_correlator::window_energies(d_sch_correlator.power(sch_seq_nr), search_length, window_length, window_energy_buffer);
 
-    strongest_window_nr = max_element(window_energy_buffer.begin(), window_energy_buffer.end()) - window_energy_buffer.begin();
+    strongest_window_nr = std::max_element(window_energy_buffer, window_energy_buffer + windows_num) - window_energy_buffer;
     //   d_channel_imp_resp.clear();
 
     max_correlation = 0;
@@ -641,31 +528,6 @@ int receiver_impl::get_sch_chan_imp_resp(const gr_complex *input, gr_complex * c
 }
 
 
-void receiver_impl::detect_burst(const gr_complex * input, gr_complex * chan_imp_resp, int burst_start, unsigned char * output_binary)
-{
-    float output[BURST_SIZE];
-    std::vector<gr_complex> rhh_temp(CHAN_IMP_RESP_LENGTH*d_OSR);
-    gr_complex rhh[CHAN_IMP_RESP_LENGTH];
-    gr_complex filtered_burst[BURST_SIZE];
-    int start_state = 3;
-    unsigned int stop_states[2] = {4, 12};
-
-    autocorrelation(chan_imp_resp, &rhh_temp[0], d_chan_imp_length*d_OSR);
-    for (int ii = 0; ii < (d_chan_imp_length); ii++)
-    {
-        rhh[ii] = conj(rhh_temp[ii*d_OSR]);
-    }
-
-    mafi(&input[burst_start], BURST_SIZE, chan_imp_resp, d_chan_imp_length*d_OSR, filtered_burst);
-
-    viterbi_detector(filtered_burst, BURST_SIZE, rhh, start_state, stop_states, 2, output);
-
-    for (int i = 0; i < BURST_SIZE ; i++)
-    {
-        output_binary[i] = (output[i] > 0);
-    }
-}
-
 void receiver_impl::gmsk_mapper(const unsigned char * input, int nitems, gr_complex * gmsk_output, gr_complex start_point)
 {
     gr_complex j = gr_complex(0.0, 1.0);
@@ -687,161 +549,109 @@ void receiver_impl::gmsk_mapper(const unsigned char * input, int nitems, gr_comp
     }
 }
 
-gr_complex receiver_impl::correlate_sequence(const gr_complex * sequence, int length, const gr_complex * input)
-{
-    gr_complex result(0.0, 0.0);
-    int sample_number = 0;
-
-    for (int ii = 0; ii < length; ii++)
-    {
-        sample_number = (ii * d_OSR) ;
-        result += sequence[ii] * conj(input[sample_number]);
-    }
-
-    result = result / gr_complex(length, 0);
-    return result;
-}
-
-//computes autocorrelation for positive arguments
-inline void receiver_impl::autocorrelation(const gr_complex * input, gr_complex * out, int nitems)
+void receiver_impl::send_burst(burst_counter burst_nr, const unsigned char * burst_binary, const int8_t * burst_soft, uint8_t burst_type, unsigned int input_nr)
 {
-    int i, k;
-    for (k = nitems - 1; k >= 0; k--)
-    {
-        out[k] = gr_complex(0, 0);
-        for (i = k; i < nitems; i++)
+    if(d_pipeline && !d_pipeline->idle())   //bursts of other carriers are still processed
+    {                                       //so this one has to wait for them
+        carrier_pipeline::job * job = acquire_job();
+        job->input_nr = input_nr;
+        job->frame_nr = burst_nr.get_frame_nr();
+        job->timeslot_nr = burst_nr.get_timeslot_nr();
+        job->signal_dbm = d_signal_dbm;
+        job->has_burst = true;
+        job->burst_type = burst_type;
+        job->allocations = 0;
+        memcpy(job->burst_binary, burst_binary, BURST_SIZE);
+        job->soft_bits = (burst_soft != NULL);
+        if(burst_soft)
         {
-            out[k] += input[i] * conj(input[i-k]);
+            memcpy(job->burst_soft, burst_soft, BURST_SIZE);
         }
+        d_pipeline->complete(job);
     }
-}
-
-inline void receiver_impl::mafi(const gr_complex * input, int nitems, gr_complex * filter, int filter_length, gr_complex * output)
-{
-    int ii = 0, n, a;
-
-    for (n = 0; n < nitems; n++)
+    else
     {
-        a = n * d_OSR;
-        output[n] = 0;
-        ii = 0;
-
-        while (ii < filter_length)
-        {
-            if ((a + ii) >= nitems*d_OSR){
-                break;
-            }
-            output[n] += input[a+ii] * filter[ii];
-            ii++;
-        }
+        publish_burst(burst_nr.get_frame_nr(), burst_nr.get_timeslot_nr(), burst_binary, burst_soft, burst_type, d_signal_dbm, input_nr);
     }
 }
 
-//especially computations of strongest_window_nr
-int receiver_impl::get_norm_chan_imp_resp(const gr_complex *input, gr_complex * chan_imp_resp, float *corr_max, int bcc)
+void receiver_impl::publish_burst(uint32_t frame_nr, uint32_t timeslot_nr, const unsigned char * burst_binary, const int8_t * burst_soft, uint8_t burst_type, float signal_dbm, unsigned int input_nr)
 {
-    std::vector<gr_complex> correlation_buffer;
-    std::vector<float> power_buffer;
-    std::vector<float> window_energy_buffer;
+    gsmtap_hdr header;
+    int8_t bits[BURST_SIZE];
+    gsmtap_hdr * tap_header = &header;
 
-    int strongest_window_nr;
-    int burst_start = 0;
-    int chan_imp_resp_center = 0;
-    float max_correlation = 0;
-    float energy = 0;
-   
-    int search_center = (int)((TRAIN_POS + GUARD_PERIOD) * d_OSR);
-    int search_start_pos = search_center + 1 - 5*d_OSR;
-    //   int search_start_pos = search_center -  d_chan_imp_length * d_OSR;
-    int search_stop_pos = search_center + d_chan_imp_length * d_OSR + 5 * d_OSR;
-
-    for(int ii = search_start_pos; ii < search_stop_pos; ii++)
+    memset(tap_header, 0, sizeof(gsmtap_hdr));
+    tap_header->version = GSMTAP_VERSION;
+    tap_header->hdr_len = sizeof(gsmtap_hdr)/4;
+    tap_header->type = GSMTAP_TYPE_UM_BURST;
+    tap_header->timeslot = static_cast<uint8_t>(timeslot_nr);
+    tap_header->frame_number = htobe32(frame_nr);
+    tap_header->sub_type = burst_type;
+    tap_header->arfcn = htobe16(d_hopping->cell_allocation[input_nr]) ; 
+    tap_header->signal_dbm = static_cast<int8_t>(signal_dbm);
+    tap_header->snr_db = 0;
+
+    if(!d_soft_bits)
     {
-        gr_complex correlation = correlate_sequence(&d_norm_training_seq[bcc][TRAIN_BEGINNING], N_TRAIN_BITS - 10, &input[ii]);
-        correlation_buffer.push_back(correlation);
-        power_buffer.push_back(std::pow(abs(correlation), 2));
+        memcpy(bits, burst_binary, BURST_SIZE);
     }
-//    plot(power_buffer);
-    //compute window energies
-    std::vector<float>::iterator iter = power_buffer.begin();
-    bool loop_end = false;
-    while (iter != power_buffer.end())
+    else
     {
-        std::vector<float>::iterator iter_ii = iter;
-        energy = 0;
-
-        for (int ii = 0; ii < (d_chan_imp_length - 2)*d_OSR; ii++, iter_ii++)
-        {
-            if (iter_ii == power_buffer.end())
-            {
-                loop_end = true;
-                break;
-            }
-            energy += (*iter_ii);
-        }
-        if (loop_end)
+        tap_header->res = burst::SOFT_BITS;
+        for(int i = 0; i < BURST_SIZE; i++)   //bursts which weren't detected (FCCH, dummy) are sure
         {
-            break;
+            bits[i] = burst_soft ? burst_soft[i] : (burst_binary[i] ? -127 : 127);
         }
-        iter++;
-
-        window_energy_buffer.push_back(energy);
     }
 
-    strongest_window_nr = max_element(window_energy_buffer.begin(), window_energy_buffer.end()-((d_chan_imp_length)*d_OSR)) - window_energy_buffer.begin();
-    //strongest_window_nr = strongest_window_nr-d_OSR; 
-    if(strongest_window_nr<0){
-       strongest_window_nr = 0;
-    }
-    
-    max_correlation = 0;
-    for (int ii = 0; ii < (d_chan_imp_length)*d_OSR; ii++)
-    {
-        gr_complex correlation = correlation_buffer[strongest_window_nr + ii];
-        if (abs(correlation) > max_correlation)
-        {
-            chan_imp_resp_center = ii;
-            max_correlation = abs(correlation);
-        }
-        //     d_channel_imp_resp.push_back(correlation);
-        chan_imp_resp[ii] = correlation;
-    }
-    
-    *corr_max = max_correlation;
+    pmt::pmt_t msg = burst::make(header, bits);
 
-    //DCOUT("strongest_window_nr_new: " << strongest_window_nr);
-    burst_start = search_start_pos + strongest_window_nr - TRAIN_POS * d_OSR; //compute first sample posiiton which corresponds to the first sample of the impulse response
-
-    //DCOUT("burst_start: " << burst_start);
-    return burst_start;
+    if(input_nr==0){
+        message_port_pub(d_c0_port, msg);
+    } else {
+        message_port_pub(d_cx_port, msg);
+    }
 }
 
+void receiver_impl::dispatch_burst(const gr_complex * input, int tseq_num, double signal_pwr, unsigned int input_nr)
+{
+    carrier_pipeline::job * job = acquire_job();
+
+    std::copy(input, input + job->samples.size(), job->samples.begin());
+    job->input_nr = input_nr;
+    job->frame_nr = d_burst_nr.get_frame_nr();
+    job->timeslot_nr = d_burst_nr.get_timeslot_nr();
+    job->tseq_num = tseq_num;
+    job->signal_pwr = signal_pwr;
+    job->signal_dbm = d_signal_dbm;
+    job->burst_type = GSMTAP_BURST_NORMAL;
+    job->soft_bits = d_soft_bits;
+    d_pipeline->dispatch(job);
+}
 
-void receiver_impl::send_burst(burst_counter burst_nr, const unsigned char * burst_binary, uint8_t burst_type, unsigned int input_nr)
+carrier_pipeline::job * receiver_impl::acquire_job()
 {
-    boost::scoped_ptr<gsmtap_hdr> tap_header(new gsmtap_hdr());
-   
-    tap_header->version = GSMTAP_VERSION;
-    tap_header->hdr_len = sizeof(gsmtap_hdr)/4;
-    tap_header->type = GSMTAP_TYPE_UM_BURST;
-    tap_header->timeslot = static_cast<uint8_t>(d_burst_nr.get_timeslot_nr());
-    tap_header->frame_number = htobe32(d_burst_nr.get_frame_nr());
-    tap_header->sub_type = burst_type;
-    tap_header->arfcn = htobe16(d_cell_allocation[input_nr]) ; 
-    tap_header->signal_dbm = static_cast<int8_t>(d_signal_dbm);
-    tap_header->snr_db = 0;
+    carrier_pipeline::job * job;
+    while((job = d_pipeline->acquire()) == NULL)   //all jobs are in flight - wait for the oldest one
+    {
+        publish_finished_bursts();
+        boost::this_thread::yield();
+    }
+    return job;
+}
 
-    int8_t header_plus_burst[sizeof(gsmtap_hdr)+BURST_SIZE];
-    memcpy(header_plus_burst, tap_header.get(), sizeof(gsmtap_hdr));
-    memcpy(header_plus_burst+sizeof(gsmtap_hdr), burst_binary, BURST_SIZE);
-    
-    pmt::pmt_t blob_header_plus_burst = pmt::make_blob(header_plus_burst,sizeof(gsmtap_hdr)+BURST_SIZE);
-    pmt::pmt_t msg = pmt::cons(pmt::PMT_NIL, blob_header_plus_burst);
-    
-    if(input_nr==0){
-        message_port_pub(pmt::mp("C0"), msg);
-    } else {
-        message_port_pub(pmt::mp("CX"), msg);
+void receiver_impl::publish_finished_bursts()
+{
+    carrier_pipeline::job * job;
+    while((job = d_pipeline->finished()) != NULL)
+    {
+        if(job->has_burst)
+        {
+            publish_burst(job->frame_nr, job->timeslot_nr, job->burst_binary, job->soft_bits ? job->burst_soft : NULL, job->burst_type, job->signal_dbm, job->input_nr);
+        }
+        d_allocations += job->allocations;
+        d_pipeline->release();
     }
 }
 
@@ -870,9 +680,85 @@ void receiver_impl::configure_receiver()
     d_channel_conf.set_burst_types(TIMESLOT7, TEST51, sizeof(TEST51) / sizeof(unsigned), dummy_or_normal);
 }
 
+int receiver_impl::hopping_state::followed_input(const burst_counter & burst_nr) const
+{
+    if(ma.empty())
+    {
+        return -1;
+    }
+    if(!(timeslots & (1 << burst_nr.get_timeslot_nr())))
+    {
+        return 0;   //only C0 is received in timeslots of other channels
+    }
+    return ma_inputs[hopping.mai(burst_nr.get_frame_nr())];
+}
+
+void receiver_impl::hopping_state::map_ma_inputs()
+{
+    ma_inputs.assign(ma.size(), 0);
+    for(unsigned int ii = 0; ii < ma.size(); ii++)
+    {
+        bool found = false;
+        for(unsigned int input_nr = 0; input_nr < cell_allocation.size() && !found; input_nr++)
+        {
+            if(cell_allocation[input_nr] == ma[ii])
+            {
+                ma_inputs[ii] = input_nr;   //C0 is received anyway, so 0 stays 0
+                found = true;
+            }
+        }
+        if(!found)
+        {
+            std::cerr << "warning: ARFCN " << ma[ii] << " of the MA isn't in the cell allocation of the receiver" << std::endl;
+        }
+    }
+}
+
 void receiver_impl::set_cell_allocation(const std::vector<int> &cell_allocation)
 {
-    d_cell_allocation = cell_allocation;
+    boost::mutex::scoped_lock lock(d_hopping_mutex);
+    boost::shared_ptr<hopping_state> state(new hopping_state(*d_new_hopping));
+    state->cell_allocation = cell_allocation;
+    state->map_ma_inputs();
+    d_new_hopping = state;
+    d_hopping_changed = true;
+}
+
+void receiver_impl::set_hopping(const std::vector<int> &ma, int maio, int hsn, int timeslot_mask)
+{
+    boost::shared_ptr<hopping_state> state(new hopping_state());
+    std::vector<int> clamped_ma(ma);
+    int narfcn = ma.size();
+
+    if(narfcn > 0)
+    {
+        // Check user input for GSM 05.02, p16 compliance
+        if(narfcn > 64) {
+            std::cerr << "warning: clamping number of RFCNs in the MA (" << narfcn << "), which should be 1 <= N <= 64." << std::endl;
+            narfcn = 64;
+            clamped_ma.resize(narfcn);
+        }
+
+        if(maio < 0 || maio >= narfcn) {
+            std::cerr << "warning: clamping MAIO (" << maio << "), which should be 0 <= MAIO < N." << std::endl;
+            maio = boost::algorithm::clamp(maio, 0, narfcn - 1);
+        }
+
+        if(hsn < 0 || hsn > 63) {
+            std::cerr << "warning: clamping HSN (" << hsn << "), which should be 0 <= HSN < 64." << std::endl;
+            hsn = boost::algorithm::clamp(hsn, 0, 63);
+        }
+
+        state->hopping.set(maio, hsn, narfcn);   //computed before locking, it takes a while for HSN other than 0
+    }
+    state->ma.swap(clamped_ma);
+    state->timeslots = timeslot_mask;
+
+    boost::mutex::scoped_lock lock(d_hopping_mutex);
+    state->cell_allocation = d_new_hopping->cell_allocation;
+    state->map_ma_inputs();
+    d_new_hopping = state;
+    d_hopping_changed = true;
 }
 
 void receiver_impl::set_tseq_nums(const std::vector<int> & tseq_nums)
@@ -27,6 +27,15 @@
 #include <grgsm/gsmtap.h>
 #include <gsm_constants.h>
 #include <receiver_config.h>
+#include <tseq_correlator.h>
+#include <burst_detector.h>
+#include <carrier_pipeline.h>
+#include <fcch_detector.h>
+#include <hopping_sequence.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
 #include <vector>
 
 namespace gr {
@@ -40,9 +49,9 @@ namespace gr {
         //@{
         const int d_OSR; ///< oversampling ratio
         const int d_chan_imp_length; ///< channel impulse length
+        const bool d_soft_bits; ///< publish soft bits instead of hard ones
         float d_signal_dbm;
         std::vector<int> d_tseq_nums; ///< stores training sequence numbers for channels different than C0
-        std::vector<int> d_cell_allocation; ///< stores cell allocation - absolute rf channel numbers (ARFCNs) assigned to the given cell. The variable should at least contain C0 channel number.
         //@}
 
         gr_complex d_sch_training_seq[N_SYNC_BITS]; ///<encoded training sequence of a SCH burst
@@ -87,6 +96,98 @@ namespace gr {
         //@}
         
         unsigned d_failed_sch; ///< number of subsequent erroneous SCH bursts    
+
+        /**@name Buffers preallocated for processing of bursts
+         *
+         * They are sized in the constructor for the worst case, so processing
+         * of bursts in the "synchronized" state doesn't allocate memory.
+         * If one of them, or one of the burst detector's, has to grow anyway
+         * it's counted in d_allocations and reported on the "measurements"
+         * port as allocations per burst. Allocations made by the runtime
+         * and pmt while publishing aren't seen by this counter;
+         * benchmark_receiver_carriers counts those by replacing operator new.
+         */
+        //@{
+        std::vector<gr_complex> d_channel_imp_resp; ///< channel impulse response of the current burst
+        std::vector<float> d_window_energy_buffer; ///< energies of the SCH channel impulse response windows
+        std::vector<tag_t> d_freq_offset_tags; ///< frequency offset tags found in the current input buffer
+        unsigned d_allocations; ///< number of allocations since the last report
+        unsigned d_processed_bursts; ///< number of processed bursts since the last report
+        //@}
+
+        /**@name Ports and tag keys - created once, as creating a pmt symbol is not free */
+        //@{
+        const pmt::pmt_t d_c0_port;
+        const pmt::pmt_t d_cx_port;
+        const pmt::pmt_t d_measurements_port;
+        const pmt::pmt_t d_freq_offset_key;
+        //@}
+
+        /**@name Channel estimation and detection */
+        //@{
+        tseq_correlator d_sch_correlator; ///< correlator with the SCH extended training sequence
+        burst_detector d_detector; ///< detector of bursts processed on the scheduler thread
+        boost::scoped_ptr<carrier_pipeline> d_pipeline; ///< workers detecting bursts of carriers other than C0, NULL if they're detected on the scheduler thread
+        fcch_detector d_fcch_detector; ///< searches for a FCCH burst before the receiver is synchronized
+        //@}
+
+        /**@name Cell allocation and followed hopping channel
+         *
+         * If a mobile allocation is set, carriers other than C0 are received
+         * only in the timeslots of the followed channel and only the carrier
+         * it uses in the given frame - bursts of the other ones aren't
+         * detected at all.
+         *
+         * The setters make a new state and work() takes the last one when
+         * it starts, so a call uses the same parameters throughout and the
+         * mutex is taken only after a change.
+         */
+        //@{
+        struct hopping_state
+        {
+            std::vector<int> cell_allocation; ///< absolute rf channel numbers (ARFCNs) assigned to the given cell, at least the C0 channel number
+            std::vector<int> ma; ///< mobile allocation, empty if all carriers are received
+            std::vector<int> ma_inputs; ///< input numbers of the ARFCNs of the mobile allocation, 0 if the ARFCN isn't received
+            hopping_sequence hopping; ///< MAI of every frame
+            int timeslots; ///< mask of the timeslots of the followed channel
+
+            /**
+             * Finds inputs of the ARFCNs of the mobile allocation in the cell allocation
+             */
+            void map_ma_inputs();
+
+            /**
+             * Returns the input of the carrier used by the followed channel in the given burst,
+             * 0 if no carrier other than C0 is used and -1 if all carriers are received
+             */
+            int followed_input(const burst_counter & burst_nr) const;
+        };
+
+        boost::shared_ptr<const hopping_state> d_hopping; ///< state used by work()
+        boost::shared_ptr<const hopping_state> d_new_hopping; ///< state set last, protected by d_hopping_mutex
+        boost::atomic<bool> d_hopping_changed; ///< d_new_hopping wasn't taken by work() yet
+        boost::mutex d_hopping_mutex;
+        //@}
+
+        /** Returns a preallocated buffer with at least given number of elements
+         *
+         * @param buffer one of the preallocated buffers
+         * @param size required number of elements
+         * @return pointer to the first element of the buffer
+         */
+        template <typename T>
+        T * scratch(std::vector<T> & buffer, size_t size)
+        {
+            if (buffer.size() < size)
+            {
+                if (buffer.capacity() < size)
+                {
+                    d_allocations++;
+                }
+                buffer.resize(size);
+            }
+            return &buffer[0];
+        }
         
         /** Function whis is used to search a FCCH burst and to compute frequency offset before
         * "synchronized" state of the receiver
@@ -130,16 +231,6 @@ namespace gr {
          */
         int get_sch_chan_imp_resp(const gr_complex *input, gr_complex * chan_imp_resp);
 
-        /** MLSE detection of a burst bits
-         *
-         * Detects bits of burst using viterbi algorithm.
-         * @param input vector with input samples
-         * @param chan_imp_resp vector with the channel impulse response
-         * @param burst_start number of the first sample of the burst
-         * @param output_binary vector with output bits
-         */
-        void detect_burst(const gr_complex * input, gr_complex * chan_imp_resp, int burst_start, unsigned char * output_binary);
-
         /** Encodes differentially input bits and maps them into MSK states
          *
          * @param input vector with input bits
@@ -149,51 +240,40 @@ namespace gr {
          */
         void gmsk_mapper(const unsigned char * input, int nitems, gr_complex * gmsk_output, gr_complex start_point);
 
-        /** Correlates MSK mapped sequence with input signal
+        /**
+         * Sends burst through a C0 (for burst from C0 channel) or Cx (for other bursts) message port
          *
-         * @param sequence MKS mapped sequence
-         * @param length length of the sequence
-         * @param input_signal vector with input samples
-         * @return correlation value
+         * @param burst_nr - frame number of the burst
+         * @param burst_binary - content of the burst
+         * @param burst_soft - soft bits of the burst, NULL if the burst wasn't detected
+         * @b_type - type of the burst
          */
-        gr_complex correlate_sequence(const gr_complex * sequence, int length, const gr_complex * input);
+        void send_burst(burst_counter burst_nr, const unsigned char * burst_binary, const int8_t * burst_soft, uint8_t burst_type, unsigned int input_nr);
 
-        /** Computes autocorrelation of input vector for positive arguments
-         *
-         * @param input vector with input samples
-         * @param out output vector
-         * @param nitems length of the input vector
+        /**
+         * Builds a GSMTAP message with a burst and publishes it on a C0 or Cx message port
          */
-        inline void autocorrelation(const gr_complex * input, gr_complex * out, int nitems);
+        void publish_burst(uint32_t frame_nr, uint32_t timeslot_nr, const unsigned char * burst_binary, const int8_t * burst_soft, uint8_t burst_type, float signal_dbm, unsigned int input_nr);
 
-        /** Filters input signal through channel impulse response
+        /**
+         * Hands a burst of a carrier other than C0 to the workers
          *
          * @param input vector with input samples
-         * @param nitems number of samples to pass through filter
-         * @param filter filter taps - channel impulse response
-         * @param filter_length nember of filter taps
-         * @param output vector with filtered samples
+         * @param tseq_num number of the training sequence of the carrier
+         * @param signal_pwr mean power of the burst
+         * @param input_nr number of the input
          */
-        inline void mafi(const gr_complex * input, int nitems, gr_complex * filter, int filter_length, gr_complex * output);
+        void dispatch_burst(const gr_complex * input, int tseq_num, double signal_pwr, unsigned int input_nr);
 
-        /**  Extracts channel impulse response from a normal burst and computes first sample number of this burst
-         *
-         * @param input vector with input samples
-         * @param chan_imp_resp complex vector where channel impulse response will be stored
-         * @param search_range possible absolute offset of a channel impulse response start
-         * @param bcc base station color code - number of a training sequence
-         * @return first sample number of normal burst
+        /**
+         * Returns a free job of the pipeline, publishing finished bursts until one is available
          */
-        int get_norm_chan_imp_resp(const gr_complex *input, gr_complex * chan_imp_resp, float *corr_max, int bcc);
+        carrier_pipeline::job * acquire_job();
 
         /**
-         * Sends burst through a C0 (for burst from C0 channel) or Cx (for other bursts) message port
-         *
-         * @param burst_nr - frame number of the burst
-         * @param burst_binary - content of the burst
-         * @b_type - type of the burst
+         * Publishes bursts finished by the workers, in the order they were received
          */
-        void send_burst(burst_counter burst_nr, const unsigned char * burst_binary, uint8_t burst_type, unsigned int input_nr);
+        void publish_finished_bursts();
 
         /**
          * Configures burst types in different channels
@@ -203,12 +283,15 @@ namespace gr {
 
         
      public:
-       receiver_impl(int osr, const std::vector<int> &cell_allocation, const std::vector<int> &tseq_nums);
+       receiver_impl(int osr, const std::vector<int> &cell_allocation, const std::vector<int> &tseq_nums, int burst_workers, bool soft_bits);
       ~receiver_impl();
       
+      bool stop();
+      
       int work(int noutput_items, gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
       virtual void set_cell_allocation(const std::vector<int> &cell_allocation);
       virtual void set_tseq_nums(const std::vector<int> & tseq_nums);
+      virtual void set_hopping(const std::vector<int> &ma, int maio, int hsn, int timeslot_mask);
       virtual void reset();
     };
   } // namespace gsm
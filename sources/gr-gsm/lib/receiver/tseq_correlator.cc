@@ -0,0 +1,125 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <tseq_correlator.h>
+#include <volk/volk.h>
+#include <cmath>
+
+tseq_correlator::tseq_correlator(int osr, int max_offsets) :
+    d_OSR(osr),
+    d_seq_length(0),
+    d_seqs_num(0),
+    d_max_offsets(max_offsets),
+    d_offsets_num(0),
+    d_phase_length(0)
+{
+}
+
+void tseq_correlator::reserve(int offsets_num)
+{
+    //buffers only grow, so after the first use with the largest
+    //search range there are no more allocations
+    d_phase_length = (offsets_num - 1) / d_OSR + d_seq_length;
+    if (d_phases.size() < (size_t)(d_OSR * d_phase_length))
+    {
+        d_phases.resize(d_OSR * d_phase_length);
+    }
+    if (d_correlations.size() < (size_t)(d_seqs_num * offsets_num))
+    {
+        d_correlations.resize(d_seqs_num * offsets_num);
+        d_powers.resize(d_seqs_num * offsets_num);
+    }
+}
+
+void tseq_correlator::set_sequences(const gr_complex * sequences, int seqs_num, int seq_length, int seq_stride)
+{
+    d_seqs_num = seqs_num;
+    d_seq_length = seq_length;
+    d_sequences.resize(seqs_num * seq_length);
+    for (int s = 0; s < seqs_num; s++)
+    {
+        for (int ii = 0; ii < seq_length; ii++)
+        {
+            d_sequences[s * seq_length + ii] = sequences[s * seq_stride + ii];
+        }
+    }
+    reserve(d_max_offsets);
+}
+
+void tseq_correlator::correlate(const gr_complex * input, int offsets_num, const int * seq_nrs, int seq_nrs_num)
+{
+    reserve(offsets_num);
+    d_offsets_num = offsets_num;
+
+    //split the window into polyphase components - sample number n of the
+    //sequence for offset "o" is then sample o/d_OSR + n of component o%d_OSR
+    for (int p = 0; p < d_OSR && p < offsets_num; p++)
+    {
+        const int phase_offsets = (offsets_num - p + d_OSR - 1) / d_OSR;
+        gr_complex * phase = &d_phases[p * d_phase_length];
+        for (int jj = 0; jj < phase_offsets + d_seq_length - 1; jj++)
+        {
+            phase[jj] = input[p + jj * d_OSR];
+        }
+    }
+
+    for (int s = 0; s < seq_nrs_num; s++)
+    {
+        const gr_complex * sequence = &d_sequences[seq_nrs[s] * d_seq_length];
+        gr_complex * correlations = &d_correlations[seq_nrs[s] * offsets_num];
+        float * powers = &d_powers[seq_nrs[s] * offsets_num];
+
+        for (int o = 0; o < offsets_num; o++)
+        {
+            //sum of input * conj(sequence) is the conjugate of the wanted sum of sequence * conj(input)
+            gr_complex result;
+            volk_32fc_x2_conjugate_dot_prod_32fc(&result, &d_phases[(o % d_OSR) * d_phase_length + o / d_OSR], sequence, d_seq_length);
+            correlations[o] = conj(result) / gr_complex(d_seq_length, 0);
+            powers[o] = std::pow(abs(correlations[o]), 2);
+        }
+    }
+}
+
+int tseq_correlator::window_energies(const float * power, int length, int window_length, float * energies)
+{
+    const int windows_num = length - window_length + 1;
+    double energy = 0;
+
+    if (windows_num <= 0)
+    {
+        return 0;
+    }
+    for (int ii = 0; ii < window_length; ii++)
+    {
+        energy += power[ii];
+    }
+    energies[0] = energy;
+    for (int ii = 1; ii < windows_num; ii++)
+    {
+        energy += power[ii + window_length - 1] - power[ii - 1];
+        energies[ii] = energy;
+    }
+    return windows_num;
+}
@@ -0,0 +1,109 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_TSEQ_CORRELATOR_H
+#define INCLUDED_GSM_TSEQ_CORRELATOR_H
+
+#include <gnuradio/gr_complex.h>
+#include <vector>
+
+/** Correlates oversampled input signal with a set of MSK mapped training
+ * sequences for a whole range of offsets at once
+ *
+ * Sequences are compared with every d_OSR-th input sample. The input window
+ * is split once into d_OSR polyphase components, so for every offset and
+ * every requested sequence the correlation is a single contiguous VOLK
+ * dot product. The same split is shared by all sequences - detection of an
+ * unknown training sequence costs one input preparation instead of eight.
+ *
+ * Result for offset n and sequence s is:
+ *   sum(sequence_s[k] * conj(input[n + k * osr])) / length
+ * The energies of channel impulse response windows are computed from the
+ * correlation powers with a running sum.
+ */
+class tseq_correlator
+{
+  private:
+    const int d_OSR;
+    int d_seq_length; ///< number of symbols of every sequence
+    int d_seqs_num; ///< number of sequences
+    int d_max_offsets; ///< number of offsets the buffers are allocated for
+    int d_offsets_num; ///< number of offsets correlated by the last call of correlate
+    int d_phase_length; ///< length of a single polyphase component
+    std::vector<gr_complex> d_sequences; ///< sequences stored one after another
+    std::vector<gr_complex> d_phases; ///< polyphase components of the input window
+    std::vector<gr_complex> d_correlations; ///< correlations for all sequences and offsets
+    std::vector<float> d_powers; ///< squared magnitudes of the correlations
+
+    void reserve(int offsets_num);
+
+  public:
+    /** Constructor
+     *
+     * @param osr oversampling ratio of the input signal
+     * @param max_offsets maximal number of offsets searched in one call,
+     *        buffers for it are allocated here
+     */
+    tseq_correlator(int osr, int max_offsets);
+
+    /** Sets training sequences
+     *
+     * @param sequences first symbol of the first sequence
+     * @param seqs_num number of sequences
+     * @param seq_length number of symbols used from every sequence
+     * @param seq_stride distance between first symbols of subsequent sequences
+     */
+    void set_sequences(const gr_complex * sequences, int seqs_num, int seq_length, int seq_stride);
+
+    /** Correlates the input with chosen sequences for offsets 0..offsets_num-1
+     *
+     * @param input first sample of the searched window, the window has to
+     *        contain offsets_num + (seq_length - 1) * osr samples
+     * @param offsets_num number of offsets
+     * @param seq_nrs numbers of sequences to correlate with
+     * @param seq_nrs_num number of elements in seq_nrs
+     */
+    void correlate(const gr_complex * input, int offsets_num, const int * seq_nrs, int seq_nrs_num);
+
+    /** Returns correlations with given sequence computed by the last correlate call */
+    const gr_complex * correlation(int seq_nr) const
+    {
+      return &d_correlations[seq_nr * d_offsets_num];
+    }
+
+    /** Returns squared magnitudes of the correlations with given sequence */
+    const float * power(int seq_nr) const
+    {
+      return &d_powers[seq_nr * d_offsets_num];
+    }
+
+    /** Computes energies of all windows of power values with a running sum
+     *
+     * @param power input power values
+     * @param length number of power values
+     * @param window_length number of values summed in a window
+     * @param energies output energies, length - window_length + 1 values
+     * @return number of windows
+     */
+    static int window_energies(const float * power, int length, int window_length, float * energies);
+};
+
+#endif /* INCLUDED_GSM_TSEQ_CORRELATOR_H */
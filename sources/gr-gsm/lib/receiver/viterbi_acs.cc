@@ -0,0 +1,476 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @author Piotr Krysik <ptrkrysik@gmail.com>
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <viterbi_acs.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define VITERBI_ACS_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+* Scalar reference implementation.
+* It's composed of two parts: one for odd input samples (imaginary numbers)
+* and one for even samples (real numbers).
+* Each part is composed of independent (parallelisable) statements like
+* this one:
+*      pm_candidate1 = old_path_metrics[0] -input_symbol_imag +increment[2];
+*      pm_candidate2 = old_path_metrics[8] -input_symbol_imag -increment[5];
+*      paths_difference=pm_candidate2-pm_candidate1;
+*      new_path_metrics[1]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+*      trans_table[sample_nr][1] = paths_difference;
+*/
+static void viterbi_acs_generic(const gr_complex * input, unsigned int samples_num, const float * increment, float * path_metrics, float (* trans_table)[PATHS_NUM])
+{
+   float path_metrics1[PATHS_NUM];
+   float path_metrics2[PATHS_NUM];
+   float paths_difference;
+   float * new_path_metrics;
+   float * old_path_metrics;
+   float * tmp;
+   float pm_candidate1, pm_candidate2;
+   float input_symbol_real, input_symbol_imag;
+   unsigned int sample_nr;
+
+   memcpy(path_metrics1, path_metrics, sizeof(path_metrics1));
+
+   sample_nr=0;
+   old_path_metrics=path_metrics1;
+   new_path_metrics=path_metrics2;
+   while(sample_nr<samples_num){
+      //Processing imag states
+      input_symbol_imag = input[sample_nr].imag();
+
+      pm_candidate1 = old_path_metrics[0] +input_symbol_imag -increment[2];
+      pm_candidate2 = old_path_metrics[8] +input_symbol_imag +increment[5];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[0]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][0] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[0] -input_symbol_imag +increment[2];
+      pm_candidate2 = old_path_metrics[8] -input_symbol_imag -increment[5];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[1]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][1] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[1] +input_symbol_imag -increment[3];
+      pm_candidate2 = old_path_metrics[9] +input_symbol_imag +increment[4];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[2]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][2] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[1] -input_symbol_imag +increment[3];
+      pm_candidate2 = old_path_metrics[9] -input_symbol_imag -increment[4];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[3]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][3] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[2] +input_symbol_imag -increment[0];
+      pm_candidate2 = old_path_metrics[10] +input_symbol_imag +increment[7];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[4]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][4] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[2] -input_symbol_imag +increment[0];
+      pm_candidate2 = old_path_metrics[10] -input_symbol_imag -increment[7];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[5]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][5] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[3] +input_symbol_imag -increment[1];
+      pm_candidate2 = old_path_metrics[11] +input_symbol_imag +increment[6];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[6]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][6] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[3] -input_symbol_imag +increment[1];
+      pm_candidate2 = old_path_metrics[11] -input_symbol_imag -increment[6];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[7]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][7] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[4] +input_symbol_imag -increment[6];
+      pm_candidate2 = old_path_metrics[12] +input_symbol_imag +increment[1];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[8]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][8] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[4] -input_symbol_imag +increment[6];
+      pm_candidate2 = old_path_metrics[12] -input_symbol_imag -increment[1];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[9]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][9] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[5] +input_symbol_imag -increment[7];
+      pm_candidate2 = old_path_metrics[13] +input_symbol_imag +increment[0];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[10]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][10] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[5] -input_symbol_imag +increment[7];
+      pm_candidate2 = old_path_metrics[13] -input_symbol_imag -increment[0];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[11]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][11] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[6] +input_symbol_imag -increment[4];
+      pm_candidate2 = old_path_metrics[14] +input_symbol_imag +increment[3];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[12]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][12] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[6] -input_symbol_imag +increment[4];
+      pm_candidate2 = old_path_metrics[14] -input_symbol_imag -increment[3];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[13]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][13] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[7] +input_symbol_imag -increment[5];
+      pm_candidate2 = old_path_metrics[15] +input_symbol_imag +increment[2];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[14]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][14] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[7] -input_symbol_imag +increment[5];
+      pm_candidate2 = old_path_metrics[15] -input_symbol_imag -increment[2];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[15]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][15] = paths_difference;
+      tmp=old_path_metrics;
+      old_path_metrics=new_path_metrics;
+      new_path_metrics=tmp;
+
+      sample_nr++;
+      if(sample_nr==samples_num)
+         break;
+
+      //Processing real states
+      input_symbol_real = input[sample_nr].real();
+
+      pm_candidate1 = old_path_metrics[0] -input_symbol_real -increment[7];
+      pm_candidate2 = old_path_metrics[8] -input_symbol_real +increment[0];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[0]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][0] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[0] +input_symbol_real +increment[7];
+      pm_candidate2 = old_path_metrics[8] +input_symbol_real -increment[0];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[1]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][1] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[1] -input_symbol_real -increment[6];
+      pm_candidate2 = old_path_metrics[9] -input_symbol_real +increment[1];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[2]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][2] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[1] +input_symbol_real +increment[6];
+      pm_candidate2 = old_path_metrics[9] +input_symbol_real -increment[1];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[3]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][3] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[2] -input_symbol_real -increment[5];
+      pm_candidate2 = old_path_metrics[10] -input_symbol_real +increment[2];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[4]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][4] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[2] +input_symbol_real +increment[5];
+      pm_candidate2 = old_path_metrics[10] +input_symbol_real -increment[2];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[5]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][5] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[3] -input_symbol_real -increment[4];
+      pm_candidate2 = old_path_metrics[11] -input_symbol_real +increment[3];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[6]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][6] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[3] +input_symbol_real +increment[4];
+      pm_candidate2 = old_path_metrics[11] +input_symbol_real -increment[3];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[7]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][7] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[4] -input_symbol_real -increment[3];
+      pm_candidate2 = old_path_metrics[12] -input_symbol_real +increment[4];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[8]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][8] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[4] +input_symbol_real +increment[3];
+      pm_candidate2 = old_path_metrics[12] +input_symbol_real -increment[4];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[9]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][9] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[5] -input_symbol_real -increment[2];
+      pm_candidate2 = old_path_metrics[13] -input_symbol_real +increment[5];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[10]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][10] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[5] +input_symbol_real +increment[2];
+      pm_candidate2 = old_path_metrics[13] +input_symbol_real -increment[5];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[11]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][11] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[6] -input_symbol_real -increment[1];
+      pm_candidate2 = old_path_metrics[14] -input_symbol_real +increment[6];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[12]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][12] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[6] +input_symbol_real +increment[1];
+      pm_candidate2 = old_path_metrics[14] +input_symbol_real -increment[6];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[13]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][13] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[7] -input_symbol_real -increment[0];
+      pm_candidate2 = old_path_metrics[15] -input_symbol_real +increment[7];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[14]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][14] = paths_difference;
+
+      pm_candidate1 = old_path_metrics[7] +input_symbol_real +increment[0];
+      pm_candidate2 = old_path_metrics[15] +input_symbol_real -increment[7];
+      paths_difference=pm_candidate2-pm_candidate1;
+      new_path_metrics[15]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
+      trans_table[sample_nr][15] = paths_difference;
+
+      tmp=old_path_metrics;
+      old_path_metrics=new_path_metrics;
+      new_path_metrics=tmp;
+
+      sample_nr++;
+   }
+
+   memcpy(path_metrics, old_path_metrics, sizeof(path_metrics1));
+}
+
+#ifdef VITERBI_ACS_HAVE_X86
+/*
+* The SIMD kernels compute the same candidates as the reference code, but
+* with the terms arranged per state:
+*      pm_candidate1 = (old_path_metrics[state/2]   + (+/-)input_symbol) + branch1[state];
+*      pm_candidate2 = (old_path_metrics[state/2+8] + (+/-)input_symbol) + branch2[state];
+* Adding a negated value is exact, so the results are bit-exact with the
+* reference. The selection is done with max(pm_candidate1, pm_candidate2),
+* which returns the second operand for equal values - exactly like
+* (paths_difference<0) ? pm_candidate1 : pm_candidate2. The tables below store the numbers of the increments used by
+* even states (odd states use the same increments with opposite signs).
+*/
+static const unsigned int imag_increment1[PATHS_NUM/2] = {2, 3, 0, 1, 6, 7, 4, 5};
+static const unsigned int imag_increment2[PATHS_NUM/2] = {5, 4, 7, 6, 1, 0, 3, 2};
+static const unsigned int real_increment1[PATHS_NUM/2] = {7, 6, 5, 4, 3, 2, 1, 0};
+static const unsigned int real_increment2[PATHS_NUM/2] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+static void make_branch_tables(const float * increment, float * imag1, float * imag2, float * real1, float * real2)
+{
+   for(unsigned int k=0; k<PATHS_NUM/2; k++){
+      imag1[2*k]   = -increment[imag_increment1[k]];
+      imag1[2*k+1] =  increment[imag_increment1[k]];
+      imag2[2*k]   =  increment[imag_increment2[k]];
+      imag2[2*k+1] = -increment[imag_increment2[k]];
+      real1[2*k]   = -increment[real_increment1[k]];
+      real1[2*k+1] =  increment[real_increment1[k]];
+      real2[2*k]   =  increment[real_increment2[k]];
+      real2[2*k+1] = -increment[real_increment2[k]];
+   }
+}
+
+/*
+* SSE: 4 states per register, path metrics are kept in registers during
+* the whole burst.
+*/
+__attribute__((target("sse")))
+static inline void acs_sse_step(__m128 * pm, __m128 symbol, const float * branch1, const float * branch2, float * decisions)
+{
+   __m128 prev1[4], prev2[4];
+
+   prev1[0] = _mm_unpacklo_ps(pm[0], pm[0]);
+   prev1[1] = _mm_unpackhi_ps(pm[0], pm[0]);
+   prev1[2] = _mm_unpacklo_ps(pm[1], pm[1]);
+   prev1[3] = _mm_unpackhi_ps(pm[1], pm[1]);
+   prev2[0] = _mm_unpacklo_ps(pm[2], pm[2]);
+   prev2[1] = _mm_unpackhi_ps(pm[2], pm[2]);
+   prev2[2] = _mm_unpacklo_ps(pm[3], pm[3]);
+   prev2[3] = _mm_unpackhi_ps(pm[3], pm[3]);
+
+   for(int ii=0; ii<4; ii++){
+      __m128 pm_candidate1 = _mm_add_ps(_mm_add_ps(prev1[ii], symbol), _mm_loadu_ps(branch1 + 4*ii));
+      __m128 pm_candidate2 = _mm_add_ps(_mm_add_ps(prev2[ii], symbol), _mm_loadu_ps(branch2 + 4*ii));
+      __m128 paths_difference = _mm_sub_ps(pm_candidate2, pm_candidate1);
+      pm[ii] = _mm_max_ps(pm_candidate1, pm_candidate2);
+      _mm_storeu_ps(decisions + 4*ii, paths_difference);
+   }
+}
+
+__attribute__((target("sse")))
+static void viterbi_acs_sse(const gr_complex * input, unsigned int samples_num, const float * increment, float * path_metrics, float (* trans_table)[PATHS_NUM])
+{
+   float imag1[PATHS_NUM], imag2[PATHS_NUM], real1[PATHS_NUM], real2[PATHS_NUM];
+   const __m128 imag_sign = _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f);
+   const __m128 real_sign = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+   __m128 pm[4];
+   unsigned int sample_nr;
+
+   make_branch_tables(increment, imag1, imag2, real1, real2);
+   for(int ii=0; ii<4; ii++){
+      pm[ii] = _mm_loadu_ps(path_metrics + 4*ii);
+   }
+
+   for(sample_nr=0; sample_nr<samples_num; sample_nr++){
+      if((sample_nr & 1) == 0){
+         __m128 symbol = _mm_mul_ps(_mm_set1_ps(input[sample_nr].imag()), imag_sign);
+         acs_sse_step(pm, symbol, imag1, imag2, trans_table[sample_nr]);
+      } else {
+         __m128 symbol = _mm_mul_ps(_mm_set1_ps(input[sample_nr].real()), real_sign);
+         acs_sse_step(pm, symbol, real1, real2, trans_table[sample_nr]);
+      }
+   }
+
+   for(int ii=0; ii<4; ii++){
+      _mm_storeu_ps(path_metrics + 4*ii, pm[ii]);
+   }
+}
+
+/*
+* AVX: 8 states per register. AVX shuffles don't cross 128-bit lanes, so
+* the previous path metrics are first broadcast to both lanes and then
+* duplicated with a per-lane variable permutation.
+*/
+__attribute__((target("avx")))
+static inline __m256 acs_avx_duplicate(__m256 pm, const int lane, __m256i order)
+{
+   return _mm256_permutevar_ps(_mm256_permute2f128_ps(pm, pm, lane), order);
+}
+
+__attribute__((target("avx")))
+static inline void acs_avx_step(__m256 * pm, __m256 symbol, const float * branch1, const float * branch2, float * decisions)
+{
+   const __m256i order = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+   __m256 prev1[2], prev2[2];
+
+   prev1[0] = acs_avx_duplicate(pm[0], 0x00, order);
+   prev1[1] = acs_avx_duplicate(pm[0], 0x11, order);
+   prev2[0] = acs_avx_duplicate(pm[1], 0x00, order);
+   prev2[1] = acs_avx_duplicate(pm[1], 0x11, order);
+
+   for(int ii=0; ii<2; ii++){
+      __m256 pm_candidate1 = _mm256_add_ps(_mm256_add_ps(prev1[ii], symbol), _mm256_loadu_ps(branch1 + 8*ii));
+      __m256 pm_candidate2 = _mm256_add_ps(_mm256_add_ps(prev2[ii], symbol), _mm256_loadu_ps(branch2 + 8*ii));
+      __m256 paths_difference = _mm256_sub_ps(pm_candidate2, pm_candidate1);
+      pm[ii] = _mm256_max_ps(pm_candidate1, pm_candidate2);
+      _mm256_storeu_ps(decisions + 8*ii, paths_difference);
+   }
+}
+
+__attribute__((target("avx")))
+static void viterbi_acs_avx(const gr_complex * input, unsigned int samples_num, const float * increment, float * path_metrics, float (* trans_table)[PATHS_NUM])
+{
+   float imag1[PATHS_NUM], imag2[PATHS_NUM], real1[PATHS_NUM], real2[PATHS_NUM];
+   const __m256 imag_sign = _mm256_setr_ps(1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f);
+   const __m256 real_sign = _mm256_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f);
+   __m256 pm[2];
+   unsigned int sample_nr;
+
+   make_branch_tables(increment, imag1, imag2, real1, real2);
+   pm[0] = _mm256_loadu_ps(path_metrics);
+   pm[1] = _mm256_loadu_ps(path_metrics + 8);
+
+   for(sample_nr=0; sample_nr<samples_num; sample_nr++){
+      if((sample_nr & 1) == 0){
+         __m256 symbol = _mm256_mul_ps(_mm256_set1_ps(input[sample_nr].imag()), imag_sign);
+         acs_avx_step(pm, symbol, imag1, imag2, trans_table[sample_nr]);
+      } else {
+         __m256 symbol = _mm256_mul_ps(_mm256_set1_ps(input[sample_nr].real()), real_sign);
+         acs_avx_step(pm, symbol, real1, real2, trans_table[sample_nr]);
+      }
+   }
+
+   _mm256_storeu_ps(path_metrics, pm[0]);
+   _mm256_storeu_ps(path_metrics + 8, pm[1]);
+}
+#endif /* VITERBI_ACS_HAVE_X86 */
+
+/*
+* Table of kernels supported by the running CPU - it's filled once,
+* on the first use.
+*/
+namespace {
+  struct viterbi_acs_table
+  {
+    viterbi_acs_impl impls[3];
+    unsigned int impls_num;
+
+    void add(const char * name, viterbi_acs_kernel kernel)
+    {
+      impls[impls_num].name = name;
+      impls[impls_num].kernel = kernel;
+      impls_num++;
+    }
+
+    viterbi_acs_table() : impls_num(0)
+    {
+      add("generic", viterbi_acs_generic);
+#ifdef VITERBI_ACS_HAVE_X86
+      __builtin_cpu_init();
+      if(__builtin_cpu_supports("sse")){
+        add("sse", viterbi_acs_sse);
+      }
+      if(__builtin_cpu_supports("avx")){
+        add("avx", viterbi_acs_avx);
+      }
+#endif
+    }
+  };
+}
+
+const viterbi_acs_impl * viterbi_acs_impls(unsigned int * impls_num)
+{
+   static const viterbi_acs_table table;
+   *impls_num = table.impls_num;
+   return table.impls;
+}
+
+viterbi_acs_kernel viterbi_acs_get(const char * impl_name)
+{
+   unsigned int impls_num;
+   const viterbi_acs_impl * impls = viterbi_acs_impls(&impls_num);
+
+   if(impl_name == NULL){
+      return impls[impls_num-1].kernel;
+   }
+   for(unsigned int i=0; i<impls_num; i++){
+      if(strcmp(impls[i].name, impl_name) == 0){
+         return impls[i].kernel;
+      }
+   }
+   return NULL;
+}
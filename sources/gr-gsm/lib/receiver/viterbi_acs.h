@@ -0,0 +1,82 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * viterbi_acs:
+ *           Add-Compare-Select kernels of the MLSE viterbi_detector.
+ *           There is one kernel per instruction set, in the same spirit
+ *           as VOLK: "generic" is the scalar reference and "sse"/"avx"
+ *           process all 16 trellis states of a sample with 4 or 2
+ *           vector operations. All kernels give bit-exact results -
+ *           every path metric is computed with the same sequence of
+ *           floating point operations as in the scalar code.
+ *
+ *           The fastest kernel supported by the CPU is selected on the
+ *           first call of viterbi_acs_get(NULL).
+ *
+ * SYNTAX:   void viterbi_acs_kernel(
+ *                                  const gr_complex * input,
+ *                                  unsigned int samples_num,
+ *                                  const float * increment,
+ *                                  float * path_metrics,
+ *                                  float (* trans_table)[PATHS_NUM])
+ *
+ * INPUT:    input:        Complex received signal after matched filtering.
+ *           samples_num:  Number of samples in the input table.
+ *           increment:    Table of 8 reference levels for computation of
+ *                         branch metrics.
+ *           path_metrics: Initial path metrics of the 16 states.
+ *
+ * OUTPUT:   path_metrics: Path metrics after the last sample.
+ *           trans_table:  Path differences (decisions) for every sample
+ *                         and state, used during the traceback.
+ */
+
+#ifndef INCLUDED_VITERBI_ACS_H
+#define INCLUDED_VITERBI_ACS_H
+
+#include <gnuradio/gr_complex.h>
+#include <gsm_constants.h>
+
+#define PATHS_NUM (1 << (CHAN_IMP_RESP_LENGTH-1))
+
+typedef void (*viterbi_acs_kernel)(const gr_complex * input, unsigned int samples_num, const float * increment, float * path_metrics, float (* trans_table)[PATHS_NUM]);
+
+typedef struct {
+  const char * name;         ///< name of the implementation: "generic", "sse", "avx"
+  viterbi_acs_kernel kernel; ///< pointer to the kernel
+} viterbi_acs_impl;
+
+/** Returns implementations of the ACS kernel supported by the running CPU
+ *
+ * @param[out] impls_num number of entries in the returned table
+ * @return table of the implementations, ordered from the slowest ("generic") to the fastest
+ */
+const viterbi_acs_impl * viterbi_acs_impls(unsigned int * impls_num);
+
+/** Returns ACS kernel with given name
+ *
+ * @param impl_name name of the implementation, NULL selects the fastest one
+ * @return pointer to the kernel or NULL if there is no such implementation
+ */
+viterbi_acs_kernel viterbi_acs_get(const char * impl_name);
+
+#endif /* INCLUDED_VITERBI_ACS_H */
@@ -57,40 +57,27 @@
 
 #include <gnuradio/gr_complex.h>
 #include <gsm_constants.h>
+#include <viterbi_acs.h>
+#include <viterbi_detector.h>
 #include <cmath>
-
-#define PATHS_NUM (1 << (CHAN_IMP_RESP_LENGTH-1))
-
-void viterbi_detector(const gr_complex * input, unsigned int samples_num, gr_complex * rhh, unsigned int start_state, const unsigned int * stop_states, unsigned int stops_num, float * output)
-{
-   float increment[8];
-   float path_metrics1[16];
-   float path_metrics2[16];
-   float paths_difference;
-   float * new_path_metrics;
-   float * old_path_metrics;
-   float * tmp;
-   float trans_table[BURST_SIZE][16];
-   float pm_candidate1, pm_candidate2;
-   bool real_imag;
-   float input_symbol_real, input_symbol_imag;
-   unsigned int i, sample_nr;
+#include <string.h>
 
 /*
-* Setup first path metrics, so only state pointed by start_state is possible.
-* Start_state metric is equal to zero, the rest is written with some very low value,
-* which makes them practically impossible to occur.
+* This table was generated with hope that it gives a litle speedup during
+* traceback stage. 
+* Received bit is related to the number of state in the trellis.
+* I've numbered states so their parity (number of ones) is related
+* to a received bit. 
 */
-   for(i=0; i<PATHS_NUM; i++){
-      path_metrics1[i]=(-10e30);
-   }
-   path_metrics1[start_state]=0;
+static const unsigned int parity_table[PATHS_NUM] = { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0,  };
 
 /*
 * Compute Increment - a table of values which does not change for subsequent input samples.
 * Increment is table of reference levels for computation of branch metrics:
 *    branch metric = (+/-)received_sample (+/-) reference_level
 */
+static void compute_increment(const gr_complex * rhh, float * increment)
+{
    increment[0] = -rhh[1].imag() -rhh[2].real() -rhh[3].imag() +rhh[4].real();
    increment[1] = rhh[1].imag() -rhh[2].real() -rhh[3].imag() +rhh[4].real();
    increment[2] = -rhh[1].imag() +rhh[2].real() -rhh[3].imag() +rhh[4].real();
@@ -99,239 +86,37 @@ void viterbi_detector(const gr_complex * input, unsigned int samples_num, gr_com
    increment[5] = rhh[1].imag() -rhh[2].real() +rhh[3].imag() +rhh[4].real();
    increment[6] = -rhh[1].imag() +rhh[2].real() +rhh[3].imag() +rhh[4].real();
    increment[7] = rhh[1].imag() +rhh[2].real() +rhh[3].imag() +rhh[4].real();
+}
 
+static void viterbi_detector_kernel(const gr_complex * input, unsigned int samples_num, gr_complex * rhh, unsigned int start_state, const unsigned int * stop_states, unsigned int stops_num, float * output, viterbi_acs_kernel acs)
+{
+   float increment[8];
+   float path_metrics[PATHS_NUM];
+   float trans_table[BURST_SIZE][PATHS_NUM];
+   bool real_imag;
+   unsigned int i, sample_nr;
 
 /*
-* Computation of path metrics and decisions (Add-Compare-Select).
-* It's composed of two parts: one for odd input samples (imaginary numbers)
-* and one for even samples (real numbers).
-* Each part is composed of independent (parallelisable) statements like  
-* this one:
-*      pm_candidate1 = old_path_metrics[0] -input_symbol_imag +increment[2];
-*      pm_candidate2 = old_path_metrics[8] -input_symbol_imag -increment[5];
-*      paths_difference=pm_candidate2-pm_candidate1;
-*      new_path_metrics[1]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-*      trans_table[sample_nr][1] = paths_difference;
-* This is very good point for optimisations (SIMD or OpenMP) as it's most time 
-* consuming part of this function. 
+* Setup first path metrics, so only state pointed by start_state is possible.
+* Start_state metric is equal to zero, the rest is written with some very low value,
+* which makes them practically impossible to occur.
 */
-   sample_nr=0;
-   old_path_metrics=path_metrics1;
-   new_path_metrics=path_metrics2;
-   while(sample_nr<samples_num){
-      //Processing imag states
-      real_imag=1;
-      input_symbol_imag = input[sample_nr].imag();
-
-      pm_candidate1 = old_path_metrics[0] +input_symbol_imag -increment[2];
-      pm_candidate2 = old_path_metrics[8] +input_symbol_imag +increment[5];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[0]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][0] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[0] -input_symbol_imag +increment[2];
-      pm_candidate2 = old_path_metrics[8] -input_symbol_imag -increment[5];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[1]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][1] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[1] +input_symbol_imag -increment[3];
-      pm_candidate2 = old_path_metrics[9] +input_symbol_imag +increment[4];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[2]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][2] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[1] -input_symbol_imag +increment[3];
-      pm_candidate2 = old_path_metrics[9] -input_symbol_imag -increment[4];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[3]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][3] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[2] +input_symbol_imag -increment[0];
-      pm_candidate2 = old_path_metrics[10] +input_symbol_imag +increment[7];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[4]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][4] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[2] -input_symbol_imag +increment[0];
-      pm_candidate2 = old_path_metrics[10] -input_symbol_imag -increment[7];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[5]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][5] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[3] +input_symbol_imag -increment[1];
-      pm_candidate2 = old_path_metrics[11] +input_symbol_imag +increment[6];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[6]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][6] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[3] -input_symbol_imag +increment[1];
-      pm_candidate2 = old_path_metrics[11] -input_symbol_imag -increment[6];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[7]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][7] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[4] +input_symbol_imag -increment[6];
-      pm_candidate2 = old_path_metrics[12] +input_symbol_imag +increment[1];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[8]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][8] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[4] -input_symbol_imag +increment[6];
-      pm_candidate2 = old_path_metrics[12] -input_symbol_imag -increment[1];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[9]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][9] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[5] +input_symbol_imag -increment[7];
-      pm_candidate2 = old_path_metrics[13] +input_symbol_imag +increment[0];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[10]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][10] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[5] -input_symbol_imag +increment[7];
-      pm_candidate2 = old_path_metrics[13] -input_symbol_imag -increment[0];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[11]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][11] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[6] +input_symbol_imag -increment[4];
-      pm_candidate2 = old_path_metrics[14] +input_symbol_imag +increment[3];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[12]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][12] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[6] -input_symbol_imag +increment[4];
-      pm_candidate2 = old_path_metrics[14] -input_symbol_imag -increment[3];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[13]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][13] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[7] +input_symbol_imag -increment[5];
-      pm_candidate2 = old_path_metrics[15] +input_symbol_imag +increment[2];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[14]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][14] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[7] -input_symbol_imag +increment[5];
-      pm_candidate2 = old_path_metrics[15] -input_symbol_imag -increment[2];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[15]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][15] = paths_difference;
-      tmp=old_path_metrics;
-      old_path_metrics=new_path_metrics;
-      new_path_metrics=tmp;
-
-      sample_nr++;
-      if(sample_nr==samples_num)
-         break;
-
-      //Processing real states
-      real_imag=0;
-      input_symbol_real = input[sample_nr].real();
-
-      pm_candidate1 = old_path_metrics[0] -input_symbol_real -increment[7];
-      pm_candidate2 = old_path_metrics[8] -input_symbol_real +increment[0];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[0]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][0] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[0] +input_symbol_real +increment[7];
-      pm_candidate2 = old_path_metrics[8] +input_symbol_real -increment[0];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[1]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][1] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[1] -input_symbol_real -increment[6];
-      pm_candidate2 = old_path_metrics[9] -input_symbol_real +increment[1];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[2]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][2] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[1] +input_symbol_real +increment[6];
-      pm_candidate2 = old_path_metrics[9] +input_symbol_real -increment[1];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[3]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][3] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[2] -input_symbol_real -increment[5];
-      pm_candidate2 = old_path_metrics[10] -input_symbol_real +increment[2];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[4]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][4] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[2] +input_symbol_real +increment[5];
-      pm_candidate2 = old_path_metrics[10] +input_symbol_real -increment[2];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[5]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][5] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[3] -input_symbol_real -increment[4];
-      pm_candidate2 = old_path_metrics[11] -input_symbol_real +increment[3];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[6]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][6] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[3] +input_symbol_real +increment[4];
-      pm_candidate2 = old_path_metrics[11] +input_symbol_real -increment[3];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[7]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][7] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[4] -input_symbol_real -increment[3];
-      pm_candidate2 = old_path_metrics[12] -input_symbol_real +increment[4];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[8]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][8] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[4] +input_symbol_real +increment[3];
-      pm_candidate2 = old_path_metrics[12] +input_symbol_real -increment[4];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[9]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][9] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[5] -input_symbol_real -increment[2];
-      pm_candidate2 = old_path_metrics[13] -input_symbol_real +increment[5];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[10]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][10] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[5] +input_symbol_real +increment[2];
-      pm_candidate2 = old_path_metrics[13] +input_symbol_real -increment[5];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[11]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][11] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[6] -input_symbol_real -increment[1];
-      pm_candidate2 = old_path_metrics[14] -input_symbol_real +increment[6];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[12]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][12] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[6] +input_symbol_real +increment[1];
-      pm_candidate2 = old_path_metrics[14] +input_symbol_real -increment[6];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[13]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][13] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[7] -input_symbol_real -increment[0];
-      pm_candidate2 = old_path_metrics[15] -input_symbol_real +increment[7];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[14]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][14] = paths_difference;
-
-      pm_candidate1 = old_path_metrics[7] +input_symbol_real +increment[0];
-      pm_candidate2 = old_path_metrics[15] +input_symbol_real -increment[7];
-      paths_difference=pm_candidate2-pm_candidate1;
-      new_path_metrics[15]=(paths_difference<0) ? pm_candidate1 : pm_candidate2;
-      trans_table[sample_nr][15] = paths_difference;
+   for(i=0; i<PATHS_NUM; i++){
+      path_metrics[i]=(-10e30);
+   }
+   path_metrics[start_state]=0;
 
-      tmp=old_path_metrics;
-      old_path_metrics=new_path_metrics;
-      new_path_metrics=tmp;
+   compute_increment(rhh, increment);
 
-      sample_nr++;
-   }
+/*
+* Computation of path metrics and decisions (Add-Compare-Select).
+* This is the most time consuming part of this function, so it's done
+* by a kernel selected for the instruction set of the CPU (see viterbi_acs.h).
+* The last processed sample decides if the traceback starts from
+* a real (even sample number) or imaginary (odd sample number) part.
+*/
+   acs(input, samples_num, increment, path_metrics, trans_table);
+   real_imag = (samples_num % 2) == 1;
 
 /*
 * Find the best from the stop states by comparing their path metrics.
@@ -341,24 +126,15 @@ void viterbi_detector(const gr_complex * input, unsigned int samples_num, gr_com
    unsigned int best_stop_state;
    float stop_state_metric, max_stop_state_metric;
    best_stop_state = stop_states[0];
-   max_stop_state_metric = old_path_metrics[best_stop_state];
+   max_stop_state_metric = path_metrics[best_stop_state];
    for(i=1; i< stops_num; i++){
-      stop_state_metric = old_path_metrics[stop_states[i]];
+      stop_state_metric = path_metrics[stop_states[i]];
       if(stop_state_metric > max_stop_state_metric){
          max_stop_state_metric = stop_state_metric;
          best_stop_state = stop_states[i];
       }
    }
 
-/*
-* This table was generated with hope that it gives a litle speedup during
-* traceback stage. 
-* Received bit is related to the number of state in the trellis.
-* I've numbered states so their parity (number of ones) is related
-* to a received bit. 
-*/
-   static const unsigned int parity_table[PATHS_NUM] = { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0,  };
-
 /*
 * Table of previous states in the trellis diagram.
 * For GMSK modulation every state has two previous states.
@@ -391,3 +167,124 @@ void viterbi_detector(const gr_complex * input, unsigned int samples_num, gr_com
       real_imag = !real_imag;
    }
 }
+
+void viterbi_detector(const gr_complex * input, unsigned int samples_num, gr_complex * rhh, unsigned int start_state, const unsigned int * stop_states, unsigned int stops_num, float * output)
+{
+   static const viterbi_acs_kernel acs = viterbi_acs_get(NULL);
+   viterbi_detector_kernel(input, samples_num, rhh, start_state, stop_states, stops_num, output, acs);
+}
+
+bool viterbi_detector_manual(const gr_complex * input, unsigned int samples_num, gr_complex * rhh, unsigned int start_state, const unsigned int * stop_states, unsigned int stops_num, float * output, const char * impl_name)
+{
+   viterbi_acs_kernel acs = viterbi_acs_get(impl_name);
+   if(acs == NULL){
+      return false;
+   }
+   viterbi_detector_kernel(input, samples_num, rhh, start_state, stop_states, stops_num, output, acs);
+   return true;
+}
+
+/*
+* Branch metric of the transition from prev_state to state at the given sample,
+* the same as in the Add-Compare-Select kernels. Even samples are imaginary,
+* odd ones are real. The previous state is state/2 or state/2+8.
+*/
+static inline float branch_metric(const gr_complex * input, unsigned int sample_nr, const float * increment, unsigned int prev_state, unsigned int state)
+{
+   static const unsigned int imag_increment[2][PATHS_NUM/2] = { {2, 3, 0, 1, 6, 7, 4, 5}, {5, 4, 7, 6, 1, 0, 3, 2} };
+   static const unsigned int real_increment[2][PATHS_NUM/2] = { {7, 6, 5, 4, 3, 2, 1, 0}, {0, 1, 2, 3, 4, 5, 6, 7} };
+   unsigned int upper = prev_state >= PATHS_NUM/2;
+   float metric;
+
+   if((sample_nr % 2) == 0){
+      float x = input[sample_nr].imag();
+      metric = upper ? x + increment[imag_increment[1][state/2]] : x - increment[imag_increment[0][state/2]];
+   } else {
+      float x = input[sample_nr].real();
+      metric = upper ? -x + increment[real_increment[1][state/2]] : -x - increment[real_increment[0][state/2]];
+   }
+   return (state % 2) ? -metric : metric;
+}
+
+void viterbi_detector_soft(const gr_complex * input, unsigned int samples_num, gr_complex * rhh, unsigned int start_state, const unsigned int * stop_states, unsigned int stops_num, float * output)
+{
+   float increment[8];
+   float start_metrics[PATHS_NUM];
+   float forward_metrics[BURST_SIZE][PATHS_NUM];
+   float backward_metrics[PATHS_NUM][2];
+   float prev_backward_metrics[PATHS_NUM][2];
+   unsigned int i, state, bit, sample_nr;
+
+   compute_increment(rhh, increment);
+
+/*
+* Forward recursion - path metrics of every state after every sample,
+* the same ones as computed by the ACS kernels.
+*/
+   for(state=0; state<PATHS_NUM; state++){
+      start_metrics[state] = (state == start_state) ? 0 : (-10e30);
+   }
+   for(sample_nr=0; sample_nr<samples_num; sample_nr++){
+      const float * prev_metrics = (sample_nr == 0) ? start_metrics : forward_metrics[sample_nr-1];
+      for(state=0; state<PATHS_NUM; state++){
+         unsigned int lower = state/2, upper = state/2 + PATHS_NUM/2;
+         float pm_candidate1 = prev_metrics[lower] + branch_metric(input, sample_nr, increment, lower, state);
+         float pm_candidate2 = prev_metrics[upper] + branch_metric(input, sample_nr, increment, upper, state);
+         forward_metrics[sample_nr][state] = (pm_candidate2 < pm_candidate1) ? pm_candidate1 : pm_candidate2;
+      }
+   }
+
+/*
+* Backward recursion. Bits are differentially decoded during the traceback
+* of viterbi_detector: bit n is the XOR of (real_imag ^ parity_table[state])
+* over all samples after n, so backward metrics are kept separately for
+* paths which give "0" and "1" at the current sample. The output is the
+* difference of the best paths through "1" and through "0".
+*/
+   for(state=0; state<PATHS_NUM; state++){
+      backward_metrics[state][0] = (-10e30);
+      backward_metrics[state][1] = (-10e30);
+   }
+   for(i=0; i<stops_num; i++){
+      backward_metrics[stop_states[i]][0] = 0;
+   }
+
+   sample_nr=samples_num;
+   while(sample_nr>0){
+      sample_nr--;
+
+      float best[2] = {(-10e30), (-10e30)};
+      for(state=0; state<PATHS_NUM; state++){
+         for(bit=0; bit<2; bit++){
+            float metric = forward_metrics[sample_nr][state] + backward_metrics[state][bit];
+            if(metric > best[bit]){
+               best[bit] = metric;
+            }
+         }
+      }
+      output[sample_nr] = best[1] - best[0];
+
+      if(sample_nr == 0)
+         break;
+
+      unsigned int real_imag = (sample_nr + 1) % 2;
+      for(state=0; state<PATHS_NUM; state++){
+         prev_backward_metrics[state][0] = (-10e30);
+         prev_backward_metrics[state][1] = (-10e30);
+      }
+      for(state=0; state<PATHS_NUM; state++){
+         unsigned int flip = real_imag ^ parity_table[state];
+         unsigned int prev_states[2] = {state/2, state/2 + PATHS_NUM/2};
+         for(i=0; i<2; i++){
+            float branch = branch_metric(input, sample_nr, increment, prev_states[i], state);
+            for(bit=0; bit<2; bit++){
+               float metric = branch + backward_metrics[state][bit];
+               if(metric > prev_backward_metrics[prev_states[i]][bit ^ flip]){
+                  prev_backward_metrics[prev_states[i]][bit ^ flip] = metric;
+               }
+            }
+         }
+      }
+      memcpy(backward_metrics, prev_backward_metrics, sizeof(backward_metrics));
+   }
+}
@@ -60,4 +60,24 @@
 
 void viterbi_detector(const gr_complex * input, unsigned int samples_num, gr_complex * rhh, unsigned int start_state, const unsigned int * stop_states, unsigned int stops_num, float * output);
 
+/*
+ * viterbi_detector_manual:
+ *           The same as viterbi_detector, but the Add-Compare-Select part
+ *           is done by the implementation with given name ("generic", "sse",
+ *           "avx") instead of the fastest one supported by the CPU.
+ *           Returns false if the implementation isn't available.
+ */
+bool viterbi_detector_manual(const gr_complex * input, unsigned int samples_num, gr_complex * rhh, unsigned int start_state, const unsigned int * stop_states, unsigned int stops_num, float * output, const char * impl_name);
+
+/*
+ * viterbi_detector_soft:
+ *           Soft output detection on the same trellis (max-log-MAP).
+ *           Arguments are the same as of viterbi_detector. Output for every
+ *           bit is the difference between path metrics of the best sequence
+ *           in which the bit is "1" and the best one in which it's "0", so its
+ *           sign is the decision of viterbi_detector and its magnitude is the
+ *           reliability of the decision.
+ */
+void viterbi_detector_soft(const gr_complex * input, unsigned int samples_num, gr_complex * rhh, unsigned int start_state, const unsigned int * stop_states, unsigned int stops_num, float * output);
+
 #endif /* INCLUDED_VITERBI_DETECTOR_H */
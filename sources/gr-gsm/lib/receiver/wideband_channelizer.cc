@@ -0,0 +1,251 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <wideband_channelizer.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+
+#define BIN_SPACING     200e3   //wanted spacing of the filter bank bins, the carrier spacing
+#define PFB_PASSBAND    185e3   //half bandwidth of a carrier (135kHz) with a margin for the clock offset
+#define CHANNEL_CUTOFF  125e3   //channel filter of the resampler, as the one of gsm_input
+#define CHANNEL_TRANS   75e3
+
+/*
+ * Windowed sinc low pass filter with the number of taps computed like
+ * firdes does it for the window, scaled to the gain at DC
+ */
+static std::vector<float>
+low_pass(double rate, double cutoff, double transition, bool blackman, int multiple, double gain)
+{
+    double attenuation = blackman ? 74.0 : 53.0;
+    int ntaps = (int)(attenuation * rate / (22.0 * transition));
+    ntaps = std::max(multiple, (ntaps + multiple - 1) / multiple * multiple);
+
+    std::vector<float> taps(ntaps);
+    double center = (ntaps - 1) / 2.0;
+    double wc = 2 * M_PI * cutoff / rate;
+    double sum = 0;
+    for(int n = 0; n < ntaps; n++) {
+        double x = n - center;
+        double h = (x == 0) ? wc / M_PI : sin(wc * x) / (M_PI * x);
+        double w;
+        if(blackman) {
+            w = 0.42 - 0.5 * cos(2 * M_PI * n / (ntaps - 1)) + 0.08 * cos(4 * M_PI * n / (ntaps - 1));
+        } else {
+            w = 0.54 - 0.46 * cos(2 * M_PI * n / (ntaps - 1));
+        }
+        taps[n] = h * w;
+        sum += taps[n];
+    }
+    for(int n = 0; n < ntaps; n++) {
+        taps[n] *= gain / sum;
+    }
+    return taps;
+}
+
+wideband_channelizer::wideband_channelizer(double samp_rate_in, double fc, const std::vector<double> & channel_freqs, int osr, double ppm) :
+    d_samp_rate_in(samp_rate_in),
+    d_fc(fc),
+    d_samp_rate_out(1625000.0 / 6.0 * osr),
+    d_ppm(ppm),
+    d_frame(0),
+    d_mu(0)
+{
+    d_decim = std::max(1, (int)(samp_rate_in / (OVERSAMPLING * BIN_SPACING)));
+    d_nbins = OVERSAMPLING * d_decim;
+    d_bin_rate = samp_rate_in / d_decim;
+    double spacing = samp_rate_in / d_nbins;
+
+    //the filter bank only has to keep what would alias into the carrier after decimation,
+    //the carrier is filtered by the resampler
+    double passband = std::min(spacing / 2 + PFB_PASSBAND, d_bin_rate * 7 / 16);
+    std::vector<float> prototype = low_pass(samp_rate_in, d_bin_rate / 2, d_bin_rate - 2 * passband, true, d_nbins, 1.0);
+    d_pfb_taps.assign(prototype.rbegin(), prototype.rend());
+    d_delay.assign(d_pfb_taps.size() - 1, 0);
+    d_acc.resize(2 * d_nbins);
+    d_fft = new gr::fft::fft_complex(d_nbins, false);
+
+    std::vector<float> interpolator = low_pass(RESAMPLER_PHASES * d_bin_rate, CHANNEL_CUTOFF, CHANNEL_TRANS, false, RESAMPLER_PHASES, RESAMPLER_PHASES);
+    d_resamp_ntaps = interpolator.size() / RESAMPLER_PHASES;
+    d_resamp_taps.assign((RESAMPLER_PHASES + 1) * d_resamp_ntaps, 0);
+    for(int f = 0; f <= RESAMPLER_PHASES; f++) {
+        for(int j = 0; j < d_resamp_ntaps; j++) {
+            size_t n = f + j * RESAMPLER_PHASES;
+            if(n < interpolator.size()) {
+                d_resamp_taps[f * d_resamp_ntaps + d_resamp_ntaps - 1 - j] = interpolator[n];
+            }
+        }
+    }
+
+    d_channels.resize(channel_freqs.size());
+    for(size_t c = 0; c < channel_freqs.size(); c++) {
+        channel & ch = d_channels[c];
+        ch.freq = channel_freqs[c];
+        ch.offset = channel_freqs[c] - fc;
+        ch.bin = ((int)round(ch.offset / spacing) % d_nbins + d_nbins) % d_nbins;
+        for(int r = 0; r < OVERSAMPLING; r++) {
+            ch.frame_phase.push_back(std::polar(1.0f, (float)(-2 * M_PI * ch.bin * r / OVERSAMPLING)));
+        }
+        ch.history.assign(2 * d_resamp_ntaps, 0);
+        ch.history_pos = 0;
+    }
+    set_offsets();
+}
+
+wideband_channelizer::~wideband_channelizer()
+{
+    delete d_fft;
+}
+
+void wideband_channelizer::set_ppm(double ppm)
+{
+    d_ppm = ppm;
+    set_offsets();
+}
+
+/*
+ * With the clock off by ppm, a carrier at freq is seen at offset - ppm * freq
+ * and the input is faster by ppm, see clock_offset_corrector
+ */
+void wideband_channelizer::set_offsets()
+{
+    double error = d_ppm * 1e-6;
+    double spacing = d_samp_rate_in / d_nbins;
+
+    d_resamp_ratio = d_bin_rate * (1 + error) / d_samp_rate_out;
+    for(size_t c = 0; c < d_channels.size(); c++) {
+        channel & ch = d_channels[c];
+        double rest = ch.offset - error * ch.freq - round(ch.offset / spacing) * spacing;
+        ch.rotator.set_phase_incr(std::polar(1.0f, (float)(-2 * M_PI * rest / d_bin_rate)));
+    }
+}
+
+/*
+ * Sums the polyphase branches of the prototype filter on the last
+ * d_pfb_taps.size() input samples starting at x and transforms them
+ * into the bins
+ */
+inline void wideband_channelizer::filter_frame(const gr_complex * x)
+{
+    const int nbranches = d_pfb_taps.size() / d_nbins;
+    const float * in = (const float *)x;
+    float * acc = &d_acc[0];
+
+    std::fill(d_acc.begin(), d_acc.end(), 0.0f);
+    for(int q = 0; q < nbranches; q++) {
+        const float * h = &d_pfb_taps[q * d_nbins];
+        const float * s = in + 2 * q * d_nbins;
+        for(int m = 0; m < d_nbins; m++) {
+            acc[2 * m] += h[m] * s[2 * m];
+            acc[2 * m + 1] += h[m] * s[2 * m + 1];
+        }
+    }
+
+    gr_complex * fft_in = d_fft->get_inbuf();
+    for(int m = 0; m < d_nbins; m++) {
+        int k = d_nbins - 1 - m;
+        fft_in[m] = gr_complex(acc[2 * k], acc[2 * k + 1]);
+    }
+    d_fft->execute();
+}
+
+int wideband_channelizer::channelize(const gr_complex * in, int ninput, gr_complex * const * out, int noutput, int & consumed)
+{
+    const int nframes = ninput / d_decim;
+    memcpy(delay_input(nframes), in, nframes * d_decim * sizeof(gr_complex));
+    return filter_frames(nframes, out, noutput, consumed);
+}
+
+int wideband_channelizer::channelize(const int16_t * in, int ninput, gr_complex * const * out, int noutput, int & consumed)
+{
+    const int nframes = ninput / d_decim;
+    volk_16i_s32f_convert_32f((float *)delay_input(nframes), in, 32768.0f, 2 * nframes * d_decim);
+    return filter_frames(nframes, out, noutput, consumed);
+}
+
+/*
+ * Makes room for the input of nframes frames after the history
+ */
+gr_complex * wideband_channelizer::delay_input(int nframes)
+{
+    const int history = d_pfb_taps.size() - 1;
+
+    if(d_delay.size() < (size_t)(history + nframes * d_decim)) {
+        d_delay.resize(history + nframes * d_decim);
+    }
+    return &d_delay[history];
+}
+
+int wideband_channelizer::filter_frames(int nframes, gr_complex * const * out, int noutput, int & consumed)
+{
+    const int history = d_pfb_taps.size() - 1;
+    int produced = 0;
+    int frame;
+
+    for(frame = 0; frame < nframes; frame++) {
+        int outputs = 0;
+        for(double mu = d_mu; mu < 1.0; mu += d_resamp_ratio) {
+            outputs++;
+        }
+        if(produced + outputs > noutput) {
+            break;
+        }
+
+        filter_frame(&d_delay[(frame + 1) * d_decim - 1]);
+        const gr_complex * bins = d_fft->get_outbuf();
+        for(size_t c = 0; c < d_channels.size(); c++) {
+            channel & ch = d_channels[c];
+            gr_complex sample = ch.rotator.rotate(bins[ch.bin] * ch.frame_phase[d_frame]);
+            ch.history[ch.history_pos] = sample;
+            ch.history[ch.history_pos + d_resamp_ntaps] = sample;
+            ch.history_pos = (ch.history_pos + 1) % d_resamp_ntaps;
+        }
+        d_frame = (d_frame + 1) % OVERSAMPLING;
+
+        while(d_mu < 1.0) {
+            double pos = d_mu * RESAMPLER_PHASES;
+            int phase = (int)pos;
+            float frac = pos - phase;
+            const float * taps0 = &d_resamp_taps[phase * d_resamp_ntaps];
+            const float * taps1 = taps0 + d_resamp_ntaps;
+            for(size_t c = 0; c < d_channels.size(); c++) {
+                const gr_complex * h = &d_channels[c].history[d_channels[c].history_pos];
+                gr_complex a, b;
+                volk_32fc_32f_dot_prod_32fc(&a, h, taps0, d_resamp_ntaps);
+                volk_32fc_32f_dot_prod_32fc(&b, h, taps1, d_resamp_ntaps);
+                out[c][produced] = a + frac * (b - a);
+            }
+            produced++;
+            d_mu += d_resamp_ratio;
+        }
+        d_mu -= 1.0;
+    }
+
+    consumed = frame * d_decim;
+    memmove(&d_delay[0], &d_delay[consumed], history * sizeof(gr_complex));
+    return produced;
+}
@@ -0,0 +1,138 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_WIDEBAND_CHANNELIZER_H
+#define INCLUDED_GSM_WIDEBAND_CHANNELIZER_H
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/blocks/rotator.h>
+#include <gnuradio/fft/fft.h>
+#include <vector>
+#include <stdint.h>
+
+/** Polyphase filter bank channelizer of GSM carriers of a wideband signal
+ *
+ * The band is split into bins about 200kHz apart by one polyphase filter
+ * bank and FFT, which is 4 times oversampled so that a carrier between two
+ * bins isn't aliased. Only the bins of the requested carriers are used:
+ * each of them is shifted by the rest of the carrier's offset and then
+ * resampled to GSM rate times OSR by a polyphase interpolator, whose
+ * prototype filter is also the channel filter.
+ *
+ * The clock offset (ppm) is applied once per carrier, in the shift and
+ * the resampling ratio, instead of on the wideband signal. All carriers
+ * share the resampler phase, so they always have the same number of
+ * output samples.
+ */
+class wideband_channelizer
+{
+  private:
+    struct channel
+    {
+        double offset; ///< nominal offset of the carrier from the center frequency
+        double freq; ///< absolute frequency of the carrier
+        int bin; ///< filter bank bin of the carrier
+        std::vector<gr_complex> frame_phase; ///< phase correction of the bin, one per frame modulo OVERSAMPLING
+        gr::blocks::rotator rotator; ///< shifts the rest of the offset
+        std::vector<gr_complex> history; ///< last samples of the bin, written twice
+        int history_pos;
+    };
+
+    static const int OVERSAMPLING = 4; ///< bin rate to bin spacing
+    static const int RESAMPLER_PHASES = 32;
+
+    double d_samp_rate_in;
+    double d_fc;
+    double d_samp_rate_out;
+    double d_ppm;
+    int d_nbins; ///< number of filter bank bins (FFT size)
+    int d_decim; ///< input samples per bin sample
+    double d_bin_rate; ///< sample rate of a bin
+
+    /**@name Filter bank */
+    //@{
+    std::vector<float> d_pfb_taps; ///< time reversed prototype, a multiple of d_nbins long
+    std::vector<gr_complex> d_delay; ///< history of the prototype length and the input of a call
+    std::vector<float> d_acc; ///< interleaved sums of the polyphase branches
+    gr::fft::fft_complex * d_fft;
+    unsigned d_frame; ///< frames since start, modulo OVERSAMPLING
+    //@}
+
+    /**@name Resampler */
+    //@{
+    int d_resamp_ntaps; ///< taps of one phase
+    std::vector<float> d_resamp_taps; ///< RESAMPLER_PHASES + 1 phases, each time reversed
+    double d_resamp_ratio; ///< bin samples per output sample
+    double d_mu; ///< position of the next output between bin samples
+    //@}
+
+    std::vector<channel> d_channels;
+
+    void set_offsets();
+    inline void filter_frame(const gr_complex * x);
+    gr_complex * delay_input(int nframes);
+    int filter_frames(int nframes, gr_complex * const * out, int noutput, int & consumed);
+
+  public:
+    /** Constructor
+     *
+     * @param samp_rate_in input sample rate
+     * @param fc center frequency of the input
+     * @param channel_freqs frequencies of the extracted carriers
+     * @param osr oversampling ratio of the outputs
+     * @param ppm clock offset of the input
+     */
+    wideband_channelizer(double samp_rate_in, double fc, const std::vector<double> & channel_freqs, int osr, double ppm);
+    ~wideband_channelizer();
+
+    /** Changes the clock offset, keeping the state of the filters */
+    void set_ppm(double ppm);
+
+    int nchannels() const { return d_channels.size(); }
+    int nbins() const { return d_nbins; }
+    int decimation() const { return d_decim; }
+    double samp_rate_out() const { return d_samp_rate_out; }
+
+    /** Number of input samples per output sample */
+    double input_per_output() const { return d_decim * d_resamp_ratio; }
+
+    /** Channelizes the input
+     *
+     * Consumes input by multiples of decimation() samples and stops when
+     * another one wouldn't fit in the outputs.
+     * @param in input samples
+     * @param ninput number of input samples
+     * @param out one output vector per carrier
+     * @param noutput space in each output vector
+     * @param consumed set to the number of used input samples
+     * @return number of samples written to every output
+     */
+    int channelize(const gr_complex * in, int ninput, gr_complex * const * out, int noutput, int & consumed);
+
+    /** Channelizes interleaved int16 IQ, full scale being 1.0
+     *
+     * The samples are converted while copied into the filter bank delay
+     * line, so a wideband input takes half the memory bandwidth.
+     */
+    int channelize(const int16_t * in, int ninput, gr_complex * const * out, int noutput, int & consumed);
+};
+
+#endif /* INCLUDED_GSM_WIDEBAND_CHANNELIZER_H */
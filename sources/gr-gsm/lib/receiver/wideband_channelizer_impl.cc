@@ -0,0 +1,48 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "wideband_channelizer_impl.h"
+
+namespace gr {
+  namespace gsm {
+
+    wideband_channelizer_cc::sptr
+    wideband_channelizer_cc::make(double samp_rate_in, double fc, const std::vector<double> &channel_freqs, int osr, double ppm)
+    {
+      return gnuradio::get_initial_sptr
+        (new wideband_channelizer_impl<wideband_channelizer_cc, gr_complex>
+         ("wideband_channelizer_cc", sizeof(gr_complex), samp_rate_in, fc, channel_freqs, osr, ppm));
+    }
+
+    wideband_channelizer_sc16::sptr
+    wideband_channelizer_sc16::make(double samp_rate_in, double fc, const std::vector<double> &channel_freqs, int osr, double ppm)
+    {
+      return gnuradio::get_initial_sptr
+        (new wideband_channelizer_impl<wideband_channelizer_sc16, int16_t>
+         ("wideband_channelizer_sc16", 2 * sizeof(int16_t), samp_rate_in, fc, channel_freqs, osr, ppm));
+    }
+
+  } /* namespace gsm */
+} /* namespace gr */
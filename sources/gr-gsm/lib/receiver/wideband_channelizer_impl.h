@@ -0,0 +1,165 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GSM_WIDEBAND_CHANNELIZER_IMPL_H
+#define INCLUDED_GSM_WIDEBAND_CHANNELIZER_IMPL_H
+
+#include <gnuradio/io_signature.h>
+#include <grgsm/receiver/wideband_channelizer_cc.h>
+#include <grgsm/receiver/wideband_channelizer_sc16.h>
+#include <wideband_channelizer.h>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <math.h>
+
+namespace gr {
+  namespace gsm {
+
+    /*
+     * Implementation of the wideband channelizer blocks, which only
+     * differ in the type of their input: complex float (gr_complex) or
+     * interleaved int16 IQ (int16_t), one overload of
+     * wideband_channelizer::channelize() each
+     */
+    template <class block_type, class input_type>
+    class wideband_channelizer_impl : public block_type
+    {
+     private:
+      double d_samp_rate_in;
+      double d_fc;
+      std::vector<double> d_channel_freqs;
+      int d_osr;
+      double d_ppm;
+      boost::scoped_ptr<wideband_channelizer> d_channelizer;
+      boost::mutex d_mutex; ///< protects d_channelizer from changes during general_work()
+
+      /*
+       * Has to be called with d_mutex held, except from the constructor
+       */
+      void rebuild()
+      {
+        if(d_samp_rate_in <= 0 || d_osr < 1) {
+          throw std::invalid_argument(this->name() + ": invalid sample rate or OSR");
+        }
+        for(size_t c = 0; c < d_channel_freqs.size(); c++) {
+          if(fabs(d_channel_freqs[c] - d_fc) > d_samp_rate_in / 2) {
+            throw std::out_of_range(this->name() + ": carrier outside of the input band");
+          }
+        }
+        d_channelizer.reset(new wideband_channelizer(d_samp_rate_in, d_fc, d_channel_freqs, d_osr, d_ppm));
+        this->set_relative_rate(1.0 / d_channelizer->input_per_output());
+      }
+
+      void set_ppm_msg(pmt::pmt_t msg)
+      {
+        if(pmt::is_real(msg)) {
+          set_ppm(pmt::to_double(msg));
+        }
+      }
+
+     public:
+      /*
+       * sizeof_input is the size of one input sample, two input_type
+       * for int16 IQ
+       */
+      wideband_channelizer_impl(const std::string &name, size_t sizeof_input,
+                                double samp_rate_in, double fc, const std::vector<double> &channel_freqs, int osr, double ppm)
+        : gr::block(name,
+                gr::io_signature::make(1, 1, sizeof_input),
+                gr::io_signature::make(channel_freqs.size(), channel_freqs.size(), sizeof(gr_complex))),
+          d_samp_rate_in(samp_rate_in),
+          d_fc(fc),
+          d_channel_freqs(channel_freqs),
+          d_osr(osr),
+          d_ppm(ppm)
+      {
+        if(channel_freqs.empty()) {
+          throw std::invalid_argument(name + ": no carriers");
+        }
+        rebuild();
+
+        this->message_port_register_in(pmt::mp("ppm_in"));
+        this->set_msg_handler(pmt::mp("ppm_in"), boost::bind(&wideband_channelizer_impl::set_ppm_msg, this, _1));
+      }
+
+      void set_ppm(double ppm)
+      {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_ppm = ppm;
+        d_channelizer->set_ppm(ppm);
+      }
+
+      double ppm() const { return d_ppm; }
+
+      void set_fc(double fc)
+      {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_fc = fc;
+        rebuild();
+      }
+
+      void set_samp_rate_in(double samp_rate_in)
+      {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_samp_rate_in = samp_rate_in;
+        rebuild();
+      }
+
+      void set_osr(int osr)
+      {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_osr = osr;
+        rebuild();
+      }
+
+      void forecast(int noutput_items, gr_vector_int &ninput_items_required)
+      {
+        boost::mutex::scoped_lock lock(d_mutex);
+        int decim = d_channelizer->decimation();
+        int frames = (int)ceil(noutput_items * d_channelizer->input_per_output() / decim) + 1;
+        ninput_items_required[0] = frames * decim;
+      }
+
+      int general_work(int noutput_items,
+                       gr_vector_int &ninput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items)
+      {
+        boost::mutex::scoped_lock lock(d_mutex);
+        const input_type *in = (const input_type *) input_items[0];
+        int consumed;
+
+        int produced = d_channelizer->channelize(in, ninput_items[0],
+                                                 (gr_complex * const *) &output_items[0],
+                                                 noutput_items, consumed);
+        this->consume_each(consumed);
+        return produced;
+      }
+    };
+
+  } // namespace gsm
+} // namespace gr
+
+#endif /* INCLUDED_GSM_WIDEBAND_CHANNELIZER_IMPL_H */
@@ -0,0 +1,129 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# @file
+# @section LICENSE
+#
+# Gr-gsm is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# Gr-gsm is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with gr-gsm; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+#
+
+from gnuradio import gr, gr_unittest
+import grgsm
+import os
+import tempfile
+
+HYPERFRAME = 26 * 51 * 2048
+
+def make_bursts(n):
+    """
+        n different bursts, burst i holds the bits of i
+    """
+    return [format(i, "016b") * 9 + "0000" for i in range(n)]
+
+class qa_burst_container (gr_unittest.TestCase):
+
+    def setUp (self):
+        fd, self.container = tempfile.mkstemp()
+        os.close(fd)
+        fd, self.burst_file = tempfile.mkstemp()
+        os.close(fd)
+
+        # two streams (timeslots 0 and 3) going over the end of a hyperframe
+        self.framenumbers = [HYPERFRAME - 3, HYPERFRAME - 3, HYPERFRAME - 2, HYPERFRAME - 2,
+                             HYPERFRAME - 1, HYPERFRAME - 1, 0, 0, 1, 1, 2, 2]
+        self.timeslots = [0, 3] * 6
+        self.bursts = make_bursts(len(self.framenumbers))
+
+    def tearDown (self):
+        os.remove(self.container)
+        os.remove(self.burst_file)
+
+    def write(self, indexed, framenumbers, timeslots, bursts):
+        tb = gr.top_block()
+        src = grgsm.burst_source(framenumbers, timeslots, bursts)
+        sink = grgsm.burst_file_sink(self.container if indexed else self.burst_file, indexed)
+        tb.msg_connect(src, "out", sink, "in")
+        tb.run()
+        return tb, src
+
+    def read(self, filename, first_frame=0, last_frame=0xffffffff):
+        tb = gr.top_block()
+        src = grgsm.burst_file_source(filename, first_frame, last_frame)
+        sink = grgsm.burst_sink()
+        tb.msg_connect(src, "out", sink, "in")
+        tb.run()
+        return list(sink.get_framenumbers()), list(sink.get_timeslots()), list(sink.get_burst_data())
+
+    def test_001_round_trip (self):
+        """
+            all bursts come back in the order they were written
+        """
+        self.write(True, self.framenumbers, self.timeslots, self.bursts)
+        self.assertEqual(self.read(self.container), (self.framenumbers, self.timeslots, self.bursts))
+
+    def test_002_range_over_wrap (self):
+        """
+            frame numbers of the range are unwrapped: the frame after the
+            last one of the hyperframe is HYPERFRAME
+        """
+        self.write(True, self.framenumbers, self.timeslots, self.bursts)
+        framenumbers, timeslots, bursts = self.read(self.container, HYPERFRAME - 1, HYPERFRAME)
+        self.assertEqual(framenumbers, self.framenumbers[4:8])
+        self.assertEqual(timeslots, self.timeslots[4:8])
+        self.assertEqual(bursts, self.bursts[4:8])
+
+        framenumbers, timeslots, bursts = self.read(self.container, HYPERFRAME + 2, HYPERFRAME + 2)
+        self.assertEqual(bursts, self.bursts[10:12])
+
+    def test_003_serialized_file_range (self):
+        """
+            first_frame and last_frame mean the same for a file of
+            serialized messages
+        """
+        self.write(False, self.framenumbers, self.timeslots, self.bursts)
+        self.write(True, self.framenumbers, self.timeslots, self.bursts)
+        for first, last in [(HYPERFRAME - 1, HYPERFRAME), (HYPERFRAME + 2, HYPERFRAME + 2), (0, 0xffffffff)]:
+            self.assertEqual(self.read(self.burst_file, first, last), self.read(self.container, first, last))
+
+    def test_004_converters (self):
+        """
+            a container converted to serialized messages and back keeps
+            all bursts
+        """
+        self.write(True, self.framenumbers, self.timeslots, self.bursts)
+        self.assertEqual(grgsm.container_to_burst_file(self.container, self.burst_file), len(self.bursts))
+        self.assertEqual(self.read(self.burst_file), (self.framenumbers, self.timeslots, self.bursts))
+
+        os.remove(self.container)
+        self.assertEqual(grgsm.burst_file_to_container(self.burst_file, self.container), len(self.bursts))
+        self.assertEqual(self.read(self.container, HYPERFRAME - 1, HYPERFRAME)[2], self.bursts[4:8])
+
+    def test_005_restart (self):
+        """
+            bursts written after the flowgraph was started again are
+            appended to the container
+        """
+        tb, src = self.write(True, self.framenumbers[:6], self.timeslots[:6], self.bursts[:6])
+        src.set_framenumbers(self.framenumbers[6:])
+        src.set_timeslots(self.timeslots[6:])
+        src.set_burst_data(self.bursts[6:])
+        tb.run()
+
+        self.assertEqual(self.read(self.container), (self.framenumbers, self.timeslots, self.bursts))
+        self.assertEqual(self.read(self.container, HYPERFRAME, HYPERFRAME)[2], self.bursts[6:8])
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_burst_container, "qa_burst_container.xml")
@@ -0,0 +1,111 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# @file
+# @section LICENSE
+# 
+# Gr-gsm is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# Gr-gsm is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with gr-gsm; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+# 
+
+from gnuradio import gr, gr_unittest, blocks
+import grgsm
+import random
+
+class qa_cell_demapper (gr_unittest.TestCase):
+
+    def setUp (self):
+        self.tb = gr.top_block ()
+        random.seed(51)
+        self.framenumbers_input = []
+        self.timeslots_input = []
+        self.bursts_input = []
+        for fn in range(0, 4 * 104):
+            for tn in range(0, 8):
+                self.framenumbers_input.append(fn)
+                self.timeslots_input.append(tn)
+                self.bursts_input.append("".join(random.choice("01") for ii in range(148)))
+
+    def tearDown (self):
+        self.tb = None
+
+    def reference_bursts (self, timeslot, demapper, port):
+        """
+            Returns framenumbers and bursts of a timeslot demapped by one of the older demappers
+        """
+        tb = gr.top_block ()
+        src = grgsm.burst_source(self.framenumbers_input, self.timeslots_input, self.bursts_input)
+        ts_filter = grgsm.burst_timeslot_filter(timeslot)
+        sink = grgsm.burst_sink()
+
+        tb.msg_connect(src, "out", ts_filter, "in")
+        tb.msg_connect(ts_filter, "out", demapper, "bursts")
+        tb.msg_connect(demapper, port, sink, "in")
+        tb.run ()
+
+        return list(zip(sink.get_framenumbers(), sink.get_burst_data()))
+
+    def demapped_bursts (self, sink, timeslot):
+        return [(fn, data) for (fn, tn, data) in zip(sink.get_framenumbers(), sink.get_timeslots(), sink.get_burst_data()) if tn == timeslot]
+
+    def test_001_whole_cell (self):
+        """
+            The same bursts as with a timeslot filter and a demapper for each timeslot
+        """
+        src = grgsm.burst_source(self.framenumbers_input, self.timeslots_input, self.bursts_input)
+        demapper = grgsm.cell_demapper([grgsm.TS_BCCH_CCCH_SDCCH4, grgsm.TS_SDCCH8, grgsm.TS_TCH_F, grgsm.TS_TCH_F, grgsm.TS_BCCH_CCCH])
+        bursts_sink = grgsm.burst_sink()
+        tch_sink = grgsm.burst_sink()
+
+        self.tb.msg_connect(src, "out", demapper, "bursts")
+        self.tb.msg_connect(demapper, "bursts", bursts_sink, "in")
+        self.tb.msg_connect(demapper, "tch_bursts", tch_sink, "in")
+        self.tb.run ()
+
+        self.assertEqual(self.demapped_bursts(bursts_sink, 0), self.reference_bursts(0,
+            grgsm.universal_ctrl_chans_demapper(0, [2,6,12,16,22,26,32,36,42,46], [1,2,2,2,7,7,7,7,135,135]), "bursts"))
+        self.assertEqual(self.demapped_bursts(bursts_sink, 1), self.reference_bursts(1,
+            grgsm.universal_ctrl_chans_demapper(1, [0,4,8,12,16,20,24,28,32,36,40,44], [8,8,8,8,8,8,8,8,136,136,136,136]), "bursts"))
+        self.assertEqual(self.demapped_bursts(bursts_sink, 4), self.reference_bursts(4,
+            grgsm.universal_ctrl_chans_demapper(4, [2,6,12,16,22,26,32,36,42,46], [1,2,2,2,2,2,2,2,2,2]), "bursts"))
+        for tn in [2, 3]:
+            self.assertEqual(self.demapped_bursts(bursts_sink, tn), self.reference_bursts(tn, grgsm.tch_f_chans_demapper(tn), "acch_bursts"))
+            self.assertEqual(self.demapped_bursts(tch_sink, tn), self.reference_bursts(tn, grgsm.tch_f_chans_demapper(tn), "tch_bursts"))
+        for tn in [5, 6, 7]:
+            self.assertEqual(self.demapped_bursts(bursts_sink, tn), [])
+            self.assertEqual(self.demapped_bursts(tch_sink, tn), [])
+
+    def test_002_blocks (self):
+        """
+            Bursts of a block are published together, in order
+        """
+        src = grgsm.burst_source(self.framenumbers_input, self.timeslots_input, self.bursts_input)
+        demapper = grgsm.cell_demapper([grgsm.TS_BCCH_CCCH, grgsm.TS_SDCCH8])
+        sink = grgsm.burst_sink()
+
+        self.tb.msg_connect(src, "out", demapper, "bursts")
+        self.tb.msg_connect(demapper, "bursts", sink, "in")
+        self.tb.run ()
+
+        framenumbers = list(sink.get_framenumbers())
+        timeslots = list(sink.get_timeslots())
+        self.assertEqual(len(framenumbers) % 4, 0)
+        for ii in range(0, len(framenumbers), 4):
+            self.assertEqual(framenumbers[ii:ii+4], range(framenumbers[ii], framenumbers[ii] + 4))
+            self.assertEqual(timeslots[ii:ii+4], [timeslots[ii]] * 4)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_cell_demapper, "qa_cell_demapper.xml")
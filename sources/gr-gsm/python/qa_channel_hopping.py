@@ -0,0 +1,88 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# @file
+# @section LICENSE
+#
+# Gr-gsm is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# Gr-gsm is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with gr-gsm; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+#
+
+from gnuradio import gr, gr_unittest
+import grgsm
+import pmt
+import struct
+import time
+
+FRAMENUMBERS = [0, 1, 2, 25, 26, 50, 51, 1325, 1326, 26 * 51 * 2048 - 1]
+
+def make_burst(fn, arfcn, timeslot):
+    """
+        burst message with a gsmtap header of the given frame number and
+        ARFCN, the timeslot field is used to tell the bursts apart
+    """
+    header = struct.pack(">BBBBHbbIBBBB", 2, 4, 3, timeslot, arfcn, 0, 0, fn, 0, 0, 0, 0)
+    data = [ord(c) for c in header] + [0] * 148
+    return pmt.cons(pmt.PMT_NIL, pmt.init_u8vector(len(data), data))
+
+class qa_channel_hopping (gr_unittest.TestCase):
+
+    def setUp (self):
+        self.tb = gr.top_block()
+
+    def tearDown (self):
+        self.tb = None
+
+    def hop(self, ma, maio, hsn):
+        """
+            sends the bursts of each frame on every ARFCN of the MA and
+            returns the MAI of the ones the hopper forwarded
+        """
+        hopper = grgsm.cx_channel_hopper(ma, maio, hsn)
+        sink = grgsm.burst_sink()
+        self.tb.msg_connect(hopper, "bursts", sink, "in")
+        self.tb.start()
+        for fn in FRAMENUMBERS:
+            for mai, arfcn in enumerate(ma):
+                hopper.to_basic_block()._post(pmt.intern("CX"), make_burst(fn, arfcn, mai))
+        while len(sink.get_framenumbers()) < len(FRAMENUMBERS):
+            time.sleep(0.01)
+        self.tb.stop()
+        self.tb.wait()
+
+        self.assertEqual(list(sink.get_framenumbers()), FRAMENUMBERS)
+        return list(sink.get_timeslots())
+
+    def test_001_cyclic (self):
+        """
+            HSN 0 is cyclic hopping, MAI = (FN + MAIO) mod N
+        """
+        self.assertEqual(self.hop([3, 17, 42, 66], 1, 0), [(fn + 1) % 4 for fn in FRAMENUMBERS])
+
+    def test_002_pseudo_random (self):
+        """
+            MAI of the pseudo random hopping of GSM 05.02 section 6.2.3
+        """
+        self.assertEqual(self.hop([1, 5, 9, 13, 17, 21, 25], 3, 45), [3, 4, 5, 2, 0, 1, 3, 2, 1, 5])
+
+    def test_003_pseudo_random_16 (self):
+        """
+            N a power of two, M' is always below N
+        """
+        ma = range(100, 116)
+        self.assertEqual(self.hop(ma, 0, 63), [11, 1, 7, 10, 8, 5, 4, 6, 8, 2])
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_channel_hopping, "qa_channel_hopping.xml")
@@ -0,0 +1,91 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# @file
+# @section LICENSE
+# 
+# Gr-gsm is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# Gr-gsm is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with gr-gsm; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+# 
+
+from gnuradio import gr, gr_unittest, blocks
+import grgsm
+import binascii
+import socket
+import struct
+import tempfile
+
+class qa_gsmtap_sink (gr_unittest.TestCase):
+
+    def setUp (self):
+        self.tb = gr.top_block()
+        self.receiver = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.receiver.bind(("127.0.0.1", 0))
+        self.receiver.settimeout(1)
+        self.port = self.receiver.getsockname()[1]
+        self.pcap = tempfile.NamedTemporaryFile()
+        self.msgs_input = [
+            "02 04 01 00 00 00 c9 00 00 1d 3c e5 02 00 01 00 15 06 21 00 01 f0 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b",
+            "02 04 01 00 00 00 ca 00 00 1d 3c e9 02 00 02 00 15 06 21 00 01 f0 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b",
+            "02 04 01 00 00 00 cb 00 00 1d 3d 0e 01 00 00 00 59 06 1a 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 ff e5 04 00",
+            "02 04 01 00 00 00 cb 00 00 1d 3d 12 02 00 00 00 15 06 21 00 01 f0 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b 2b"
+        ]
+        self.datagrams_expected = [binascii.unhexlify(m.replace(" ", "")) for m in self.msgs_input]
+
+    def tearDown (self):
+        self.receiver.close()
+        self.pcap.close()
+        self.tb = None
+
+    def test_001_datagrams (self):
+        """
+            Every message is sent as one datagram, unchanged
+        """
+        src = grgsm.message_source(self.msgs_input)
+        sink = grgsm.gsmtap_sink("127.0.0.1", self.port)
+        self.tb.msg_connect(src, "msgs", sink, "in")
+        self.tb.run()
+
+        datagrams = [self.receiver.recv(1024) for m in self.msgs_input]
+        self.assertEqual(datagrams, self.datagrams_expected)
+        self.assertEqual(sink.sent(), len(self.msgs_input))
+        self.assertEqual(sink.send_errors(), 0)
+
+    def test_002_pcap (self):
+        """
+            The pcap file holds the datagrams as IPv4/UDP packets to the destination port
+        """
+        src = grgsm.message_source(self.msgs_input)
+        sink = grgsm.gsmtap_sink("127.0.0.1", self.port, self.pcap.name)
+        self.tb.msg_connect(src, "msgs", sink, "in")
+        self.tb.run()
+        sink = None
+
+        data = open(self.pcap.name, "rb").read()
+        magic, major, minor, zone, sigfigs, snaplen, linktype = struct.unpack("=IHHiIII", data[:24])
+        self.assertEqual((magic, major, minor, linktype), (0xa1b2c3d4, 2, 4, 101))
+
+        offset = 24
+        for expected in self.datagrams_expected:
+            sec, usec, incl_len, orig_len = struct.unpack("=IIII", data[offset:offset + 16])
+            packet = data[offset + 16:offset + 16 + incl_len]
+            self.assertEqual(incl_len, 28 + len(expected))
+            self.assertEqual(struct.unpack(">H", packet[22:24])[0], self.port)
+            self.assertEqual(packet[28:], expected)
+            offset += 16 + incl_len
+        self.assertEqual(offset, len(data))
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_gsmtap_sink, "qa_gsmtap_sink.xml")
@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# @file
+# @section LICENSE
+# 
+# Gr-gsm is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# Gr-gsm is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with gr-gsm; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+# 
+
+from gnuradio import gr, gr_unittest, blocks
+import grgsm
+import cmath
+import math
+
+class qa_wideband_channelizer_cc (gr_unittest.TestCase):
+
+    def setUp (self):
+        self.tb = gr.top_block()
+        self.samp_rate_in = 2e6
+        self.fc = 935e6
+        self.osr = 4
+        self.samp_rate_out = 1625000.0/6.0*self.osr
+
+    def tearDown (self):
+        self.tb = None
+
+    def channelize (self, tones, channel_freqs, ppm=0, nsamples=200000):
+        """
+        Runs tones (absolute frequency, amplitude) as seen with a clock
+        off by ppm through the channelizer
+        """
+        error = ppm * 1e-6
+        data = [0j] * nsamples
+        for freq, amplitude in tones:
+            w = 2 * math.pi * (freq / (1 + error) - self.fc) / self.samp_rate_in
+            for n in range(nsamples):
+                data[n] += amplitude * cmath.exp(1j * w * n)
+
+        src = blocks.vector_source_c(data)
+        channelizer = grgsm.wideband_channelizer_cc(self.samp_rate_in, self.fc, channel_freqs, self.osr, ppm)
+        sinks = [blocks.vector_sink_c() for f in channel_freqs]
+        self.tb.connect(src, channelizer)
+        for port, sink in enumerate(sinks):
+            self.tb.connect((channelizer, port), sink)
+        self.tb.run()
+        return [sink.data() for sink in sinks]
+
+    def tone (self, samples):
+        """
+        Mean amplitude and frequency of the second half of samples
+        """
+        samples = samples[len(samples)//2:]
+        amplitude = sum(abs(s) for s in samples) / len(samples)
+        phase = sum(cmath.phase(samples[n+1] * samples[n].conjugate()) for n in range(len(samples)-1))
+        return amplitude, phase / (len(samples)-1) / (2 * math.pi) * self.samp_rate_out
+
+    def test_001_carriers (self):
+        """
+            A tone 20kHz above one carrier, a tone on another carrier and
+            nothing on the third one
+        """
+        channel_freqs = [self.fc + 400e3, self.fc - 600e3, self.fc + 800e3]
+        tones = [(self.fc + 420e3, 1.0), (self.fc - 600e3, 0.5)]
+        outputs = self.channelize(tones, channel_freqs)
+
+        expected_len = 200000 * self.samp_rate_out / self.samp_rate_in
+        for output in outputs:
+            self.assertEqual(len(output), len(outputs[0]))
+            self.assertTrue(abs(len(output) - expected_len) < 0.01 * expected_len)
+
+        amplitude, freq = self.tone(outputs[0])
+        self.assertAlmostEqual(amplitude, 1.0, delta=0.02)
+        self.assertAlmostEqual(freq, 20e3, delta=10)
+        amplitude, freq = self.tone(outputs[1])
+        self.assertAlmostEqual(amplitude, 0.5, delta=0.01)
+        self.assertAlmostEqual(freq, 0, delta=10)
+        amplitude, freq = self.tone(outputs[2])
+        self.assertTrue(amplitude < 0.01)
+
+    def test_002_ppm (self):
+        """
+            The clock offset is corrected on all carriers
+        """
+        channel_freqs = [self.fc + 400e3, self.fc - 600e3]
+        tones = [(self.fc + 400e3, 1.0), (self.fc - 600e3, 1.0)]
+        outputs = self.channelize(tones, channel_freqs, ppm=25)
+
+        for output in outputs:
+            amplitude, freq = self.tone(output)
+            self.assertAlmostEqual(amplitude, 1.0, delta=0.02)
+            self.assertAlmostEqual(freq, 0, delta=10)
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_wideband_channelizer_cc, "qa_wideband_channelizer_cc.xml")
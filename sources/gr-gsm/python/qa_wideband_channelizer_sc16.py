@@ -0,0 +1,75 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# @file
+# @section LICENSE
+# 
+# Gr-gsm is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+# 
+# Gr-gsm is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with gr-gsm; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+# 
+
+from gnuradio import gr, gr_unittest, blocks
+import grgsm
+import cmath
+import math
+
+class qa_wideband_channelizer_sc16 (gr_unittest.TestCase):
+
+    def setUp (self):
+        self.tb = gr.top_block()
+        self.samp_rate_in = 2e6
+        self.fc = 935e6
+        self.osr = 4
+
+    def tearDown (self):
+        self.tb = None
+
+    def test_001_same_as_cc (self):
+        """
+            Interleaved int16 IQ at full scale gives the outputs of the
+            complex float channelizer, up to the quantization
+        """
+        channel_freqs = [self.fc + 400e3, self.fc - 600e3]
+        nsamples = 100000
+        data = [0j] * nsamples
+        for freq, amplitude in [(self.fc + 420e3, 0.6), (self.fc - 600e3, 0.3)]:
+            w = 2 * math.pi * (freq - self.fc) / self.samp_rate_in
+            for n in range(nsamples):
+                data[n] += amplitude * cmath.exp(1j * w * n)
+        data_sc16 = []
+        for s in data:
+            data_sc16 += [int(round(s.real * 32767)), int(round(s.imag * 32767))]
+
+        src_cc = blocks.vector_source_c(data)
+        src_sc16 = blocks.vector_source_s(data_sc16, False, 2)
+        channelizer_cc = grgsm.wideband_channelizer_cc(self.samp_rate_in, self.fc, channel_freqs, self.osr, 0)
+        channelizer_sc16 = grgsm.wideband_channelizer_sc16(self.samp_rate_in, self.fc, channel_freqs, self.osr, 0)
+        sinks_cc = [blocks.vector_sink_c() for f in channel_freqs]
+        sinks_sc16 = [blocks.vector_sink_c() for f in channel_freqs]
+        self.tb.connect(src_cc, channelizer_cc)
+        self.tb.connect(src_sc16, channelizer_sc16)
+        for port in range(len(channel_freqs)):
+            self.tb.connect((channelizer_cc, port), sinks_cc[port])
+            self.tb.connect((channelizer_sc16, port), sinks_sc16[port])
+        self.tb.run()
+
+        for port in range(len(channel_freqs)):
+            expected = sinks_cc[port].data()
+            output = sinks_sc16[port].data()
+            self.assertEqual(len(output), len(expected))
+            self.assertTrue(len(output) > 0)
+            self.assertComplexTuplesAlmostEqual2(expected, output, abs_eps=1e-3)
+
+if __name__ == '__main__':
+    gr_unittest.run(qa_wideband_channelizer_sc16, "qa_wideband_channelizer_sc16.xml")
@@ -13,9 +13,20 @@ from gnuradio.filter import firdes
 from distutils.version import LooseVersion as version
 import grgsm
 
+def decimation_filter(samp_rate_in, samp_rate_out):
+    """Decimation and low pass filter in front of the resampler. The
+    decimated rate stays above 4 times the carrier's half band, where
+    the MMSE interpolator works, and the filter keeps what would alias
+    into the carrier (+-135kHz) out."""
+    decim = int(samp_rate_in / max(samp_rate_out, 4 * 135e3))
+    if decim < 2:
+        return 1, []
+    stop = samp_rate_in / decim - 135e3
+    return decim, firdes.low_pass(1, samp_rate_in, (135e3 + stop) / 2, stop - 135e3, firdes.WIN_HAMMING, 6.76)
+
 class gsm_input(grgsm.hier_block):
 
-    def __init__(self, ppm=0, osr=4, fc=940e6, samp_rate_in=1e6):
+    def __init__(self, ppm=0, osr=4, fc=940e6, samp_rate_in=1e6, decimate=False):
         grgsm.hier_block.__init__(
             self, "GSM input adaptor",
             gr.io_signature(1, 1, gr.sizeof_gr_complex*1),
@@ -29,6 +40,7 @@ class gsm_input(grgsm.hier_block):
         self.osr = osr
         self.fc = fc
         self.samp_rate_in = samp_rate_in
+        self.decimate = decimate
 
         ##################################################
         # Variables
@@ -48,6 +60,7 @@ class gsm_input(grgsm.hier_block):
             samp_rate_in=samp_rate_in,
         )
         self.fractional_resampler_xx_0 = filter.fractional_resampler_cc(0, samp_rate_in/samp_rate_out)
+        self.set_decimation()
 
         ##################################################
         # Connections
@@ -63,6 +76,16 @@ class gsm_input(grgsm.hier_block):
         self.msg_connect(self, "ppm_in", self.gsm_clock_offset_corrector_0, "ppm_in")
 
 
+    def set_decimation(self):
+        # decimating in the resampler is asked for with decimate=True,
+        # older GNU Radio can't do it
+        if hasattr(self.fractional_resampler_xx_0, "set_decimation"):
+            if self.decimate:
+                decim, taps = decimation_filter(self.samp_rate_in, self.samp_rate_out)
+            else:
+                decim, taps = 1, []
+            self.fractional_resampler_xx_0.set_decimation(decim, taps)
+
     def get_ppm(self):
         return self.ppm
 
@@ -90,8 +113,16 @@ class gsm_input(grgsm.hier_block):
     def set_samp_rate_in(self, samp_rate_in):
         self.samp_rate_in = samp_rate_in
         self.fractional_resampler_xx_0.set_resamp_ratio(self.samp_rate_in/self.samp_rate_out)
+        self.set_decimation()
         self.gsm_clock_offset_corrector_0.set_samp_rate_in(self.samp_rate_in)
 
+    def get_decimate(self):
+        return self.decimate
+
+    def set_decimate(self, decimate):
+        self.decimate = decimate
+        self.set_decimation()
+
     def get_samp_rate_out(self):
         return self.samp_rate_out
 
@@ -99,4 +130,5 @@ class gsm_input(grgsm.hier_block):
         self.samp_rate_out = samp_rate_out
         self.low_pass_filter_0_0.set_taps(firdes.low_pass(1, self.samp_rate_out, 125e3, 5e3, firdes.WIN_HAMMING, 6.76))
         self.fractional_resampler_xx_0.set_resamp_ratio(self.samp_rate_in/self.samp_rate_out)
+        self.set_decimation()
 
@@ -11,11 +11,14 @@
 #include "grgsm/receiver/receiver.h"
 #include "grgsm/receiver/clock_offset_control.h"
 #include "grgsm/receiver/cx_channel_hopper.h"
+#include "grgsm/receiver/wideband_channelizer_cc.h"
+#include "grgsm/receiver/wideband_channelizer_sc16.h"
 #include "grgsm/decoding/control_channels_decoder.h"
 #include "grgsm/decoding/tch_f_decoder.h"
 #include "grgsm/decryption/decryption.h"
 #include "grgsm/demapping/universal_ctrl_chans_demapper.h"
 #include "grgsm/demapping/tch_f_chans_demapper.h"
+#include "grgsm/demapping/cell_demapper.h"
 #include "grgsm/flow_control/burst_timeslot_splitter.h"
 #include "grgsm/flow_control/burst_sdcch_subslot_splitter.h"
 #include "grgsm/flow_control/burst_timeslot_filter.h"
@@ -31,12 +34,14 @@
 #include "grgsm/misc_utils/tmsi_dumper.h"
 #include "grgsm/misc_utils/burst_file_sink.h"
 #include "grgsm/misc_utils/burst_file_source.h"
+#include "grgsm/misc_utils/burst_container.h"
 #include "grgsm/qa_utils/burst_sink.h"
 #include "grgsm/qa_utils/burst_source.h"
 #include "grgsm/qa_utils/message_source.h"
 #include "grgsm/qa_utils/message_sink.h"
 #include "grgsm/misc_utils/message_file_sink.h"
 #include "grgsm/misc_utils/message_file_source.h"
+#include "grgsm/misc_utils/gsmtap_sink.h"
 %}
 
 %include "grgsm/receiver/receiver.h"
@@ -45,6 +50,10 @@ GR_SWIG_BLOCK_MAGIC2(gsm, receiver);
 GR_SWIG_BLOCK_MAGIC2(gsm, clock_offset_control);
 %include "grgsm/receiver/cx_channel_hopper.h"
 GR_SWIG_BLOCK_MAGIC2(gsm, cx_channel_hopper);
+%include "grgsm/receiver/wideband_channelizer_cc.h"
+GR_SWIG_BLOCK_MAGIC2(gsm, wideband_channelizer_cc);
+%include "grgsm/receiver/wideband_channelizer_sc16.h"
+GR_SWIG_BLOCK_MAGIC2(gsm, wideband_channelizer_sc16);
 
 %include "grgsm/decoding/control_channels_decoder.h"
 GR_SWIG_BLOCK_MAGIC2(gsm, control_channels_decoder);
@@ -58,6 +67,8 @@ GR_SWIG_BLOCK_MAGIC2(gsm, decryption);
 GR_SWIG_BLOCK_MAGIC2(gsm, universal_ctrl_chans_demapper);
 %include "grgsm/demapping/tch_f_chans_demapper.h"
 GR_SWIG_BLOCK_MAGIC2(gsm, tch_f_chans_demapper);
+%include "grgsm/demapping/cell_demapper.h"
+GR_SWIG_BLOCK_MAGIC2(gsm, cell_demapper);
 
 %include "grgsm/flow_control/burst_timeslot_splitter.h"
 GR_SWIG_BLOCK_MAGIC2(gsm, burst_timeslot_splitter);
@@ -78,6 +89,13 @@ GR_SWIG_BLOCK_MAGIC2(gsm, bursts_printer);
 GR_SWIG_BLOCK_MAGIC2(gsm, burst_file_sink);
 %include "grgsm/misc_utils/burst_file_source.h"
 GR_SWIG_BLOCK_MAGIC2(gsm, burst_file_source);
+//only the converters of burst containers - the reader and the writer are for C++
+namespace gr {
+  namespace gsm {
+    uint64_t burst_file_to_container(const std::string & burst_filename, const std::string & container_filename);
+    uint64_t container_to_burst_file(const std::string & container_filename, const std::string & burst_filename);
+  }
+}
 %include "grgsm/misc_utils/extract_system_info.h"
 GR_SWIG_BLOCK_MAGIC2(gsm, extract_system_info);
 %include "grgsm/misc_utils/extract_immediate_assignment.h"
@@ -94,6 +112,8 @@ GR_SWIG_BLOCK_MAGIC2(gsm, tmsi_dumper);
 GR_SWIG_BLOCK_MAGIC2(gsm, message_file_sink);
 %include "grgsm/misc_utils/message_file_source.h"
 GR_SWIG_BLOCK_MAGIC2(gsm, message_file_source);
+%include "grgsm/misc_utils/gsmtap_sink.h"
+GR_SWIG_BLOCK_MAGIC2(gsm, gsmtap_sink);
 
 %include "grgsm/qa_utils/burst_sink.h"
 GR_SWIG_BLOCK_MAGIC2(gsm, burst_sink);
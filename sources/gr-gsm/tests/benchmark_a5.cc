@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Measures keystreams per second of A5/1 and A5/2: osmo_a5() of
+ * libosmocore called for every frame and the bitsliced implementation
+ * which generates A5_BITSLICED_FRAMES consecutive frames at once. Both
+ * directions are generated and compared.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <a5_bitsliced.h>
+
+extern "C" {
+    #include <osmocom/gsm/a5.h>
+}
+
+#include "benchmark_utils.h"
+
+#define BATCHES_NUM 2000
+#define FRAMES_NUM  (BATCHES_NUM * A5_BITSLICED_FRAMES)
+#define FIRST_FN    1000000
+
+int
+main()
+{
+  static uint8_t reference[FRAMES_NUM][2][A5_KEYSTREAM_BITS];
+  static uint8_t dl[FRAMES_NUM][A5_KEYSTREAM_BITS];
+  static uint8_t ul[FRAMES_NUM][A5_KEYSTREAM_BITS];
+  uint8_t key[8] = {0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0};
+  int result = 0;
+
+  for(int version = 1; version <= 2; version++) {
+    char name[32];
+
+    double start = cpu_time();
+    for(int f = 0; f < FRAMES_NUM; f++) {
+      osmo_a5(version, key, FIRST_FN + f, reference[f][0], reference[f][1]);
+    }
+    double total = cpu_time() - start;
+
+    snprintf(name, sizeof(name), "osmo_a5 A5/%d", version);
+    printf("%18s:  cpu: %6.3f  keystreams/sec: %10.3e\n", name, total, FRAMES_NUM / total);
+
+    start = cpu_time();
+    for(int b = 0; b < BATCHES_NUM; b++) {
+      uint32_t fn[A5_BITSLICED_FRAMES];
+      int first = b * A5_BITSLICED_FRAMES;
+
+      for(int f = 0; f < A5_BITSLICED_FRAMES; f++) {
+        fn[f] = FIRST_FN + first + f;
+      }
+      if(version == 1) {
+        a5_1_bitsliced(key, fn, A5_BITSLICED_FRAMES, &dl[first], &ul[first]);
+      } else {
+        a5_2_bitsliced(key, fn, A5_BITSLICED_FRAMES, &dl[first], &ul[first]);
+      }
+    }
+    total = cpu_time() - start;
+
+    bool identical = true;
+    for(int f = 0; f < FRAMES_NUM; f++) {
+      if(memcmp(dl[f], reference[f][0], A5_KEYSTREAM_BITS) != 0 ||
+         memcmp(ul[f], reference[f][1], A5_KEYSTREAM_BITS) != 0) {
+        identical = false;
+        result = 1;
+      }
+    }
+
+    snprintf(name, sizeof(name), "bitsliced A5/%d", version);
+    printf("%18s:  cpu: %6.3f  keystreams/sec: %10.3e  %s\n", name, total, FRAMES_NUM / total,
+           identical ? "identical" : "MISMATCH");
+  }
+
+  return result;
+}
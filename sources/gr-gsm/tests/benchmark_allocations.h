@@ -0,0 +1,54 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Counts heap allocations of the whole process, the libraries and all
+ * threads included, by replacing operator new. To be included by the
+ * single source file of a benchmark.
+ */
+
+#ifndef INCLUDED_GSM_BENCHMARK_ALLOCATIONS_H
+#define INCLUDED_GSM_BENCHMARK_ALLOCATIONS_H
+
+#include <stdlib.h>
+#include <new>
+#include <boost/atomic.hpp>
+
+static boost::atomic<unsigned long> allocations(0);
+
+void *
+operator new(size_t size)
+{
+  allocations.fetch_add(1, boost::memory_order_relaxed);
+  void *p = malloc(size);
+  if(p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void
+operator delete(void *p) throw()
+{
+  free(p);
+}
+
+#endif /* INCLUDED_GSM_BENCHMARK_ALLOCATIONS_H */
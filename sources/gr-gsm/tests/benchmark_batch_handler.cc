@@ -0,0 +1,198 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Blocks per second of control_channels_decoder when its batch message
+ * handler gets one burst per call, as when bursts arrive one by one,
+ * and when it gets the bursts of many blocks per call, as when bursts
+ * of several timeslots or ARFCNs are queued on its input. Random blocks
+ * are coded with the SACCH code and some of the coded bits are flipped,
+ * so that a part of the blocks needs the Fire code correction or fails.
+ * The decoded messages of each run are checked against those of the
+ * run with one burst per call.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+#include <algorithm>
+#include <gnuradio/io_signature.h>
+#include <grgsm/burst.h>
+#include <grgsm/decoding/control_channels_decoder.h>
+#include <cch.h>
+#include "benchmark_blocks.h"
+#include "benchmark_utils.h"
+
+#define BLOCKS_NUM  1024
+#define ITERATIONS  10
+
+using namespace gr::gsm;
+
+/*
+ * Keeps the messages it is sent in its queue, which is drained after
+ * each run
+ */
+class decoded_sink : public gr::block
+{
+  public:
+    decoded_sink()
+      : gr::block("decoded_sink",
+                  gr::io_signature::make(0, 0, 0),
+                  gr::io_signature::make(0, 0, 0))
+    {
+        message_port_register_in(pmt::mp("in"));
+    }
+
+    std::vector<pmt::pmt_t> take()
+    {
+        std::vector<pmt::pmt_t> msgs;
+        pmt::pmt_t msg;
+        while((msg = delete_head_nowait(pmt::mp("in")))) {
+            msgs.push_back(msg);
+        }
+        return msgs;
+    }
+};
+
+/*
+ * Codes random data with the Fire code and the SACCH convolutional
+ * code, flips every coded bit with probability between 0 and 1/16,
+ * depending on the block, and maps the block on 4 bursts.
+ */
+static void
+make_block(int block, std::vector<pmt::pmt_t> & msgs)
+{
+  static const int poly_taps[] = {0, 14, 17, 23, 37, 40};
+  unsigned char u[CONV_INPUT_SIZE + 4] = {0};
+  unsigned char * d = u + 4;
+  unsigned char rem[DATA_BLOCK_SIZE + PARITY_SIZE] = {0};
+  unsigned char coded[CONV_SIZE];
+
+  for(int i = 0; i < DATA_BLOCK_SIZE; i++) {
+    d[i] = rem[i] = rand() & 1;
+  }
+  for(int i = 0; i < DATA_BLOCK_SIZE; i++) {
+    if(rem[i]) {
+      for(unsigned int t = 0; t < sizeof(poly_taps) / sizeof(poly_taps[0]); t++) {
+        rem[i + poly_taps[t]] ^= 1;
+      }
+    }
+  }
+  for(int i = 0; i < PARITY_SIZE; i++) {
+    d[DATA_BLOCK_SIZE + i] = !rem[DATA_BLOCK_SIZE + i];
+  }
+
+  for(int k = 0; k < CONV_INPUT_SIZE; k++) {
+    const unsigned char * uk = d + k;
+    coded[2 * k] = uk[0] ^ uk[-3] ^ uk[-4];
+    coded[2 * k + 1] = uk[0] ^ uk[-1] ^ uk[-3] ^ uk[-4];
+  }
+
+  int flip_limit = (block % 32) * RAND_MAX / 512;
+  for(int k = 0; k < CONV_SIZE; k++) {
+    if(rand() < flip_limit) {
+      coded[k] ^= 1;
+    }
+  }
+
+  //interleave as the decoder deinterleaves
+  unsigned char iBLOCK[BLOCKS * iBLOCK_SIZE];
+  for(int k = 0; k < CONV_SIZE; k++) {
+    int B = k % 4;
+    int j = 2 * ((49 * k) % 57) + ((k % 8) / 4);
+    iBLOCK[B * 114 + j] = coded[k];
+  }
+  for(int ii = 0; ii < 4; ii++) {
+    gsmtap_hdr header;
+    int8_t bits[burst::SIZE];
+    memset(&header, 0, sizeof(gsmtap_hdr));
+    header.version = GSMTAP_VERSION;
+    header.hdr_len = sizeof(gsmtap_hdr) / 4;
+    header.type = GSMTAP_TYPE_UM_BURST;
+    memset(bits, 0, burst::SIZE);
+    for(int jj = 0; jj < 57; jj++) {
+      bits[jj + 3] = iBLOCK[ii * iBLOCK_SIZE + jj];
+      bits[jj + 88] = iBLOCK[ii * iBLOCK_SIZE + jj + 57];
+    }
+    msgs.push_back(burst::make(header, bits));
+  }
+}
+
+int
+main()
+{
+  static const unsigned int blocks_per_call[] = {0, 1, 8, 32, 128};
+  std::vector<pmt::pmt_t> msgs;
+  pmt::pmt_t port = pmt::mp("bursts");
+  double reference = 0;
+  std::vector<pmt::pmt_t> reference_msgs;
+  bool all_same = true;
+
+  srand(0);
+  for(int b = 0; b < BLOCKS_NUM; b++) {
+    make_block(b, msgs);
+  }
+
+  for(unsigned int n = 0; n < sizeof(blocks_per_call) / sizeof(blocks_per_call[0]); n++) {
+    control_channels_decoder::sptr decoder = control_channels_decoder::make();
+    boost::shared_ptr<decoded_sink> sink = gnuradio::get_initial_sptr(new decoded_sink());
+    decoder->message_port_sub(pmt::mp("msgs"), pmt::cons(sink->alias_pmt(), pmt::mp("in")));
+    size_t chunk = blocks_per_call[n] ? 4 * blocks_per_call[n] : 1;
+
+    double start = cpu_time();
+    for(int i = 0; i < ITERATIONS; i++) {
+      for(size_t m = 0; m < msgs.size(); m += chunk) {
+        std::vector<pmt::pmt_t> batch(msgs.begin() + m, msgs.begin() + std::min(m + chunk, msgs.size()));
+        msg_dispatcher::dispatch(decoder, port, batch);
+      }
+    }
+    double total = cpu_time() - start;
+    double rate = (double)ITERATIONS * BLOCKS_NUM / total;
+    std::vector<pmt::pmt_t> decoded = sink->take();
+    bool same = true;
+    if(n == 0) {
+      reference = rate;
+      reference_msgs = decoded;
+    } else {
+      same = decoded.size() == reference_msgs.size();
+      for(size_t m = 0; same && m < decoded.size(); m++) {
+        same = pmt::equal(decoded[m], reference_msgs[m]);
+      }
+      all_same = all_same && same;
+    }
+
+    char name[32];
+    if(blocks_per_call[n]) {
+      snprintf(name, sizeof(name), "%u blocks per call", blocks_per_call[n]);
+    } else {
+      snprintf(name, sizeof(name), "1 burst per call");
+    }
+    printf("%20s:  cpu: %6.3f  blocks/sec: %10.3e  speedup: %5.2f  decoded: %lu%s\n", name, total, rate,
+           rate / reference, (unsigned long)decoded.size(), same ? "" : "  MISMATCH");
+  }
+  return all_same ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Source and sink blocks of the benchmarks running the receiver, and
+ * the dispatch of messages of the benchmarks feeding blocks directly
+ */
+
+#ifndef INCLUDED_GSM_BENCHMARK_BLOCKS_H
+#define INCLUDED_GSM_BENCHMARK_BLOCKS_H
+
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <gnuradio/sync_block.h>
+#include <gnuradio/io_signature.h>
+
+/*
+ * Plays samples of the capture once. With an offset the playback starts
+ * that many samples into the capture and wraps around to its beginning,
+ * so the number of samples played stays the same.
+ */
+class capture_source : public gr::sync_block
+{
+  const std::vector<gr_complex> & d_samples;
+  size_t d_pos;
+  size_t d_offset;
+
+public:
+  capture_source(const std::vector<gr_complex> & samples, size_t offset = 0)
+    : gr::sync_block("capture_source",
+                     gr::io_signature::make(0, 0, 0),
+                     gr::io_signature::make(1, 1, sizeof(gr_complex))),
+      d_samples(samples), d_pos(0),
+      d_offset(samples.empty() ? 0 : offset % samples.size())
+  {
+  }
+
+  int work(int noutput_items, gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+  {
+    gr_complex *out = (gr_complex *) output_items[0];
+    int n = std::min((size_t)noutput_items, d_samples.size() - d_pos);
+    if(n == 0) {
+      return WORK_DONE;
+    }
+    size_t start = (d_pos + d_offset) % d_samples.size();
+    size_t first = std::min((size_t)n, d_samples.size() - start);
+    memcpy(out, &d_samples[start], first * sizeof(gr_complex));
+    memcpy(out + first, &d_samples[0], (n - first) * sizeof(gr_complex));
+    d_pos += n;
+    return n;
+  }
+};
+
+/*
+ * Hands a batch of messages to the handlers of a block the way the
+ * scheduler does, so that blocks made by their public make() can be fed
+ * without a flowgraph. dispatch_msgs() is protected, so it's reached
+ * through a class derived from basic_block.
+ */
+class msg_dispatcher : public gr::basic_block
+{
+public:
+  static void dispatch(gr::basic_block_sptr block, pmt::pmt_t which_port, const std::vector<pmt::pmt_t> &msgs)
+  {
+    void (gr::basic_block::*dispatch_msgs)(pmt::pmt_t, const std::vector<pmt::pmt_t> &) = &msg_dispatcher::dispatch_msgs;
+    ((*block).*dispatch_msgs)(which_port, msgs);
+  }
+};
+
+/*
+ * Counts the bursts it is sent.
+ */
+class burst_counter_sink : public gr::block
+{
+  unsigned long d_bursts;
+
+  void count(pmt::pmt_t msg)
+  {
+    d_bursts++;
+  }
+
+public:
+  burst_counter_sink()
+    : gr::block("burst_counter_sink",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0)),
+      d_bursts(0)
+  {
+    message_port_register_in(pmt::mp("in"));
+    set_msg_handler(pmt::mp("in"), boost::bind(&burst_counter_sink::count, this, _1));
+  }
+
+  unsigned long bursts() const
+  {
+    return d_bursts;
+  }
+};
+
+#endif /* INCLUDED_GSM_BENCHMARK_BLOCKS_H */
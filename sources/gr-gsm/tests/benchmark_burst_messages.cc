@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Compares burst messages made with pmt::make_blob with the ones of
+ * gr::gsm::burst, whose pairs and blobs come from the PMT pools.
+ *
+ * Every burst goes the way of a burst of a control channel: it's
+ * published by the receiver, checked by a timeslot filter, copied with a
+ * new header by a demapper and read by a decoder. Heap allocations are
+ * counted by replacing operator new.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <grgsm/burst.h>
+#include <grgsm/gsmtap.h>
+#include "benchmark_utils.h"
+#include "benchmark_allocations.h"
+
+#define BURST_SIZE 148
+#define BURSTS     1000000
+
+static void
+fill_header(gsmtap_hdr * header, int ii)
+{
+  memset(header, 0, sizeof(gsmtap_hdr));
+  header->version = GSMTAP_VERSION;
+  header->hdr_len = sizeof(gsmtap_hdr)/4;
+  header->type = GSMTAP_TYPE_UM_BURST;
+  header->timeslot = ii % 8;
+  header->frame_number = ii / 8;
+}
+
+/*
+ * Path of a burst made with pmt::cons and pmt::make_blob, as it was
+ * done before.
+ */
+static int
+blob_path(const unsigned char * burst_binary, int ii)
+{
+  //receiver
+  int8_t header_plus_burst[sizeof(gsmtap_hdr)+BURST_SIZE];
+  fill_header((gsmtap_hdr *)header_plus_burst, ii);
+  memcpy(header_plus_burst+sizeof(gsmtap_hdr), burst_binary, BURST_SIZE);
+  pmt::pmt_t msg = pmt::cons(pmt::PMT_NIL, pmt::make_blob(header_plus_burst, sizeof(header_plus_burst)));
+
+  //timeslot filter
+  gsmtap_hdr * header = (gsmtap_hdr *)pmt::blob_data(pmt::cdr(msg));
+  if(header->timeslot == 7) {
+    return 0;
+  }
+
+  //demapper
+  int8_t new_msg[sizeof(gsmtap_hdr)+BURST_SIZE];
+  memcpy(new_msg, header, sizeof(gsmtap_hdr)+BURST_SIZE);
+  ((gsmtap_hdr *)new_msg)->sub_type = GSMTAP_CHANNEL_SDCCH8;
+  pmt::pmt_t msg_out = pmt::cons(pmt::PMT_NIL, pmt::make_blob(new_msg, sizeof(new_msg)));
+
+  //decoder
+  const int8_t * burst_bits = (const int8_t *)pmt::blob_data(pmt::cdr(msg_out)) + sizeof(gsmtap_hdr);
+  return burst_bits[3] + burst_bits[88];
+}
+
+/*
+ * Path of a burst made with gr::gsm::burst.
+ */
+static int
+burst_path(const unsigned char * burst_binary, int ii)
+{
+  //receiver
+  gsmtap_hdr header;
+  fill_header(&header, ii);
+  pmt::pmt_t msg = gr::gsm::burst::make(header, (const int8_t *)burst_binary);
+
+  //timeslot filter
+  gr::gsm::burst in(msg);
+  if(in.header().timeslot == 7) {
+    return 0;
+  }
+
+  //demapper
+  gsmtap_hdr new_header = in.header();
+  new_header.sub_type = GSMTAP_CHANNEL_SDCCH8;
+  pmt::pmt_t msg_out = gr::gsm::burst::make(new_header, in.bits());
+
+  //decoder
+  gr::gsm::burst out(msg_out);
+  return out.bits()[3] + out.bits()[88];
+}
+
+int
+main()
+{
+  unsigned char burst_binary[BURST_SIZE];
+  for(int ii = 0; ii < BURST_SIZE; ii++) {
+    burst_binary[ii] = rand() & 1;
+  }
+
+  for(int pass = 0; pass < 2; pass++) {
+    long sum = 0;
+    unsigned long start_allocations = allocations;
+    double start = cpu_time();
+    for(int ii = 0; ii < BURSTS; ii++) {
+      sum += pass == 0 ? blob_path(burst_binary, ii) : burst_path(burst_binary, ii);
+    }
+    double total = cpu_time() - start;
+    unsigned long n = allocations - start_allocations;
+
+    printf("%18s:  cpu: %6.3f  bursts/sec: %10.3e  allocations/burst: %5.2f  (%ld)\n",
+           pass == 0 ? "make_blob" : "burst::make", total, BURSTS / total, (double)n / BURSTS, sum);
+  }
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Compares replay of burst files: the file of serialized messages read
+ * the way burst_file_source does it, and the burst container read
+ * through its memory map - all of it, and a range of frame numbers found
+ * with the index. Bursts of 4 ARFCNs with 8 timeslots each are written to
+ * two files in the directory given as the argument (/tmp by default).
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <string>
+
+#include <grgsm/burst.h>
+#include <grgsm/endian.h>
+#include <grgsm/misc_utils/burst_container.h>
+#include "benchmark_utils.h"
+
+#define PMT_SIZE    174
+#define FRAMES_NUM  20000
+#define ARFCNS_NUM  4
+#define RANGE       1000            // frames replayed from the middle of the capture
+
+using namespace gr::gsm;
+
+static void
+write_burst_file(const std::string & filename)
+{
+  std::ofstream output(filename.c_str(), std::ofstream::binary);
+  uint8_t header_plus_burst[sizeof(gsmtap_hdr) + burst::SIZE];
+  gsmtap_hdr * header = (gsmtap_hdr *)header_plus_burst;
+
+  memset(header_plus_burst, 0, sizeof(header_plus_burst));
+  header->version = GSMTAP_VERSION;
+  header->hdr_len = sizeof(gsmtap_hdr) / 4;
+  header->type = GSMTAP_TYPE_UM_BURST;
+  for(int fn = 0; fn < FRAMES_NUM; fn++) {
+    for(int arfcn = 0; arfcn < ARFCNS_NUM; arfcn++) {
+      for(int tn = 0; tn < 8; tn++) {
+        header->frame_number = htobe32(fn);
+        header->arfcn = htobe16(arfcn * 10);
+        header->timeslot = tn;
+        for(unsigned int ii = 0; ii < burst::SIZE; ii++) {
+          header_plus_burst[sizeof(gsmtap_hdr) + ii] = rand() & 1;
+        }
+        std::string s = pmt::serialize_str(pmt::cons(pmt::PMT_NIL, pmt::make_blob(header_plus_burst, sizeof(header_plus_burst))));
+        output.write(s.data(), s.length());
+      }
+    }
+  }
+}
+
+static void
+print_result(const char * name, double total, long bursts, double bytes)
+{
+  printf("%18s:  cpu: %6.3f  bursts/sec: %10.3e  MB/s: %8.1f  (%ld bursts)\n",
+         name, total, bursts / total, bytes / total / 1e6, bursts);
+}
+
+int
+main(int argc, char **argv)
+{
+  std::string dir = (argc > 1) ? argv[1] : "/tmp";
+  std::string burst_filename = dir + "/benchmark_bursts.bin";
+  std::string container_filename = dir + "/benchmark_bursts.gsmb";
+  long checksum = 0;
+
+  srand(0);
+  write_burst_file(burst_filename);
+
+  double start = cpu_time();
+  uint64_t converted = burst_file_to_container(burst_filename, container_filename);
+  print_result("conversion", cpu_time() - start, converted, (double)converted * PMT_SIZE);
+
+  //the way of burst_file_source
+  start = cpu_time();
+  {
+    std::ifstream input(burst_filename.c_str(), std::ifstream::binary);
+    char unserialized[PMT_SIZE];
+    long bursts = 0;
+    while(input.read(unserialized, PMT_SIZE)) {
+      pmt::pmt_t msg = pmt::deserialize_str(std::string(unserialized, PMT_SIZE));
+      checksum += burst(msg).bits()[3];
+      bursts++;
+    }
+    print_result("serialized", cpu_time() - start, bursts, (double)bursts * PMT_SIZE);
+  }
+
+  //all records, each one published as a burst
+  start = cpu_time();
+  {
+    burst_container_reader reader(container_filename);
+    for(uint64_t ii = 0; ii < reader.records_num(); ii++) {
+      const burst_container::record & r = reader.at(ii);
+      pmt::pmt_t msg = burst::make(r.header, r.bits);
+      checksum += burst(msg).bits()[3];
+    }
+    print_result("container", cpu_time() - start, reader.records_num(),
+                 (double)reader.records_num() * sizeof(burst_container::record));
+  }
+
+  //only the records
+  start = cpu_time();
+  {
+    burst_container_reader reader(container_filename);
+    for(uint64_t ii = 0; ii < reader.records_num(); ii++) {
+      const burst_container::record & r = reader.at(ii);
+      checksum += r.frame + r.bits[3];
+    }
+    print_result("container scan", cpu_time() - start, reader.records_num(),
+                 (double)reader.records_num() * sizeof(burst_container::record));
+  }
+
+  //a range of frames from the middle
+  start = cpu_time();
+  {
+    const uint32_t first = FRAMES_NUM / 2, last = first + RANGE - 1;
+    burst_container_reader reader(container_filename);
+    uint64_t end = reader.upper_bound(last);
+    long bursts = 0;
+    for(uint64_t ii = reader.lower_bound(first); ii < end; ii++) {
+      const burst_container::record & r = reader.at(ii);
+      if(r.frame >= first && r.frame <= last) {
+        checksum += r.bits[3];
+        bursts++;
+      }
+    }
+    double total = cpu_time() - start;
+    print_result("container range", total, bursts, (double)bursts * sizeof(burst_container::record));
+    if(bursts != RANGE * ARFCNS_NUM * 8) {
+      printf("wrong number of bursts in the range\n");
+      return 1;
+    }
+  }
+
+  remove(burst_filename.c_str());
+  remove(container_filename.c_str());
+  printf("checksum: %ld\n", checksum);
+  return 0;
+}
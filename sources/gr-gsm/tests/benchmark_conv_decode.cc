@@ -0,0 +1,135 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Measures blocks per second of the CCH Viterbi decoder: conv_decode()
+ * called for every block and every batch implementation available on
+ * this CPU. Random blocks are coded and a part of the coded bits is
+ * flipped, so that some of the blocks can't be corrected. Decoded bits
+ * and error counts of the batch decoders are compared with conv_decode().
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+#include <cch.h>
+#include <cch_batch.h>
+#include "benchmark_utils.h"
+
+#define BLOCKS_NUM  4096            // number of different noisy blocks
+#define BATCH_SIZE  64              // blocks passed to one call of the batch decoder
+#define ITERATIONS  25
+
+/*
+ * Codes random data with the SACCH convolutional code and flips every
+ * coded bit with probability between 0 and 1/8, depending on the block.
+ */
+static void
+make_block(int block, unsigned char * coded)
+{
+  unsigned char u[CONV_INPUT_SIZE + 4] = {0};
+
+  for(int i = 0; i < DATA_BLOCK_SIZE + PARITY_SIZE; i++) {
+    u[i + 4] = rand() & 1;
+  }
+  for(int k = 0; k < CONV_INPUT_SIZE; k++) {
+    const unsigned char * uk = u + 4 + k;
+    coded[2 * k] = uk[0] ^ uk[-3] ^ uk[-4];
+    coded[2 * k + 1] = uk[0] ^ uk[-1] ^ uk[-3] ^ uk[-4];
+  }
+
+  int flip_limit = (block % 32) * RAND_MAX / 256;
+  for(int k = 0; k < CONV_SIZE; k++) {
+    if(rand() < flip_limit) {
+      coded[k] ^= 1;
+    }
+  }
+}
+
+int
+main()
+{
+  std::vector<unsigned char> coded(BLOCKS_NUM * CONV_SIZE);
+  std::vector<unsigned char> reference(BLOCKS_NUM * CONV_INPUT_SIZE);
+  std::vector<unsigned char> decoded(BLOCKS_NUM * CONV_INPUT_SIZE);
+  std::vector<int> reference_errors(BLOCKS_NUM), errors(BLOCKS_NUM);
+  std::vector<const unsigned char *> data_ptrs(BLOCKS_NUM);
+  std::vector<unsigned char *> output_ptrs(BLOCKS_NUM);
+  unsigned int impls_num;
+  const conv_decode_batch_impl * impls = conv_decode_batch_impls(&impls_num);
+  int result = 0;
+
+  srand(0);
+  for(int b = 0; b < BLOCKS_NUM; b++) {
+    make_block(b, &coded[b * CONV_SIZE]);
+    data_ptrs[b] = &coded[b * CONV_SIZE];
+    output_ptrs[b] = &decoded[b * CONV_INPUT_SIZE];
+  }
+
+  double start = cpu_time();
+  for(int i = 0; i < ITERATIONS; i++) {
+    for(int b = 0; b < BLOCKS_NUM; b++) {
+      reference_errors[b] = conv_decode(&reference[b * CONV_INPUT_SIZE], &coded[b * CONV_SIZE]);
+    }
+  }
+  double total = cpu_time() - start;
+  printf("%18s:  cpu: %6.3f  blocks/sec: %10.3e\n", "conv_decode", total,
+         (double)ITERATIONS * BLOCKS_NUM / total);
+
+  for(unsigned int n = 0; n < impls_num; n++) {
+    memset(&decoded[0], 0xff, decoded.size());
+    start = cpu_time();
+    for(int i = 0; i < ITERATIONS; i++) {
+      for(int b = 0; b < BLOCKS_NUM; b += BATCH_SIZE) {
+        impls[n].kernel(&output_ptrs[b], &data_ptrs[b], &errors[b], BATCH_SIZE);
+      }
+    }
+    total = cpu_time() - start;
+
+    bool exact = decoded == reference && errors == reference_errors;
+    if(!exact) {
+      result = 1;
+    }
+
+    printf("%18s:  cpu: %6.3f  blocks/sec: %10.3e  %s\n",
+           impls[n].name, total, (double)ITERATIONS * BLOCKS_NUM / total, exact ? "identical" : "MISMATCH");
+  }
+
+  //a batch which doesn't fill all lanes of the last pass
+  for(unsigned int n = 0; n < impls_num; n++) {
+    const unsigned int odd_size = impls[n].lanes + 3;
+    memset(&decoded[0], 0xff, odd_size * CONV_INPUT_SIZE);
+    impls[n].kernel(&output_ptrs[0], &data_ptrs[0], &errors[0], odd_size);
+    if(memcmp(&decoded[0], &reference[0], odd_size * CONV_INPUT_SIZE) != 0 ||
+       memcmp(&errors[0], &reference_errors[0], odd_size * sizeof(int)) != 0) {
+      printf("%18s:  MISMATCH with a batch of %u blocks\n", impls[n].name, odd_size);
+      result = 1;
+    }
+  }
+
+  return result;
+}
@@ -0,0 +1,230 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Measures time to FCCH synchronization on a recorded capture.
+ *
+ * Usage: benchmark_fcch_search capture.cfile
+ *
+ * The capture has to contain complex float samples of a C0 carrier at
+ * 4 samples per symbol. Acquisition is started from many points of the
+ * capture, as after a loss of synchronization, and input is given to the
+ * search in chunks like the ones the scheduler gives to the receiver.
+ * The per-sample search of the receiver is compared with fcch_detector,
+ * which has to find exactly the same start positions and frequency offsets.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include <boost/circular_buffer.hpp>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/math.h>
+#include <gsm_constants.h>
+#include <fcch_detector.h>
+#include "benchmark_utils.h"
+
+#define OSR            4
+#define CHUNK          8192      // samples given to one search call
+#define ACQUISITIONS   200
+
+/*
+ * The per-sample search of receiver_impl::find_fcch_burst.
+ */
+static bool
+per_sample_search(const gr_complex *input, int nitems,
+                  int & to_consume, int & start_pos, double & freq_offset)
+{
+  boost::circular_buffer<float> phase_diff_buffer(FCCH_HITS_NEEDED * OSR);
+  float phase_diff = 0;
+  int hit_count = 0;
+  int miss_count = 0;
+  double best_sum = 0;
+  float lowest_max_min_diff = 99999;
+  int sample_number = 0;
+  bool searching = true;
+
+  to_consume = 0;
+  start_pos = -1;
+
+  while(true) {
+    if(searching) {
+      sample_number++;
+      if(sample_number > nitems - FCCH_HITS_NEEDED * OSR) {
+        to_consume = sample_number;
+        return false;
+      }
+      phase_diff = gr::fast_atan2f(input[sample_number] * conj(input[sample_number-1]));
+      if(phase_diff > 0) {
+        to_consume = sample_number;
+        searching = false;
+      }
+      continue;
+    }
+
+    if(phase_diff > 0) {
+      hit_count++;
+    }
+    else {
+      miss_count++;
+    }
+
+    if((miss_count >= FCCH_MAX_MISSES * OSR) && (hit_count <= FCCH_HITS_NEEDED * OSR)) {
+      hit_count = 0;
+      miss_count = 0;
+      start_pos = -1;
+      lowest_max_min_diff = 99999;
+      phase_diff_buffer.clear();
+      searching = true;
+      continue;
+    }
+    else if(((miss_count >= FCCH_MAX_MISSES * OSR) && (hit_count > FCCH_HITS_NEEDED * OSR)) || (hit_count > 2 * FCCH_HITS_NEEDED * OSR)) {
+      break;
+    }
+    else if((miss_count < FCCH_MAX_MISSES * OSR) && (hit_count > FCCH_HITS_NEEDED * OSR)) {
+      float min_phase_diff = *(std::min_element(phase_diff_buffer.begin(), phase_diff_buffer.end()));
+      float max_phase_diff = *(std::max_element(phase_diff_buffer.begin(), phase_diff_buffer.end()));
+
+      if(lowest_max_min_diff > max_phase_diff - min_phase_diff) {
+        lowest_max_min_diff = max_phase_diff - min_phase_diff;
+        start_pos = sample_number - FCCH_HITS_NEEDED * OSR - FCCH_MAX_MISSES * OSR;
+        best_sum = 0;
+        for(boost::circular_buffer<float>::iterator it = phase_diff_buffer.begin(); it != phase_diff_buffer.end(); it++) {
+          best_sum += *it - (M_PI / 2) / OSR;
+        }
+      }
+    }
+
+    sample_number++;
+    if(sample_number >= nitems) {
+      return false;
+    }
+    phase_diff = gr::fast_atan2f(input[sample_number] * conj(input[sample_number-1]));
+    phase_diff_buffer.push_back(phase_diff);
+  }
+
+  to_consume = start_pos + FCCH_HITS_NEEDED * OSR + 1;
+  freq_offset = best_sum / FCCH_HITS_NEEDED * 1625000.0/6 / (2 * M_PI);
+  return true;
+}
+
+struct acquisition
+{
+  bool found;
+  long fcch_start_pos;
+  double freq_offset;
+};
+
+enum search_type { PER_SAMPLE, VECTORIZED };
+
+/*
+ * Searches for FCCH from the given position like the receiver does:
+ * samples checked without success are consumed and the search goes on
+ * with the next chunk.
+ */
+static acquisition
+acquire(const std::vector<gr_complex> & samples, long pos, search_type type, fcch_detector & detector)
+{
+  acquisition result = {false, 0, 0};
+
+  while(pos + 2 < (long)samples.size()) {
+    int nitems = std::min((long)CHUNK, (long)samples.size() - pos);
+    int to_consume = 0, start_pos = -1;
+    double freq_offset = 0;
+    bool found;
+
+    if(type == PER_SAMPLE) {
+      found = per_sample_search(&samples[pos], nitems, to_consume, start_pos, freq_offset);
+    }
+    else {
+      found = detector.find(&samples[pos], nitems, to_consume, start_pos, freq_offset);
+    }
+
+    if(found) {
+      result.found = true;
+      result.fcch_start_pos = pos + start_pos;
+      result.freq_offset = freq_offset;
+      break;
+    }
+    pos += std::max(to_consume, 1);
+  }
+  return result;
+}
+
+int
+main(int argc, char **argv)
+{
+  std::vector<gr_complex> samples;
+  fcch_detector detector(OSR);
+  static const char * names[] = {"per-sample", "vectorized"};
+  std::vector<acquisition> results[2];
+
+  if(argc < 2) {
+    fprintf(stderr, "usage: %s capture.cfile\n", argv[0]);
+    return 1;
+  }
+
+  if(!read_capture(argv[1], samples)) {
+    return 1;
+  }
+
+  for(int type = PER_SAMPLE; type <= VECTORIZED; type++) {
+    long samples_to_sync = 0;
+    int found = 0;
+
+    double start = cpu_time();
+    for(int ii = 0; ii < ACQUISITIONS; ii++) {
+      long pos = (long)(samples.size() / 2) * ii / ACQUISITIONS;
+      acquisition a = acquire(samples, pos, (search_type)type, detector);
+      if(a.found) {
+        found++;
+        samples_to_sync += a.fcch_start_pos - pos;
+      }
+      results[type].push_back(a);
+    }
+    double total = cpu_time() - start;
+
+    printf("%18s:  cpu: %6.3f  acquisitions/sec: %10.3e  found: %3d  mean time to sync: %6.1f ms of signal\n",
+           names[type], total, ACQUISITIONS / total, found,
+           found ? 1000.0 * samples_to_sync / found / (GSM_SYMBOL_RATE * OSR) : 0.0);
+  }
+
+  int exact = 0;
+  for(int ii = 0; ii < ACQUISITIONS; ii++) {
+    const acquisition & ref = results[PER_SAMPLE][ii];
+    const acquisition & vec = results[VECTORIZED][ii];
+
+    if(ref.found == vec.found && (!ref.found ||
+       (ref.fcch_start_pos == vec.fcch_start_pos && ref.freq_offset == vec.freq_offset))) {
+      exact++;
+    }
+  }
+  printf("identical results: %d/%d\n", exact, ACQUISITIONS);
+
+  return exact == ACQUISITIONS ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * GSMTAP messages per second sent to a local UDP receiver, which stands
+ * in for Wireshark, the way socket_pdu sends them (the blob is copied
+ * and sent with one sendto() per message) and by gsmtap_sink, with one
+ * message and with many messages per call of its batch handler.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <vector>
+#include <algorithm>
+#include <boost/thread/thread.hpp>
+#include <grgsm/gsmtap.h>
+#include <grgsm/misc_utils/gsmtap_sink.h>
+#include "benchmark_blocks.h"
+#include "benchmark_utils.h"
+
+#define MSGS_NUM    4096
+#define ITERATIONS  25
+#define PAYLOAD_LEN 23
+
+using namespace gr::gsm;
+
+static volatile bool receiving;
+static volatile unsigned long received;
+
+static void
+receive(int sock)
+{
+  char buf[2048];
+  while(receiving) {
+    if(recv(sock, buf, sizeof(buf), 0) > 0) {
+      received++;
+    }
+  }
+}
+
+/*
+ * Sends like socket_pdu in UDP_CLIENT mode: the blob is copied into a
+ * vector which is sent with a separate call
+ */
+static void
+send_copied(int sock, const std::vector<pmt::pmt_t> &msgs)
+{
+  for(size_t m = 0; m < msgs.size(); m++) {
+    pmt::pmt_t vector = pmt::cdr(msgs[m]);
+    size_t len = pmt::blob_length(vector);
+    size_t offset = 0;
+    const uint8_t * data = (const uint8_t *)pmt::uniform_vector_elements(vector, offset);
+    std::vector<uint8_t> copy(data, data + len);
+    send(sock, &copy[0], copy.size(), 0);
+  }
+}
+
+int
+main()
+{
+  static const unsigned int msgs_per_call[] = {0, 1, 16, 256};
+  std::vector<pmt::pmt_t> msgs;
+  pmt::pmt_t port = pmt::mp("in");
+  double reference = 0;
+
+  int rx = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in addr;
+  socklen_t addr_len = sizeof(addr);
+  int rcvbuf = 16 * 1024 * 1024;
+  struct timeval timeout = {0, 100000};
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  setsockopt(rx, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  setsockopt(rx, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  if(bind(rx, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+     getsockname(rx, (struct sockaddr *)&addr, &addr_len) < 0) {
+    perror("bind");
+    return 1;
+  }
+  int rx_port = ntohs(addr.sin_port);
+
+  int tx = socket(AF_INET, SOCK_DGRAM, 0);
+  if(connect(tx, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    perror("connect");
+    return 1;
+  }
+
+  srand(0);
+  for(int m = 0; m < MSGS_NUM; m++) {
+    uint8_t buf[sizeof(gsmtap_hdr) + PAYLOAD_LEN];
+    gsmtap_hdr * header = (gsmtap_hdr *)buf;
+    memset(header, 0, sizeof(gsmtap_hdr));
+    header->version = GSMTAP_VERSION;
+    header->hdr_len = sizeof(gsmtap_hdr) / 4;
+    header->type = GSMTAP_TYPE_UM;
+    header->sub_type = GSMTAP_CHANNEL_BCCH;
+    header->frame_number = htobe32(m);
+    for(int i = 0; i < PAYLOAD_LEN; i++) {
+      buf[sizeof(gsmtap_hdr) + i] = rand();
+    }
+    msgs.push_back(pmt::cons(pmt::PMT_NIL, pmt::make_blob(buf, sizeof(buf))));
+  }
+
+  receiving = true;
+  boost::thread receiver(receive, rx);
+
+  for(unsigned int n = 0; n < sizeof(msgs_per_call) / sizeof(msgs_per_call[0]); n++) {
+    gsmtap_sink::sptr sink = gsmtap_sink::make("127.0.0.1", rx_port);
+    size_t chunk = msgs_per_call[n];
+    received = 0;
+
+    double start = wall_time();
+    for(int i = 0; i < ITERATIONS; i++) {
+      if(chunk == 0) {
+        send_copied(tx, msgs);
+        continue;
+      }
+      for(size_t m = 0; m < msgs.size(); m += chunk) {
+        std::vector<pmt::pmt_t> batch(msgs.begin() + m, msgs.begin() + std::min(m + chunk, msgs.size()));
+        msg_dispatcher::dispatch(sink, port, batch);
+      }
+    }
+    double total = wall_time() - start;
+    double rate = (double)ITERATIONS * MSGS_NUM / total;
+    if(n == 0) {
+      reference = rate;
+    }
+    //let the receiver drain its buffer before counting
+    usleep(200000);
+
+    char name[32];
+    if(chunk) {
+      snprintf(name, sizeof(name), "%u msgs per call", msgs_per_call[n]);
+    } else {
+      snprintf(name, sizeof(name), "socket_pdu style");
+    }
+    printf("%18s:  time: %6.3f  msgs/sec: %10.3e  received: %5.1f%%  speedup: %5.2f\n",
+           name, total, rate, 100.0 * received / ((double)ITERATIONS * MSGS_NUM), rate / reference);
+  }
+
+  receiving = false;
+  receiver.join();
+  close(tx);
+  close(rx);
+  return 0;
+}
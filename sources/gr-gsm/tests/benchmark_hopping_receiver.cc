@@ -0,0 +1,124 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Feeds a recorded C0 signal to all inputs of the receiver and follows one
+ * hopping channel on a mobile allocation of 1 to 64 carriers, once with
+ * all carriers detected and filtered by cx_channel_hopper and once with
+ * the hopping sequence set in the receiver.
+ *
+ * Usage: benchmark_hopping_receiver capture.cfile [hsn] [timeslot_mask]
+ *
+ * The capture has to contain complex float samples of a C0 carrier at
+ * 4 samples per symbol (1625000/6*4 Hz). Both chains should deliver the
+ * same number of bursts of the followed channel; the CPU time is what it
+ * costs to follow it.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <gnuradio/top_block.h>
+#include <gnuradio/sync_block.h>
+#include <gnuradio/io_signature.h>
+#include <grgsm/receiver/receiver.h>
+#include <grgsm/receiver/cx_channel_hopper.h>
+#include "benchmark_utils.h"
+#include "benchmark_blocks.h"
+
+#define OSR 4
+
+static void
+run_receiver(const std::vector<gr_complex> & samples, int carriers, int hsn, int timeslot_mask, bool hopping_receiver)
+{
+  std::vector<int> cell_allocation;
+  std::vector<int> ma;
+  for(int ii = 0; ii <= carriers; ii++) {
+    cell_allocation.push_back(ii);
+  }
+  ma.assign(cell_allocation.begin() + 1, cell_allocation.end());
+
+  gr::top_block_sptr tb = gr::make_top_block("benchmark_hopping_receiver");
+  boost::shared_ptr<capture_source> src(new capture_source(samples));
+  gr::gsm::receiver::sptr receiver = gr::gsm::receiver::make(OSR, cell_allocation, std::vector<int>());
+  boost::shared_ptr<burst_counter_sink> sink(new burst_counter_sink());
+
+  for(int ii = 0; ii <= carriers; ii++) {
+    tb->connect(src, 0, receiver, ii);
+  }
+  if(hopping_receiver) {
+    receiver->set_hopping(ma, 0, hsn, timeslot_mask);
+    tb->msg_connect(receiver, "CX", sink, "in");
+  } else {
+    gr::gsm::cx_channel_hopper::sptr hopper = gr::gsm::cx_channel_hopper::make(ma, 0, hsn);
+    tb->msg_connect(receiver, "CX", hopper, "CX");
+    tb->msg_connect(hopper, "bursts", sink, "in");
+  }
+
+  double cpu_start = cpu_time();
+  double wall_start = wall_time();
+  tb->run();
+  double cpu = cpu_time() - cpu_start;
+  double wall = wall_time() - wall_start;
+
+  printf("%8d %-8s  wall: %6.3f  cpu: %6.3f  followed bursts: %8lu  cpu/burst: %10.3e\n",
+         carriers, hopping_receiver ? "receiver" : "hopper", wall, cpu, sink->bursts(),
+         sink->bursts() ? cpu / sink->bursts() : 0.0);
+}
+
+int
+main(int argc, char **argv)
+{
+  std::vector<gr_complex> samples;
+  int hsn = 1;
+  int timeslot_mask = 0xff;
+
+  if(argc < 2) {
+    fprintf(stderr, "usage: %s capture.cfile [hsn] [timeslot_mask]\n", argv[0]);
+    return 1;
+  }
+  if(argc > 2) {
+    hsn = atoi(argv[2]);
+  }
+  if(argc > 3) {
+    timeslot_mask = strtol(argv[3], NULL, 0);
+  }
+
+  if(!read_capture(argv[1], samples)) {
+    return 1;
+  }
+
+  printf("%8s %-8s\n", "carriers", "chain");
+  for(int carriers = 1; carriers <= 64; carriers *= 2) {
+    run_receiver(samples, carriers, hsn, timeslot_mask, false);
+    run_receiver(samples, carriers, hsn, timeslot_mask, true);
+  }
+
+  return 0;
+}
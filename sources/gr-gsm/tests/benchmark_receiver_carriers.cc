@@ -0,0 +1,243 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Feeds a recorded C0 signal to the receiver as distinct carriers and
+ * sweeps the number of carriers from 1 to 64, once with all bursts
+ * detected in the block's thread and once with the carrier pipeline.
+ *
+ * Carrier k gets the capture advanced by k TDMA frames (wrapping around
+ * at its end), so each carrier carries other bursts while the slot timing
+ * found on C0 stays valid for all of them. A burst of carrier k in frame
+ * fn has to be the burst C0 received in frame fn + k - the number of
+ * bursts of the other carriers which match is reported along with the
+ * number compared, so that bursts mixed up between carriers show.
+ *
+ * Usage: benchmark_receiver_carriers capture.cfile [burst_workers]
+ *
+ * The capture has to contain complex float samples of a C0 carrier at
+ * 4 samples per symbol (1625000/6*4 Hz). Bursts per second of CPU time
+ * are reported as "per core" - they stay flat as long as the workers
+ * don't add overhead, while bursts/sec of wall time should grow with the
+ * number of workers. Heap allocations of the whole flowgraph, its setup
+ * included, are counted by replacing operator new and reported per burst.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <gnuradio/top_block.h>
+#include <gnuradio/sync_block.h>
+#include <gnuradio/io_signature.h>
+#include <grgsm/receiver/receiver.h>
+#include <grgsm/burst.h>
+#include <grgsm/endian.h>
+#include "benchmark_utils.h"
+#include "benchmark_blocks.h"
+#include "benchmark_allocations.h"
+
+#define OSR 4
+#define FRAME_SAMPLES (1250 * OSR)
+#define HYPERFRAME (26 * 51 * 2048)
+
+/*
+ * Counts bursts and remembers a hash of the bits of each, into storage
+ * reserved up front so that the allocations of the receiver are counted
+ * alone.
+ */
+class carrier_check_sink : public gr::block
+{
+ public:
+  struct record
+  {
+    uint32_t fn;
+    uint16_t arfcn;
+    uint8_t ts;
+    uint64_t hash;
+
+    bool operator<(const record & other) const
+    {
+      if(arfcn != other.arfcn) {
+        return arfcn < other.arfcn;
+      }
+      if(fn != other.fn) {
+        return fn < other.fn;
+      }
+      return ts < other.ts;
+    }
+  };
+
+ private:
+  std::vector<record> d_records;
+  unsigned long d_bursts;
+
+  void check(pmt::pmt_t msg)
+  {
+    d_bursts++;
+    if(d_records.size() == d_records.capacity()) {
+      return;
+    }
+
+    gr::gsm::burst b(msg);
+    int8_t buf[gr::gsm::burst::SIZE];
+    const int8_t *bits = b.hard_bits(buf);
+
+    record r;
+    r.fn = be32toh(b.header().frame_number);
+    r.arfcn = be16toh(b.header().arfcn);
+    r.ts = b.header().timeslot;
+    r.hash = 14695981039346656037ULL;
+    for(unsigned int ii = 0; ii < gr::gsm::burst::SIZE; ii++) {
+      r.hash = (r.hash ^ (uint8_t)bits[ii]) * 1099511628211ULL;
+    }
+    d_records.push_back(r);
+  }
+
+ public:
+  carrier_check_sink(size_t capacity)
+    : gr::block("carrier_check_sink",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(0, 0, 0)),
+      d_bursts(0)
+  {
+    d_records.reserve(capacity);
+    message_port_register_in(pmt::mp("in"));
+    set_msg_handler(pmt::mp("in"), boost::bind(&carrier_check_sink::check, this, _1));
+  }
+
+  unsigned long bursts() const
+  {
+    return d_bursts;
+  }
+
+  /*
+   * Compares bursts of carrier k (k > 0) with the bursts C0 received
+   * k frames later. Counts the carriers with bursts and the bursts with
+   * an ARFCN which isn't one of the carriers.
+   */
+  void compare(int carriers, unsigned long & compared, unsigned long & matched,
+               int & active, unsigned long & foreign)
+  {
+    std::sort(d_records.begin(), d_records.end());
+    std::vector<bool> seen(carriers, false);
+    compared = matched = foreign = 0;
+
+    for(size_t ii = 0; ii < d_records.size(); ii++) {
+      const record & r = d_records[ii];
+      if(r.arfcn >= carriers) {
+        foreign++;
+        continue;
+      }
+      seen[r.arfcn] = true;
+      if(r.arfcn == 0) {
+        continue;
+      }
+
+      record key;
+      key.arfcn = 0;
+      key.fn = (r.fn + r.arfcn) % HYPERFRAME;
+      key.ts = r.ts;
+      std::vector<record>::const_iterator c0 = std::lower_bound(d_records.begin(), d_records.end(), key);
+      if(c0 != d_records.end() && c0->arfcn == 0 && c0->fn == key.fn && c0->ts == key.ts) {
+        compared++;
+        matched += c0->hash == r.hash;
+      }
+    }
+    active = std::count(seen.begin(), seen.end(), true);
+  }
+};
+
+static void
+run_receiver(const std::vector<gr_complex> & samples, int carriers, int burst_workers)
+{
+  std::vector<int> cell_allocation;
+  for(int ii = 0; ii < carriers; ii++) {
+    cell_allocation.push_back(ii);
+  }
+
+  gr::top_block_sptr tb = gr::make_top_block("benchmark_receiver_carriers");
+  gr::gsm::receiver::sptr receiver = gr::gsm::receiver::make(OSR, cell_allocation, std::vector<int>(), burst_workers);
+  /* at most 8 bursts per frame and carrier, with some room for bursts
+     detected at frame boundaries */
+  size_t capacity = (samples.size() / FRAME_SAMPLES + 1) * 9 * carriers;
+  boost::shared_ptr<carrier_check_sink> sink(new carrier_check_sink(capacity));
+
+  for(int ii = 0; ii < carriers; ii++) {
+    boost::shared_ptr<capture_source> src(new capture_source(samples, (size_t)ii * FRAME_SAMPLES));
+    tb->connect(src, 0, receiver, ii);
+  }
+  tb->msg_connect(receiver, "C0", sink, "in");
+  tb->msg_connect(receiver, "CX", sink, "in");
+
+  unsigned long start_allocations = allocations;
+  double cpu_start = cpu_time();
+  double wall_start = wall_time();
+  tb->run();
+  double cpu = cpu_time() - cpu_start;
+  double wall = wall_time() - wall_start;
+  unsigned long n = allocations - start_allocations;
+
+  unsigned long compared, matched, foreign;
+  int active;
+  sink->compare(carriers, compared, matched, active, foreign);
+
+  printf("%8d %8d  wall: %6.3f  cpu: %6.3f  bursts: %8lu  bursts/sec: %10.3e  bursts/sec/core: %10.3e  allocations/burst: %6.2f"
+         "  carriers with bursts: %2d  matching C0: %lu/%lu  foreign: %lu\n",
+         carriers, burst_workers, wall, cpu, sink->bursts(), sink->bursts() / wall, sink->bursts() / cpu,
+         sink->bursts() ? (double)n / sink->bursts() : 0.0, active, matched, compared, foreign);
+}
+
+int
+main(int argc, char **argv)
+{
+  std::vector<gr_complex> samples;
+  int cores = boost::thread::hardware_concurrency();
+  int burst_workers = cores > 1 ? cores - 1 : 1;
+
+  if(argc < 2) {
+    fprintf(stderr, "usage: %s capture.cfile [burst_workers]\n", argv[0]);
+    return 1;
+  }
+  if(argc > 2) {
+    burst_workers = atoi(argv[2]);
+  }
+
+  if(!read_capture(argv[1], samples)) {
+    return 1;
+  }
+
+  printf("%8s %8s\n", "carriers", "workers");
+  for(int carriers = 1; carriers <= 64; carriers *= 2) {
+    run_receiver(samples, carriers, 0);
+    run_receiver(samples, carriers, burst_workers);
+  }
+
+  return 0;
+}
@@ -0,0 +1,305 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Measures the gain of soft-decision decoding of control channel blocks.
+ *
+ * Usage: benchmark_soft_bits [blocks per SNR point]
+ *
+ * Random blocks are convolutionally coded, interleaved and mapped on four
+ * normal bursts as on a SACCH/SDCCH. The bursts are GMSK modulated at
+ * 4 samples per symbol, go through an AWGN channel and are detected by
+ * burst_detector, which gives hard and soft bits. The blocks are decoded
+ * with conv_decode (hard) and conv_decode_soft from cch.c, as in
+ * control_channels_decoder, and with ViterbiR2O4, as FACCH/F in
+ * tch_f_decoder. Coded bit error rate, decoded bit error rate and block
+ * error rate are printed for every Es/N0.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+#include <math.h>
+#include <gnuradio/gr_complex.h>
+#include <gsm_constants.h>
+#include <burst_detector.h>
+#include <cch.h>
+#include <BitVector.h>
+#include <ViterbiR204.h>
+#include "benchmark_utils.h"
+
+#define OSR            4
+#define TSC            0
+#define BLOCKS_NUM     1000        // default number of blocks per SNR point
+#define LEAD_BITS      8           // bits transmitted before the burst - its first bit is at GUARD_PERIOD
+#define SLOT_BITS      173         // bits modulated for one burst, enough for the samples of a timeslot
+#define PULSE_SYMBOLS  4           // length of the GMSK frequency pulse
+#define BT             0.3
+
+enum decoder_type { CCH_HARD, CCH_SOFT, R204_HARD, R204_SOFT, DECODERS_NUM };
+
+static const char * decoder_names[DECODERS_NUM] = {
+  "conv_decode", "conv_decode_soft", "ViterbiR2O4 hard", "ViterbiR2O4 soft"
+};
+
+static double
+gaussian()
+{
+  double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+  double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+  return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+/*
+ * Encodes differentially and maps bits on MSK states, like the receiver does
+ * with the training sequences.
+ */
+static void
+gmsk_mapper(const unsigned char * input, int nitems, gr_complex * gmsk_output, gr_complex start_point)
+{
+  gr_complex j = gr_complex(0.0, 1.0);
+  int previous_symbol = 2 * input[0] - 1;
+  gmsk_output[0] = start_point;
+
+  for(int i = 1; i < nitems; i++) {
+    int current_symbol = 2 * input[i] - 1;
+    gmsk_output[i] = j * gr_complex(current_symbol * previous_symbol, 0.0) * gmsk_output[i-1];
+    previous_symbol = current_symbol;
+  }
+}
+
+/*
+ * GMSK modulator - Gaussian frequency pulse with BT = 0.3, a bit equal to
+ * the previous one turns the phase by +pi/2.
+ */
+class gmsk_modulator
+{
+ private:
+  std::vector<double> d_freq_pulse; ///< sums up to 1/2
+
+ public:
+  gmsk_modulator() : d_freq_pulse(PULSE_SYMBOLS * OSR)
+  {
+    const double k = 2 * M_PI * BT / sqrt(log(2.0));
+    double sum = 0;
+    for(size_t n = 0; n < d_freq_pulse.size(); n++) {
+      double t = (n + 0.5) / OSR - PULSE_SYMBOLS / 2.0;
+      d_freq_pulse[n] = erf(k * (t + 0.5) / sqrt(2.0)) - erf(k * (t - 0.5) / sqrt(2.0));
+      sum += d_freq_pulse[n];
+    }
+    for(size_t n = 0; n < d_freq_pulse.size(); n++) {
+      d_freq_pulse[n] /= 2 * sum;
+    }
+  }
+
+  void modulate(const unsigned char * bits, int nbits, gr_complex * output)
+  {
+    const int delay = PULSE_SYMBOLS * OSR / 2;
+    std::vector<double> freq(nbits * OSR + 2 * delay, 0.0);
+
+    for(int i = 0; i < nbits; i++) {
+      int previous = (i > 0) ? bits[i-1] : 0;
+      double a = (bits[i] == previous) ? 1.0 : -1.0;
+      for(size_t n = 0; n < d_freq_pulse.size(); n++) {
+        freq[i * OSR + n] += a * d_freq_pulse[n];
+      }
+    }
+    double phase = 0;
+    for(int n = 0; n < nbits * OSR + delay; n++) {
+      phase += M_PI * freq[n];
+      if(n >= delay) {
+        output[n - delay] = std::polar(1.0f, (float)phase);
+      }
+    }
+  }
+};
+
+/*
+ * The SACCH/SDCCH coding: rate 1/2 convolutional code with 4 flush bits,
+ * interleaving over 4 bursts and mapping on normal bursts.
+ */
+static void
+encode_block(const unsigned char * data, unsigned char bursts[4][BURST_SIZE])
+{
+  unsigned char u[CONV_INPUT_SIZE + 4] = {0};
+  unsigned char coded[CONV_SIZE];
+
+  memcpy(u + 4, data, DATA_BLOCK_SIZE + PARITY_SIZE);
+  for(int k = 0; k < CONV_INPUT_SIZE; k++) {
+    const unsigned char * uk = u + 4 + k;
+    coded[2 * k] = uk[0] ^ uk[-3] ^ uk[-4];
+    coded[2 * k + 1] = uk[0] ^ uk[-1] ^ uk[-3] ^ uk[-4];
+  }
+
+  for(int b = 0; b < 4; b++) {
+    memset(bursts[b], 0, BURST_SIZE);
+    bursts[b][3 + DATA_BITS] = 1;
+    memcpy(&bursts[b][TRAIN_POS - TRAIN_BEGINNING], train_seq[TSC], N_TRAIN_BITS);
+    bursts[b][TRAIN_POS - TRAIN_BEGINNING + N_TRAIN_BITS] = 1;
+  }
+  for(int k = 0; k < CONV_SIZE; k++) {
+    int b = k % 4;
+    int j = 2 * ((49 * k) % 57) + ((k % 8) / 4);
+    bursts[b][(j < 57) ? j + 3 : j + 88 - 57] = coded[k];
+  }
+}
+
+static void
+deinterleave(const unsigned char hard_bursts[4][BURST_SIZE], const int8_t soft_bursts[4][BURST_SIZE],
+             unsigned char * hard, signed char * soft)
+{
+  for(int k = 0; k < CONV_SIZE; k++) {
+    int b = k % 4;
+    int j = 2 * ((49 * k) % 57) + ((k % 8) / 4);
+    int pos = (j < 57) ? j + 3 : j + 88 - 57;
+    hard[k] = hard_bursts[b][pos];
+    soft[k] = soft_bursts[b][pos];
+  }
+}
+
+int
+main(int argc, char **argv)
+{
+  int blocks_num = (argc > 1) ? atoi(argv[1]) : BLOCKS_NUM;
+  const int slot_samples = SLOT_BITS * OSR;
+
+  gr_complex norm_training_seqs[TRAIN_SEQ_NUM][N_TRAIN_BITS];
+  for(int i = 0; i < TRAIN_SEQ_NUM; i++) {
+    gr_complex start_point = (train_seq[i][0] == 0) ? gr_complex(1.0, 0.0) : gr_complex(-1.0, 0.0);
+    gmsk_mapper(train_seq[i], N_TRAIN_BITS, norm_training_seqs[i], start_point);
+  }
+  burst_detector detector(OSR);
+  detector.set_norm_training_seqs(norm_training_seqs);
+  gmsk_modulator modulator;
+  ViterbiR2O4 vr204;
+
+  std::vector<gr_complex> samples(slot_samples);
+  unsigned char slot_bits[SLOT_BITS];
+  unsigned char data[DATA_BLOCK_SIZE + PARITY_SIZE];
+  unsigned char tx_bursts[4][BURST_SIZE];
+  unsigned char hard_bursts[4][BURST_SIZE];
+  int8_t soft_bursts[4][BURST_SIZE];
+  unsigned char hard[CONV_SIZE];
+  signed char soft[CONV_SIZE];
+  unsigned char decoded[CONV_INPUT_SIZE];
+  SoftVector c(CONV_SIZE);
+  BitVector u(CONV_INPUT_SIZE);
+  double decoding_time[DECODERS_NUM] = {0};
+  long decoded_blocks = 0;
+
+  srand(1);
+  printf("%6s  %10s", "Es/N0", "coded BER");
+  for(int d = 0; d < DECODERS_NUM; d++) {
+    printf("  %18s BER/BLER", decoder_names[d]);
+  }
+  printf("\n");
+
+  for(int snr_db = 0; snr_db <= 10; snr_db++) {
+    //signal has unit power, noise is white over OSR times the symbol rate
+    const double noise_amplitude = sqrt(OSR / pow(10.0, snr_db / 10.0) / 2);
+    long coded_errors = 0;
+    long bit_errors[DECODERS_NUM] = {0};
+    long block_errors[DECODERS_NUM] = {0};
+
+    for(int block = 0; block < blocks_num; block++) {
+      for(int i = 0; i < DATA_BLOCK_SIZE + PARITY_SIZE; i++) {
+        data[i] = rand() & 1;
+      }
+      encode_block(data, tx_bursts);
+
+      for(int b = 0; b < 4; b++) {
+        for(int i = 0; i < SLOT_BITS; i++) {
+          slot_bits[i] = rand() & 1;   //neighbouring timeslots
+        }
+        memcpy(slot_bits + LEAD_BITS, tx_bursts[b], BURST_SIZE);
+        modulator.modulate(slot_bits, SLOT_BITS, &samples[0]);
+        for(int n = 0; n < slot_samples; n++) {
+          samples[n] += gr_complex(noise_amplitude * gaussian(), noise_amplitude * gaussian());
+        }
+
+        gr_complex chan_imp_resp[CHAN_IMP_RESP_LENGTH * OSR];
+        float corr_max;
+        int burst_start = detector.get_norm_chan_imp_resp(&samples[0], chan_imp_resp, &corr_max, TSC);
+        detector.detect_burst(&samples[0], chan_imp_resp, burst_start, hard_bursts[b], soft_bursts[b]);
+      }
+
+      deinterleave(hard_bursts, soft_bursts, hard, soft);
+      for(int b = 0; b < 4; b++) {
+        for(int i = 0; i < DATA_BITS; i++) {
+          coded_errors += (hard_bursts[b][i + 3] != tx_bursts[b][i + 3]);
+          coded_errors += (hard_bursts[b][i + 88] != tx_bursts[b][i + 88]);
+        }
+      }
+
+      for(int d = 0; d < DECODERS_NUM; d++) {
+        double start = cpu_time();
+        switch(d) {
+        case CCH_HARD:
+          conv_decode(decoded, hard);
+          break;
+        case CCH_SOFT:
+          conv_decode_soft(decoded, soft);
+          break;
+        case R204_HARD:
+        case R204_SOFT:
+          for(int k = 0; k < CONV_SIZE; k++) {
+            c[k] = (d == R204_HARD) ? hard[k] : 0.5f - soft[k] / 254.0f;
+          }
+          vr204.decode(c, u);
+          for(int k = 0; k < CONV_INPUT_SIZE; k++) {
+            decoded[k] = u.bit(k);
+          }
+          break;
+        }
+        decoding_time[d] += cpu_time() - start;
+
+        int errors = 0;
+        for(int i = 0; i < DATA_BLOCK_SIZE + PARITY_SIZE; i++) {
+          errors += (decoded[i] != data[i]);
+        }
+        bit_errors[d] += errors;
+        block_errors[d] += (errors != 0);
+      }
+      decoded_blocks++;
+    }
+
+    printf("%4d dB  %10.3e", snr_db, (double)coded_errors / (blocks_num * CONV_SIZE));
+    for(int d = 0; d < DECODERS_NUM; d++) {
+      printf("  %18.3e %8.3e", (double)bit_errors[d] / (blocks_num * (DATA_BLOCK_SIZE + PARITY_SIZE)),
+             (double)block_errors[d] / blocks_num);
+    }
+    printf("\n");
+  }
+
+  printf("\n");
+  for(int d = 0; d < DECODERS_NUM; d++) {
+    printf("%18s:  cpu: %6.3f  blocks/sec: %10.3e\n", decoder_names[d], decoding_time[d],
+           decoded_blocks / decoding_time[d]);
+  }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Timing and capture loading shared by the benchmarks
+ */
+
+#ifndef INCLUDED_GSM_BENCHMARK_UTILS_H
+#define INCLUDED_GSM_BENCHMARK_UTILS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/time.h>
+
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+#include <vector>
+#include <gnuradio/gr_complex.h>
+
+static inline double
+timeval_to_double(const struct timeval *tv)
+{
+  return (double)tv->tv_sec + (double)tv->tv_usec * 1e-6;
+}
+
+/*
+ * User and system time used by the process (all its threads), in seconds
+ */
+static inline double
+cpu_time()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage rusage;
+  if(getrusage(RUSAGE_SELF, &rusage) < 0) {
+    perror("getrusage");
+    exit(1);
+  }
+  return timeval_to_double(&rusage.ru_utime) + timeval_to_double(&rusage.ru_stime);
+#else
+  return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+static inline double
+wall_time()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return timeval_to_double(&tv);
+}
+
+/*
+ * Reads a capture of complex float samples, false if it can't be opened
+ */
+static inline bool
+read_capture(const char * filename, std::vector<gr_complex> & samples)
+{
+  FILE *fp = fopen(filename, "rb");
+  if(fp == NULL) {
+    perror(filename);
+    return false;
+  }
+  gr_complex buf[4096];
+  size_t n;
+  while((n = fread(buf, sizeof(gr_complex), 4096, fp)) > 0) {
+    samples.insert(samples.end(), buf, buf + n);
+  }
+  fclose(fp);
+  return true;
+}
+
+#endif /* INCLUDED_GSM_BENCHMARK_UTILS_H */
@@ -0,0 +1,116 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Measures bursts per second of the MLSE detector for every
+ * Add-Compare-Select implementation available on this CPU and checks
+ * that their soft outputs are bit-exact with the "generic" one.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+#include <gnuradio/gr_complex.h>
+#include <gsm_constants.h>
+#include <viterbi_acs.h>
+#include <viterbi_detector.h>
+#include "benchmark_utils.h"
+
+#define BURSTS_NUM  1000            // number of different synthetic bursts
+#define ITERATIONS  (200 * BURSTS_NUM)
+
+static float
+uniform()
+{
+  return 2.0f * rand() / RAND_MAX - 1.0f;
+}
+
+/*
+ * Synthetic matched filter outputs: random symbols passed through
+ * a random, but realistic looking, channel autocorrelation plus noise.
+ */
+static void
+make_bursts(std::vector<gr_complex> & input, std::vector<gr_complex> & rhh)
+{
+  input.resize(BURSTS_NUM * BURST_SIZE);
+  rhh.resize(BURSTS_NUM * CHAN_IMP_RESP_LENGTH);
+
+  for(int b = 0; b < BURSTS_NUM; b++) {
+    gr_complex * r = &rhh[b * CHAN_IMP_RESP_LENGTH];
+    r[0] = gr_complex(1.0f, 0.0f);
+    for(int k = 1; k < CHAN_IMP_RESP_LENGTH; k++) {
+      r[k] = gr_complex(uniform(), uniform()) * (0.5f / k);
+    }
+
+    gr_complex * in = &input[b * BURST_SIZE];
+    for(int i = 0; i < BURST_SIZE; i++) {
+      float symbol = (rand() & 1) ? 1.0f : -1.0f;
+      in[i] = gr_complex(symbol, symbol) + gr_complex(uniform(), uniform()) * 0.7f;
+    }
+  }
+}
+
+int
+main()
+{
+  const unsigned int start_state = 3;
+  const unsigned int stop_states[2] = {4, 12};
+  std::vector<gr_complex> input, rhh;
+  std::vector<float> reference(BURSTS_NUM * BURST_SIZE);
+  std::vector<float> output(BURSTS_NUM * BURST_SIZE);
+  unsigned int impls_num;
+  const viterbi_acs_impl * impls = viterbi_acs_impls(&impls_num);
+  int result = 0;
+
+  srand(0);
+  make_bursts(input, rhh);
+
+  for(int b = 0; b < BURSTS_NUM; b++) {
+    viterbi_detector_manual(&input[b * BURST_SIZE], BURST_SIZE, &rhh[b * CHAN_IMP_RESP_LENGTH],
+                            start_state, stop_states, 2, &reference[b * BURST_SIZE], "generic");
+  }
+
+  for(unsigned int n = 0; n < impls_num; n++) {
+    double start = cpu_time();
+    for(int i = 0; i < ITERATIONS; i++) {
+      int b = i % BURSTS_NUM;
+      viterbi_detector_manual(&input[b * BURST_SIZE], BURST_SIZE, &rhh[b * CHAN_IMP_RESP_LENGTH],
+                              start_state, stop_states, 2, &output[b * BURST_SIZE], impls[n].name);
+    }
+    double total = cpu_time() - start;
+
+    bool exact = memcmp(&output[0], &reference[0], output.size() * sizeof(float)) == 0;
+    if(!exact) {
+      result = 1;
+    }
+
+    printf("%18s:  cpu: %6.3f  bursts/sec: %10.3e  %s\n",
+           impls[n].name, total, ITERATIONS / total, exact ? "bit-exact" : "MISMATCH");
+  }
+
+  return result;
+}
@@ -0,0 +1,151 @@
+/* -*- c++ -*- */
+/*
+ * @file
+ * @section LICENSE
+ *
+ * Gr-gsm is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * Gr-gsm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-gsm; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Cores needed to channelize carriers of a wideband signal in real time,
+ * for 10, 20 and 50 MS/s inputs and a growing number of carriers, with
+ * wideband_channelizer and with what gsm_wideband_input did before: a
+ * frequency translating FIR filter with the channel filter designed at the
+ * input rate, followed by a resampler, for every carrier. The second one
+ * is measured with one carrier and scaled, its cost being linear in the
+ * number of carriers (the resampler, cheap next to the filter, is left
+ * out).
+ *
+ * At 20 MS/s the channelizer is also given interleaved int16 IQ, as an
+ * osmosdr source with format=sc16 delivers it: the input it reads per
+ * second (the memory traffic of the wideband link) and the cores it needs,
+ * against complex float input.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include <volk/volk.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/blocks/rotator.h>
+#include <wideband_channelizer.h>
+#include "benchmark_utils.h"
+
+#define OSR             4
+#define FC              940e6
+#define CHUNK           65536   // input samples given to one call
+#define SIGNAL_TIME     0.5     // seconds of input channelized in a run
+#define REFERENCE_TIME  0.02
+
+/*
+ * Cores used by one carrier of the per-carrier chain: a filter with as
+ * many taps as firdes.low_pass(1, samp_rate, 125e3, 75e3, WIN_HAMMING)
+ * has, shifted to the carrier, applied to every input sample
+ */
+static double
+reference_cores(double samp_rate, const std::vector<gr_complex> & input)
+{
+  int ntaps = (int)(53.0 * samp_rate / (22.0 * 75e3)) | 1;
+  std::vector<gr_complex> taps(ntaps);
+  for(int n = 0; n < ntaps; n++) {
+    taps[n] = std::polar(1.0f / ntaps, (float)(2 * M_PI * 400e3 * n / samp_rate));
+  }
+  std::vector<gr_complex> output(CHUNK);
+  gr::blocks::rotator rotator;
+  rotator.set_phase_incr(std::polar(1.0f, (float)(-2 * M_PI * 400e3 / samp_rate)));
+
+  long nsamples = (long)(REFERENCE_TIME * samp_rate);
+  double start = cpu_time();
+  for(long done = 0; done < nsamples; done += CHUNK - ntaps) {
+    for(int n = 0; n < CHUNK - ntaps; n++) {
+      gr_complex sum;
+      volk_32fc_x2_dot_prod_32fc(&sum, &input[n], &taps[0], ntaps);
+      output[n] = rotator.rotate(sum);
+    }
+  }
+  return (cpu_time() - start) / REFERENCE_TIME;
+}
+
+template <typename T>
+static double
+channelizer_cores(double samp_rate, int ncarriers, const T * input)
+{
+  std::vector<double> freqs;
+  for(int c = 0; c < ncarriers; c++) {
+    freqs.push_back(FC + (c - ncarriers / 2) * 200e3);
+  }
+  wideband_channelizer channelizer(samp_rate, FC, freqs, OSR, 0);
+
+  int noutput = (int)(CHUNK / channelizer.input_per_output()) + 16;
+  std::vector<std::vector<gr_complex> > outputs(ncarriers, std::vector<gr_complex>(noutput));
+  std::vector<gr_complex *> out;
+  for(int c = 0; c < ncarriers; c++) {
+    out.push_back(&outputs[c][0]);
+  }
+
+  long nsamples = (long)(SIGNAL_TIME * samp_rate);
+  double start = cpu_time();
+  for(long done = 0; done < nsamples; ) {
+    int consumed;
+    channelizer.channelize(input, CHUNK, &out[0], noutput, consumed);
+    done += consumed;
+  }
+  return (cpu_time() - start) / SIGNAL_TIME;
+}
+
+int
+main()
+{
+  static const double samp_rates[] = {10e6, 20e6, 50e6};
+  static const int carriers[] = {1, 2, 4, 8, 16, 32};
+  std::vector<gr_complex> input(CHUNK);
+  std::vector<int16_t> input_sc16(2 * CHUNK);
+
+  srand(0);
+  for(int n = 0; n < CHUNK; n++) {
+    input[n] = gr_complex(rand() / (float)RAND_MAX - 0.5f, rand() / (float)RAND_MAX - 0.5f);
+    input_sc16[2 * n] = (int16_t)(input[n].real() * 32767);
+    input_sc16[2 * n + 1] = (int16_t)(input[n].imag() * 32767);
+  }
+
+  for(unsigned int r = 0; r < sizeof(samp_rates) / sizeof(samp_rates[0]); r++) {
+    double per_carrier = reference_cores(samp_rates[r], input);
+    printf("%.0f MS/s\n", samp_rates[r] / 1e6);
+    for(unsigned int n = 0; n < sizeof(carriers) / sizeof(carriers[0]); n++) {
+      double cores = channelizer_cores(samp_rates[r], carriers[n], &input[0]);
+      double reference = per_carrier * carriers[n];
+      printf("%4d carriers:  channelizer cores: %7.3f  per-carrier filters cores: %8.3f  speedup: %7.2f\n",
+             carriers[n], cores, reference, reference / cores);
+    }
+  }
+
+  printf("20 MS/s, complex float (%.0f MB/s input) against int16 IQ (%.0f MB/s input)\n",
+         20e6 * sizeof(gr_complex) / 1e6, 20e6 * 2 * sizeof(int16_t) / 1e6);
+  for(unsigned int n = 0; n < sizeof(carriers) / sizeof(carriers[0]); n++) {
+    double fc32 = channelizer_cores(20e6, carriers[n], &input[0]);
+    double sc16 = channelizer_cores(20e6, carriers[n], &input_sc16[0]);
+    printf("%4d carriers:  complex float cores: %7.3f  int16 cores: %7.3f\n",
+           carriers[n], fc32, sc16);
+  }
+  return 0;
+}
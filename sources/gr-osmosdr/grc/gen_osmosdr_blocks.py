@@ -27,7 +27,11 @@ MAIN_TMPL = """\
   <throttle>1</throttle>
   <import>import osmosdr</import>
   <import>import time</import>
+#if $sourk == 'source':
+  <make>osmosdr.$(sourk)( args="numchan=" + str(\$nchan) + " format=\$type " + \$args )
+#else
   <make>osmosdr.$(sourk)( args="numchan=" + str(\$nchan) + " " + \$args )
+#end if
 #for $m in range($max_mboards)
 ########################################################################
 \#if \$num_mboards() > $m and \$clock_source$(m)()
@@ -86,6 +90,18 @@ self.\$(id).set_bandwidth(\$bw$(n), $n)
       <key>fc32</key>
       <opt>type:fc32</opt>
     </option>
+#if $sourk == 'source':
+    <option>
+      <name>Complex int16</name>
+      <key>sc16</key>
+      <opt>type:sc16</opt>
+    </option>
+    <option>
+      <name>Complex int8</name>
+      <key>sc8</key>
+      <opt>type:sc8</opt>
+    </option>
+#end if
   </param>
   <param>
     <name>Device Arguments</name>
@@ -232,7 +248,12 @@ While primarily being developed for the OsmoSDR hardware, this block as well sup
 By using the osmocom $sourk block you can take advantage of a common software api in your application(s) independent of the underlying radio hardware.
 
 Output Type:
-This parameter controls the data type of the stream in gnuradio. Only complex float32 samples are supported at the moment.
+This parameter controls the data type of the stream in gnuradio.
+#if $sourk == 'source':
+Complex int16 and int8 are interleaved IQ at full scale, with half or a quarter of the memory traffic of complex float32. RTL-SDR, HackRF and bladeRF deliver them natively, the other devices are converted from complex float32. IQ balance correction only applies to complex float32.
+#else
+Only complex float32 samples are supported at the moment.
+#end if
 
 Device Arguments:
 The device argument is a comma delimited string used to locate devices on your system. Device arguments for multiple devices may be given by separating them with a space.
@@ -263,7 +284,7 @@ Lines ending with ... mean it's possible to bind devices together by specifying
   file='/path/to/your file',rate=1e6[,freq=100e6][,append=true][,throttle=true] ...
 #end if
   redpitaya=192.168.1.100[:1001]
-  hackrf=0[,buffers=32][,bias=0|1][,bias_tx=0|1]
+  hackrf=0[,buffers=32][,bias=0|1][,bias_tx=0|1][,zerocopy=0|1]
   bladerf=0[,fpga='/path/to/the/bitstream.rbf']
   uhd[,serial=...][,lo_offset=0][,mcr=52e6][,nchan=2][,subdev='\\\\'B:0 A:0\\\\''] ...
 
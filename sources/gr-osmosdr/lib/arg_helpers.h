@@ -24,8 +24,11 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <stdexcept>
+#include <stdint.h>
 
 #include <gnuradio/io_signature.h>
+#include <gnuradio/gr_complex.h>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/tokenizer.hpp>
@@ -118,7 +121,53 @@ struct is_nchan_argument
   }
 };
 
-inline gr::io_signature::sptr args_to_io_signature( const std::string &args )
+struct is_format_argument
+{
+  bool operator ()(const std::string &str)
+  {
+    return str.find("format=") == 0;
+  }
+};
+
+/* sample format of the streams: complex float, int16 or int8 IQ */
+inline size_t format_to_item_size( const std::string &format )
+{
+  if ( format == "fc32" )
+    return sizeof(gr_complex);
+  if ( format == "sc16" )
+    return 2 * sizeof(int16_t);
+  if ( format == "sc8" )
+    return 2 * sizeof(int8_t);
+
+  throw std::runtime_error("Unsupported sample format '" + format + "', use fc32, sc16 or sc8.");
+}
+
+inline std::string args_to_format( const std::string &args )
+{
+  std::string format = "fc32";
+
+  BOOST_FOREACH( std::string arg, args_to_vector( args ) )
+    if ( is_format_argument()( arg ) ) // global sample format
+      format = param_to_pair( arg ).second;
+
+  format_to_item_size( format ); // throws on unsupported ones
+  return format;
+}
+
+/* item size of a device block, given its own params */
+inline size_t params_to_item_size( const std::string &params )
+{
+  dict_t dict = params_to_dict( params );
+
+  if ( dict.count("format") )
+    return format_to_item_size( dict["format"] );
+
+  return sizeof(gr_complex);
+}
+
+/* streams of complex float, unless the caller converts to another format */
+inline gr::io_signature::sptr args_to_io_signature( const std::string &args,
+                                                    size_t itemsize = sizeof(gr_complex) )
 {
   size_t max_nchan = 0;
   size_t dev_nchan = 0;
@@ -139,6 +188,12 @@ inline gr::io_signature::sptr args_to_io_signature( const std::string &args )
                     is_nchan_argument() ),
                   arg_list.end() );
 
+  arg_list.erase( std::remove_if( // and the global format
+                    arg_list.begin(),
+                    arg_list.end(),
+                    is_format_argument() ),
+                  arg_list.end() );
+
   // try to parse device specific nchan values, assume 1 channel if none given
 
   BOOST_FOREACH( std::string arg, arg_list )
@@ -159,7 +214,7 @@ inline gr::io_signature::sptr args_to_io_signature( const std::string &args )
     throw std::runtime_error("Wrong device arguments specified. Missing nchan?");
 
   const size_t nchan = std::max<size_t>(dev_nchan, 1); // assume at least one
-  return gr::io_signature::make(nchan, nchan, sizeof(gr_complex));
+  return gr::io_signature::make(nchan, nchan, itemsize);
 }
 
 #endif // OSMOSDR_ARG_HELPERS_H
@@ -36,6 +36,8 @@
 
 #include <gnuradio/io_signature.h>
 
+#include <volk/volk.h>
+
 #include "arg_helpers.h"
 #include "bladerf_source_c.h"
 #include "osmosdr/source.h"
@@ -71,7 +73,8 @@ static const int MAX_OUT = 1;	// maximum number of output streams
 bladerf_source_c::bladerf_source_c (const std::string &args)
   : gr::sync_block ("bladerf_source_c",
                     gr::io_signature::make (MIN_IN, MAX_IN, sizeof (gr_complex)),
-                    gr::io_signature::make (MIN_OUT, MAX_OUT, sizeof (gr_complex)))
+                    gr::io_signature::make (MIN_OUT, MAX_OUT, params_to_item_size(args))),
+    _itemsize(params_to_item_size(args))
 {
   int ret;
   std::string device_name;
@@ -139,9 +142,8 @@ int bladerf_source_c::work( int noutput_items,
                             gr_vector_void_star &output_items )
 {
   int ret;
-  int16_t *current;
-  const float scaling = 1.0f / 2048.0f;
-  gr_complex *out = static_cast<gr_complex *>(output_items[0]);
+  int16_t *samples = _conv_buf;
+  char *out = static_cast<char *>(output_items[0]);
   struct bladerf_metadata meta;
   struct bladerf_metadata *meta_ptr = NULL;
 
@@ -156,8 +158,13 @@ int bladerf_source_c::work( int noutput_items,
     }
 
     _conv_buf = static_cast<int16_t*>(tmp);
+    samples = _conv_buf;
   }
 
+  /* int16 IQ is read right into the output and scaled in place */
+  if (_itemsize == 2 * sizeof(int16_t))
+    samples = reinterpret_cast<int16_t *>(out);
+
   if (_use_metadata) {
     memset(&meta, 0, sizeof(meta));
     meta.flags = BLADERF_META_FLAG_RX_NOW;
@@ -165,7 +172,7 @@ int bladerf_source_c::work( int noutput_items,
   }
 
   /* Grab all the samples into the temporary buffer */
-  ret = bladerf_sync_rx(_dev.get(), static_cast<void *>(_conv_buf),
+  ret = bladerf_sync_rx(_dev.get(), static_cast<void *>(samples),
                         noutput_items, meta_ptr, _stream_timeout_ms);
   if ( ret != 0 ) {
     std::cerr << _pfx << "bladerf_sync_rx error: "
@@ -183,19 +190,17 @@ int bladerf_source_c::work( int noutput_items,
       _consecutive_failures = 0;
   }
 
-  current = _conv_buf;
-
-  /* Convert them from fixed to floating point */
-  for (int i = 0; i < noutput_items; ++i) {
-    float x, y;
-
-    x = scaling * *current;
-    current++;
-
-    y = scaling * *current;
-    current++;
-
-    out[i] = gr_complex(x, y) ;
+  /* Convert them from SC16Q11 to the output format */
+  if (_itemsize == 2 * sizeof(int16_t)) {
+    for (int i = 0; i < 2 * noutput_items; ++i)
+      samples[i] = samples[i] * 16;
+  } else if (_itemsize == 2 * sizeof(int8_t)) {
+    int8_t *out8 = reinterpret_cast<int8_t *>(out);
+    for (int i = 0; i < 2 * noutput_items; ++i)
+      out8[i] = samples[i] >> 4;
+  } else {
+    volk_16i_s32f_convert_32f(reinterpret_cast<float *>(out), samples,
+                              2048.0f, 2 * noutput_items);
   }
 
   return noutput_items;
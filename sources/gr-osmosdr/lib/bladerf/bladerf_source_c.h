@@ -115,6 +115,7 @@ public:
 
 private:
   osmosdr::gain_range_t _lna_range;
+  size_t _itemsize; /* complex float, int16 or int8 IQ */
 };
 
 #endif /* INCLUDED_BLADERF_SOURCE_C_H */
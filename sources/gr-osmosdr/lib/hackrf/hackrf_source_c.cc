@@ -29,10 +29,10 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 
 #include <boost/assign.hpp>
 #include <boost/format.hpp>
-#include <boost/detail/endian.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/thread/thread.hpp>
 
@@ -49,6 +49,9 @@ using namespace boost::assign;
 
 #define BYTES_PER_SAMPLE  2 /* HackRF device produces 8 bit unsigned IQ data */
 
+/* samples lost before the tagged one, when transfers were dropped */
+static const pmt::pmt_t RX_DROPPED_KEY = pmt::string_to_symbol("rx_dropped");
+
 #define HACKRF_FORMAT_ERROR(ret) \
   boost::str( boost::format("(%d) %s") \
     % ret % hackrf_error_name((enum hackrf_error)ret) ) \
@@ -89,9 +92,11 @@ static const int MAX_OUT = 1;	// maximum number of output streams
 hackrf_source_c::hackrf_source_c (const std::string &args)
   : gr::sync_block ("hackrf_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
-        gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+        gr::io_signature::make(MIN_OUT, MAX_OUT, params_to_item_size(args))),
     _dev(NULL),
-    _buf(NULL),
+    _ring(NULL),
+    _itemsize(params_to_item_size(args)),
+    _zero_copy(false),
     _sample_rate(0),
     _center_freq(0),
     _freq_corr(0),
@@ -106,7 +111,7 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
 
   dict_t dict = params_to_dict(args);
 
-  _buf_num = _buf_len = _buf_head = _buf_used = _buf_offset = 0;
+  _buf_num = _buf_len = _buf_offset = 0;
 
   if (dict.count("buffers"))
     _buf_num = boost::lexical_cast< unsigned int >( dict["buffers"] );
@@ -120,18 +125,15 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
   if (0 == _buf_len || _buf_len % 512 != 0) /* len must be multiple of 512 */
     _buf_len = BUF_LEN;
 
-  _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+  if (dict.count("zerocopy"))
+    _zero_copy = boost::lexical_cast< bool >( dict["zerocopy"] );
 
-  // create a lookup table for gr_complex values
-  for (unsigned int i = 0; i <= 0xffff; i++) {
-#ifdef BOOST_LITTLE_ENDIAN
-    _lut.push_back( gr_complex( (float(int8_t(i & 0xff))) * (1.0f/128.0f),
-                                (float(int8_t(i >> 8))) * (1.0f/128.0f) ) );
-#else // BOOST_BIG_ENDIAN
-    _lut.push_back( gr_complex( (float(int8_t(i >> 8))) * (1.0f/128.0f),
-                                (float(int8_t(i & 0xff))) * (1.0f/128.0f) ) );
-#endif
+#ifndef LIBHACKRF_HAVE_RELEASE_RX_BUFFER
+  if (_zero_copy) {
+    std::cerr << "Zero-copy receive is not supported by this libhackrf." << std::endl;
+    _zero_copy = false;
   }
+#endif
 
   {
     boost::mutex::scoped_lock lock( _usage_mutex );
@@ -222,12 +224,19 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
     }
   }
 
-  _buf = (unsigned short **) malloc(_buf_num * sizeof(unsigned short *));
+#ifdef LIBHACKRF_HAVE_RELEASE_RX_BUFFER
+  if (_zero_copy) {
+    /* transfers queued for work() aren't in flight, keep 2 of them going */
+    if (_buf_num < 4)
+      _buf_num = 4;
 
-  if (_buf) {
-    for(unsigned int i = 0; i < _buf_num; ++i)
-      _buf[i] = (unsigned short *) malloc(_buf_len);
-  }
+    ret = hackrf_set_transfer_count( _dev, _buf_num );
+    HACKRF_THROW_ON_ERROR(ret, "Failed to set the number of transfers")
+
+    _ring = new transfer_ring( _buf_num - 2, 0 );
+  } else
+#endif
+    _ring = new transfer_ring( _buf_num, _buf_len );
 
 //  _thread = gr::thread::thread(_hackrf_wait, this);
 
@@ -258,14 +267,8 @@ hackrf_source_c::~hackrf_source_c ()
     }
   }
 
-  if (_buf) {
-    for(unsigned int i = 0; i < _buf_num; ++i) {
-      free(_buf[i]);
-    }
-
-    free(_buf);
-    _buf = NULL;
-  }
+  delete _ring;
+  _ring = NULL;
 }
 
 int hackrf_source_c::_hackrf_rx_callback(hackrf_transfer *transfer)
@@ -276,21 +279,18 @@ int hackrf_source_c::_hackrf_rx_callback(hackrf_transfer *transfer)
 
 int hackrf_source_c::hackrf_rx_callback(unsigned char *buf, uint32_t len)
 {
-  {
-    boost::mutex::scoped_lock lock( _buf_mutex );
-
-    int buf_tail = (_buf_head + _buf_used) % _buf_num;
-    memcpy(_buf[buf_tail], buf, len);
+#ifdef LIBHACKRF_HAVE_RELEASE_RX_BUFFER
+  if (_zero_copy) {
+    if ( _ring->push(buf, len) )
+      return HACKRF_RX_KEEP_BUFFER; /* given back by work() */
 
-    if (_buf_used == _buf_num) {
-      std::cerr << "O" << std::flush;
-      _buf_head = (_buf_head + 1) % _buf_num;
-    } else {
-      _buf_used++;
-    }
+    std::cerr << "O" << std::flush;
+    return 0;
   }
+#endif
 
-  _buf_cond.notify_one();
+  if ( ! _ring->push_copy(buf, len) )
+    std::cerr << "O" << std::flush;
 
   return 0; // TODO: return -1 on error/stop
 }
@@ -308,6 +308,8 @@ bool hackrf_source_c::start()
 {
   if ( ! _dev )
     return false;
+
+  _ring->start();
 #if 0
   int ret = hackrf_start_rx( _dev, _hackrf_rx_callback, (void *)this );
   if ( ret != HACKRF_SUCCESS ) {
@@ -322,6 +324,8 @@ bool hackrf_source_c::stop()
 {
   if ( ! _dev )
     return false;
+
+  _ring->stop();
 #if 0
   int ret = hackrf_stop_rx( _dev );
   if ( ret != HACKRF_SUCCESS ) {
@@ -336,54 +340,46 @@ int hackrf_source_c::work( int noutput_items,
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items )
 {
-  gr_complex *out = (gr_complex *)output_items[0];
+  char *out = (char *)output_items[0];
 
   bool running = false;
 
   if ( _dev )
     running = (hackrf_is_streaming( _dev ) == HACKRF_TRUE);
 
-  {
-    boost::mutex::scoped_lock lock( _buf_mutex );
-
-    while (_buf_used < 3 && running) // collect at least 3 buffers
-      _buf_cond.wait( lock );
-  }
+  if ( running )
+    _ring->wait(3); // collect at least 3 buffers
 
   if ( ! running )
     return WORK_DONE;
 
-  unsigned short *buf = _buf[_buf_head] + _buf_offset;
+  int produced = 0;
+  const transfer_ring::transfer *t;
 
-  if (noutput_items <= _samp_avail) {
-    for (int i = 0; i < noutput_items; ++i)
-      *out++ = _lut[ *(buf + i) ];
+  while ( produced < noutput_items && (t = _ring->front()) ) {
+    unsigned int avail = t->len / BYTES_PER_SAMPLE - _buf_offset;
+    unsigned int n = std::min( avail, (unsigned int)(noutput_items - produced) );
 
-    _buf_offset += noutput_items;
-    _samp_avail -= noutput_items;
-  } else {
-    for (int i = 0; i < _samp_avail; ++i)
-      *out++ = _lut[ *(buf + i) ];
+    if ( _buf_offset == 0 && t->dropped )
+      add_item_tag( 0, nitems_written(0) + produced, RX_DROPPED_KEY,
+                    pmt::from_uint64( (uint64_t)t->dropped * t->len / BYTES_PER_SAMPLE ) );
 
-    {
-      boost::mutex::scoped_lock lock( _buf_mutex );
+    transfer_ring::convert( out + produced * _itemsize,
+                            t->buf + _buf_offset * BYTES_PER_SAMPLE, n, _itemsize );
+    produced += n;
+    _buf_offset += n;
 
-      _buf_head = (_buf_head + 1) % _buf_num;
-      _buf_used--;
+    if ( n == avail ) {
+#ifdef LIBHACKRF_HAVE_RELEASE_RX_BUFFER
+      if (_zero_copy)
+        hackrf_release_rx_buffer( _dev, t->buf );
+#endif
+      _ring->pop();
+      _buf_offset = 0;
     }
-
-    buf = _buf[_buf_head];
-
-    int remaining = noutput_items - _samp_avail;
-
-    for (int i = 0; i < remaining; ++i)
-      *out++ = _lut[ *(buf + i) ];
-
-    _buf_offset = remaining;
-    _samp_avail = (_buf_len / BYTES_PER_SAMPLE) - remaining;
   }
 
-  return noutput_items;
+  return produced;
 }
 
 std::vector<std::string> hackrf_source_c::get_devices()
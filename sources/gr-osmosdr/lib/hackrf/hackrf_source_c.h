@@ -26,11 +26,11 @@
 #include <gnuradio/sync_block.h>
 
 #include <boost/thread/mutex.hpp>
-#include <boost/thread/condition_variable.hpp>
 
 #include <libhackrf/hackrf.h>
 
 #include "source_iface.h"
+#include "transfer_ring.h"
 
 class hackrf_source_c;
 
@@ -129,20 +129,14 @@ private:
   static int _usage;
   static boost::mutex _usage_mutex;
 
-  std::vector<gr_complex> _lut;
-
   hackrf_device *_dev;
   gr::thread::thread _thread;
-  unsigned short **_buf;
+  transfer_ring *_ring;
+  size_t _itemsize; /* complex float, int16 or int8 IQ */
+  bool _zero_copy;
   unsigned int _buf_num;
   unsigned int _buf_len;
-  unsigned int _buf_head;
-  unsigned int _buf_used;
-  boost::mutex _buf_mutex;
-  boost::condition_variable _buf_cond;
-
   unsigned int _buf_offset;
-  int _samp_avail;
 
   double _sample_rate;
   double _center_freq;
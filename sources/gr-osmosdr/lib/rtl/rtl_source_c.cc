@@ -32,11 +32,11 @@
 
 #include <boost/assign.hpp>
 #include <boost/format.hpp>
-#include <boost/detail/endian.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 #include <stdio.h>
 
 #include <rtl-sdr.h>
@@ -51,6 +51,17 @@ using namespace boost::assign;
 
 #define BYTES_PER_SAMPLE  2 // rtl device delivers 8 bit unsigned IQ data
 
+/*
+ * The samples are made signed while copied out of the transfer, the
+ * zero of the ADC is at 127.4 rather than 128 though (which only
+ * complex float output corrects)
+ */
+#define SIGN_FLIP  0x80
+#define DC_OFFSET  (0.6f / 128.0f)
+
+/* samples lost before the tagged one, when transfers were dropped */
+static const pmt::pmt_t RX_DROPPED_KEY = pmt::string_to_symbol("rx_dropped");
+
 /*
  * Create a new instance of rtl_source_c and return
  * a boost shared_ptr.  This is effectively the public constructor.
@@ -81,9 +92,10 @@ static const int MAX_OUT = 1;	// maximum number of output streams
 rtl_source_c::rtl_source_c (const std::string &args)
   : gr::sync_block ("rtl_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
-        gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+        gr::io_signature::make(MIN_OUT, MAX_OUT, params_to_item_size(args))),
     _dev(NULL),
-    _buf(NULL),
+    _ring(NULL),
+    _itemsize(params_to_item_size(args)),
     _running(false),
     _no_tuner(false),
     _auto_gain(false),
@@ -150,7 +162,7 @@ rtl_source_c::rtl_source_c (const std::string &args)
   if (dict.count("offset_tune"))
     offset_tune = boost::lexical_cast< unsigned int >( dict["offset_tune"] );
 
-  _buf_num = _buf_len = _buf_head = _buf_used = _buf_offset = 0;
+  _buf_num = _buf_len = _buf_offset = 0;
 
   if (dict.count("buffers"))
     _buf_num = boost::lexical_cast< unsigned int >( dict["buffers"] );
@@ -169,19 +181,6 @@ rtl_source_c::rtl_source_c (const std::string &args)
               << std::endl;
   }
 
-  _samp_avail = _buf_len / BYTES_PER_SAMPLE;
-
-  // create a lookup table for gr_complex values
-  for (unsigned int i = 0; i <= 0xffff; i++) {
-#ifdef BOOST_LITTLE_ENDIAN
-    _lut.push_back( gr_complex( (float(i & 0xff) - 127.4f) * (1.0f/128.0f),
-                                (float(i >> 8) - 127.4f) * (1.0f/128.0f) ) );
-#else // BOOST_BIG_ENDIAN
-    _lut.push_back( gr_complex( (float(i >> 8) - 127.4f) * (1.0f/128.0f),
-                                (float(i & 0xff) - 127.4f) * (1.0f/128.0f) ) );
-#endif
-  }
-
   _dev = NULL;
   ret = rtlsdr_open( &_dev, dev_index );
   if (ret < 0)
@@ -230,12 +229,9 @@ rtl_source_c::rtl_source_c (const std::string &args)
 
   set_if_gain( 24 ); /* preset to a reasonable default (non-GRC use case) */
 
-  _buf = (unsigned short **) malloc(_buf_num * sizeof(unsigned short *));
-
-  if (_buf) {
-    for(unsigned int i = 0; i < _buf_num; ++i)
-      _buf[i] = (unsigned short *) malloc(_buf_len);
-  }
+  /* librtlsdr resubmits a transfer once the callback returns, so the
+   * samples have to be copied out of it */
+  _ring = new transfer_ring( _buf_num, _buf_len );
 }
 
 /*
@@ -255,18 +251,13 @@ rtl_source_c::~rtl_source_c ()
     _dev = NULL;
   }
 
-  if (_buf) {
-    for(unsigned int i = 0; i < _buf_num; ++i) {
-      free(_buf[i]);
-    }
-
-    free(_buf);
-    _buf = NULL;
-  }
+  delete _ring;
+  _ring = NULL;
 }
 
 bool rtl_source_c::start()
 {
+  _ring->start();
   _running = true;
   _thread = gr::thread::thread(_rtlsdr_wait, this);
 
@@ -296,21 +287,8 @@ void rtl_source_c::rtlsdr_callback(unsigned char *buf, uint32_t len)
     return;
   }
 
-  {
-    boost::mutex::scoped_lock lock( _buf_mutex );
-
-    int buf_tail = (_buf_head + _buf_used) % _buf_num;
-    memcpy(_buf[buf_tail], buf, len);
-
-    if (_buf_used == _buf_num) {
-      std::cerr << "O" << std::flush;
-      _buf_head = (_buf_head + 1) % _buf_num;
-    } else {
-      _buf_used++;
-    }
-  }
-
-  _buf_cond.notify_one();
+  if ( ! _ring->push_copy(buf, len, SIGN_FLIP) )
+    std::cerr << "O" << std::flush;
 }
 
 void rtl_source_c::_rtlsdr_wait(rtl_source_c *obj)
@@ -327,50 +305,46 @@ void rtl_source_c::rtlsdr_wait()
   if ( ret != 0 )
     std::cerr << "rtlsdr_read_async returned with " << ret << std::endl;
 
-  _buf_cond.notify_one();
+  _ring->stop();
 }
 
 int rtl_source_c::work( int noutput_items,
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items )
 {
-  gr_complex *out = (gr_complex *)output_items[0];
-
-  {
-    boost::mutex::scoped_lock lock( _buf_mutex );
+  char *out = (char *)output_items[0];
 
-    while (_buf_used < 3 && _running) // collect at least 3 buffers
-      _buf_cond.wait( lock );
-  }
+  if (_running)
+    _ring->wait(3); // collect at least 3 buffers
 
   if (!_running)
     return WORK_DONE;
 
-  while (noutput_items && _buf_used) {
-    const int nout = std::min(noutput_items, _samp_avail);
-    const unsigned short *buf = _buf[_buf_head] + _buf_offset;
+  int produced = 0;
+  const transfer_ring::transfer *t;
 
-    for (int i = 0; i < nout; ++i)
-      *out++ = _lut[ *(buf + i) ];
+  while (produced < noutput_items && (t = _ring->front())) {
+    const unsigned int avail = t->len / BYTES_PER_SAMPLE - _buf_offset;
+    const unsigned int nout = std::min(avail, (unsigned int)(noutput_items - produced));
 
-    noutput_items -= nout;
-    _samp_avail -= nout;
+    if (_buf_offset == 0 && t->dropped)
+      add_item_tag( 0, nitems_written(0) + produced, RX_DROPPED_KEY,
+                    pmt::from_uint64( (uint64_t)t->dropped * t->len / BYTES_PER_SAMPLE ) );
 
-    if (!_samp_avail) {
-      {
-        boost::mutex::scoped_lock lock( _buf_mutex );
+    transfer_ring::convert( out + produced * _itemsize,
+                            t->buf + _buf_offset * BYTES_PER_SAMPLE, nout, _itemsize, DC_OFFSET );
 
-        _buf_head = (_buf_head + 1) % _buf_num;
-        _buf_used--;
-      }
-      _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+    produced += nout;
+
+    if (nout == avail) {
+      _ring->pop();
       _buf_offset = 0;
     } else {
       _buf_offset += nout;
     }
   }
 
-  return (out - ((gr_complex *)output_items[0]));
+  return produced;
 }
 
 std::vector<std::string> rtl_source_c::get_devices()
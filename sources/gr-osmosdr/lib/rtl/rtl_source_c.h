@@ -25,10 +25,10 @@
 #include <gnuradio/sync_block.h>
 
 #include <gnuradio/thread/thread.h>
-#include <boost/thread/mutex.hpp>
-#include <boost/thread/condition_variable.hpp>
+#include <boost/atomic.hpp>
 
 #include "source_iface.h"
+#include "transfer_ring.h"
 
 class rtl_source_c;
 typedef struct rtlsdr_dev rtlsdr_dev_t;
@@ -122,21 +122,15 @@ private:
   static void _rtlsdr_wait(rtl_source_c *obj);
   void rtlsdr_wait();
 
-  std::vector<gr_complex> _lut;
-
   rtlsdr_dev_t *_dev;
   gr::thread::thread _thread;
-  unsigned short **_buf;
+  transfer_ring *_ring;
+  size_t _itemsize; /* complex float, int16 or int8 IQ */
   unsigned int _buf_num;
   unsigned int _buf_len;
-  unsigned int _buf_head;
-  unsigned int _buf_used;
-  boost::mutex _buf_mutex;
-  boost::condition_variable _buf_cond;
-  bool _running;
+  boost::atomic<bool> _running;
 
   unsigned int _buf_offset;
-  int _samp_avail;
 
   bool _no_tuner;
   bool _auto_gain;
@@ -30,6 +30,8 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/blocks/null_source.h>
 #include <gnuradio/blocks/throttle.h>
+#include <gnuradio/blocks/float_to_short.h>
+#include <gnuradio/blocks/float_to_char.h>
 #include <gnuradio/constants.h>
 
 #ifdef ENABLE_OSMOSDR
@@ -111,7 +113,7 @@ osmosdr::source::make( const std::string &args )
 source_impl::source_impl( const std::string &args )
   : gr::hier_block2 ("source_impl",
         gr::io_signature::make(0, 0, 0),
-        args_to_io_signature(args)),
+        args_to_io_signature(args, format_to_item_size(args_to_format(args)))),
     _sample_rate(NAN)
 {
   size_t channel = 0;
@@ -119,6 +121,9 @@ source_impl::source_impl( const std::string &args )
 
   std::vector< std::string > arg_list = args_to_vector(args);
 
+  const std::string format = args_to_format(args);
+  const size_t itemsize = format_to_item_size(format);
+
   std::vector< std::string > dev_types;
 
 #ifdef ENABLE_FILE
@@ -253,8 +258,17 @@ source_impl::source_impl( const std::string &args )
 
   BOOST_FOREACH(std::string arg, arg_list) {
 
+    if ( is_format_argument()( arg ) )
+      continue;
+
     dict_t dict = params_to_dict(arg);
 
+    /* only these drivers deliver other formats natively, the output of
+     * the others is converted below */
+    if ( format != "fc32" &&
+         (dict.count("rtl") || dict.count("hackrf") || dict.count("bladerf")) )
+      arg += ",format=" + format;
+
 //    std::cerr << std::endl;
 //    BOOST_FOREACH( dict_t::value_type &entry, dict )
 //      std::cerr << "'" << entry.first << "' = '" << entry.second << "'" << std::endl;
@@ -368,6 +382,26 @@ source_impl::source_impl( const std::string &args )
       _devs.push_back( iface );
 
       for (size_t i = 0; i < iface->get_num_channels(); i++) {
+        if ( format != "fc32" ) {
+          if ( (size_t) block->output_signature()->sizeof_stream_item(i) == itemsize ) {
+            connect(block, i, self(), channel++);
+            continue;
+          }
+
+          /* complex float only, scale it to the range of the integers:
+           * a complex item is a vector of two floats, which the volk
+           * conversion scales and saturates in one pass */
+          gr::basic_block_sptr convert;
+          if ( format == "sc16" )
+            convert = gr::blocks::float_to_short::make( 2, 32767.0f );
+          else
+            convert = gr::blocks::float_to_char::make( 2, 127.0f );
+
+          connect(block, i, convert, 0);
+          connect(convert, 0, self(), channel++);
+          continue;
+        }
+
 #ifdef HAVE_IQBALANCE
         gr::iqbalance::optimize_c::sptr iq_opt = gr::iqbalance::optimize_c::make( 0 );
         gr::iqbalance::fix_cc::sptr     iq_fix = gr::iqbalance::fix_cc::make();
@@ -399,10 +433,10 @@ source_impl::source_impl( const std::string &args )
      * the missing hardware (channels) with null sourc(e) */
 
     gr::blocks::null_source::sptr null_source = \
-        gr::blocks::null_source::make( sizeof(gr_complex) );
+        gr::blocks::null_source::make( itemsize );
 
     gr::blocks::throttle::sptr throttle = \
-        gr::blocks::throttle::make( sizeof(gr_complex), 1e5 );
+        gr::blocks::throttle::make( itemsize, 1e5 );
 
     connect(null_source, 0, throttle, 0);
 
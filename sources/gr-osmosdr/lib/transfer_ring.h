@@ -0,0 +1,246 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2016 Free Software Foundation, Inc.
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_TRANSFER_RING_H
+#define OSMOSDR_TRANSFER_RING_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <gnuradio/gr_complex.h>
+
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <volk/volk.h>
+
+/*
+ * Passes the sample buffers of USB transfers from the callback of a
+ * source (the producer) to its work() (the consumer) without locks.
+ *
+ * In copy mode the ring owns its buffers: the callback copies each
+ * transfer into a free one, which work() gives back after conversion.
+ * Otherwise the ring holds the buffers of the transfers themselves,
+ * which work() has to hand back to the driver once converted.
+ *
+ * When the ring is full the newest transfer is dropped, and the number
+ * of transfers dropped before a buffer is passed along with it.
+ * work() only sleeps when there is nothing to convert, the callback
+ * only takes the mutex to wake it up.
+ */
+class transfer_ring
+{
+public:
+  struct transfer {
+    unsigned char *buf;
+    unsigned int len;     /* bytes */
+    unsigned int dropped; /* transfers dropped right before this one */
+  };
+
+  /*
+   * num: buffers in copy mode, otherwise transfers the ring may hold
+   * len: bytes of a buffer in copy mode, 0 otherwise
+   */
+  transfer_ring( unsigned int num, unsigned int len ) :
+    _filled(num),
+    _free(num),
+    _num(num),
+    _len(len),
+    _dropped(0),
+    _has_front(false),
+    _waiting(false),
+    _stopped(false)
+  {
+    for (unsigned int i = 0; _len && i < num; i++)
+      _free.push( (unsigned char *) malloc(_len) );
+  }
+
+  ~transfer_ring()
+  {
+    unsigned char *buf;
+    transfer t;
+
+    if (_len) {
+      if (_has_front)
+        free(_front.buf);
+      while (_filled.pop(t))
+        free(t.buf);
+      while (_free.pop(buf))
+        free(buf);
+    }
+  }
+
+  /* producer: copies a transfer, the bytes optionally XORed with mask */
+  bool push_copy( const unsigned char *buf, unsigned int len, uint8_t mask = 0 )
+  {
+    transfer t;
+
+    if ( ! _free.pop(t.buf) ) {
+      _dropped++;
+      return false;
+    }
+
+    t.len = len < _len ? len : _len;
+    if (mask) {
+      uint64_t mask64 = 0x0101010101010101ULL * mask;
+      unsigned int i = 0;
+      for (; i + 8 <= t.len; i += 8) {
+        uint64_t v;
+        memcpy(&v, buf + i, 8);
+        v ^= mask64;
+        memcpy(t.buf + i, &v, 8);
+      }
+      for (; i < t.len; i++)
+        t.buf[i] = buf[i] ^ mask;
+    } else {
+      memcpy(t.buf, buf, t.len);
+    }
+
+    enqueue(t);
+    return true;
+  }
+
+  /* producer: passes the buffer of a transfer, false if it was dropped */
+  bool push( unsigned char *buf, unsigned int len )
+  {
+    if ( ! _filled.write_available() ) {
+      _dropped++;
+      return false;
+    }
+
+    transfer t;
+    t.buf = buf;
+    t.len = len;
+    enqueue(t);
+    return true;
+  }
+
+  /* consumer: waits until n transfers (at most all) are queued or stop() was called */
+  void wait( size_t n )
+  {
+    if ( n > _num )
+      n = _num;
+    if ( available() >= n )
+      return;
+
+    boost::mutex::scoped_lock lock( _mutex );
+    _waiting = true;
+    boost::atomic_thread_fence( boost::memory_order_seq_cst );
+    while ( available() < n && ! _stopped )
+      _cond.wait( lock );
+    _waiting = false;
+  }
+
+  /* consumer: the oldest transfer, NULL if there is none */
+  const transfer *front()
+  {
+    if ( ! _has_front )
+      _has_front = _filled.pop(_front);
+    return _has_front ? &_front : NULL;
+  }
+
+  /* consumer: removes front(), in copy mode its buffer is reused */
+  void pop()
+  {
+    if (_len)
+      _free.push(_front.buf);
+    _has_front = false;
+  }
+
+  /* consumer: number of queued transfers */
+  size_t available()
+  {
+    return _filled.read_available() + (_has_front ? 1 : 0);
+  }
+
+  /* wakes up and no longer blocks wait(), until start() */
+  void stop()
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    _stopped = true;
+    _cond.notify_one();
+  }
+
+  void start()
+  {
+    boost::mutex::scoped_lock lock( _mutex );
+    _stopped = false;
+  }
+
+  /*
+   * 8 bit signed IQ to items of the given size: complex scaled to
+   * [-1, 1), int16 IQ scaled to full range or int8 IQ as they are.
+   * dc_offset is added to I and Q of complex items in the same pass.
+   */
+  static void convert( void *out, const unsigned char *in, unsigned int nsamples, size_t itemsize,
+                       float dc_offset = 0.0f )
+  {
+    switch (itemsize) {
+    case 2 * sizeof(int8_t):
+      memcpy( out, in, 2 * nsamples );
+      break;
+    case 2 * sizeof(int16_t):
+      volk_8i_convert_16i( (int16_t *)out, (const int8_t *)in, 2 * nsamples );
+      break;
+    default:
+      if (dc_offset == 0.0f) {
+        volk_8i_s32f_convert_32f( (float *)out, (const int8_t *)in, 128.0f, 2 * nsamples );
+      } else {
+        float *f = (float *)out;
+        const int8_t *s = (const int8_t *)in;
+        for (unsigned int i = 0; i < 2 * nsamples; ++i)
+          f[i] = s[i] * (1.0f / 128.0f) + dc_offset;
+      }
+    }
+  }
+
+private:
+  void enqueue( transfer &t )
+  {
+    t.dropped = _dropped;
+    _dropped = 0;
+    _filled.push(t);
+
+    boost::atomic_thread_fence( boost::memory_order_seq_cst );
+    if ( _waiting ) {
+      boost::mutex::scoped_lock lock( _mutex );
+      _cond.notify_one();
+    }
+  }
+
+  boost::lockfree::spsc_queue< transfer > _filled;
+  boost::lockfree::spsc_queue< unsigned char * > _free;
+  unsigned int _num;
+  unsigned int _len;
+  unsigned int _dropped; /* producer only */
+
+  transfer _front;       /* consumer only */
+  bool _has_front;
+
+  boost::atomic<bool> _waiting;
+  bool _stopped;
+  boost::mutex _mutex;
+  boost::condition_variable _cond;
+};
+
+#endif /* OSMOSDR_TRANSFER_RING_H */
@@ -161,6 +161,7 @@ static int free_transfers(hackrf_device* device)
 		{
 			if( device->transfers[transfer_index] != NULL )
 			{
+				free(device->transfers[transfer_index]->buffer);
 				libusb_free_transfer(device->transfers[transfer_index]);
 				device->transfers[transfer_index] = NULL;
 			}
@@ -1349,6 +1350,7 @@ static void* transfer_threadproc(void* arg)
 static void hackrf_libusb_transfer_callback(struct libusb_transfer* usb_transfer)
 {
 	hackrf_device* device = (hackrf_device*)usb_transfer->user_data;
+	int result;
 
 	if(usb_transfer->status == LIBUSB_TRANSFER_COMPLETED)
 	{
@@ -1361,7 +1363,8 @@ static void hackrf_libusb_transfer_callback(struct libusb_transfer* usb_transfer
 			transfer.tx_ctx = device->tx_ctx
 		};
 
-		if( device->callback(&transfer) == 0 )
+		result = device->callback(&transfer);
+		if( result == 0 )
 		{
 			if( libusb_submit_transfer(usb_transfer) < 0)
 			{
@@ -1369,6 +1372,10 @@ static void hackrf_libusb_transfer_callback(struct libusb_transfer* usb_transfer
 			}else {
 				return;
 			}
+		}else if( result == HACKRF_RX_KEEP_BUFFER )
+		{
+			/* resubmitted by hackrf_release_rx_buffer() */
+			return;
 		}else {
 			request_exit();
 		}
@@ -1467,6 +1474,47 @@ int ADDCALL hackrf_is_streaming(hackrf_device* device)
 	}
 }
 
+int ADDCALL hackrf_release_rx_buffer(hackrf_device* device, uint8_t* buffer)
+{
+	uint32_t transfer_index;
+
+	if( hackrf_is_streaming(device) != HACKRF_TRUE )
+	{
+		return HACKRF_ERROR_STREAMING_STOPPED;
+	}
+
+	for(transfer_index=0; transfer_index<device->transfer_count; transfer_index++)
+	{
+		if( device->transfers[transfer_index]->buffer == buffer )
+		{
+			if( libusb_submit_transfer(device->transfers[transfer_index]) < 0 )
+			{
+				request_exit();
+				return HACKRF_ERROR_LIBUSB;
+			}
+			return HACKRF_SUCCESS;
+		}
+	}
+	return HACKRF_ERROR_INVALID_PARAM;
+}
+
+int ADDCALL hackrf_set_transfer_count(hackrf_device* device, const uint32_t count)
+{
+	if( count == 0 )
+	{
+		return HACKRF_ERROR_INVALID_PARAM;
+	}
+
+	if( device->transfer_thread_started != false )
+	{
+		return HACKRF_ERROR_BUSY;
+	}
+
+	free_transfers(device);
+	device->transfer_count = count;
+	return allocate_transfers(device);
+}
+
 int ADDCALL hackrf_start_rx(hackrf_device* device, hackrf_sample_block_cb_fn callback, void* rx_ctx)
 {
 	int result;
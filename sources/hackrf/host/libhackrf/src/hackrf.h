@@ -120,6 +120,10 @@ typedef struct hackrf_device_list hackrf_device_list_t;
 
 typedef int (*hackrf_sample_block_cb_fn)(hackrf_transfer* transfer);
 
+/* returned by an rx callback which keeps the buffer of the transfer, which
+   is then only resubmitted by hackrf_release_rx_buffer() */
+#define HACKRF_RX_KEEP_BUFFER 2
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -144,6 +148,12 @@ extern ADDAPI int ADDCALL hackrf_stop_tx(hackrf_device* device);
 
 /* return HACKRF_TRUE if success */
 extern ADDAPI int ADDCALL hackrf_is_streaming(hackrf_device* device);
+
+/* hands back a buffer kept by the rx callback, to be filled again */
+extern ADDAPI int ADDCALL hackrf_release_rx_buffer(hackrf_device* device, uint8_t* buffer);
+
+/* number of transfers in flight, only while not streaming */
+extern ADDAPI int ADDCALL hackrf_set_transfer_count(hackrf_device* device, const uint32_t count);
  
 extern ADDAPI int ADDCALL hackrf_max2837_read(hackrf_device* device, uint8_t register_number, uint16_t* value);
 extern ADDAPI int ADDCALL hackrf_max2837_write(hackrf_device* device, uint8_t register_number, uint16_t value);